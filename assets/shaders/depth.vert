@@ -31,12 +31,15 @@
 //     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //
 
-uniform mat4 mvpMat;
+// the frame and pass constants shared by all programs (see scene-blocks.glsl)
+#include "scene-blocks.glsl"
+// the per-object constants, fetched by object index (see object-data.glsl)
+#include "object-data.glsl"
 
 layout (location = 0) in vec3 position;
 
 void main() {
     vec4 positionHomogeneous = vec4(position, 1.0f);
     // output clip-space position...
-    gl_Position = mvpMat * positionHomogeneous;
+    gl_Position = viewProjection * passModelMat * fetchModelMat() * positionHomogeneous;
 }
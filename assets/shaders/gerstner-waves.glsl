@@ -0,0 +1,51 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//NOTE: this file is #included by shaders (see ShaderTools::loadShaderSource) and must NOT have a #version line
+//NOTE: this is the single GLSL definition of the wave set, its C++ mirror is geometry::GerstnerWaveStd140 / geometry::GerstnerWaveBlockHeaderStd140 in gerstner-wave.h
+//NOTE: the C++ side queries the block size from the linked program to find the capacity, so MAX_COUNT_OF_GERSTNER_WAVES only needs to be changed here
+//NOTE: 16 + 256 x 32 bytes = 8208 bytes, well under the 16KB minimum GL_MAX_UNIFORM_BLOCK_SIZE
+// reference: https://developer.nvidia.com/gpugems/gpugems/part-i-natural-effects/chapter-1-effective-water-simulation-physical-models
+// reference: https://www.khronos.org/opengl/wiki/Interface_Block_(GLSL)#Memory_layout
+
+const uint MAX_COUNT_OF_GERSTNER_WAVES = 256;
+
+struct GerstnerWave {
+    float amplitude_A;
+    float frequency_w;
+    float phaseConstant_phi;
+    float steepness_Q_i;
+    vec2 xzDirection_D;
+};
+
+layout(std140) uniform GerstnerWaveBlock {
+    uint gerstnerWaveCount; // the live count, loops over the waves should use this rather than MAX_COUNT_OF_GERSTNER_WAVES
+    GerstnerWave gerstnerWaves[MAX_COUNT_OF_GERSTNER_WAVES];
+};
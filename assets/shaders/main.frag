@@ -31,21 +31,18 @@
 //     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //
 
-uniform vec4 fogColourFarAtCurrentTime;
-uniform float fogDepthRadiusFar;
-uniform float fogDepthRadiusNear;
-uniform bool hasNormals;
-uniform bool isTextured;
-// in view-space
-uniform vec3 lightVec;
+// the frame and pass constants shared by all programs (see scene-blocks.glsl)
+#include "scene-blocks.glsl"
+
 uniform sampler2D textureData;
-uniform float zFar;
 
 in vec3 COLOUR;
 in vec3 normalVec;
 in vec2 UV;
 in vec3 viewSpacePosition;
 in vec3 viewVec;
+flat in int HAS_NORMALS;
+flat in int IS_TEXTURED;
 
 out vec4 colour;
 
@@ -56,6 +53,9 @@ void main() {
     //NOTE: using the view-space position since we want the distance from the camera eye (which is the origin of view-space)
     float worldSpaceDepth = clamp(length(viewSpacePosition) / zFar, 0.0f, 1.0f);
 
+    bool hasNormals = 0 != HAS_NORMALS;
+    bool isTextured = 0 != IS_TEXTURED;
+
     vec4 baseColour = isTextured ? texture(textureData, UV) : vec4(COLOUR, 1.0f);
     // if we have normals, apply Lambertian diffuse
     // diffuse factor (in range [0.0, 1.0]
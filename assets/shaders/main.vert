@@ -31,16 +31,10 @@
 //     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //
 
-// default "plane" is a singularity which will cause this manual clipping test to always succeed for all vertices
-//NOTE: this symbolic value should always be passed when you want this manual clipping disabled (cause some drivers might ignore glEnable/glDisable of GL_CLIP_DISTANCEi)
-//NOTE: if you ever output a clip distance that isn't enabled, the clipping stage will just ignore the manual test
-// reference: https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/gl_ClipDistance.xhtml
-// reference: https://prideout.net/clip-planes
-uniform vec4 clipPlane0 = vec4(0.0f, 0.0f, 0.0f, 1.0f); // <A, B, C, D> where Ax + By + Cz = D
-uniform bool forceFlipNormals;
-uniform mat4 modelMat;
-uniform mat4 modelViewMat;
-uniform mat4 mvpMat;
+// the frame and pass constants shared by all programs (see scene-blocks.glsl)
+#include "scene-blocks.glsl"
+// the per-object constants, fetched by object index (see object-data.glsl)
+#include "object-data.glsl"
 
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec3 normal;
@@ -52,16 +46,25 @@ out vec3 normalVec;
 out vec2 UV;
 out vec3 viewSpacePosition;
 out vec3 viewVec;
+flat out int HAS_NORMALS;
+flat out int IS_TEXTURED;
 
 out float gl_ClipDistance[1];
 
 void main() {
+    // the pass matrix (e.g. the local reflections mirror) is applied on top of the object's own model matrix
+    mat4 worldMat = passModelMat * fetchModelMat();
+    mat4 modelViewMat = view * worldMat;
+
     vec4 positionHomogenous = vec4(position, 1.0f);
     vec4 normalHomogenous = forceFlipNormals ? vec4(-normal, 0.0f) : vec4(normal, 0.0f);
 
     // output (pass-throughs)...
     COLOUR = colour;
     UV = uv;
+    vec4 objectFlags = fetchObjectFlags();
+    HAS_NORMALS = int(objectFlags.x);
+    IS_TEXTURED = int(objectFlags.y);
 
     // output view-space position...
     viewSpacePosition = (modelViewMat * positionHomogenous).xyz;
@@ -69,10 +72,14 @@ void main() {
     viewVec = normalize(viewSpacePosition);
 
     // output clip-space position...
-    gl_Position = mvpMat * positionHomogenous;
+    gl_Position = projection * modelViewMat * positionHomogenous;
 
     // apply manual clip plane...
-    gl_ClipDistance[0] = dot(modelMat * positionHomogenous, clipPlane0);
+    //NOTE: the clip plane is the pass's clipPlane0, a symbolic singularity <0, 0, 0, 1> causes this manual clipping test to always succeed for all vertices
+    //NOTE: if you ever output a clip distance that isn't enabled, the clipping stage will just ignore the manual test
+    // reference: https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/gl_ClipDistance.xhtml
+    // reference: https://prideout.net/clip-planes
+    gl_ClipDistance[0] = dot(worldMat * positionHomogenous, clipPlane0);
 
     // output normal vector
     normalVec = normalize((modelViewMat * normalHomogenous).xyz);
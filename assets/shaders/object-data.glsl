@@ -0,0 +1,50 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//NOTE: this file is #included by vertex shaders (see ShaderTools::loadShaderSource) and must NOT have a #version line
+//NOTE: the per-object constants live in a texture buffer (5 RGBA32F texels per object, see ObjectData in scene-blocks.h), indexed by the object's index in the render list
+//NOTE: the index is a per-vertex attribute of the batched scene geometry (see SceneBatch), and a constant attribute value (glVertexAttribI1ui) for an object drawn from its own VAO
+//      this stands in for gl_DrawID, which needs GL 4.6 (or ARB_shader_draw_parameters)
+// reference: https://www.khronos.org/opengl/wiki/Buffer_Texture
+
+layout (location = 4) in uint objectIndex;
+
+uniform samplerBuffer objectData;
+
+mat4 fetchModelMat() {
+    int firstTexel = int(objectIndex) * 5;
+    return mat4(texelFetch(objectData, firstTexel), texelFetch(objectData, firstTexel + 1), texelFetch(objectData, firstTexel + 2), texelFetch(objectData, firstTexel + 3));
+}
+
+// <hasNormals, isTextured, 0, 0> as 0.0 or 1.0
+vec4 fetchObjectFlags() {
+    return texelFetch(objectData, int(objectIndex) * 5 + 4);
+}
@@ -0,0 +1,71 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//NOTE: this file is #included by shaders (see ShaderTools::loadShaderSource) and must NOT have a #version line
+//NOTE: this is the single GLSL definition of the shared scene blocks, their C++ mirrors are FrameBlockStd140 / PassBlockStd140 in scene-blocks.h
+//NOTE: both blocks live in 1 uniform buffer per frame, written once and then bound by offset (see RenderEngine::updateSceneBlocks)
+//NOTE: the per-object constants are fetched by object index instead (see object-data.glsl)
+// reference: https://www.khronos.org/opengl/wiki/Interface_Block_(GLSL)#Memory_layout
+
+// constants shared by every pass of a frame (bound once per frame)
+//NOTE: each vec3 is followed by a float, which std140 packs into the same 16 bytes
+layout(std140) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    mat4 viewMatOnlyYaw;
+    vec4 fogColourFarAtCurrentTime;
+    vec3 cameraPosition; // world-space
+    float fogDepthRadiusFar;
+    vec3 lightVec; // view-space
+    float fogDepthRadiusNear;
+    vec3 sunPosition; // world-space, the inverse light direction
+    float sunShininess; // higher shininess means smaller specular highlight (sun)
+    vec2 viewportWidthHeight;
+    float sunStrength; // this scalar affects how much of the sun light is added on top of the diffuse sky colour
+    float waveAnimationTimeInSeconds; // in range [0.0, inf)
+    float verticalBounceWaveDisplacement;
+    float zNear;
+    float zFar;
+    float frameBlockPadding;
+};
+
+// constants of 1 pass (a cubemap face, the local reflections/refractions, the depth texture or the main framebuffer)
+layout(std140) uniform PassBlock {
+    mat4 passModelMat; // applied on top of every object's model matrix (e.g. the mirror about the XZ-plane of the local reflections)
+    mat4 VPNoTranslation; // for the skyboxes
+    // <A, B, C, D> where Ax + By + Cz = D
+    //NOTE: a pass without a clip plane gets the symbolic singularity <0, 0, 0, 1>, which always succeeds (some drivers might ignore glEnable/glDisable of GL_CLIP_DISTANCEi)
+    vec4 clipPlane0;
+    bool forceFlipNormals;
+    float passBlockPadding0;
+    float passBlockPadding1;
+    float passBlockPadding2;
+};
@@ -31,13 +31,14 @@
 //     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //
 
+// the frame and pass constants shared by all programs (see scene-blocks.glsl)
+#include "scene-blocks.glsl"
+
 // used as a grayscale intensity threshold acting as a way to control the proportion of clouds from the skybox textures get drawn
 uniform float oneMinusCloudProportion;
 // used to scale both "fog/blur" of atmosphere and increase grayness of clouds
 uniform float overcastStrength;
 uniform samplerCube skyboxClouds;
-// the inverse light direction
-uniform vec3 sunPosition;
 
 in vec3 STR;
 
@@ -31,16 +31,13 @@
 //     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //
 
+// the frame and pass constants shared by all programs (see scene-blocks.glsl)
+#include "scene-blocks.glsl"
+
 // this is the sky-gradient texture that will be interpolated based on time of day
 uniform sampler1D skysphere;
 // this scales the sun horizon colour to be darker
 uniform float sunHorizonDarkness;
-// the inverse light direction
-uniform vec3 sunPosition;
-// higher shininess means smaller specular highlight (sun)
-uniform float sunShininess;
-// this scalar affects how much of the sun light is added on top of the diffuse sky colour
-uniform float sunStrength;
 
 in vec3 normalVec;
 
@@ -31,7 +31,8 @@
 //     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //
 
-uniform mat4 VPNoTranslation;
+// the frame and pass constants shared by all programs (see scene-blocks.glsl)
+#include "scene-blocks.glsl"
 
 layout (location = 0) in vec3 vertex;
 
@@ -31,7 +31,10 @@
 //     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //
 
-uniform mat4 mvp;
+// the frame and pass constants shared by all programs (see scene-blocks.glsl)
+#include "scene-blocks.glsl"
+// the per-object constants, fetched by object index (see object-data.glsl)
+#include "object-data.glsl"
 
 layout (location = 0) in vec3 vertex;
 layout (location = 1) in vec3 normal;
@@ -41,6 +44,6 @@ layout (location = 3) in vec3 colour;
 out vec3 COLOUR;
 
 void main(void) {
-    gl_Position = mvp * vec4(vertex, 1.0f);
+    gl_Position = viewProjection * passModelMat * fetchModelMat() * vec4(vertex, 1.0f);
     COLOUR = colour;
 }
@@ -0,0 +1,70 @@
+#version 410 core
+
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+// pass-through twin of water-grid.vert for when the displaced surface was already captured this frame (transform feedback)
+//NOTE: only the camera-dependent outputs are recomputed here, the gerstner + detail stack is never re-evaluated
+//NOTE: the vertices are in gl_VertexID order of water-grid.vert, so the same grid index buffer draws them
+
+// the frame and pass constants shared by all programs (see scene-blocks.glsl)
+#include "scene-blocks.glsl"
+
+layout (location = 0) in vec3 capturedWorldPosition;
+layout (location = 1) in vec3 capturedWorldNormal; // not flipped towards the camera
+layout (location = 2) in vec2 capturedXYPositionNDCSpaceHeight0; // of the camera the capture was made with (i.e. this frame's main camera)
+
+out vec4 heightmap_colour;
+out vec3 normal;
+out vec3 normalVecInViewSpaceOnlyYaw;
+out vec3 viewVecRaw;
+out vec2 xyPositionNDCSpaceHeight0;
+
+void main() {
+    // the heightmap sample isn't captured (it is only a debug colour), so output its zero displacement value
+    heightmap_colour = vec4(0.5f, 0.5f, 0.5f, 1.0f);
+
+    // output final vertex position in clip-space
+    gl_Position = viewProjection * vec4(capturedWorldPosition, 1.0f);
+
+    xyPositionNDCSpaceHeight0 = capturedXYPositionNDCSpaceHeight0;
+
+    // output world-space view vector (non-normalized)
+    //NOTE: defined as pointing away from a surface point towards the camera eye
+    viewVecRaw = cameraPosition - capturedWorldPosition;
+
+    // flip the normal when the camera is underwater (same as water-grid.vert)...
+    normal = capturedWorldNormal;
+    if (dot(normal, normalize(viewVecRaw)) < 0.0f) normal *= -1;
+
+    // output normal vector in view space of the camera with only yaw (thus, camera y-axis == world-space y-axis)
+    normalVecInViewSpaceOnlyYaw = normalize((viewMatOnlyYaw * vec4(normal, 0.0f)).xyz);
+}
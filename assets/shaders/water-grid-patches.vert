@@ -0,0 +1,56 @@
+#version 410 core
+
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+// the control points of the tessellated water variant, a coarse gridLength x gridLength grid of base-plane positions (the displacement is done per generated vertex in water-grid.tese)
+//NOTE: same gl_VertexID layout and corner interpolation as water-grid.vert (the grid is laid into quad patches by WaterGrid::generatePatchIndices())
+
+uniform vec4 bottomLeftGridPointInWorld;
+uniform vec4 bottomRightGridPointInWorld;
+// assuming a square grid, we get gridLength = sqrt(gridResolution) - e.g. 4x4 grid means resolution of 16 and length of 4
+//NOTE: we are assuming that gridLength >= 2
+uniform uint gridLength;
+uniform vec4 topLeftGridPointInWorld;
+uniform vec4 topRightGridPointInWorld;
+
+out vec3 patchCornerPosition; // world-space, on the base plane
+
+void main() {
+    //NOTE: using integer division here to our advantage
+    float du = 1.0f / (gridLength - 1);
+    float dv = 1.0f / (gridLength - 1);
+    vec2 uv = vec2(mod(gl_VertexID, gridLength) * du, (gl_VertexID / gridLength) * dv);
+
+    vec4 mix_u_1 = mix(bottomLeftGridPointInWorld, bottomRightGridPointInWorld, uv.s);
+    vec4 mix_u_2 = mix(topLeftGridPointInWorld, topRightGridPointInWorld, uv.s);
+    patchCornerPosition = mix(mix_u_1, mix_u_2, uv.t).xyz;
+}
@@ -31,28 +31,26 @@
 //     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //
 
+// the frame and pass constants shared by all programs (see scene-blocks.glsl)
+#include "scene-blocks.glsl"
+
 uniform sampler2D depthTexture2D;
-uniform vec4 fogColourFarAtCurrentTime;
-uniform float fogDepthRadiusFar;
-uniform float fogDepthRadiusNear;
+uniform sampler2D localReflectionsDepthTexture2D;
 uniform sampler2D localReflectionsTexture2D;
+uniform sampler2D localRefractionsDepthTexture2D;
 uniform sampler2D localRefractionsTexture2D;
+// true while the local reflections/refractions are rendered at a reduced size (see RenderEngine::localReflectionsDownscale)
+uniform bool isUpsamplingLocalReflections;
+uniform bool isUpsamplingLocalRefractions;
 uniform samplerCube skybox;
+// in range [0.0, inf), the mip level the sky reflections are blurred to (at least) at zFar
+uniform float skyboxReflectionDistanceLOD;
 // in range [0.0, 1.0]
 uniform float softEdgesDeltaDepthThreshold;
-// the inverse light direction
-uniform vec3 sunPosition;
-// higher shininess means smaller specular highlight (sun)
-uniform float sunShininess;
-// this scalar affects how much of the sun light is added on top of the diffuse sky colour
-uniform float sunStrength;
 // in range [0.0, 1.0]
 uniform float tintDeltaDepthThreshold;
-uniform vec2 viewportWidthHeight;
 // in range [0.0, 1.0]
 uniform float waterClarity;
-uniform float zFar;
-uniform float zNear;
 
 in vec4 heightmap_colour;
 in vec3 normal;
@@ -67,6 +65,40 @@ float linearizeDepth(in float depth) {
     return (zNear * depth) / (zFar - depth * (zFar - zNear));
 }
 
+// depth-aware upsample of a reduced size local reflections/refractions texture
+// the 2x2 bilinear footprint is re-weighted by how close each texel's (linear) depth is to the reference depth, so colours don't bleed across silhouettes (or into the alpha of 0.0 sky texels)
+//NOTE: a negative referenceDepth uses the nearest of the 4 texels instead (for when there is no full-size depth to guide it)
+vec4 upsampleDepthAware(in sampler2D colourTexture, in sampler2D depthTexture, in vec2 uv, in float referenceDepth) {
+    // relative to the linear depth range [0.0, 1.0], small enough that a step between 2 surfaces dominates the bilinear weights
+    const float DEPTH_EPSILON = 0.001f;
+
+    ivec2 textureLength = textureSize(colourTexture, 0);
+    vec2 texelPosition = uv * vec2(textureLength) - 0.5f;
+    ivec2 baseTexel = ivec2(floor(texelPosition));
+    vec2 bilinearFraction = texelPosition - vec2(baseTexel);
+
+    ivec2 texels[4];
+    float depths[4];
+    float nearestDepth = 1.0f;
+    for (int i = 0; i < 4; ++i) {
+        texels[i] = clamp(baseTexel + ivec2(i % 2, i / 2), ivec2(0, 0), textureLength - 1);
+        depths[i] = linearizeDepth(texelFetch(depthTexture, texels[i], 0).x);
+        nearestDepth = min(nearestDepth, depths[i]);
+    }
+    float guideDepth = referenceDepth < 0.0f ? nearestDepth : referenceDepth;
+
+    vec4 colourSum = vec4(0.0f, 0.0f, 0.0f, 0.0f);
+    float weightSum = 0.0f;
+    for (int i = 0; i < 4; ++i) {
+        vec2 bilinearWeights = mix(vec2(1.0f, 1.0f) - bilinearFraction, bilinearFraction, vec2(i % 2, i / 2));
+        float weight = bilinearWeights.x * bilinearWeights.y / (DEPTH_EPSILON + abs(depths[i] - guideDepth));
+        colourSum += weight * texelFetch(colourTexture, texels[i], 0);
+        weightSum += weight;
+    }
+    // every texel is weighted above 0.0 unless its bilinear weight is, and those can't all be at once
+    return colourSum / weightSum;
+}
+
 void main() {
     float viewVecLength = length(viewVecRaw);
     float viewVecDepthClamped = clamp(viewVecLength / zFar, 0.0f, 1.0f);
@@ -93,7 +125,10 @@ void main() {
     // both input vectors should be normalized to ensure output vector is normalized
     //NOTE: the incident vector must point towards the surface (thus, we negate the view vector that is defined as pointing away)
     vec3 R = reflect(-viewVec, normal);
-    vec4 skybox_reflection_colour = vec4(texture(skybox, R).rgb, 1.0f);
+    // the screen-space LOD (from how fast R changes between pixels) is raised with distance, where the sub-pixel waves make R noisy (and alias) anyway
+    //NOTE: textureQueryLod().y is the unclamped LOD the hardware would have picked for texture(skybox, R)
+    float skyboxReflectionLOD = max(textureQueryLod(skybox, R).y, viewVecDepthClamped * skyboxReflectionDistanceLOD);
+    vec4 skybox_reflection_colour = vec4(textureLod(skybox, R, skyboxReflectionLOD).rgb, 1.0f);
 
     //NOTE: should be same value as in skysphere shader
     const vec3 SUN_BASE_COLOUR = vec3(1.0f, 1.0f, 1.0f);
@@ -129,8 +164,9 @@ void main() {
     vec2 uvLocalRefractions = clamp(uvLocalRefractionsYDistorted + uvLocalRefractionsXZDistortion, vec2(0.0f, 0.0f), vec2(1.0f, 1.0f));
 
     // finally, we can compute the local reflection and refraction colours (where an alpha of 0.0 symbolically represents no local reflection (or local refraction, respectively) for this fragment)
-    vec4 localReflectionColour = texture(localReflectionsTexture2D, uvLocalReflections);
-    vec4 localRefractionColour = texture(localRefractionsTexture2D, uvLocalRefractions);
+    //NOTE: at a reduced size, the refractions are guided by the full size depth of the (unshallowed) scene, while the reflections (which have no full size counterpart) keep the nearest surface
+    vec4 localReflectionColour = isUpsamplingLocalReflections ? upsampleDepthAware(localReflectionsTexture2D, localReflectionsDepthTexture2D, uvLocalReflections, -1.0f) : texture(localReflectionsTexture2D, uvLocalReflections);
+    vec4 localRefractionColour = isUpsamplingLocalRefractions ? upsampleDepthAware(localRefractionsTexture2D, localRefractionsDepthTexture2D, uvLocalRefractions, linearizeDepth(texture(depthTexture2D, uvLocalRefractions).x)) : texture(localRefractionsTexture2D, uvLocalRefractions);
 
     //TODO: figure out a more realistic way in determining the tint colour (e.g. factor in the sky colour?), or have them in UI?
     const vec3 DEEP_TINT_COLOUR_AT_NOON = vec3(0.0f, 0.341f, 0.482f);
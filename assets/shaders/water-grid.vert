@@ -31,86 +31,95 @@
 //     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //
 
-//NOTE: this must match the value in the C++ program
-const uint MAX_COUNT_OF_GERSTNER_WAVES = 4;
+// the displacement/normal stack lives in water-surface.glsl (shared with the tessellated variant, see water-grid.tese)
+#include "water-surface.glsl"
+// the frame and pass constants shared by all programs (see scene-blocks.glsl)
+#include "scene-blocks.glsl"
 
 uniform vec4 bottomLeftGridPointInWorld;
 uniform vec4 bottomRightGridPointInWorld;
-uniform vec3 cameraPosition;
-
-// reference: https://developer.nvidia.com/gpugems/gpugems/part-i-natural-effects/chapter-1-effective-water-simulation-physical-models
-// reference: https://github.com/CaffeineViking/osgw/blob/master/share/shaders/gerstner.glsl
-// caller must pass in the number of initialized waves
-uniform uint gerstnerWaveCount = 0;
-uniform struct GerstnerWave {
-    float amplitude_A;
-    float frequency_w;
-    float phaseConstant_phi;
-    float steepness_Q_i;
-    vec2 xzDirection_D;
-} gerstnerWaves[MAX_COUNT_OF_GERSTNER_WAVES];
+
+// the geometry-clipmap mode replaces the projected grid corners with one clipmap level per draw (see WaterClipmap)
+uniform bool isUsingClipmap = false;
+uniform vec2 clipmapOrigin; // world-space (x, z) of vertex 0
+uniform float clipmapCellSize; // in range (0.0, inf)
+// the (x, z) chessboard distances from the camera between which the vertices morph into the parent level's grid (start == end for no morph)
+uniform float clipmapMorphStartDistance;
+uniform float clipmapMorphEndDistance;
 
 // assuming a square grid, we get gridLength = sqrt(gridResolution) - e.g. 4x4 grid means resolution of 16 and length of 4
 //NOTE: we are assuming that gridLength >= 2
 uniform uint gridLength;
-uniform sampler2D heightmap;
-uniform float heightmapDisplacementScale; // in range [0.0, inf)
-uniform float heightmapSampleScale; // in range [0.0, inf)
+// the analytic normals are the default, but the old finite-difference normals are kept around to compare against (both visually and in frametime)
+uniform bool isUsingFiniteDifferenceNormals = false;
 uniform vec4 topLeftGridPointInWorld;
 uniform vec4 topRightGridPointInWorld;
-uniform float verticalBounceWaveDisplacement;
-uniform mat4 viewMatOnlyYaw;
-uniform mat4 viewProjection;
-uniform float waveAnimationTimeInSeconds; // in range [0.0, inf)
 
 out vec4 heightmap_colour;
 out vec3 normal;
 out vec3 normalVecInViewSpaceOnlyYaw;
 out vec3 viewVecRaw;
 out vec2 xyPositionNDCSpaceHeight0;
+// only read back by the transform feedback capture (see water-grid-captured.vert), the fragment stage ignores them
+out vec3 worldPosition;
+out vec3 worldNormal; // not flipped towards the camera
+
+// returns how far the clipmap vertex at this uv is morphed into the parent level's grid, in range [0.0, 1.0]
+//NOTE: based on the distance to the camera (rather than to the level's edge), so it doesn't jump when the level is re-snapped
+float computeClipmapMorphFactor(in vec2 uv) {
+    if (clipmapMorphEndDistance <= clipmapMorphStartDistance) return 0.0f;
+    vec2 toCamera = abs(clipmapOrigin + round(uv * float(gridLength - 1)) * clipmapCellSize - cameraPosition.xz);
+    return clamp((max(toCamera.x, toCamera.y) - clipmapMorphStartDistance) / (clipmapMorphEndDistance - clipmapMorphStartDistance), 0.0f, 1.0f);
+}
 
-// reference: https://developer.nvidia.com/gpugems/gpugems/part-i-natural-effects/chapter-1-effective-water-simulation-physical-models
-//TODO: it seems like the direction is interpreted backwards?
-vec3 computeGerstnerSurfacePosition(in vec2 xzGridPosition, in float timeInSeconds) {
-    vec3 gerstnerSurfacePosition = vec3(xzGridPosition.x, 0.0f, xzGridPosition.y);
-    for (uint i = 0; i < gerstnerWaveCount; ++i) {
-        // this contribution of this wave...
-        float xyzConstant_1 = gerstnerWaves[i].frequency_w * dot(gerstnerWaves[i].xzDirection_D, xzGridPosition) + gerstnerWaves[i].phaseConstant_phi * timeInSeconds;
-        float xzConstant_1 = gerstnerWaves[i].steepness_Q_i * cos(xyzConstant_1);
-        vec3 gerstnerWavePosition = gerstnerWaves[i].amplitude_A * vec3(gerstnerWaves[i].xzDirection_D.x * xzConstant_1, sin(xyzConstant_1), gerstnerWaves[i].xzDirection_D.y * xzConstant_1);
-        gerstnerSurfacePosition += gerstnerWavePosition;
-    }
+// reference: https://github.com/fstrugar/CDLOD/blob/master/cdlod_paper_latest.pdf
+// the odd rows/columns slide onto their even neighbours, so a fully morphed level has exactly the parent's vertices (and triangles, as the diagonals match)
+vec4 computeClipmapGridPosition(in vec2 uv) {
+    vec2 gridCoordinates = round(uv * float(gridLength - 1));
+    gridCoordinates -= fract(0.5f * gridCoordinates) * 2.0f * computeClipmapMorphFactor(uv);
+    vec2 xz = clipmapOrigin + gridCoordinates * clipmapCellSize;
+    return vec4(xz.x, 0.0f, xz.y, 1.0f);
+}
 
-    return gerstnerSurfacePosition;
+// returns the world-space length of the longer grid cell edge at this uv
+//NOTE: the grid is a bilinear patch between the projected corners, so the partial derivatives are exact
+//NOTE: a clipmap cell widens to the parent's cell size as it morphs
+float computeGridCellFootprint(in vec2 uv) {
+    if (isUsingClipmap) return clipmapCellSize * (1.0f + computeClipmapMorphFactor(uv));
+    vec2 dPosition_du = mix(bottomRightGridPointInWorld - bottomLeftGridPointInWorld, topRightGridPointInWorld - topLeftGridPointInWorld, uv.t).xz;
+    vec2 dPosition_dv = mix(topLeftGridPointInWorld - bottomLeftGridPointInWorld, topRightGridPointInWorld - bottomRightGridPointInWorld, uv.s).xz;
+    return max(length(dPosition_du), length(dPosition_dv)) / float(gridLength - 1);
 }
 
 vec4 computeInterpolatedGridPosition(in vec2 uv) {
+    if (isUsingClipmap) return computeClipmapGridPosition(uv);
     vec4 mix_u_1 = mix(bottomLeftGridPointInWorld, bottomRightGridPointInWorld, uv.s);
     vec4 mix_u_2 = mix(topLeftGridPointInWorld, topRightGridPointInWorld, uv.s);
     return mix(mix_u_1, mix_u_2, uv.t);
 }
 
-vec4 sampleHeightmap(in vec4 position) {
-    //TODO: do we have to handle overflow? (either here or in C++ program)?
-    //TODO: I think it would be best to actually use the texture as 8-bit since that is what the image is. Right now all textures are used as RGBA.
-    // reference: https://open.gl/textures
-    //NOTE: the heightmap is assumed to be either setup with wrapping as GL_REPEAT or GL_MIRRORED_REPEAT
-    //NOTE: increase the scale for "rougher water"
-    //NOTE: the scale =:= proportion of texel row/column that fits in 1 unit along the respective axis
-    // e.g. a scale of 1.0 means the 2D texture is entirely fit inside a 1 unit x 1 unit cell of world space
-    // e.g. a scale of 0.1 means the 2D texture is entirely fit inside a 10 unit x 10 unit cell of world space
-    //NOTE: for an intuitive mapping-orientation of the texture, we flip the position.z, since our RH-coordinate system has +x (right) and +z (down) when staring down at XZ-plane from +y side.
-    return texture(heightmap, heightmapSampleScale * vec2(position.x, -position.z));
+// computes the full world-space surface position (gerstner + detail + vertical bounce) for a grid uv
+vec4 computeSurfacePosition(in vec2 uv) {
+    float cellFootprint = computeGridCellFootprint(uv);
+    vec4 position = computeInterpolatedGridPosition(uv);
+    position = vec4(computeWaveSurfacePosition(position.xz, waveAnimationTimeInSeconds, cellFootprint), 1.0f);
+    position.xyz += computeDetailDisplacement(position, cellFootprint);
+    position.y += verticalBounceWaveDisplacement;
+    return position;
 }
 
-float computeHeightmapDisplacement(in vec4 heightmapSample) {
-    float heightmap_intensity_0_to_1 = heightmapSample.r;
-    float heightmap_intensity_neg1_to_1 = 2.0f * (heightmap_intensity_0_to_1 - 0.5f);
-    //NOTE: increase the scale for "steeper water"
-    return heightmapDisplacementScale * heightmap_intensity_neg1_to_1;
+// computes the surface normal by central differences of the four adjacent grid vertices
+//NOTE: this costs four extra full surface evaluations (including heightmap fetches) per vertex, so it is only kept for comparison
+vec3 computeFiniteDifferenceNormal(in vec2 uv, in float du, in float dv) {
+    vec4 pos_minus_du = computeSurfacePosition(uv - vec2(du, 0.0f));
+    vec4 pos_plus_du = computeSurfacePosition(uv + vec2(du, 0.0f));
+    vec4 pos_minus_dv = computeSurfacePosition(uv - vec2(0.0f, dv));
+    vec4 pos_plus_dv = computeSurfacePosition(uv + vec2(0.0f, dv));
+
+    return normalize(cross((pos_plus_du - pos_minus_du).xyz, (pos_plus_dv - pos_minus_dv).xyz));
 }
 
-//TODO: animate the heightmap displacement values over time + increase randomness (reduce tiling visuals)
+//TODO: increase the heightmap randomness (reduce tiling visuals)
 void main() {
     // example of what the expected vertexID layout is (using a length = 4 grid for demonstration)...
     //
@@ -133,15 +142,26 @@ void main() {
 
     // compute the interpolated world-space grid position for this vertexID...
     vec4 position = computeInterpolatedGridPosition(uv);
-
-    // apply gerstner...
-    position = vec4(computeGerstnerSurfacePosition(position.xz, waveAnimationTimeInSeconds), 1.0f);
-
-    // output a debug colour corresponding to the sampled heightmap colour
-    heightmap_colour = sampleHeightmap(position);
-
-    // displacement bumps...
-    position.y += computeHeightmapDisplacement(heightmap_colour);
+    // and how much world-space it covers (for the wave LOD)...
+    float cellFootprint = computeGridCellFootprint(uv);
+
+    // apply gerstner (also computing its derivatives when using the analytic normals)...
+    vec3 gerstnerTangent;
+    vec3 gerstnerBitangent;
+    if (isUsingFiniteDifferenceNormals) position = vec4(computeWaveSurfacePosition(position.xz, waveAnimationTimeInSeconds, cellFootprint), 1.0f);
+    else position = vec4(computeWaveSurfacePositionAndDerivatives(position.xz, waveAnimationTimeInSeconds, cellFootprint, gerstnerTangent, gerstnerBitangent), 1.0f);
+    vec4 gerstnerPosition = position;
+
+    // output a debug colour corresponding to the sampled heightmap colour (or the FFT ocean normal), then apply the displacement bumps...
+    if (isUsingOceanFFT) {
+        heightmap_colour = vec4(0.5f + 0.5f * textureLod(oceanNormalTexture2D, computeOceanUV(position), 0.0f).xyz, 1.0f);
+        position.xyz += computeDetailDisplacement(position, cellFootprint);
+    } else {
+        //NOTE: the fetch is skipped entirely once the heightmap is fully faded out (mid-grey is its zero displacement)
+        float heightmapLODWeight = computeHeightmapLODWeight(cellFootprint);
+        heightmap_colour = (heightmapLODWeight > 0.0f) ? sampleHeightmap(position) : vec4(0.5f, 0.5f, 0.5f, 1.0f);
+        position.y += heightmapLODWeight * computeHeightmapDisplacement(heightmap_colour);
+    }
 
     // vertical bounce...
     position.y += verticalBounceWaveDisplacement;
@@ -157,34 +177,12 @@ void main() {
     //NOTE: defined as pointing away from a surface point towards the camera eye
     viewVecRaw = cameraPosition - position.xyz;
 
-    //TODO: refactor all these position calculations into 1 function
-    //TODO: if possible, it would be nice to get all the vertex positions computed and then pass them off to another shader stage to compute all the normals without redundant calculation, but this works for now
-    //      maybe you could render the positions to a texture and then sample the neighbours, but that is overly complicated and may even be slower
-    // compute four adjacent vertex positions...
-    vec4 pos_minus_du = computeInterpolatedGridPosition(uv - vec2(du, 0.0f));
-    vec4 pos_plus_du = computeInterpolatedGridPosition(uv + vec2(du, 0.0f));
-    vec4 pos_minus_dv = computeInterpolatedGridPosition(uv - vec2(0.0f, dv));
-    vec4 pos_plus_dv = computeInterpolatedGridPosition(uv + vec2(0.0f, dv));
-
-    pos_minus_du = vec4(computeGerstnerSurfacePosition(pos_minus_du.xz, waveAnimationTimeInSeconds), 1.0f);
-    pos_plus_du = vec4(computeGerstnerSurfacePosition(pos_plus_du.xz, waveAnimationTimeInSeconds), 1.0f);
-    pos_minus_dv = vec4(computeGerstnerSurfacePosition(pos_minus_dv.xz, waveAnimationTimeInSeconds), 1.0f);
-    pos_plus_dv = vec4(computeGerstnerSurfacePosition(pos_plus_dv.xz, waveAnimationTimeInSeconds), 1.0f);
-
-    pos_minus_du.y += computeHeightmapDisplacement(sampleHeightmap(pos_minus_du));
-    pos_plus_du.y += computeHeightmapDisplacement(sampleHeightmap(pos_plus_du));
-    pos_minus_dv.y += computeHeightmapDisplacement(sampleHeightmap(pos_minus_dv));
-    pos_plus_dv.y += computeHeightmapDisplacement(sampleHeightmap(pos_plus_dv));
-
-    pos_minus_du.y += verticalBounceWaveDisplacement;
-    pos_plus_du.y += verticalBounceWaveDisplacement;
-    pos_minus_dv.y += verticalBounceWaveDisplacement;
-    pos_plus_dv.y += verticalBounceWaveDisplacement;
-
     //NOTE: since the projector is currently always above the water and our waves have no y-overlaps, this original normal will always be pointing upwards (+y)
     //TODO: probably check this assumption to be safe
-    //TODO: currently some of the normals appear black (0 vector or negative?) when debug rendered as the fragment colour, so fix this bug (could be from flipping or bad math)
-    normal = normalize(cross((pos_plus_du - pos_minus_du).xyz, (pos_plus_dv - pos_minus_dv).xyz));
+    if (isUsingFiniteDifferenceNormals) normal = computeFiniteDifferenceNormal(uv, du, dv);
+    else normal = computeAnalyticNormal(gerstnerPosition, gerstnerTangent, gerstnerBitangent, cellFootprint);
+    worldPosition = position.xyz;
+    worldNormal = normal;
     // flip the normal when the camera is underwater...
     //TODO: I think this is inaccurate when camera is close to water surface, so a fix would be to compute the "water position.y" where the camera is (from camera.xz) and then compare water position.y to cameraPosition.y to decide if flipping is needed
     if (dot(normal, normalize(viewVecRaw)) < 0.0f) normal *= -1;
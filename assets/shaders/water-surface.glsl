@@ -0,0 +1,232 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//NOTE: this file is #included by shaders (see ShaderTools::loadShaderSource) and must NOT have a #version line
+// the water surface displacement (gerstner + detail) and its analytic normal, shared by every stage that displaces the water (see water-grid.vert and water-grid.tese)
+//NOTE: the caller provides the base-plane position and the local grid cell footprint (for the wave LOD), however its grid is laid out
+
+// reference: https://github.com/CaffeineViking/osgw/blob/master/share/shaders/gerstner.glsl
+// the wave set lives in a uniform buffer (caller only needs to re-upload it when a wave changes)
+#include "gerstner-waves.glsl"
+
+// the baked (looping + tiling) gerstner atlas replaces the per-vertex wave sum when enabled (see GerstnerAtlas)
+uniform bool isUsingGerstnerAtlas = false;
+uniform sampler2DArray gerstnerAtlasDisplacementTexture2DArray; // xyz = gerstner displacement
+uniform sampler2DArray gerstnerAtlasNormalTexture2DArray; // xyz = unit normal
+uniform float gerstnerAtlasLayer0; // layer at or before the current time
+uniform float gerstnerAtlasLayer1; // layer after the current time (wraps around to 0)
+uniform float gerstnerAtlasLayerBlend; // in range [0.0, 1.0)
+uniform float gerstnerAtlasTileLength; // in range (0.0, inf)
+
+uniform sampler2D heightmap;
+// the following frame of a streamed heightmap sequence (same size as heightmap), equal to heightmap when there is no sequence
+uniform sampler2D heightmapNext;
+uniform float heightmapFrameBlend; // in range [0.0, 1.0), cross-fade from heightmap to heightmapNext
+uniform float heightmapDisplacementScale; // in range [0.0, inf)
+uniform float heightmapSampleScale; // in range [0.0, inf)
+// distance-based wave LOD: detail whose wavelength spans fewer than waveLODMinSamplesPerWavelength grid cells is faded out (and skipped once fully faded)
+uniform bool isUsingWaveLOD = false;
+uniform float waveLODMinSamplesPerWavelength = 2.0f; // in range (0.0, inf), 2.0 is the nyquist limit
+// the CPU FFT ocean replaces the static heightmap when enabled (see OceanFFT)
+uniform bool isUsingOceanFFT = false;
+uniform sampler2D oceanDisplacementTexture2D; // xyz = (choppy x, height, choppy z)
+uniform sampler2D oceanNormalTexture2D; // xyz = unit normal
+uniform float oceanPatchLength; // in range (0.0, inf), world-space length covered by 1 repeat of the ocean textures
+
+// returns the amplitude weight of a detail band given its angular frequency (2 x pi / wavelength) and the local cell footprint
+// 0.0 at waveLODMinSamplesPerWavelength cells per wavelength (the band would alias), fading up to 1.0 at twice that
+float computeWaveLODWeight(in float angularFrequency, in float cellFootprint) {
+    if (!isUsingWaveLOD) return 1.0f;
+    float TWO_PI = 6.283185307f;
+    float samplesPerWavelength = TWO_PI / max(angularFrequency * cellFootprint, 1e-6f);
+    return clamp(samplesPerWavelength / waveLODMinSamplesPerWavelength - 1.0f, 0.0f, 1.0f);
+}
+
+// reference: https://developer.nvidia.com/gpugems/gpugems/part-i-natural-effects/chapter-1-effective-water-simulation-physical-models
+//TODO: it seems like the direction is interpreted backwards?
+vec3 computeGerstnerSurfacePosition(in vec2 xzGridPosition, in float timeInSeconds, in float cellFootprint) {
+    vec3 gerstnerSurfacePosition = vec3(xzGridPosition.x, 0.0f, xzGridPosition.y);
+    for (uint i = 0; i < gerstnerWaveCount; ++i) {
+        // skip waves that are too short to be resolved by the grid here...
+        float lodWeight = computeWaveLODWeight(gerstnerWaves[i].frequency_w, cellFootprint);
+        if (lodWeight <= 0.0f) continue;
+
+        // this contribution of this wave...
+        float xyzConstant_1 = gerstnerWaves[i].frequency_w * dot(gerstnerWaves[i].xzDirection_D, xzGridPosition) + gerstnerWaves[i].phaseConstant_phi * timeInSeconds;
+        float xzConstant_1 = gerstnerWaves[i].steepness_Q_i * cos(xyzConstant_1);
+        vec3 gerstnerWavePosition = lodWeight * gerstnerWaves[i].amplitude_A * vec3(gerstnerWaves[i].xzDirection_D.x * xzConstant_1, sin(xyzConstant_1), gerstnerWaves[i].xzDirection_D.y * xzConstant_1);
+        gerstnerSurfacePosition += gerstnerWavePosition;
+    }
+
+    return gerstnerSurfacePosition;
+}
+
+// reference: https://developer.nvidia.com/gpugems/gpugems/part-i-natural-effects/chapter-1-effective-water-simulation-physical-models (section 1.2.4 - normals and tangents)
+// same as above, but also outputs the partial derivatives of the surface w.r.t. the undisplaced grid position (reusing the same sin/cos evaluations)
+//NOTE: tangent = dP/dx and bitangent = dP/dz, thus cross(bitangent, tangent) is the upwards facing normal
+vec3 computeGerstnerSurfacePositionAndDerivatives(in vec2 xzGridPosition, in float timeInSeconds, in float cellFootprint, out vec3 tangent, out vec3 bitangent) {
+    vec3 gerstnerSurfacePosition = vec3(xzGridPosition.x, 0.0f, xzGridPosition.y);
+    tangent = vec3(1.0f, 0.0f, 0.0f);
+    bitangent = vec3(0.0f, 0.0f, 1.0f);
+    for (uint i = 0; i < gerstnerWaveCount; ++i) {
+        float lodWeight = computeWaveLODWeight(gerstnerWaves[i].frequency_w, cellFootprint);
+        if (lodWeight <= 0.0f) continue;
+        //NOTE: the weight is constant per vertex, so it just scales the amplitude in the derivatives too
+        float A = lodWeight * gerstnerWaves[i].amplitude_A;
+
+        vec2 D = gerstnerWaves[i].xzDirection_D;
+        float xyzConstant_1 = gerstnerWaves[i].frequency_w * dot(D, xzGridPosition) + gerstnerWaves[i].phaseConstant_phi * timeInSeconds;
+        float sinConstant = sin(xyzConstant_1);
+        float cosConstant = cos(xyzConstant_1);
+        float xzConstant_1 = gerstnerWaves[i].steepness_Q_i * cosConstant;
+        gerstnerSurfacePosition += A * vec3(D.x * xzConstant_1, sinConstant, D.y * xzConstant_1);
+
+        // derivative terms (WA = w * A)...
+        float WA = gerstnerWaves[i].frequency_w * A;
+        float xzDerivativeConstant = gerstnerWaves[i].steepness_Q_i * WA * sinConstant;
+        float yDerivativeConstant = WA * cosConstant;
+        tangent += vec3(-D.x * D.x * xzDerivativeConstant, D.x * yDerivativeConstant, -D.x * D.y * xzDerivativeConstant);
+        bitangent += vec3(-D.x * D.y * xzDerivativeConstant, D.y * yDerivativeConstant, -D.y * D.y * xzDerivativeConstant);
+    }
+
+    return gerstnerSurfacePosition;
+}
+
+// interpolates between the 2 atlas layers bracketing the current time
+//NOTE: texel i was baked at i x tileLength / resolution, so shift by half a texel to hit it exactly
+vec4 sampleGerstnerAtlas(in sampler2DArray atlas, in vec2 xzGridPosition) {
+    vec2 uv = xzGridPosition / gerstnerAtlasTileLength + 0.5f / vec2(textureSize(atlas, 0).xy);
+    return mix(textureLod(atlas, vec3(uv, gerstnerAtlasLayer0), 0.0f), textureLod(atlas, vec3(uv, gerstnerAtlasLayer1), 0.0f), gerstnerAtlasLayerBlend);
+}
+
+// the gerstner-displaced position, either summed live or played back from the atlas
+//NOTE: the atlas is played back as baked (the wave LOD only applies to the live sum)
+vec3 computeWaveSurfacePosition(in vec2 xzGridPosition, in float timeInSeconds, in float cellFootprint) {
+    if (isUsingGerstnerAtlas) return vec3(xzGridPosition.x, 0.0f, xzGridPosition.y) + sampleGerstnerAtlas(gerstnerAtlasDisplacementTexture2DArray, xzGridPosition).xyz;
+    return computeGerstnerSurfacePosition(xzGridPosition, timeInSeconds, cellFootprint);
+}
+
+// same as above, but with the tangent frame
+//NOTE: the atlas only stores the normal, so its tangent frame is the heightfield approximation (cross(bitangent, tangent) still gives back the baked normal)
+vec3 computeWaveSurfacePositionAndDerivatives(in vec2 xzGridPosition, in float timeInSeconds, in float cellFootprint, out vec3 tangent, out vec3 bitangent) {
+    if (isUsingGerstnerAtlas) {
+        vec3 atlasNormal = normalize(sampleGerstnerAtlas(gerstnerAtlasNormalTexture2DArray, xzGridPosition).xyz);
+        tangent = vec3(1.0f, -atlasNormal.x / atlasNormal.y, 0.0f);
+        bitangent = vec3(0.0f, -atlasNormal.z / atlasNormal.y, 1.0f);
+        return computeWaveSurfacePosition(xzGridPosition, timeInSeconds, cellFootprint);
+    }
+    return computeGerstnerSurfacePositionAndDerivatives(xzGridPosition, timeInSeconds, cellFootprint, tangent, bitangent);
+}
+
+vec4 sampleHeightmap(in vec4 position) {
+    //TODO: do we have to handle overflow? (either here or in C++ program)?
+    //NOTE: a streamed sequence is single-channel (R8/R16, swizzled to greyscale), while the static fallback heightmap is still RGBA
+    // reference: https://open.gl/textures
+    //NOTE: the heightmap is assumed to be either setup with wrapping as GL_REPEAT or GL_MIRRORED_REPEAT
+    //NOTE: increase the scale for "rougher water"
+    //NOTE: the scale =:= proportion of texel row/column that fits in 1 unit along the respective axis
+    // e.g. a scale of 1.0 means the 2D texture is entirely fit inside a 1 unit x 1 unit cell of world space
+    // e.g. a scale of 0.1 means the 2D texture is entirely fit inside a 10 unit x 10 unit cell of world space
+    //NOTE: for an intuitive mapping-orientation of the texture, we flip the position.z, since our RH-coordinate system has +x (right) and +z (down) when staring down at XZ-plane from +y side.
+    vec2 uvHeightmap = heightmapSampleScale * vec2(position.x, -position.z);
+    vec4 heightmapSample = texture(heightmap, uvHeightmap);
+    //NOTE: a blend of 0 (static heightmap, or the next frame isn't resident yet) skips the second fetch
+    if (heightmapFrameBlend > 0.0f) heightmapSample = mix(heightmapSample, texture(heightmapNext, uvHeightmap), heightmapFrameBlend);
+    return heightmapSample;
+}
+
+float computeHeightmapDisplacement(in vec4 heightmapSample) {
+    float heightmap_intensity_0_to_1 = heightmapSample.r;
+    float heightmap_intensity_neg1_to_1 = 2.0f * (heightmap_intensity_0_to_1 - 0.5f);
+    //NOTE: increase the scale for "steeper water"
+    return heightmapDisplacementScale * heightmap_intensity_neg1_to_1;
+}
+
+// returns the partial derivatives (d/dx, d/dz) of the heightmap displacement at a world-space position
+// reference: https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/textureGather.xhtml
+//NOTE: a single gather returns the 2x2 texel footprint used by the bilinear filter, so this is the exact slope of the (piecewise bilinear) displacement surface that sampleHeightmap() produces
+vec2 computeHeightmapDisplacementGradient(in vec4 position) {
+    vec2 heightmapSize = vec2(textureSize(heightmap, 0));
+    vec2 uvHeightmap = heightmapSampleScale * vec2(position.x, -position.z);
+    // gather order is (i0, j1), (i1, j1), (i1, j0), (i0, j0)
+    vec4 texels = textureGather(heightmap, uvHeightmap, 0);
+    if (heightmapFrameBlend > 0.0f) texels = mix(texels, textureGather(heightmapNext, uvHeightmap, 0), heightmapFrameBlend);
+    vec2 bilinearWeights = fract(uvHeightmap * heightmapSize - 0.5f);
+    vec2 dIntensity_dTexel = vec2(mix(texels.z - texels.w, texels.y - texels.x, bilinearWeights.y), mix(texels.x - texels.w, texels.y - texels.z, bilinearWeights.x));
+    // chain rule back to world-space (uv = heightmapSampleScale * (x, -z) and displacement = heightmapDisplacementScale * 2 * (intensity - 0.5))...
+    vec2 dIntensity_dUV = dIntensity_dTexel * heightmapSize;
+    return 2.0f * heightmapDisplacementScale * heightmapSampleScale * vec2(dIntensity_dUV.x, -dIntensity_dUV.y);
+}
+
+// the heightmap's shortest wavelength is 2 texels, i.e. 2 / (heightmapSampleScale x size) in world-space, so it is faded out as a single detail band
+float computeHeightmapLODWeight(in float cellFootprint) {
+    float PI = 3.141592654f;
+    vec2 heightmapSize = vec2(textureSize(heightmap, 0));
+    return computeWaveLODWeight(PI * heightmapSampleScale * max(heightmapSize.x, heightmapSize.y), cellFootprint);
+}
+
+// the FFT ocean patch tiles seamlessly (GL_REPEAT) with 1 repeat per oceanPatchLength
+//NOTE: vertex shaders have no implicit derivatives, so sample the base level explicitly
+//NOTE: texel i holds the surface at i x patchLength / resolution, so shift by half a texel to hit it exactly
+vec2 computeOceanUV(in vec4 position) {
+    return position.xz / oceanPatchLength + 0.5f / vec2(textureSize(oceanDisplacementTexture2D, 0));
+}
+
+// returns the detail displacement (FFT ocean or heightmap) to add on top of the gerstner position
+vec3 computeDetailDisplacement(in vec4 position, in float cellFootprint) {
+    if (isUsingOceanFFT) return textureLod(oceanDisplacementTexture2D, computeOceanUV(position), 0.0f).xyz;
+    float heightmapLODWeight = computeHeightmapLODWeight(cellFootprint);
+    if (heightmapLODWeight <= 0.0f) return vec3(0.0f);
+    return vec3(0.0f, heightmapLODWeight * computeHeightmapDisplacement(sampleHeightmap(position)), 0.0f);
+}
+
+// returns the partial derivatives (d/dx, d/dz) of the detail height
+//NOTE: for the FFT ocean this is recovered from its normal (n = normalize(-dh/dx, 1, -dh/dz)), which ignores the slope change caused by the choppy displacement
+vec2 computeDetailDisplacementGradient(in vec4 position, in float cellFootprint) {
+    if (isUsingOceanFFT) {
+        vec3 oceanNormal = textureLod(oceanNormalTexture2D, computeOceanUV(position), 0.0f).xyz;
+        return -oceanNormal.xz / oceanNormal.y;
+    }
+    float heightmapLODWeight = computeHeightmapLODWeight(cellFootprint);
+    if (heightmapLODWeight <= 0.0f) return vec2(0.0f);
+    return heightmapLODWeight * computeHeightmapDisplacementGradient(position);
+}
+
+// computes the surface normal from the analytic gerstner derivatives, plus the detail slope (applied at the gerstner-displaced position, thus the chain rule)
+//NOTE: the vertical bounce is constant over the surface, so it doesn't contribute
+vec3 computeAnalyticNormal(in vec4 gerstnerPosition, in vec3 gerstnerTangent, in vec3 gerstnerBitangent, in float cellFootprint) {
+    vec2 detailGradient = computeDetailDisplacementGradient(gerstnerPosition, cellFootprint);
+    vec3 tangent = gerstnerTangent;
+    vec3 bitangent = gerstnerBitangent;
+    tangent.y += dot(detailGradient, gerstnerTangent.xz);
+    bitangent.y += dot(detailGradient, gerstnerBitangent.xz);
+
+    return normalize(cross(bitangent, tangent));
+}
@@ -31,19 +31,23 @@
 //     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //
 
-uniform mat4 modelViewMat;
-uniform mat4 mvpMat;
+// the frame and pass constants shared by all programs (see scene-blocks.glsl)
+#include "scene-blocks.glsl"
+// the per-object constants, fetched by object index (see object-data.glsl)
+#include "object-data.glsl"
 
 layout (location = 0) in vec3 position;
 
 out vec3 viewSpacePosition;
 
 void main() {
+    mat4 modelViewMat = view * passModelMat * fetchModelMat();
+
     vec4 positionHomogeneous = vec4(position, 1.0f);
 
     // output view-space position...
     viewSpacePosition = (modelViewMat * positionHomogeneous).xyz;
 
     // output clip-space position...
-    gl_Position = mvpMat * positionHomogeneous;
+    gl_Position = projection * modelViewMat * positionHomogeneous;
 }
@@ -0,0 +1,576 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include "benchmarks.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "gerstner-wave.h"
+#include "ocean-fft.h"
+#include "projected-grid.h"
+#include "render-engine.h"
+#include "render-queue.h"
+#include "thread-pool.h"
+#include "water-clipmap.h"
+#include "water-grid.h"
+#include "water-surface.h"
+
+namespace wave_tool {
+    namespace benchmarks {
+        int run(std::string const& name, int argc, char *argv[]) {
+            if ("ocean-fft" == name) return runOceanFFT(argc, argv);
+            if ("water-surface" == name) return runWaterSurface(argc, argv);
+            if ("water-probes" == name) return runWaterProbes(argc, argv);
+            if ("projected-grid" == name) return runProjectedGrid(argc, argv);
+            if ("water-clipmap" == name) return runWaterClipmap(argc, argv);
+            if ("water-grid-indices" == name) return runWaterGridIndices(argc, argv);
+            if ("render-queue" == name) return runRenderQueue(argc, argv);
+            if ("frame-graph" == name) return runFrameGraph(argc, argv);
+
+            std::cout << "ERROR: unknown benchmark: " << name << std::endl;
+            std::cout << "available benchmarks: ocean-fft, water-surface, water-probes, projected-grid, water-clipmap, water-grid-indices, render-queue, frame-graph" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        int runOceanFFT(int argc, char *argv[]) {
+            std::vector<unsigned int> resolutions{128, 256, 512};
+            unsigned int frameCount{100};
+            unsigned int threadCount{0};
+            if (argc > 0) resolutions = {(unsigned int)std::strtoul(argv[0], nullptr, 10)};
+            if (argc > 1) frameCount = (unsigned int)std::strtoul(argv[1], nullptr, 10);
+            if (argc > 2) threadCount = (unsigned int)std::strtoul(argv[2], nullptr, 10);
+
+            for (unsigned int const resolution : resolutions) {
+                if (resolution < 2 || 0 != (resolution & (resolution - 1))) {
+                    std::cout << "ERROR: resolution must be a power of 2 >= 2, got " << resolution << std::endl;
+                    return EXIT_FAILURE;
+                }
+            }
+            if (0 == frameCount) frameCount = 1;
+
+            std::shared_ptr<ThreadPool> const threadPool{std::make_shared<ThreadPool>(threadCount)};
+            std::cout << "ocean-fft benchmark (" << threadPool->getThreadCount() << " threads, " << frameCount << " frames, " << OceanFFT::FFT_COUNT_PER_UPDATE << " 2D FFTs per frame)" << std::endl;
+
+            for (unsigned int const resolution : resolutions) {
+                OceanFFTParameters parameters;
+                parameters.resolution = resolution;
+                OceanFFT oceanFFT{parameters, threadPool};
+
+                // warm-up (first touch of the buffers, spinning up the workers)
+                oceanFFT.update(0.0f);
+
+                std::chrono::steady_clock::time_point const startTime{std::chrono::steady_clock::now()};
+                for (unsigned int frame = 0; frame < frameCount; ++frame) oceanFFT.update(frame / 60.0f);
+                double const totalSeconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count()};
+
+                double const msPerFrame{1000.0 * totalSeconds / frameCount};
+                double const fftsPerSecond{(double)frameCount * OceanFFT::FFT_COUNT_PER_UPDATE / totalSeconds};
+                std::cout << std::fixed << std::setprecision(3)
+                          << "  " << resolution << "x" << resolution
+                          << ": " << msPerFrame << " ms/frame, "
+                          << fftsPerSecond << " FFTs/s (max height " << oceanFFT.getMaxHeight() << ")" << std::endl;
+            }
+
+            return EXIT_SUCCESS;
+        }
+
+        int runWaterSurface(int argc, char *argv[]) {
+            unsigned int gridLength{513};
+            unsigned int frameCount{100};
+            unsigned int threadCount{0};
+            unsigned int waveCount{4};
+            std::string heightmapPath{"../../assets/textures/noise/waves/waves3/00.png"};
+            if (argc > 0) gridLength = (unsigned int)std::strtoul(argv[0], nullptr, 10);
+            if (argc > 1) frameCount = (unsigned int)std::strtoul(argv[1], nullptr, 10);
+            if (argc > 2) threadCount = (unsigned int)std::strtoul(argv[2], nullptr, 10);
+            if (argc > 3) waveCount = (unsigned int)std::strtoul(argv[3], nullptr, 10);
+            if (argc > 4) heightmapPath = argv[4];
+
+            if (gridLength < 2) {
+                std::cout << "ERROR: grid length must be >= 2, got " << gridLength << std::endl;
+                return EXIT_FAILURE;
+            }
+            if (0 == frameCount) frameCount = 1;
+
+            // a fixed sea state, so that runs are comparable
+            geometry::SeaStateParameters seaStateParameters;
+            seaStateParameters.waveCount = std::max(waveCount, 1u);
+            std::vector<geometry::GerstnerWave> gerstnerWaves{geometry::generateSeaState(seaStateParameters)};
+            if (0 == waveCount) gerstnerWaves.clear();
+
+            WaterSurfaceState state;
+            geometry::packGerstnerWavesStd140(gerstnerWaves, state.gerstnerWaves);
+            state.heightmap = Heightmap::loadFromFile(heightmapPath);
+            if (nullptr == state.heightmap) std::cout << "WARNING: running without a heightmap" << std::endl;
+            state.verticalBounceWaveDisplacement = 0.1f;
+
+            // roughly what the projected grid covers from the default camera
+            WaterGridCorners const corners{glm::vec4{-60.0f, 0.0f, 20.0f, 1.0f}, glm::vec4{-400.0f, 0.0f, -500.0f, 1.0f}, glm::vec4{60.0f, 0.0f, 20.0f, 1.0f}, glm::vec4{400.0f, 0.0f, -500.0f, 1.0f}};
+
+            std::shared_ptr<ThreadPool> const threadPool{std::make_shared<ThreadPool>(threadCount)};
+            std::cout << "water-surface benchmark (" << threadPool->getThreadCount() << " threads, " << frameCount << " frames, " << gridLength << "x" << gridLength << " grid, " << gerstnerWaves.size() << " waves" << (nullptr != state.heightmap ? " + heightmap" : "") << ")" << std::endl;
+
+            // time the reference (single-threaded), then the fast path single-threaded and on the pool...
+            //NOTE: the fast path is validated against the reference by the wave-tool-water-surface-tests target
+            WaterGridSoA fastGrid;
+            WaterGridSoA referenceGrid;
+            auto const timeFrames = [&](unsigned int const frames, auto const& evaluate) {
+                std::chrono::steady_clock::time_point const startTime{std::chrono::steady_clock::now()};
+                for (unsigned int frame = 0; frame < frames; ++frame) {
+                    state.timeInSeconds = frame / 60.0f;
+                    evaluate();
+                }
+                return 1000.0 * std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count() / frames;
+            };
+            unsigned int const referenceFrameCount{std::max(frameCount / 10, 1u)};
+            double const referenceMsPerFrame{timeFrames(referenceFrameCount, [&]() { WaterSurface::evaluateGridReference(corners, gridLength, state, referenceGrid); })};
+            double const fastSingleMsPerFrame{timeFrames(frameCount, [&]() { WaterSurface::evaluateGrid(corners, gridLength, state, nullptr, fastGrid); })};
+            double const fastPoolMsPerFrame{timeFrames(frameCount, [&]() { WaterSurface::evaluateGrid(corners, gridLength, state, threadPool.get(), fastGrid); })};
+
+            double const vertexCount{(double)gridLength * gridLength};
+            std::cout << std::fixed << std::setprecision(3)
+                      << "  reference (1 thread): " << referenceMsPerFrame << " ms/frame" << std::endl
+                      << "  soa (1 thread): " << fastSingleMsPerFrame << " ms/frame" << std::endl
+                      << "  soa (" << threadPool->getThreadCount() << " threads): " << fastPoolMsPerFrame << " ms/frame, "
+                      << (vertexCount / (1000.0 * fastPoolMsPerFrame)) << " Mverts/s" << std::endl;
+
+            return EXIT_SUCCESS;
+        }
+
+        int runWaterProbes(int argc, char *argv[]) {
+            std::size_t probeCount{100000};
+            unsigned int frameCount{100};
+            unsigned int threadCount{0};
+            unsigned int iterationCount{3};
+            unsigned int waveCount{4};
+            std::string heightmapPath{"../../assets/textures/noise/waves/waves3/00.png"};
+            if (argc > 0) probeCount = (std::size_t)std::strtoull(argv[0], nullptr, 10);
+            if (argc > 1) frameCount = (unsigned int)std::strtoul(argv[1], nullptr, 10);
+            if (argc > 2) threadCount = (unsigned int)std::strtoul(argv[2], nullptr, 10);
+            if (argc > 3) iterationCount = (unsigned int)std::strtoul(argv[3], nullptr, 10);
+            if (argc > 4) waveCount = (unsigned int)std::strtoul(argv[4], nullptr, 10);
+            if (argc > 5) heightmapPath = argv[5];
+
+            if (0 == probeCount) probeCount = 1;
+            if (0 == frameCount) frameCount = 1;
+
+            geometry::SeaStateParameters seaStateParameters;
+            seaStateParameters.waveCount = std::max(waveCount, 1u);
+            std::vector<geometry::GerstnerWave> gerstnerWaves{geometry::generateSeaState(seaStateParameters)};
+            if (0 == waveCount) gerstnerWaves.clear();
+
+            WaterSurfaceState state;
+            geometry::packGerstnerWavesStd140(gerstnerWaves, state.gerstnerWaves);
+            state.heightmap = Heightmap::loadFromFile(heightmapPath);
+            if (nullptr == state.heightmap) std::cout << "WARNING: running without a heightmap" << std::endl;
+            state.timeInSeconds = 12.345f;
+
+            WaterProbeBatch batch;
+            batch.resize(probeCount);
+            std::mt19937 generator{0};
+            std::uniform_real_distribution<float> positionDistribution{-200.0f, 200.0f};
+            for (std::size_t i = 0; i < probeCount; ++i) {
+                batch.probeX.at(i) = positionDistribution(generator);
+                batch.probeZ.at(i) = positionDistribution(generator);
+            }
+
+            std::shared_ptr<ThreadPool> const threadPool{std::make_shared<ThreadPool>(threadCount)};
+            std::cout << "water-probes benchmark (" << threadPool->getThreadCount() << " threads, " << frameCount << " frames, " << probeCount << " probes, " << iterationCount << " iterations, " << gerstnerWaves.size() << " waves" << (nullptr != state.heightmap ? " + heightmap" : "") << ")" << std::endl;
+
+            // 1. validate against the scalar query (same iteration count), and against a fully converged one...
+            //NOTE: as with the grid, a probe that lands on the other side of a heightmap texel edge gets a different normal, so only the mismatch fraction is checked
+            unsigned int const CONVERGED_ITERATION_COUNT{iterationCount + 8};
+            float const HEIGHT_TOLERANCE{1.0e-3f * (1.0f + geometry::computeTotalAmplitude(gerstnerWaves) + 2.0f * state.heightmapDisplacementScale)};
+            float const NORMAL_TOLERANCE{1.0e-3f};
+            float const MAX_MISMATCHED_NORMAL_FRACTION{0.01f};
+            WaterSurface::queryProbes(state, iterationCount, threadPool.get(), batch);
+            float maxHeightError{0.0f};
+            float maxVelocityError{0.0f};
+            float maxConvergenceError{0.0f};
+            std::size_t mismatchedNormalCount{0};
+            for (std::size_t i = 0; i < probeCount; ++i) {
+                glm::vec2 const probe{batch.probeX[i], batch.probeZ[i]};
+                glm::vec3 normal;
+                glm::vec3 velocity;
+                float const height{WaterSurface::queryProbeReference(probe, state, iterationCount, &normal, &velocity)};
+                maxHeightError = std::max(maxHeightError, std::abs(batch.height[i] - height));
+                maxVelocityError = std::max({maxVelocityError, std::abs(batch.velocityX[i] - velocity.x), std::abs(batch.velocityY[i] - velocity.y), std::abs(batch.velocityZ[i] - velocity.z)});
+                float const normalError{std::max({std::abs(batch.normalX[i] - normal.x), std::abs(batch.normalY[i] - normal.y), std::abs(batch.normalZ[i] - normal.z)})};
+                if (normalError > NORMAL_TOLERANCE) ++mismatchedNormalCount;
+                maxConvergenceError = std::max(maxConvergenceError, std::abs(batch.height[i] - WaterSurface::queryProbeReference(probe, state, CONVERGED_ITERATION_COUNT)));
+            }
+            float const mismatchedNormalFraction{(float)mismatchedNormalCount / probeCount};
+            bool const isValid{maxHeightError <= HEIGHT_TOLERANCE && maxVelocityError <= HEIGHT_TOLERANCE && mismatchedNormalFraction <= MAX_MISMATCHED_NORMAL_FRACTION};
+            std::cout << std::scientific << std::setprecision(3)
+                      << "  validation: max height error " << maxHeightError << ", max velocity error " << maxVelocityError << " (tolerance " << HEIGHT_TOLERANCE << ")"
+                      << ", normals off by > " << NORMAL_TOLERANCE << ": " << mismatchedNormalFraction << " (tolerance " << MAX_MISMATCHED_NORMAL_FRACTION << ")"
+                      << " -> " << (isValid ? "OK" : "FAILED") << std::endl
+                      << "  convergence: max height change vs " << CONVERGED_ITERATION_COUNT << " iterations " << maxConvergenceError << std::endl;
+
+            // 2. time the batched query, single-threaded and on the pool...
+            auto const timeFrames = [&](ThreadPool *pool) {
+                std::chrono::steady_clock::time_point const startTime{std::chrono::steady_clock::now()};
+                for (unsigned int frame = 0; frame < frameCount; ++frame) {
+                    state.timeInSeconds = frame / 60.0f;
+                    WaterSurface::queryProbes(state, iterationCount, pool, batch);
+                }
+                return 1000.0 * std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count() / frameCount;
+            };
+            double const singleMsPerFrame{timeFrames(nullptr)};
+            double const poolMsPerFrame{timeFrames(threadPool.get())};
+            std::cout << std::fixed << std::setprecision(3)
+                      << "  1 thread: " << singleMsPerFrame << " ms/frame" << std::endl
+                      << "  " << threadPool->getThreadCount() << " threads: " << poolMsPerFrame << " ms/frame, "
+                      << (probeCount / (1000.0 * poolMsPerFrame)) << " Mprobes/s" << std::endl;
+
+            return isValid ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+
+        int runProjectedGrid(int argc, char *argv[]) {
+            unsigned int updateCount{1000000};
+            float displaceableAmplitude{2.0f};
+            if (argc > 0) updateCount = (unsigned int)std::strtoul(argv[0], nullptr, 10);
+            if (argc > 1) displaceableAmplitude = std::strtof(argv[1], nullptr);
+            if (0 == updateCount) updateCount = 1;
+
+            // the same lens as the application's camera
+            float const FOV{72.0f};
+            float const ASPECT{16.0f / 9.0f};
+            float const Z_NEAR{0.1f};
+            float const Z_FAR{100.0f};
+
+            std::cout << "projected-grid benchmark (" << updateCount << " updates, displaceable amplitude " << displaceableAmplitude << ")" << std::endl;
+
+            //NOTE: the edge case/coverage validation lives in the wave-tool-projected-grid-tests target (tests/projected-grid-tests.cpp)
+            // 1. over a sweep of camera heights/orientations, compare how many of the grid's vertices each fit puts on-screen...
+            unsigned int const SWEEP_COUNT{2000};
+            unsigned int const GRID_LENGTH{WaterGrid::getGridLength(0)};
+            std::array<glm::vec3, 3> const SWEEP_POSITIONS{glm::vec3{0.0f, 1.0f + displaceableAmplitude, 0.0f}, glm::vec3{0.0f, 4.0f, 70.0f}, glm::vec3{0.0f, 30.0f, 0.0f}};
+            for (bool const isUsingHullFit : {false, true}) {
+                ProjectedGrid projectedGrid;
+                projectedGrid.isUsingHullFit = isUsingHullFit;
+                unsigned long long visibleVertexCount{0};
+                unsigned int visibleCount{0};
+                for (unsigned int sweep = 0; sweep < SWEEP_COUNT; ++sweep) {
+                    Camera camera{FOV, ASPECT, Z_NEAR, Z_FAR, SWEEP_POSITIONS[sweep % SWEEP_POSITIONS.size()]};
+                    camera.setRotation(sweep * 0.37f, -89.0f + 178.0f * ((sweep * 7919u) % 1000u) / 1000.0f);
+                    if (!projectedGrid.update(camera, displaceableAmplitude)) continue;
+                    ++visibleCount;
+                    visibleVertexCount += ProjectedGrid::countVisibleGridVertices(projectedGrid.getCornerPoints(), camera.getProjectionMat() * camera.getViewMat(), GRID_LENGTH);
+                }
+                std::cout << std::fixed << std::setprecision(1)
+                          << "  " << (isUsingHullFit ? "hull quad" : "bounds") << ": " << (100.0 * visibleVertexCount / ((double)glm::max(visibleCount, 1u) * GRID_LENGTH * GRID_LENGTH)) << "% of a " << GRID_LENGTH << " x " << GRID_LENGTH
+                          << " grid on-screen (avg. over " << visibleCount << " views)" << std::endl;
+            }
+
+            // 2. time the update over a sweep of camera orientations (so that every path through the projector setup is hit)...
+            for (bool const isUsingHullFit : {false, true}) {
+                Camera camera{FOV, ASPECT, Z_NEAR, Z_FAR, glm::vec3{0.0f, 4.0f, 70.0f}};
+                ProjectedGrid projectedGrid;
+                projectedGrid.isUsingHullFit = isUsingHullFit;
+                unsigned int visibleCount{0};
+                std::chrono::steady_clock::time_point const startTime{std::chrono::steady_clock::now()};
+                for (unsigned int update = 0; update < updateCount; ++update) {
+                    camera.setRotation(update * 0.37f, -89.0f + 178.0f * ((update * 7919u) % 1000u) / 1000.0f);
+                    if (projectedGrid.update(camera, displaceableAmplitude)) ++visibleCount;
+                }
+                double const totalSeconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count()};
+                std::cout << std::fixed << std::setprecision(3)
+                          << "  " << (isUsingHullFit ? "hull quad" : "bounds") << ": " << (1.0e9 * totalSeconds / updateCount) << " ns/update (" << visibleCount << " of " << updateCount << " visible)" << std::endl;
+            }
+
+            return EXIT_SUCCESS;
+        }
+
+        int runWaterClipmap(int argc, char *argv[]) {
+            unsigned int updateCount{100000};
+            float displaceableAmplitude{2.0f};
+            float baseCellSize{0.05f};
+            if (argc > 0) updateCount = (unsigned int)std::strtoul(argv[0], nullptr, 10);
+            if (argc > 1) displaceableAmplitude = std::strtof(argv[1], nullptr);
+            if (argc > 2) baseCellSize = std::strtof(argv[2], nullptr);
+            if (0 == updateCount) updateCount = 1;
+            if (baseCellSize <= 0.0f) {
+                std::cout << "ERROR: base cell size must be > 0.0, got " << baseCellSize << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            // the same lens as the application's camera
+            float const FOV{72.0f};
+            float const ASPECT{16.0f / 9.0f};
+            float const Z_NEAR{0.1f};
+            float const Z_FAR{100.0f};
+
+            std::cout << "water-clipmap benchmark (" << updateCount << " updates, displaceable amplitude " << displaceableAmplitude << ", base cell size " << baseCellSize << ")" << std::endl;
+
+            // time the update over a sweep of camera orientations (and positions, so that every ring variant is hit), alongside what it submits...
+            WaterClipmap waterClipmap;
+            Camera camera{FOV, ASPECT, Z_NEAR, Z_FAR, glm::vec3{0.0f, 4.0f, 70.0f}};
+            unsigned int visibleCount{0};
+            double vertexCountSum{0.0};
+            double triangleCountSum{0.0};
+            std::chrono::steady_clock::time_point const startTime{std::chrono::steady_clock::now()};
+            for (unsigned int update = 0; update < updateCount; ++update) {
+                camera.translate(glm::vec3{0.013f, 0.0f, -0.007f});
+                camera.setRotation(update * 0.37f, -89.0f + 178.0f * ((update * 7919u) % 1000u) / 1000.0f);
+                if (waterClipmap.update(camera.getPosition(), camera.getProjectionMat() * camera.getViewMat(), displaceableAmplitude, baseCellSize, Z_FAR)) ++visibleCount;
+                vertexCountSum += waterClipmap.getVertexCount();
+                triangleCountSum += waterClipmap.getTriangleCount();
+            }
+            double const totalSeconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count()};
+            std::cout << std::fixed << std::setprecision(3)
+                      << "  " << (1.0e9 * totalSeconds / updateCount) << " ns/update (" << visibleCount << " of " << updateCount << " visible)" << std::endl
+                      << std::setprecision(0)
+                      << "  avg. submitted: " << (vertexCountSum / updateCount) << " vertices, " << (triangleCountSum / updateCount) << " triangles" << std::endl;
+            // the projected grid always submits its whole grid
+            for (unsigned int level = 0; level < WaterGrid::getLevelCount(); ++level) {
+                std::cout << "  vs. projected grid " << WaterGrid::getGridLength(level) << " x " << WaterGrid::getGridLength(level) << ": "
+                          << WaterGrid::getGridLength(level) * WaterGrid::getGridLength(level) << " vertices, " << WaterGrid::getTriangleCount(level) << " triangles" << std::endl;
+            }
+
+            return EXIT_SUCCESS;
+        }
+
+        int runWaterGridIndices(int argc, char *argv[]) {
+            std::vector<unsigned int> cacheSizes{16, 32};
+            if (argc > 0 && 0 != std::strtoul(argv[0], nullptr, 10)) cacheSizes = {(unsigned int)std::strtoul(argv[0], nullptr, 10)};
+
+            std::cout << "water-grid-indices benchmark (strip width " << WaterGrid::CACHE_STRIP_CELL_COUNT << " cells)" << std::endl;
+
+            std::vector<GLuint> indices;
+            for (unsigned int level = 0; level < WaterGrid::getLevelCount(); ++level) {
+                GLuint const gridLength{WaterGrid::getGridLength(level)};
+                std::cout << "  " << gridLength << " x " << gridLength << " (" << WaterGrid::getTriangleCount(level) << " triangles):" << std::endl;
+                for (WaterGrid::IndexLayout const indexLayout : {WaterGrid::IndexLayout::ROW_LIST, WaterGrid::IndexLayout::TILED_LIST, WaterGrid::IndexLayout::TILED_STRIP}) {
+                    GLuint const bandCellRowCount{WaterGrid::getBandCellRowCount(level, indexLayout)};
+                    unsigned int const bandCount{WaterGrid::getBandCount(level, indexLayout)};
+
+                    std::chrono::steady_clock::time_point const startTime{std::chrono::steady_clock::now()};
+                    WaterGrid::generateIndices(gridLength, bandCellRowCount, indexLayout, indices);
+                    double const buildMilliseconds{std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count()};
+
+                    char const* layoutName{WaterGrid::IndexLayout::ROW_LIST == indexLayout ? "row list" : (WaterGrid::IndexLayout::TILED_LIST == indexLayout ? "tiled list" : "tiled strip")};
+                    std::cout << std::fixed << std::setprecision(3)
+                              << "    " << layoutName << ": " << bandCount << " x " << indices.size() << (WaterGrid::IndexLayout::ROW_LIST == indexLayout ? " 32-bit" : " 16-bit") << " indices ("
+                              << (indices.size() * WaterGrid::getIndexSizeInBytes(indexLayout)) / 1024.0 << " KiB), built in " << buildMilliseconds << " ms, ACMR";
+                    for (unsigned int const cacheSize : cacheSizes) std::cout << " " << WaterGrid::computeAverageCacheMissRatio(indices, indexLayout, cacheSize) << " (" << cacheSize << ")";
+                    std::cout << std::endl;
+                }
+            }
+            std::cout << std::setprecision(2) << "  all levels (+ clipmap + patches): row list " << WaterGrid::getIndexMemoryInBytes(WaterGrid::IndexLayout::ROW_LIST) / (1024.0 * 1024.0)
+                      << " MiB, tiled list " << WaterGrid::getIndexMemoryInBytes(WaterGrid::IndexLayout::TILED_LIST) / (1024.0 * 1024.0)
+                      << " MiB, tiled strip " << WaterGrid::getIndexMemoryInBytes(WaterGrid::IndexLayout::TILED_STRIP) / (1024.0 * 1024.0) << " MiB" << std::endl;
+
+            return EXIT_SUCCESS;
+        }
+
+        int runRenderQueue(int argc, char *argv[]) {
+            std::vector<unsigned int> objectCounts{1000, 2500, 5000, 10000};
+            unsigned int frameCount{100};
+            if (argc > 0 && 0 != std::strtoul(argv[0], nullptr, 10)) objectCounts = {(unsigned int)std::strtoul(argv[0], nullptr, 10)};
+            if (argc > 1) frameCount = std::max((unsigned int)std::strtoul(argv[1], nullptr, 10), 1u);
+
+            // the stress scene: 2 programs (main + trivial), 16 textures (main only), every object with its own VAO (as assignBuffers() makes them) and 1 of 32 mesh sizes
+            GLuint const MAIN_PROGRAM{1};
+            GLuint const TRIVIAL_PROGRAM{2};
+            unsigned int const TEXTURE_COUNT{16};
+            unsigned int const MESH_COUNT{32};
+            std::cout << "render-queue benchmark (" << frameCount << " frames, 2 programs, " << TEXTURE_COUNT << " textures, " << MESH_COUNT << " meshes, main pass)" << std::endl;
+
+            struct StressObject {
+                DrawState state;
+                GLsizei firstIndex; // into the shared index buffer (in render list order, like SceneBatch packs them)
+                GLsizei indexCount;
+                bool isVisible;
+            };
+
+            std::mt19937 randomEngine{1234};
+            for (unsigned int const objectCount : objectCounts) {
+                std::uniform_real_distribution<float> unitDistribution{0.0f, 1.0f};
+                std::uniform_int_distribution<unsigned int> textureDistribution{1, TEXTURE_COUNT};
+                std::uniform_int_distribution<unsigned int> meshDistribution{0, MESH_COUNT - 1};
+                std::vector<StressObject> objects;
+                std::vector<float> depths;
+                GLsizei indexCount{0};
+                for (unsigned int objectIndex = 0; objectIndex < objectCount; ++objectIndex) {
+                    bool const isMainProgram{unitDistribution(randomEngine) < 0.9f};
+                    float const polygonModeRoll{unitDistribution(randomEngine)};
+                    GLenum const polygonMode{polygonModeRoll < 0.9f ? (GLenum)GL_FILL : (polygonModeRoll < 0.95f ? (GLenum)GL_LINE : (GLenum)GL_POINT)};
+                    GLsizei const meshIndexCount{(GLsizei)(36 * (1 + meshDistribution(randomEngine)))};
+                    objects.push_back(StressObject{DrawState{isMainProgram ? MAIN_PROGRAM : TRIVIAL_PROGRAM, isMainProgram ? textureDistribution(randomEngine) : 0, objectIndex + 1, polygonMode, GL_TRIANGLES},
+                                                   indexCount, meshIndexCount, unitDistribution(randomEngine) < 0.9f});
+                    depths.push_back(1.0f + 999.0f * unitDistribution(randomEngine));
+                    indexCount += meshIndexCount;
+                }
+
+                // the per-frame queue build (+ sort), with the objects' own VAOs (drawn 1 by 1) or the shared one (batched) in their keys, like RenderEngine::buildRenderQueue()
+                GLuint const SHARED_VAO{objectCount + 1};
+                RenderQueue renderQueue;
+                RenderQueue batchedRenderQueue;
+                double buildMilliseconds{0.0};
+                for (RenderQueue *queue : {&renderQueue, &batchedRenderQueue}) {
+                    std::chrono::steady_clock::time_point const startTime{std::chrono::steady_clock::now()};
+                    for (unsigned int frame = 0; frame < frameCount; ++frame) {
+                        queue->clear();
+                        for (unsigned int objectIndex = 0; objectIndex < objectCount; ++objectIndex) {
+                            if (!objects.at(objectIndex).isVisible) continue;
+                            DrawState state{objects.at(objectIndex).state};
+                            if (&batchedRenderQueue == queue) state.vao = SHARED_VAO;
+                            queue->push(objectIndex, state, depths.at(objectIndex));
+                        }
+                        queue->sort();
+                    }
+                    buildMilliseconds = std::max(buildMilliseconds, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count() / frameCount);
+                }
+                std::vector<RenderQueue::Item> const& items{renderQueue.getItems()};
+                std::vector<RenderQueue::Item> const& batchedItems{batchedRenderQueue.getItems()};
+
+                // the state changes (program, texture, VAO, polygon mode) left after filtering the redundant ones (see GLStateCache), for a walk of the objects 1 by 1
+                auto const countStateChanges = [](std::vector<DrawState> const& states) {
+                    unsigned int stateChangeCount{0};
+                    for (std::size_t i = 0; i < states.size(); ++i) {
+                        bool const isFirst{0 == i};
+                        stateChangeCount += (isFirst || states.at(i - 1).program != states.at(i).program) + (isFirst || states.at(i - 1).texture != states.at(i).texture)
+                                          + (isFirst || states.at(i - 1).vao != states.at(i).vao) + (isFirst || states.at(i - 1).polygonMode != states.at(i).polygonMode);
+                    }
+                    return stateChangeCount;
+                };
+                std::vector<DrawState> unsortedStates;
+                for (StressObject const& object : objects) {
+                    if (object.isVisible) unsortedStates.push_back(object.state);
+                }
+                std::vector<DrawState> sortedStates;
+                for (RenderQueue::Item const& item : items) sortedStates.push_back(item.state);
+
+                // batched: 1 multi-draw per run (the VAO is shared), neighbouring meshes in the index buffer merge into 1 range
+                unsigned int runCount{0};
+                unsigned int rangeCount{0};
+                std::vector<DrawState> runStates;
+                for (std::size_t itemIndex = 0; itemIndex < batchedItems.size(); ++itemIndex) {
+                    RenderQueue::Item const& item{batchedItems.at(itemIndex)};
+                    bool const isNewRun{0 == itemIndex || !RenderQueue::isSameRun(batchedItems.at(itemIndex - 1).state, item.state, true)};
+                    if (isNewRun) {
+                        ++runCount;
+                        runStates.push_back(item.state);
+                    }
+                    StressObject const& object{objects.at(item.objectIndex)};
+                    StressObject const* previousObject{0 == itemIndex ? nullptr : &objects.at(batchedItems.at(itemIndex - 1).objectIndex)};
+                    if (isNewRun || previousObject->firstIndex + previousObject->indexCount != object.firstIndex) ++rangeCount;
+                }
+
+                std::cout << std::fixed << std::setprecision(3)
+                          << "  " << objectCount << " objects (" << items.size() << " visible): queue built + sorted in " << buildMilliseconds << " ms/frame (worst of the 2 VAO setups)" << std::endl
+                          << "    render list order: " << unsortedStates.size() << " draws, " << countStateChanges(unsortedStates) << " state changes" << std::endl
+                          << "    sorted, 1 by 1:    " << sortedStates.size() << " draws, " << countStateChanges(sortedStates) << " state changes" << std::endl
+                          << "    sorted, batched:   " << runCount << " multi-draws (" << rangeCount << " ranges), " << countStateChanges(runStates) << " state changes" << std::endl;
+            }
+
+            return EXIT_SUCCESS;
+        }
+
+        int runFrameGraph(int argc, char *argv[]) {
+            int windowWidth{1920};
+            int windowHeight{1080};
+            unsigned int frameCount{10000};
+            bool isDumping{false};
+            if (argc > 0) windowWidth = (int)std::strtol(argv[0], nullptr, 10);
+            if (argc > 1) windowHeight = (int)std::strtol(argv[1], nullptr, 10);
+            if (argc > 2) frameCount = (unsigned int)std::strtoul(argv[2], nullptr, 10);
+            if (argc > 3) isDumping = 0 != std::strtoul(argv[3], nullptr, 10);
+            if (windowWidth < 1 || windowHeight < 1) {
+                std::cout << "ERROR: window size must be at least 1 x 1, got " << windowWidth << " x " << windowHeight << std::endl;
+                return EXIT_FAILURE;
+            }
+            if (0 == frameCount) frameCount = 1;
+
+            struct Scenario {
+                char const* name;
+                unsigned int downscale;
+                bool isWaterInView;
+                RenderMode renderMode;
+            };
+            std::array<Scenario, 7> const scenarios{Scenario{"water in view, 1/2 local passes", 2, true, RenderMode::DEFAULT},
+                                                    Scenario{"water in view, full-size local passes", 1, true, RenderMode::DEFAULT},
+                                                    Scenario{"water in view, 1/4 local passes", 4, true, RenderMode::DEFAULT},
+                                                    Scenario{"water out of view", 2, false, RenderMode::DEFAULT},
+                                                    Scenario{"debug local reflections", 2, false, RenderMode::LOCAL_REFLECTIONS},
+                                                    Scenario{"debug local refractions", 2, false, RenderMode::LOCAL_REFRACTIONS},
+                                                    Scenario{"debug world-space depth", 2, false, RenderMode::WORLD_SPACE_DEPTH}};
+
+            std::cout << "frame-graph benchmark (" << windowWidth << " x " << windowHeight << ", " << frameCount << " builds per configuration)" << std::endl;
+
+            bool isValid{true};
+            FrameGraph frameGraph;
+            for (Scenario const& scenario : scenarios) {
+                FrameGraphInputs const inputs{windowWidth, windowHeight, scenario.downscale, scenario.downscale, scenario.isWaterInView, scenario.renderMode, 0};
+
+                std::chrono::steady_clock::time_point const startTime{std::chrono::steady_clock::now()};
+                for (unsigned int frame = 0; frame < frameCount; ++frame) RenderEngine::buildFrameGraph(frameGraph, inputs);
+                double const microsecondsPerFrame{1000000.0 * std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count() / frameCount};
+                FrameGraphHandles const graph{RenderEngine::buildFrameGraph(frameGraph, inputs)};
+
+                // the culling must reproduce which passes the render loop used to skip by hand
+                bool const isShowingDebugTexture{RenderMode::DEFAULT != scenario.renderMode};
+                std::array<std::pair<FrameGraph::Pass, bool>, 9> const expectedLiveness{std::make_pair(graph.skyPass, true),
+                                                                                       std::make_pair(graph.localReflectionsPass, scenario.isWaterInView || RenderMode::LOCAL_REFLECTIONS == scenario.renderMode),
+                                                                                       std::make_pair(graph.localRefractionsPass, scenario.isWaterInView || RenderMode::LOCAL_REFRACTIONS == scenario.renderMode),
+                                                                                       std::make_pair(graph.worldSpaceDepthPass, RenderMode::WORLD_SPACE_DEPTH == scenario.renderMode),
+                                                                                       std::make_pair(graph.depthPass, scenario.isWaterInView),
+                                                                                       std::make_pair(graph.opaquePass, !isShowingDebugTexture),
+                                                                                       std::make_pair(graph.waterPass, scenario.isWaterInView),
+                                                                                       std::make_pair(graph.debugPass, isShowingDebugTexture),
+                                                                                       std::make_pair(graph.uiPass, true)};
+                bool isScenarioValid{0 == frameGraph.validate()};
+                for (std::pair<FrameGraph::Pass, bool> const& expected : expectedLiveness) isScenarioValid = isScenarioValid && expected.second == frameGraph.isPassLive(expected.first);
+                isValid = isValid && isScenarioValid;
+
+                std::cout << std::fixed << std::setprecision(2)
+                          << "  " << scenario.name << ": " << frameGraph.getLivePassCount() << " / " << frameGraph.getPassCount() << " passes live, "
+                          << frameGraph.getTransientSizeInBytes() / (1024.0 * 1024.0) << " MiB of transients on " << frameGraph.getSlotCount() << " textures (" << frameGraph.getAliasedSizeInBytes() / (1024.0 * 1024.0) << " MiB aliased), "
+                          << microsecondsPerFrame << " us/build -> " << (isScenarioValid ? "OK" : "FAILED") << std::endl;
+                if (isDumping) frameGraph.dump(std::cout);
+            }
+
+            return isValid ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+}
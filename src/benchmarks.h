@@ -0,0 +1,90 @@
+#ifndef WAVE_TOOL_BENCHMARKS_H_
+#define WAVE_TOOL_BENCHMARKS_H_
+
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <string>
+
+namespace wave_tool {
+    // headless throughput benchmarks for the CPU-side modules (no window or GL context needed)
+    //NOTE: run from the cmd-line with: wave-tool --benchmark <name> [args...]
+    namespace benchmarks {
+        // returns EXIT_SUCCESS / EXIT_FAILURE, unknown names print the list of benchmarks
+        int run(std::string const& name, int argc, char *argv[]);
+
+        // times OceanFFT::update() at 128, 256 and 512 (or just the given resolution) and reports ms/frame and FFTs/second
+        //NOTE: the timing covers the whole update (spectrum evolution + 3 FFTs + unpacking), so FFTs/second is a lower bound on the raw transform rate
+        // args: [resolution] [frameCount] [threadCount]
+        int runOceanFFT(int argc, char *argv[]);
+
+        // times WaterSurface::evaluateGrid() (threaded SoA path) against the scalar reference port of water-grid.vert
+        //NOTE: that they agree (within a tolerance) is tested by the wave-tool-water-surface-tests target instead
+        //NOTE: the heightmap is the same one the application loads, if it can't be found the benchmark runs with gerstner waves only
+        // args: [gridLength] [frameCount] [threadCount] [waveCount] [heightmapPath]
+        int runWaterSurface(int argc, char *argv[]);
+
+        // times WaterSurface::queryProbes() for randomly scattered probes, validates it against the scalar reference query and reports how far the inversion is from converged
+        // args: [probeCount] [frameCount] [threadCount] [iterationCount] [waveCount] [heightmapPath]
+        int runWaterProbes(int argc, char *argv[]);
+
+        // compares how many grid vertices the bounds and the hull quad fit land on-screen over a sweep of camera orientations, and times ProjectedGrid::update() for both
+        //NOTE: the edge cases (horizon, underwater, inside the displaceable volume, ...) are tested by the wave-tool-projected-grid-tests target instead
+        // args: [updateCount] [displaceableAmplitude]
+        int runProjectedGrid(int argc, char *argv[]);
+
+        // times WaterClipmap::update() over a sweep of camera positions/orientations and compares what it submits with the projected grid
+        //NOTE: the index layout, level placement (for the same edge cases) and tile culling are tested by the wave-tool-water-clipmap-tests target instead
+        // args: [updateCount] [displaceableAmplitude] [baseCellSize]
+        int runWaterClipmap(int argc, char *argv[]);
+
+        // reports each WaterGrid::IndexLayout's index memory, build time and average cache miss ratio per level
+        //NOTE: that every layout makes exactly the triangles of the original row-by-row list (same winding) is tested by the wave-tool-water-grid-indices-tests target instead
+        // args: [cacheSize] (0 reports a 16 and a 32 entry FIFO cache)
+        int runWaterGridIndices(int argc, char *argv[]);
+
+        // stress scene of randomly generated objects (programs, textures, meshes, polygon modes, depths): times the per-frame RenderQueue build + sort
+        // then compares the draw calls and state changes of the main pass drawn in render list order, sorted 1 by 1, and sorted in batched runs (see SceneBatch)
+        //NOTE: only the CPU side is measured (no GL context), the driver cost is what the draw call and state change counts stand in for
+        //NOTE: the sorted order is tested by the wave-tool-render-queue-tests target instead
+        // args: [objectCount] (0 runs 1000, 2500, 5000 and 10000) [frameCount]
+        int runRenderQueue(int argc, char *argv[]);
+
+        // builds (declares + compiles) the RenderEngine's frame graph for the water in/out of view, each local pass size and the debug render modes: validates the culling against which passes each configuration needs and the aliasing (see FrameGraph::validate())
+        // then reports the live passes, the transient memory before/after aliasing and the time per build
+        //NOTE: only the CPU side is measured (no GL context), the render targets themselves are only allocated by the application
+        // args: [windowWidth] [windowHeight] [frameCount] [isDumping] (1 prints every compiled graph)
+        int runFrameGraph(int argc, char *argv[]);
+    }
+}
+
+#endif // WAVE_TOOL_BENCHMARKS_H_
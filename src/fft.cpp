@@ -0,0 +1,195 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include "fft.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+#include "thread-pool.h"
+
+namespace wave_tool {
+    FFT::FFT(unsigned int const length)
+        : m_length(length), m_log2Length(0)
+    {
+        assert(length >= 2 && 0 == (length & (length - 1)));
+        while ((1u << m_log2Length) < m_length) ++m_log2Length;
+
+        m_bitReversedIndices.resize(m_length);
+        for (unsigned int i = 0; i < m_length; ++i) {
+            unsigned int reversed{0};
+            for (unsigned int bit = 0; bit < m_log2Length; ++bit) reversed |= ((i >> bit) & 1u) << (m_log2Length - 1 - bit);
+            m_bitReversedIndices.at(i) = reversed;
+        }
+
+        // stages h = 1, 2, 4, ..., length / 2 need h twiddles each -> length - 1 in total
+        m_twiddlesReal.resize(m_length - 1);
+        m_twiddlesImaginary.resize(m_length - 1);
+        double const PI{3.14159265358979323846};
+        for (unsigned int h = 1; h < m_length; h <<= 1) {
+            for (unsigned int k = 0; k < h; ++k) {
+                double const angle{-PI * k / h};
+                m_twiddlesReal.at(h - 1 + k) = (float)std::cos(angle);
+                m_twiddlesImaginary.at(h - 1 + k) = (float)std::sin(angle);
+            }
+        }
+    }
+
+    void FFT::transform2D(float *real, float *imaginary, bool const isInverse, ThreadPool *threadPool) const {
+        unsigned int const blockCount{(m_length + COLUMN_BLOCK_WIDTH - 1) / COLUMN_BLOCK_WIDTH};
+        auto const columnPass = [&](std::size_t const begin, std::size_t const end) {
+            transformColumns(real, imaginary, (unsigned int)begin * COLUMN_BLOCK_WIDTH, std::min((unsigned int)end * COLUMN_BLOCK_WIDTH, m_length), isInverse);
+        };
+
+        for (unsigned int pass = 0; pass < 2; ++pass) {
+            if (nullptr != threadPool) threadPool->parallelFor(blockCount, 1, columnPass);
+            else columnPass(0, blockCount);
+            transpose(real, threadPool);
+            transpose(imaginary, threadPool);
+        }
+    }
+
+    void FFT::transformColumns(float *real, float *imaginary, unsigned int const columnBegin, unsigned int const columnEnd, bool const isInverse) const {
+        assert(columnBegin <= columnEnd && columnEnd <= m_length);
+        unsigned int const width{columnEnd - columnBegin};
+        if (0 == width) return;
+        std::size_t const stride{m_length};
+        float *re{real + columnBegin};
+        float *im{imaginary + columnBegin};
+        float const sign{isInverse ? 1.0f : -1.0f}; // sign of the exponent
+
+        // bit-reversal permutation of the rows (within this block of columns)...
+        for (unsigned int i = 0; i < m_length; ++i) {
+            unsigned int const j{m_bitReversedIndices[i]};
+            if (i >= j) continue;
+            std::swap_ranges(re + i * stride, re + i * stride + width, re + j * stride);
+            std::swap_ranges(im + i * stride, im + i * stride + width, im + j * stride);
+        }
+
+        unsigned int h{1};
+        // odd number of stages, so do a single (twiddle-free) radix-2 stage first...
+        if (1 == (m_log2Length & 1u)) {
+            for (unsigned int j = 0; j < m_length; j += 2) {
+                float *re0{re + j * stride};
+                float *im0{im + j * stride};
+                float *re1{re0 + stride};
+                float *im1{im0 + stride};
+                for (unsigned int c = 0; c < width; ++c) {
+                    float const aRe{re0[c]}, aIm{im0[c]}, bRe{re1[c]}, bIm{im1[c]};
+                    re0[c] = aRe + bRe;
+                    im0[c] = aIm + bIm;
+                    re1[c] = aRe - bRe;
+                    im1[c] = aIm - bIm;
+                }
+            }
+            h = 2;
+        }
+
+        // radix-4 stages (fuses the radix-2 DIT stages of half-size h and 2h)...
+        //   t1 = W_2h^k x1, t3 = W_2h^k x3
+        //   y0 = x0 + t1, y1 = x0 - t1, y2 = x2 + t3, y3 = x2 - t3
+        //   u2 = W_4h^k y2, u3 = W_4h^(k + h) y3 = (-/+ i) W_4h^k y3
+        //   x0' = y0 + u2, x2' = y0 - u2, x1' = y1 + u3, x3' = y1 - u3
+        for (; h < m_length; h <<= 2) {
+            float const *twiddle1Re{m_twiddlesReal.data() + (h - 1)};
+            float const *twiddle1Im{m_twiddlesImaginary.data() + (h - 1)};
+            float const *twiddle2Re{m_twiddlesReal.data() + (2 * h - 1)};
+            float const *twiddle2Im{m_twiddlesImaginary.data() + (2 * h - 1)};
+            for (unsigned int j = 0; j < m_length; j += 4 * h) {
+                for (unsigned int k = 0; k < h; ++k) {
+                    float const w1Re{twiddle1Re[k]}, w1Im{sign * -twiddle1Im[k]};
+                    float const w2Re{twiddle2Re[k]}, w2Im{sign * -twiddle2Im[k]};
+                    float *re0{re + (j + k) * stride};
+                    float *im0{im + (j + k) * stride};
+                    float *re1{re0 + h * stride};
+                    float *im1{im0 + h * stride};
+                    float *re2{re1 + h * stride};
+                    float *im2{im1 + h * stride};
+                    float *re3{re2 + h * stride};
+                    float *im3{im2 + h * stride};
+                    for (unsigned int c = 0; c < width; ++c) {
+                        float const t1Re{w1Re * re1[c] - w1Im * im1[c]};
+                        float const t1Im{w1Re * im1[c] + w1Im * re1[c]};
+                        float const t3Re{w1Re * re3[c] - w1Im * im3[c]};
+                        float const t3Im{w1Re * im3[c] + w1Im * re3[c]};
+                        float const y0Re{re0[c] + t1Re}, y0Im{im0[c] + t1Im};
+                        float const y1Re{re0[c] - t1Re}, y1Im{im0[c] - t1Im};
+                        float const y2Re{re2[c] + t3Re}, y2Im{im2[c] + t3Im};
+                        float const y3Re{re2[c] - t3Re}, y3Im{im2[c] - t3Im};
+                        float const u2Re{w2Re * y2Re - w2Im * y2Im};
+                        float const u2Im{w2Re * y2Im + w2Im * y2Re};
+                        float const v3Re{w2Re * y3Re - w2Im * y3Im};
+                        float const v3Im{w2Re * y3Im + w2Im * y3Re};
+                        // multiply by W_4^1 = sign x i
+                        float const u3Re{-sign * v3Im};
+                        float const u3Im{sign * v3Re};
+                        re0[c] = y0Re + u2Re;
+                        im0[c] = y0Im + u2Im;
+                        re2[c] = y0Re - u2Re;
+                        im2[c] = y0Im - u2Im;
+                        re1[c] = y1Re + u3Re;
+                        im1[c] = y1Im + u3Im;
+                        re3[c] = y1Re - u3Re;
+                        im3[c] = y1Im - u3Im;
+                    }
+                }
+            }
+        }
+    }
+
+    // in-place square transpose, tile by tile (each task owns a band of tile rows and swaps with the mirrored tiles)
+    void FFT::transpose(float *data, ThreadPool *threadPool) const {
+        unsigned int const tileCount{(m_length + TRANSPOSE_TILE_LENGTH - 1) / TRANSPOSE_TILE_LENGTH};
+        std::size_t const stride{m_length};
+        auto const transposeTileRows = [&](std::size_t const begin, std::size_t const end) {
+            for (std::size_t tileRow = begin; tileRow < end; ++tileRow) {
+                unsigned int const rowBegin{(unsigned int)tileRow * TRANSPOSE_TILE_LENGTH};
+                unsigned int const rowEnd{std::min(rowBegin + TRANSPOSE_TILE_LENGTH, m_length)};
+                for (unsigned int tileColumn = (unsigned int)tileRow; tileColumn < tileCount; ++tileColumn) {
+                    unsigned int const columnBegin{tileColumn * TRANSPOSE_TILE_LENGTH};
+                    unsigned int const columnEnd{std::min(columnBegin + TRANSPOSE_TILE_LENGTH, m_length)};
+                    for (unsigned int row = rowBegin; row < rowEnd; ++row) {
+                        // diagonal tiles only swap their upper triangle
+                        for (unsigned int column = (tileColumn == tileRow ? row + 1 : columnBegin); column < columnEnd; ++column) {
+                            std::swap(data[row * stride + column], data[column * stride + row]);
+                        }
+                    }
+                }
+            }
+        };
+
+        if (nullptr != threadPool) threadPool->parallelFor(tileCount, 1, transposeTileRows);
+        else transposeTileRows(0, tileCount);
+    }
+}
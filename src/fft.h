@@ -0,0 +1,74 @@
+#ifndef WAVE_TOOL_FFT_H_
+#define WAVE_TOOL_FFT_H_
+
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <vector>
+
+namespace wave_tool {
+    class ThreadPool;
+
+    // in-place, unnormalized, power-of-2 complex FFT on square 2D data stored as split (SoA) real/imaginary arrays in row-major order
+    // reference: https://en.wikipedia.org/wiki/Cooley%E2%80%93Tukey_FFT_algorithm
+    //NOTE: the butterflies are radix-4 (2 fused radix-2 DIT stages, so half the passes over memory) with a single radix-2 stage first when log2(length) is odd
+    //NOTE: every pass works on a block of adjacent columns at once, so the innermost loop is always a contiguous run of floats with a constant twiddle (auto-vectorizes to SSE/AVX/NEON without intrinsics)
+    //NOTE: rows are handled by transposing, running the column pass again, then transposing back
+    class FFT {
+        public:
+            // length must be a power of 2, >= 2
+            explicit FFT(unsigned int const length);
+
+            inline unsigned int getLength() const { return m_length; }
+
+            // forward uses exp(-i...), inverse uses exp(+i...), neither scales by 1/N
+            //NOTE: a null threadPool runs single-threaded
+            void transform2D(float *real, float *imaginary, bool const isInverse, ThreadPool *threadPool) const;
+            // transforms columns [columnBegin, columnEnd) of the length x length data
+            void transformColumns(float *real, float *imaginary, unsigned int const columnBegin, unsigned int const columnEnd, bool const isInverse) const;
+        private:
+            // columns per task, 32 floats x 2 arrays x 512 rows = 128KB working set (fits in L2)
+            static unsigned int const COLUMN_BLOCK_WIDTH{32};
+            static unsigned int const TRANSPOSE_TILE_LENGTH{32};
+
+            unsigned int m_length;
+            unsigned int m_log2Length;
+            std::vector<unsigned int> m_bitReversedIndices;
+            // W_(2h)^k = exp(-2 x pi x i x k / (2h)) for k in [0, h), stored contiguously per stage at offset (h - 1)
+            std::vector<float> m_twiddlesImaginary;
+            std::vector<float> m_twiddlesReal;
+
+            void transpose(float *data, ThreadPool *threadPool) const;
+    };
+}
+
+#endif // WAVE_TOOL_FFT_H_
@@ -0,0 +1,417 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include "frame-graph.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+#include <iostream>
+
+#include "gl-state-cache.h"
+
+namespace wave_tool {
+    bool FrameGraph::TextureDescription::operator==(TextureDescription const& other) const {
+        return width == other.width && height == other.height && internalFormat == other.internalFormat;
+    }
+
+    FrameGraph::~FrameGraph() {
+        releasePool();
+    }
+
+    void FrameGraph::reset(GLsizei const backbufferWidth, GLsizei const backbufferHeight) {
+        m_backbufferWidth = backbufferWidth;
+        m_backbufferHeight = backbufferHeight;
+        m_resources.clear();
+        m_passes.clear();
+        m_slots.clear();
+
+        // age the pooled textures (backwards, since freeing swaps in the last one)
+        for (std::size_t i = m_pool.size(); i-- > 0;) {
+            PooledTexture &pooledTexture{m_pool.at(i)};
+            pooledTexture.idleFrameCount = pooledTexture.isClaimed ? 0 : pooledTexture.idleFrameCount + 1;
+            pooledTexture.isClaimed = false;
+            if (pooledTexture.idleFrameCount > MAX_IDLE_FRAMES) freePooledTexture(i);
+        }
+    }
+
+    FrameGraph::Resource FrameGraph::createTexture(char const* name, TextureDescription const& description) {
+        ResourceNode resource;
+        resource.name = name;
+        resource.description = description;
+        resource.sizeInBytes = getSizeInBytes(description);
+        m_resources.push_back(resource);
+        return (Resource)(m_resources.size() - 1);
+    }
+
+    FrameGraph::Resource FrameGraph::importResource(char const* name, std::size_t const sizeInBytes) {
+        ResourceNode resource;
+        resource.name = name;
+        resource.isImported = true;
+        resource.sizeInBytes = sizeInBytes;
+        m_resources.push_back(resource);
+        return (Resource)(m_resources.size() - 1);
+    }
+
+    FrameGraph::Pass FrameGraph::addPass(char const* name) {
+        PassNode pass;
+        pass.name = name;
+        m_passes.push_back(pass);
+        return (Pass)(m_passes.size() - 1);
+    }
+
+    void FrameGraph::read(Pass const pass, Resource const resource) {
+        m_passes.at(pass).reads.push_back(resource);
+    }
+
+    void FrameGraph::write(Pass const pass, Resource const resource) {
+        m_passes.at(pass).writes.push_back(resource);
+    }
+
+    void FrameGraph::compile() {
+        // culling...
+        // walking backwards, a pass is live if it writes something imported or something a later live pass reads (and then everything it reads is needed in turn)
+        std::vector<bool> isNeeded(m_resources.size(), false);
+        for (std::size_t i = m_passes.size(); i-- > 0;) {
+            PassNode &pass{m_passes.at(i)};
+            pass.isLive = false;
+            for (Resource const resource : pass.writes) pass.isLive = pass.isLive || m_resources.at(resource).isImported || isNeeded.at(resource);
+            if (!pass.isLive) continue;
+
+            for (Resource const resource : pass.reads) isNeeded.at(resource) = true;
+        }
+
+        // lifetimes...
+        for (ResourceNode &resource : m_resources) {
+            resource.firstPass = NONE;
+            resource.lastPass = NONE;
+            resource.slot = NONE;
+        }
+        for (unsigned int i = 0; i < m_passes.size(); ++i) {
+            PassNode const& pass{m_passes.at(i)};
+            if (!pass.isLive) continue;
+
+            for (std::vector<Resource> const* resources : {&pass.reads, &pass.writes}) {
+                for (Resource const resource : *resources) {
+                    ResourceNode &node{m_resources.at(resource)};
+                    if (NONE == node.firstPass) node.firstPass = i;
+                    node.lastPass = i;
+                }
+            }
+        }
+
+        // aliasing...
+        // in order of first use, each live transient takes the first slot of the same description that is free by then (its last user is an earlier pass), otherwise it opens a new slot
+        //NOTE: every transient is cleared (or fully overwritten) by the first pass that writes it, so nothing carries over from the previous occupant of the slot
+        std::vector<Resource> transients;
+        for (Resource resource = 0; resource < m_resources.size(); ++resource) {
+            if (!m_resources.at(resource).isImported && NONE != m_resources.at(resource).firstPass) transients.push_back(resource);
+        }
+        std::stable_sort(transients.begin(), transients.end(), [this](Resource const a, Resource const b) { return m_resources.at(a).firstPass < m_resources.at(b).firstPass; });
+        for (Resource const resource : transients) {
+            ResourceNode &node{m_resources.at(resource)};
+            for (unsigned int slot = 0; slot < m_slots.size(); ++slot) {
+                if (m_slots.at(slot).description == node.description && m_slots.at(slot).lastPass < node.firstPass) {
+                    node.slot = slot;
+                    break;
+                }
+            }
+            if (NONE == node.slot) {
+                m_slots.push_back(Slot{node.description, NONE, 0});
+                node.slot = (unsigned int)(m_slots.size() - 1);
+            }
+            m_slots.at(node.slot).lastPass = node.lastPass;
+        }
+    }
+
+    bool FrameGraph::beginPass(Pass const pass) {
+        PassNode &node{m_passes.at(pass)};
+        node.isBindingTargets = false;
+        if (!node.isLive) return false;
+
+        // the transients this pass writes make up its framebuffer (at most 1 colour and 1 depth attachment)
+        GLuint colourTexture{0};
+        GLuint depthTexture{0};
+        TextureDescription const* targetDescription{nullptr};
+        for (Resource const resource : node.writes) {
+            ResourceNode const& target{m_resources.at(resource)};
+            if (target.isImported) continue;
+
+            (isDepthFormat(target.description.internalFormat) ? depthTexture : colourTexture) = getTexture(resource);
+            targetDescription = &target.description;
+        }
+        if (nullptr == targetDescription) return true;
+
+        GLStateCache::bindFramebuffer(findFramebuffer(colourTexture, depthTexture));
+        glViewport(0, 0, targetDescription->width, targetDescription->height);
+        node.isBindingTargets = true;
+        return true;
+    }
+
+    void FrameGraph::endPass(Pass const pass) {
+        PassNode &node{m_passes.at(pass)};
+        if (!node.isBindingTargets) return;
+
+        glViewport(0, 0, m_backbufferWidth, m_backbufferHeight);
+        GLStateCache::bindFramebuffer(0);
+        node.isBindingTargets = false;
+    }
+
+    bool FrameGraph::isPassLive(Pass const pass) const {
+        return m_passes.at(pass).isLive;
+    }
+
+    GLuint FrameGraph::getTexture(Resource const resource) {
+        ResourceNode const& node{m_resources.at(resource)};
+        if (node.isImported || NONE == node.slot) return 0;
+
+        Slot &slot{m_slots.at(node.slot)};
+        if (0 == slot.texture) slot.texture = claimTexture(slot.description);
+        return slot.texture;
+    }
+
+    void FrameGraph::releasePool() {
+        for (std::size_t i = m_pool.size(); i-- > 0;) freePooledTexture(i);
+        for (Slot &slot : m_slots) slot.texture = 0;
+    }
+
+    unsigned int FrameGraph::validate() const {
+        unsigned int violationCount{0};
+        std::vector<bool> isWritten(m_resources.size(), false);
+        for (PassNode const& pass : m_passes) {
+            if (!pass.isLive) continue;
+
+            for (Resource const resource : pass.reads) {
+                if (m_resources.at(resource).isImported || isWritten.at(resource)) continue;
+
+                std::cout << "ERROR: frame-graph.cpp - live pass " << pass.name << " reads " << m_resources.at(resource).name << " before any live pass writes it" << std::endl;
+                ++violationCount;
+            }
+            for (Resource const resource : pass.writes) isWritten.at(resource) = true;
+        }
+
+        for (Resource a = 0; a < m_resources.size(); ++a) {
+            ResourceNode const& nodeA{m_resources.at(a)};
+            if (NONE == nodeA.slot) continue;
+
+            if (nodeA.description != m_slots.at(nodeA.slot).description) {
+                std::cout << "ERROR: frame-graph.cpp - " << nodeA.name << " doesn't match the description of slot " << nodeA.slot << std::endl;
+                ++violationCount;
+            }
+            for (Resource b = a + 1; b < m_resources.size(); ++b) {
+                ResourceNode const& nodeB{m_resources.at(b)};
+                if (nodeA.slot != nodeB.slot || nodeA.lastPass < nodeB.firstPass || nodeB.lastPass < nodeA.firstPass) continue;
+
+                std::cout << "ERROR: frame-graph.cpp - " << nodeA.name << " and " << nodeB.name << " share slot " << nodeA.slot << " with overlapping lifetimes" << std::endl;
+                ++violationCount;
+            }
+        }
+        return violationCount;
+    }
+
+    unsigned int FrameGraph::getLivePassCount() const {
+        unsigned int count{0};
+        for (PassNode const& pass : m_passes) count += pass.isLive ? 1 : 0;
+        return count;
+    }
+
+    std::size_t FrameGraph::getTransientSizeInBytes() const {
+        std::size_t sizeInBytes{0};
+        for (ResourceNode const& resource : m_resources) {
+            if (!resource.isImported && NONE != resource.slot) sizeInBytes += resource.sizeInBytes;
+        }
+        return sizeInBytes;
+    }
+
+    std::size_t FrameGraph::getAliasedSizeInBytes() const {
+        std::size_t sizeInBytes{0};
+        for (Slot const& slot : m_slots) sizeInBytes += getSizeInBytes(slot.description);
+        return sizeInBytes;
+    }
+
+    std::size_t FrameGraph::getPooledSizeInBytes() const {
+        std::size_t sizeInBytes{0};
+        for (PooledTexture const& pooledTexture : m_pool) sizeInBytes += getSizeInBytes(pooledTexture.description);
+        return sizeInBytes;
+    }
+
+    void FrameGraph::dump(std::ostream &stream) const {
+        auto const toMiB = [](std::size_t const sizeInBytes) { return sizeInBytes / (1024.0 * 1024.0); };
+        auto const streamNames = [&](std::vector<Resource> const& resources) {
+            if (resources.empty()) stream << "-";
+            for (std::size_t i = 0; i < resources.size(); ++i) stream << (0 == i ? "" : ", ") << m_resources.at(resources.at(i)).name;
+        };
+
+        stream << std::fixed << std::setprecision(2);
+        stream << "frame graph: " << getLivePassCount() << " / " << m_passes.size() << " passes live, " << m_slots.size() << " transient slots" << std::endl;
+        for (unsigned int i = 0; i < m_passes.size(); ++i) {
+            PassNode const& pass{m_passes.at(i)};
+            stream << "  pass " << i << " " << pass.name << (pass.isLive ? "" : " (culled)") << ": reads ";
+            streamNames(pass.reads);
+            stream << " | writes ";
+            streamNames(pass.writes);
+            stream << std::endl;
+        }
+        for (ResourceNode const& resource : m_resources) {
+            stream << "  " << (resource.isImported ? "imported " : "transient ") << resource.name;
+            if (!resource.isImported) stream << " (" << resource.description.width << " x " << resource.description.height << " " << getFormatName(resource.description.internalFormat) << ")";
+            stream << ": " << toMiB(resource.sizeInBytes) << " MiB";
+            if (NONE == resource.firstPass) stream << ", unused";
+            else stream << ", passes " << resource.firstPass << " - " << resource.lastPass;
+            if (NONE != resource.slot) stream << ", slot " << resource.slot;
+            stream << std::endl;
+        }
+        stream << "  transient memory: " << toMiB(getTransientSizeInBytes()) << " MiB unaliased, " << toMiB(getAliasedSizeInBytes()) << " MiB aliased, " << toMiB(getPooledSizeInBytes()) << " MiB pooled ("
+               << m_pool.size() << " textures, " << m_framebuffers.size() << " framebuffers)" << std::endl;
+        stream << std::defaultfloat;
+    }
+
+    std::size_t FrameGraph::getSizeInBytes(TextureDescription const& description) {
+        std::size_t bytesPerTexel{4};
+        switch (description.internalFormat) {
+            case GL_R8:
+                bytesPerTexel = 1;
+                break;
+            case GL_R16:
+            case GL_DEPTH_COMPONENT16:
+                bytesPerTexel = 2;
+                break;
+            case GL_RGBA16F:
+            case GL_DEPTH32F_STENCIL8:
+                bytesPerTexel = 8;
+                break;
+            case GL_RGBA32F:
+                bytesPerTexel = 16;
+                break;
+            default:
+                //NOTE: GL_DEPTH_COMPONENT24 is counted as the 4 bytes it is (at least) padded to
+                break;
+        }
+        return bytesPerTexel * (std::size_t)description.width * description.height;
+    }
+
+    bool FrameGraph::isDepthFormat(GLenum const internalFormat) {
+        return GL_DEPTH_COMPONENT == internalFormat || GL_DEPTH_COMPONENT16 == internalFormat || GL_DEPTH_COMPONENT24 == internalFormat || GL_DEPTH_COMPONENT32F == internalFormat || isDepthStencilFormat(internalFormat);
+    }
+
+    bool FrameGraph::isDepthStencilFormat(GLenum const internalFormat) {
+        return GL_DEPTH_STENCIL == internalFormat || GL_DEPTH24_STENCIL8 == internalFormat || GL_DEPTH32F_STENCIL8 == internalFormat;
+    }
+
+    char const* FrameGraph::getFormatName(GLenum const internalFormat) {
+        switch (internalFormat) {
+            case GL_RGBA: return "RGBA";
+            case GL_RGBA8: return "RGBA8";
+            case GL_RGBA16F: return "RGBA16F";
+            case GL_RGBA32F: return "RGBA32F";
+            case GL_R8: return "R8";
+            case GL_R16: return "R16";
+            case GL_DEPTH_COMPONENT: return "DEPTH";
+            case GL_DEPTH_COMPONENT16: return "DEPTH16";
+            case GL_DEPTH_COMPONENT24: return "DEPTH24";
+            case GL_DEPTH_COMPONENT32F: return "DEPTH32F";
+            case GL_DEPTH24_STENCIL8: return "DEPTH24_STENCIL8";
+            case GL_DEPTH32F_STENCIL8: return "DEPTH32F_STENCIL8";
+            default: return "?";
+        }
+    }
+
+    GLuint FrameGraph::claimTexture(TextureDescription const& description) {
+        for (PooledTexture &pooledTexture : m_pool) {
+            if (!pooledTexture.isClaimed && pooledTexture.description == description) {
+                pooledTexture.isClaimed = true;
+                return pooledTexture.texture;
+            }
+        }
+
+        bool const isDepth{isDepthFormat(description.internalFormat)};
+        bool const isDepthStencil{isDepthStencilFormat(description.internalFormat)};
+        GLuint texture;
+        glGenTextures(1, &texture);
+        GLStateCache::bindTexture(GL_TEXTURE_2D, texture);
+        // set options on currently bound texture object...
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, isDepth ? GL_NEAREST : GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, isDepth ? GL_NEAREST : GL_LINEAR);
+        // generate empty texture (2D)...
+        glTexImage2D(GL_TEXTURE_2D, 0, description.internalFormat, description.width, description.height, 0,
+                     isDepthStencil ? GL_DEPTH_STENCIL : (isDepth ? GL_DEPTH_COMPONENT : GL_RGBA), isDepthStencil ? GL_UNSIGNED_INT_24_8 : (isDepth ? GL_FLOAT : GL_UNSIGNED_BYTE), nullptr);
+        GLStateCache::bindTexture(GL_TEXTURE_2D, 0);
+
+        m_pool.push_back(PooledTexture{description, texture, 0, true});
+        return texture;
+    }
+
+    GLuint FrameGraph::findFramebuffer(GLuint const colourTexture, GLuint const depthTexture) {
+        for (PooledFramebuffer const& pooledFramebuffer : m_framebuffers) {
+            if (pooledFramebuffer.colourTexture == colourTexture && pooledFramebuffer.depthTexture == depthTexture) return pooledFramebuffer.framebuffer;
+        }
+
+        // the attachments of a pooled texture never change, so its framebuffers are set up once and kept until it is freed
+        GLuint framebuffer;
+        glGenFramebuffers(1, &framebuffer);
+        GLStateCache::bindFramebuffer(framebuffer);
+        if (0 != colourTexture) glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colourTexture, 0);
+        if (0 != depthTexture) {
+            // the attachment point depends on the format, which only the pool knows
+            //NOTE: the caller has just claimed the texture, so it must still be pooled (not freed by releasePool() or the idle eviction), otherwise it falls back to a plain depth attachment
+            std::vector<PooledTexture>::const_iterator const pooledDepthTexture{std::find_if(m_pool.cbegin(), m_pool.cend(), [&](PooledTexture const& pooledTexture) { return depthTexture == pooledTexture.texture; })};
+            assert(m_pool.cend() != pooledDepthTexture);
+            if (m_pool.cend() == pooledDepthTexture) std::cout << "ERROR: frame-graph.cpp - depth texture " << depthTexture << " is not in the pool!" << std::endl;
+            bool const isDepthStencil{m_pool.cend() != pooledDepthTexture && isDepthStencilFormat(pooledDepthTexture->description.internalFormat)};
+            glFramebufferTexture2D(GL_FRAMEBUFFER, isDepthStencil ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
+        }
+        // without a colour buffer, we must explicitly declare not to render any colour data
+        glDrawBuffer(0 != colourTexture ? GL_COLOR_ATTACHMENT0 : GL_NONE);
+        glReadBuffer(0 != colourTexture ? GL_COLOR_ATTACHMENT0 : GL_NONE);
+        // check FBO setup status...
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) std::cout << "ERROR: frame-graph.cpp - framebuffer setup failed (colour " << colourTexture << ", depth " << depthTexture << ")!" << std::endl;
+
+        m_framebuffers.push_back(PooledFramebuffer{colourTexture, depthTexture, framebuffer});
+        return framebuffer;
+    }
+
+    void FrameGraph::freePooledTexture(std::size_t const index) {
+        GLuint const texture{m_pool.at(index).texture};
+        for (std::size_t i = m_framebuffers.size(); i-- > 0;) {
+            if (texture != m_framebuffers.at(i).colourTexture && texture != m_framebuffers.at(i).depthTexture) continue;
+
+            GLStateCache::deleteFramebuffers(1, &m_framebuffers.at(i).framebuffer);
+            m_framebuffers.at(i) = m_framebuffers.back();
+            m_framebuffers.pop_back();
+        }
+        GLStateCache::deleteTextures(1, &texture);
+        m_pool.at(index) = m_pool.back();
+        m_pool.pop_back();
+    }
+}
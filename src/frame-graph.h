@@ -0,0 +1,168 @@
+#ifndef WAVE_TOOL_FRAME_GRAPH_H_
+#define WAVE_TOOL_FRAME_GRAPH_H_
+
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace wave_tool {
+    // the frame's passes declared up front with the resources they read and write, so that the passes nothing depends on are culled, and the render targets are allocated lazily (only once a live pass uses them)
+    // the transient targets (only used within a frame) that have the same description and non-overlapping lifetimes are aliased onto 1 texture
+    // the imported resources (e.g. the sky cubemap or the default framebuffer) are owned elsewhere and persist across frames, so writing one is what keeps a pass (and everything it reads) alive
+    //NOTE: the passes execute in the order they are declared (the caller brackets each with beginPass() / endPass()), so the declaration order must already be a valid order
+    //NOTE: declaring and compiling is plain CPU work (no GL calls), the GL side (the pooled textures and framebuffers) is only touched from beginPass() / getTexture() on
+    class FrameGraph {
+        public:
+            // index into the current frame's declarations (only valid until the next reset())
+            using Resource = unsigned int;
+            using Pass = unsigned int;
+            inline static unsigned int const NONE{0xFFFFFFFF};
+
+            // a pooled texture that goes unclaimed for this many frames is freed (e.g. after the water has been out of view for a while)
+            inline static unsigned int const MAX_IDLE_FRAMES{120};
+
+            // a transient 2D render target, the filtering follows the format (NEAREST for depth, LINEAR otherwise) and it is always clamped to the edge
+            struct TextureDescription {
+                GLsizei width{1};
+                GLsizei height{1};
+                GLenum internalFormat{GL_RGBA8};
+
+                bool operator==(TextureDescription const& other) const;
+                inline bool operator!=(TextureDescription const& other) const { return !(*this == other); }
+            };
+
+            FrameGraph() = default;
+            ~FrameGraph();
+            FrameGraph(FrameGraph const&) = delete;
+            FrameGraph& operator=(FrameGraph const&) = delete;
+
+            // starts the declaration of a new frame (and ages the pooled textures the last frame didn't claim)
+            //NOTE: the backbuffer size is the viewport endPass() restores
+            void reset(GLsizei const backbufferWidth, GLsizei const backbufferHeight);
+            Resource createTexture(char const* name, TextureDescription const& description);
+            // sizeInBytes is only for the dump
+            Resource importResource(char const* name, std::size_t const sizeInBytes);
+            Pass addPass(char const* name);
+            void read(Pass const pass, Resource const resource);
+            void write(Pass const pass, Resource const resource);
+
+            // culls the passes whose writes nothing live reads (and that write nothing imported), works out each live transient's lifetime (first to last live pass that uses it) and aliases them onto slots
+            void compile();
+
+            // false if the pass was culled, otherwise the transient textures it writes (if any) are bound as 1 framebuffer, with the viewport set to their size
+            bool beginPass(Pass const pass);
+            // back to the default framebuffer and the backbuffer's viewport (if beginPass() bound any targets)
+            void endPass(Pass const pass);
+            bool isPassLive(Pass const pass) const;
+            // the texture behind a transient (claimed from the pool, or allocated, on first use), 0 if it was culled
+            GLuint getTexture(Resource const resource);
+
+            // frees every pooled texture and framebuffer (e.g. after a resize, when none of the old sizes will be asked for again)
+            void releasePool();
+
+            // debug check of the compiled graph (every live read is written by an earlier live pass or imported, the transients sharing a slot match it and don't overlap), prints an ERROR for every violation and returns the violation count
+            unsigned int validate() const;
+
+            unsigned int getPassCount() const { return (unsigned int)m_passes.size(); }
+            unsigned int getLivePassCount() const;
+            unsigned int getSlotCount() const { return (unsigned int)m_slots.size(); }
+            // of the live transients, as if each had its own texture
+            std::size_t getTransientSizeInBytes() const;
+            // of the live transients once aliased (1 texture per slot)
+            std::size_t getAliasedSizeInBytes() const;
+            // of every texture in the pool (including the idle ones, not yet freed)
+            std::size_t getPooledSizeInBytes() const;
+            // the passes (live or culled, with their reads/writes), the transients (size, lifetime, slot), the imported resources and the memory totals
+            void dump(std::ostream &stream) const;
+
+            static std::size_t getSizeInBytes(TextureDescription const& description);
+            static bool isDepthFormat(GLenum const internalFormat);
+            static bool isDepthStencilFormat(GLenum const internalFormat);
+        private:
+            struct ResourceNode {
+                std::string name;
+                bool isImported{false};
+                TextureDescription description{}; // transients only
+                std::size_t sizeInBytes{0};
+                unsigned int firstPass{NONE}; // lifetime, in live pass indices (NONE if culled)
+                unsigned int lastPass{NONE};
+                unsigned int slot{NONE};
+            };
+            struct PassNode {
+                std::string name;
+                std::vector<Resource> reads;
+                std::vector<Resource> writes;
+                bool isLive{false};
+                bool isBindingTargets{false}; // set by beginPass() for endPass()
+            };
+            // the transients aliased onto 1 texture
+            struct Slot {
+                TextureDescription description{};
+                unsigned int lastPass{NONE};
+                GLuint texture{0}; // 0 until claimed
+            };
+            struct PooledTexture {
+                TextureDescription description{};
+                GLuint texture{0};
+                unsigned int idleFrameCount{0};
+                bool isClaimed{false}; // by a slot of the current frame
+            };
+            struct PooledFramebuffer {
+                GLuint colourTexture{0};
+                GLuint depthTexture{0};
+                GLuint framebuffer{0};
+            };
+
+            GLsizei m_backbufferWidth{1};
+            GLsizei m_backbufferHeight{1};
+            std::vector<ResourceNode> m_resources;
+            std::vector<PassNode> m_passes;
+            std::vector<Slot> m_slots;
+            std::vector<PooledTexture> m_pool;
+            std::vector<PooledFramebuffer> m_framebuffers;
+
+            static char const* getFormatName(GLenum const internalFormat);
+
+            GLuint claimTexture(TextureDescription const& description);
+            GLuint findFramebuffer(GLuint const colourTexture, GLuint const depthTexture);
+            // also deletes the framebuffers it is attached to
+            void freePooledTexture(std::size_t const index);
+    };
+}
+
+#endif // WAVE_TOOL_FRAME_GRAPH_H_
@@ -0,0 +1,245 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include "gerstner-atlas.h"
+
+#include <glm/gtc/constants.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "thread-pool.h"
+
+namespace wave_tool {
+    // reference: http://www.isthe.com/chongo/tech/comp/fnv/index.html (FNV-1a)
+    std::uint64_t GerstnerAtlas::hashBytes(void const* data, std::size_t const size, std::uint64_t hash) {
+        unsigned char const* bytes{static_cast<unsigned char const*>(data)};
+        for (std::size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    std::unique_ptr<GerstnerAtlas> GerstnerAtlas::bakeOrLoad(std::vector<geometry::GerstnerWave> const& gerstnerWaves, GerstnerAtlasParameters const& parameters, ThreadPool *threadPool, std::string const& cacheDirectory) {
+        if (parameters.resolution < 2 || parameters.frameCount < 2 || parameters.tileLength <= 0.0f || parameters.minLoopPeriodInSeconds <= 0.0f || parameters.maxLoopPeriodInSeconds < parameters.minLoopPeriodInSeconds) {
+            std::cout << "ERROR: gerstner-atlas.cpp - invalid bake parameters!" << std::endl;
+            return nullptr;
+        }
+
+        std::unique_ptr<GerstnerAtlas> atlas{new GerstnerAtlas()};
+        atlas->m_parameters = parameters;
+        atlas->m_loopPeriodInSeconds = findLoopPeriod(gerstnerWaves, parameters.minLoopPeriodInSeconds, parameters.maxLoopPeriodInSeconds);
+        atlas->m_snappedWaves = snapWaves(gerstnerWaves, parameters.tileLength, atlas->m_loopPeriodInSeconds);
+
+        // key = everything that affects the baked texels
+        std::vector<geometry::GerstnerWaveStd140> packedWaves;
+        geometry::packGerstnerWavesStd140(atlas->m_snappedWaves, packedWaves);
+        std::uint64_t key{14695981039346656037ull};
+        key = hashBytes(&parameters.resolution, sizeof(parameters.resolution), key);
+        key = hashBytes(&parameters.frameCount, sizeof(parameters.frameCount), key);
+        key = hashBytes(&parameters.tileLength, sizeof(parameters.tileLength), key);
+        key = hashBytes(&atlas->m_loopPeriodInSeconds, sizeof(atlas->m_loopPeriodInSeconds), key);
+        if (!packedWaves.empty()) key = hashBytes(packedWaves.data(), packedWaves.size() * sizeof(geometry::GerstnerWaveStd140), key);
+        atlas->m_key = key;
+
+        std::string const cacheFilePath{cacheDirectory.empty() ? "" : atlas->getCacheFilePath(cacheDirectory)};
+        if (!cacheFilePath.empty() && atlas->loadCacheFile(cacheFilePath)) {
+            atlas->m_wasLoadedFromCache = true;
+            return atlas;
+        }
+
+        atlas->bake(threadPool);
+        if (!cacheFilePath.empty() && !atlas->saveCacheFile(cacheFilePath)) std::cout << "WARNING: gerstner-atlas.cpp - failed to write cache file: " << cacheFilePath << std::endl;
+
+        return atlas;
+    }
+
+    float GerstnerAtlas::findLoopPeriod(std::vector<geometry::GerstnerWave> const& gerstnerWaves, float const minLoopPeriodInSeconds, float const maxLoopPeriodInSeconds) {
+        float const STEP_IN_SECONDS{0.05f};
+        float bestPeriod{minLoopPeriodInSeconds};
+        float bestError{-1.0f};
+        for (float period = minLoopPeriodInSeconds; period <= maxLoopPeriodInSeconds; period += STEP_IN_SECONDS) {
+            float const phaseStep{glm::two_pi<float>() / period};
+            float error{0.0f};
+            for (geometry::GerstnerWave const& gerstnerWave : gerstnerWaves) {
+                float const cycles{glm::max(glm::round(gerstnerWave.phaseConstant_phi / phaseStep), gerstnerWave.phaseConstant_phi > 0.0f ? 1.0f : 0.0f)};
+                error += gerstnerWave.amplitude_A * glm::abs(cycles * phaseStep - gerstnerWave.phaseConstant_phi);
+            }
+            //NOTE: strictly less, so ties go to the shorter period (fewer seconds per loop -> finer time steps per layer)
+            if (bestError < 0.0f || error < bestError) {
+                bestError = error;
+                bestPeriod = period;
+            }
+        }
+
+        return bestPeriod;
+    }
+
+    std::vector<geometry::GerstnerWave> GerstnerAtlas::snapWaves(std::vector<geometry::GerstnerWave> const& gerstnerWaves, float const tileLength, float const loopPeriodInSeconds) {
+        float const kStep{glm::two_pi<float>() / tileLength};
+        float const phaseStep{glm::two_pi<float>() / loopPeriodInSeconds};
+
+        std::vector<geometry::GerstnerWave> snappedWaves;
+        snappedWaves.reserve(gerstnerWaves.size());
+        for (geometry::GerstnerWave const& gerstnerWave : gerstnerWaves) {
+            // wave vector onto the lattice...
+            glm::vec2 lattice{glm::round(gerstnerWave.frequency_w * gerstnerWave.xzDirection_D.x / kStep), glm::round(gerstnerWave.frequency_w * gerstnerWave.xzDirection_D.y / kStep)};
+            // too long to fit in the tile, so use the smallest non-zero wave vector along the dominant axis of the direction
+            //NOTE: flat waves (0 frequency or amplitude) are kept as-is, since steepness_Q_i is normalized by the wave count
+            if (0.0f == lattice.x && 0.0f == lattice.y && 0.0f != gerstnerWave.frequency_w && 0.0f != gerstnerWave.amplitude_A) {
+                if (glm::abs(gerstnerWave.xzDirection_D.x) >= glm::abs(gerstnerWave.xzDirection_D.y)) lattice.x = glm::sign(gerstnerWave.xzDirection_D.x);
+                else lattice.y = glm::sign(gerstnerWave.xzDirection_D.y);
+            }
+            float const latticeLength{glm::length(lattice)};
+            float const frequency_w{kStep * latticeLength};
+            glm::vec2 const xzDirection_D{latticeLength > 0.0f ? lattice / latticeLength : gerstnerWave.xzDirection_D};
+
+            // phase constant onto whole cycles per loop...
+            float const cycles{glm::max(glm::round(gerstnerWave.phaseConstant_phi / phaseStep), gerstnerWave.phaseConstant_phi > 0.0f ? 1.0f : 0.0f)};
+
+            snappedWaves.emplace_back(gerstnerWave.amplitude_A, frequency_w, cycles * phaseStep, gerstnerWave.steepness_Q, xzDirection_D);
+        }
+
+        return snappedWaves;
+    }
+
+    void GerstnerAtlas::releaseTexelData() {
+        std::vector<glm::vec4>().swap(m_displacements);
+        std::vector<glm::vec4>().swap(m_normals);
+    }
+
+    // evaluates the same sum (and analytic derivatives) as computeGerstnerSurfacePositionAndDerivatives() in water-grid.vert
+    void GerstnerAtlas::bake(ThreadPool *threadPool) {
+        unsigned int const resolution{m_parameters.resolution};
+        std::size_t const layerTexelCount{(std::size_t)resolution * resolution};
+        m_displacements.assign(layerTexelCount * m_parameters.frameCount, glm::vec4{0.0f});
+        m_normals.assign(layerTexelCount * m_parameters.frameCount, glm::vec4{0.0f, 1.0f, 0.0f, 0.0f});
+
+        std::vector<geometry::GerstnerWaveStd140> packedWaves;
+        geometry::packGerstnerWavesStd140(m_snappedWaves, packedWaves);
+
+        // 1 task per (layer, row)
+        auto const bakeRows = [&](std::size_t const begin, std::size_t const end) {
+            for (std::size_t layerRow = begin; layerRow < end; ++layerRow) {
+                std::size_t const layer{layerRow / resolution};
+                std::size_t const z{layerRow % resolution};
+                float const timeInSeconds{m_loopPeriodInSeconds * layer / m_parameters.frameCount};
+                for (unsigned int x = 0; x < resolution; ++x) {
+                    glm::vec2 const xzGridPosition{m_parameters.tileLength * x / resolution, m_parameters.tileLength * z / resolution};
+                    glm::vec3 displacement{0.0f};
+                    glm::vec3 tangent{1.0f, 0.0f, 0.0f};
+                    glm::vec3 bitangent{0.0f, 0.0f, 1.0f};
+                    for (geometry::GerstnerWaveStd140 const& wave : packedWaves) {
+                        glm::vec2 const D{wave.xzDirection_D};
+                        float const xyzConstant_1{wave.frequency_w * glm::dot(D, xzGridPosition) + wave.phaseConstant_phi * timeInSeconds};
+                        float const sinConstant{glm::sin(xyzConstant_1)};
+                        float const cosConstant{glm::cos(xyzConstant_1)};
+                        float const xzConstant_1{wave.steepness_Q_i * cosConstant};
+                        displacement += wave.amplitude_A * glm::vec3{D.x * xzConstant_1, sinConstant, D.y * xzConstant_1};
+
+                        float const WA{wave.frequency_w * wave.amplitude_A};
+                        float const xzDerivativeConstant{wave.steepness_Q_i * WA * sinConstant};
+                        float const yDerivativeConstant{WA * cosConstant};
+                        tangent += glm::vec3{-D.x * D.x * xzDerivativeConstant, D.x * yDerivativeConstant, -D.x * D.y * xzDerivativeConstant};
+                        bitangent += glm::vec3{-D.x * D.y * xzDerivativeConstant, D.y * yDerivativeConstant, -D.y * D.y * xzDerivativeConstant};
+                    }
+
+                    std::size_t const i{layer * layerTexelCount + z * resolution + x};
+                    m_displacements[i] = glm::vec4{displacement, 0.0f};
+                    m_normals[i] = glm::vec4{glm::normalize(glm::cross(bitangent, tangent)), 0.0f};
+                }
+            }
+        };
+
+        std::size_t const layerRowCount{(std::size_t)m_parameters.frameCount * resolution};
+        if (nullptr != threadPool) threadPool->parallelFor(layerRowCount, 0, bakeRows);
+        else bakeRows(0, layerRowCount);
+    }
+
+    std::string GerstnerAtlas::getCacheFilePath(std::string const& cacheDirectory) const {
+        std::ostringstream filePath;
+        filePath << cacheDirectory;
+        if ('/' != cacheDirectory.back() && '\\' != cacheDirectory.back()) filePath << '/';
+        filePath << "gerstner-atlas-" << std::hex << std::setw(16) << std::setfill('0') << m_key << ".bin";
+        return filePath.str();
+    }
+
+    // cache file layout: magic (8 bytes) | key (u64) | resolution (u32) | frameCount (u32) | displacements | normals
+    //NOTE: native endianness and float format, it is only a cache for the machine that wrote it
+    bool GerstnerAtlas::loadCacheFile(std::string const& filePath) {
+        std::ifstream file{filePath, std::ios::in | std::ios::binary};
+        if (!file) return false;
+
+        char magic[sizeof(CACHE_FILE_MAGIC)];
+        std::uint64_t key{0};
+        std::uint32_t resolution{0};
+        std::uint32_t frameCount{0};
+        file.read(magic, sizeof(magic));
+        file.read(reinterpret_cast<char*>(&key), sizeof(key));
+        file.read(reinterpret_cast<char*>(&resolution), sizeof(resolution));
+        file.read(reinterpret_cast<char*>(&frameCount), sizeof(frameCount));
+        if (!file || 0 != std::memcmp(magic, CACHE_FILE_MAGIC, sizeof(magic)) || key != m_key || resolution != m_parameters.resolution || frameCount != m_parameters.frameCount) return false;
+
+        std::size_t const texelCount{(std::size_t)resolution * resolution * frameCount};
+        m_displacements.resize(texelCount);
+        m_normals.resize(texelCount);
+        file.read(reinterpret_cast<char*>(m_displacements.data()), texelCount * sizeof(glm::vec4));
+        file.read(reinterpret_cast<char*>(m_normals.data()), texelCount * sizeof(glm::vec4));
+        if (!file) {
+            std::cout << "WARNING: gerstner-atlas.cpp - truncated cache file (will re-bake): " << filePath << std::endl;
+            releaseTexelData();
+            return false;
+        }
+
+        return true;
+    }
+
+    bool GerstnerAtlas::saveCacheFile(std::string const& filePath) const {
+        std::ofstream file{filePath, std::ios::out | std::ios::binary | std::ios::trunc};
+        if (!file) return false;
+
+        std::uint32_t const resolution{m_parameters.resolution};
+        std::uint32_t const frameCount{m_parameters.frameCount};
+        file.write(CACHE_FILE_MAGIC, sizeof(CACHE_FILE_MAGIC));
+        file.write(reinterpret_cast<char const*>(&m_key), sizeof(m_key));
+        file.write(reinterpret_cast<char const*>(&resolution), sizeof(resolution));
+        file.write(reinterpret_cast<char const*>(&frameCount), sizeof(frameCount));
+        file.write(reinterpret_cast<char const*>(m_displacements.data()), m_displacements.size() * sizeof(glm::vec4));
+        file.write(reinterpret_cast<char const*>(m_normals.data()), m_normals.size() * sizeof(glm::vec4));
+
+        return (bool)file;
+    }
+}
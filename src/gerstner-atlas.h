@@ -0,0 +1,103 @@
+#ifndef WAVE_TOOL_GERSTNER_ATLAS_H_
+#define WAVE_TOOL_GERSTNER_ATLAS_H_
+
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gerstner-wave.h"
+
+namespace wave_tool {
+    class ThreadPool;
+
+    struct GerstnerAtlasParameters {
+        unsigned int resolution{128}; // in range [2, inf), texels along each side of a layer
+        unsigned int frameCount{64}; // in range [2, inf), layers baked over 1 loop period
+        float tileLength{64.0f}; // in range (0.0, inf), world-space side length of 1 (seamless) tile
+        float minLoopPeriodInSeconds{8.0f}; // in range (0.0, maxLoopPeriodInSeconds]
+        float maxLoopPeriodInSeconds{32.0f}; // in range [minLoopPeriodInSeconds, inf)
+    };
+
+    // a looping (in time) and tiling (in space) bake of the gerstner wave sum, meant for long playback sessions where the sea state doesn't change
+    //NOTE: to make the bake loop, every wave vector k = w x D is snapped onto the 2 x pi / tileLength lattice (so it tiles) and every phase constant is snapped to a whole number of cycles per loop period (so it loops)
+    //NOTE: this means the baked waves can differ slightly from the live ones (see getSnappedWaves())
+    class GerstnerAtlas {
+        public:
+            // snaps the waves, then either loads a matching bake from the cache file or bakes (and writes the cache file)
+            //NOTE: a null threadPool bakes single-threaded, an empty cacheDirectory disables the disk cache
+            static std::unique_ptr<GerstnerAtlas> bakeOrLoad(std::vector<geometry::GerstnerWave> const& gerstnerWaves, GerstnerAtlasParameters const& parameters, ThreadPool *threadPool, std::string const& cacheDirectory);
+
+            // picks the period in [minPeriod, maxPeriod] that needs the least (amplitude weighted) change to the phase constants to loop
+            static float findLoopPeriod(std::vector<geometry::GerstnerWave> const& gerstnerWaves, float const minLoopPeriodInSeconds, float const maxLoopPeriodInSeconds);
+            static std::vector<geometry::GerstnerWave> snapWaves(std::vector<geometry::GerstnerWave> const& gerstnerWaves, float const tileLength, float const loopPeriodInSeconds);
+
+            inline GerstnerAtlasParameters const& getParameters() const { return m_parameters; }
+            inline float getLoopPeriodInSeconds() const { return m_loopPeriodInSeconds; }
+            inline std::vector<geometry::GerstnerWave> const& getSnappedWaves() const { return m_snappedWaves; }
+            inline bool wasLoadedFromCache() const { return m_wasLoadedFromCache; }
+            // frameCount layers of resolution x resolution texels (layer-major, then row-major with row = z)
+            // xyz = gerstner displacement relative to the undisplaced grid point, w = 0
+            inline std::vector<glm::vec4> const& getDisplacements() const { return m_displacements; }
+            // xyz = unit surface normal, w = 0
+            inline std::vector<glm::vec4> const& getNormals() const { return m_normals; }
+
+            // drops the baked texel data (e.g. once it has been uploaded to the GPU)
+            void releaseTexelData();
+        private:
+            inline static char const CACHE_FILE_MAGIC[8]{'W', 'T', 'G', 'A', 'T', 'L', 'S', '1'};
+
+            static std::uint64_t hashBytes(void const* data, std::size_t const size, std::uint64_t hash);
+
+            GerstnerAtlasParameters m_parameters;
+            float m_loopPeriodInSeconds{0.0f};
+            std::vector<geometry::GerstnerWave> m_snappedWaves;
+            std::uint64_t m_key{0}; // identifies the bake inputs (used to validate the cache file)
+            bool m_wasLoadedFromCache{false};
+            std::vector<glm::vec4> m_displacements;
+            std::vector<glm::vec4> m_normals;
+
+            GerstnerAtlas() = default;
+
+            void bake(ThreadPool *threadPool);
+            std::string getCacheFilePath(std::string const& cacheDirectory) const;
+            bool loadCacheFile(std::string const& filePath);
+            bool saveCacheFile(std::string const& filePath) const;
+    };
+}
+
+#endif // WAVE_TOOL_GERSTNER_ATLAS_H_
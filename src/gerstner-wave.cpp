@@ -0,0 +1,91 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include "gerstner-wave.h"
+
+#include <glm/gtc/constants.hpp>
+
+#include <random>
+
+namespace wave_tool {
+    namespace geometry {
+        float computeTotalAmplitude(std::vector<GerstnerWave> const& gerstnerWaves) {
+            float totalAmplitude{0.0f};
+            for (GerstnerWave const& gerstnerWave : gerstnerWaves) totalAmplitude += gerstnerWave.amplitude_A;
+            return totalAmplitude;
+        }
+
+        void packGerstnerWavesStd140(std::vector<GerstnerWave> const& gerstnerWaves, std::vector<GerstnerWaveStd140> &out_packed) {
+            out_packed.resize(gerstnerWaves.size());
+            for (std::size_t i = 0; i < gerstnerWaves.size(); ++i) {
+                GerstnerWave const& gerstnerWave{gerstnerWaves.at(i)};
+                GerstnerWaveStd140 &packed{out_packed.at(i)};
+                packed.amplitude_A = gerstnerWave.amplitude_A;
+                packed.frequency_w = gerstnerWave.frequency_w;
+                packed.phaseConstant_phi = gerstnerWave.phaseConstant_phi;
+                packed.steepness_Q_i = computeSteepness_Q_i(gerstnerWave, gerstnerWaves.size());
+                packed.xzDirection_D = gerstnerWave.xzDirection_D;
+                packed.padding = glm::vec2{0.0f, 0.0f}; // keep padding deterministic so packed buffers can be compared bytewise
+            }
+        }
+
+        std::vector<GerstnerWave> generateSeaState(SeaStateParameters const& parameters) {
+            std::vector<GerstnerWave> gerstnerWaves;
+            if (0 == parameters.waveCount || parameters.medianWavelength <= 0.0f) return gerstnerWaves;
+            gerstnerWaves.reserve(parameters.waveCount);
+
+            std::mt19937 generator{parameters.seed};
+            std::uniform_real_distribution<float> wavelengthDistribution{0.5f * parameters.medianWavelength, 2.0f * parameters.medianWavelength};
+            std::uniform_real_distribution<float> spreadDistribution{-parameters.directionalSpreadInDegrees, parameters.directionalSpreadInDegrees};
+
+            float const GRAVITY{9.81f};
+            float wavelengthSum{0.0f};
+            for (unsigned int i = 0; i < parameters.waveCount; ++i) {
+                float const wavelength_L{wavelengthDistribution(generator)};
+                float const frequency_w{glm::two_pi<float>() / wavelength_L};
+                // deep water dispersion: phi = sqrt(g x w)
+                float const phaseConstant_phi{glm::sqrt(GRAVITY * frequency_w)};
+                float const directionInRadians{glm::radians(parameters.windDirectionInDegrees + spreadDistribution(generator))};
+                glm::vec2 const xzDirection_D{glm::cos(directionInRadians), glm::sin(directionInRadians)};
+
+                // amplitude is proportional to wavelength (normalized below)
+                gerstnerWaves.emplace_back(wavelength_L, frequency_w, phaseConstant_phi, glm::clamp(parameters.steepness, 0.0f, 1.0f), xzDirection_D);
+                wavelengthSum += wavelength_L;
+            }
+
+            float const amplitudeScale{glm::max(parameters.totalAmplitude, 0.0f) / wavelengthSum};
+            for (GerstnerWave &gerstnerWave : gerstnerWaves) gerstnerWave.amplitude_A *= amplitudeScale;
+
+            return gerstnerWaves;
+        }
+    }
+}
@@ -0,0 +1,115 @@
+#ifndef WAVE_TOOL_GERSTNER_WAVE_H_
+#define WAVE_TOOL_GERSTNER_WAVE_H_
+
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <glm/glm.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace wave_tool {
+    namespace geometry {
+        // reference: https://developer.nvidia.com/gpugems/gpugems/part-i-natural-effects/chapter-1-effective-water-simulation-physical-models
+        struct GerstnerWave {
+            public:
+                float amplitude_A; // height of crest above equilibrium plane
+                float frequency_w; // w = 2/L (roughly), where L =:= wavelength (crest-to-crest distance)
+                float phaseConstant_phi; // phi = S x w, where S =:= speed (distance crest moves forward per second)
+                float steepness_Q; // controls "sharpness" of crest
+                glm::vec2 xzDirection_D; // horizontal unit vector perpendicular to the wave front along which the crest travels 
+
+                GerstnerWave(float const amplitude_A, float const frequency_w, float const phaseConstant_phi, float const steepness_Q, glm::vec2 const& xzDirection_D)
+                    : amplitude_A(amplitude_A), frequency_w(frequency_w), phaseConstant_phi(phaseConstant_phi), steepness_Q(steepness_Q), xzDirection_D(xzDirection_D)
+                {
+                    assert(amplitude_A >= 0.0f);
+                    assert(frequency_w >= 0.0f);
+                    assert(phaseConstant_phi >= 0.0f);
+                    assert(0.0f <= steepness_Q && steepness_Q <= 1.0f);
+                    float const EPSILON{0.001f};
+                    float const xzDirection_D_length{glm::length(xzDirection_D)};
+                    assert(1.0f - EPSILON <= xzDirection_D_length && xzDirection_D_length <= 1.0f + EPSILON);
+                }
+        };
+
+        // the C++ mirror of the GerstnerWaveBlock uniform block declared in assets/shaders/gerstner-waves.glsl (which is the single GLSL definition that every shader includes)
+        //NOTE: std140 rules: the uint count is padded out to 16 bytes, then each struct element is rounded up to a multiple of 16 bytes (6 floats -> 32 bytes)
+        //NOTE: the array length is NOT duplicated here, the capacity is queried from the linked program (GL_UNIFORM_BLOCK_DATA_SIZE) at runtime
+        struct GerstnerWaveBlockHeaderStd140 {
+            std::uint32_t gerstnerWaveCount;
+            std::uint32_t padding[3];
+        };
+        static_assert(sizeof(GerstnerWaveBlockHeaderStd140) == 16);
+
+        struct GerstnerWaveStd140 {
+            float amplitude_A;
+            float frequency_w;
+            float phaseConstant_phi;
+            float steepness_Q_i; // the per-wave steepness after normalizing by the live wave count (see computeSteepness_Q_i)
+            glm::vec2 xzDirection_D;
+            glm::vec2 padding;
+        };
+        static_assert(sizeof(GerstnerWaveStd140) == 32);
+
+        // Q_i = Q / (w_i x A_i x numWaves), which keeps the summed surface from looping over itself
+        //NOTE: div by zero is just handled by setting to a symbolic 0.0
+        inline float computeSteepness_Q_i(GerstnerWave const& gerstnerWave, std::size_t const gerstnerWaveCount) {
+            float const denom{gerstnerWave.frequency_w * gerstnerWave.amplitude_A * gerstnerWaveCount};
+            return (0.0f != denom) ? gerstnerWave.steepness_Q / denom : 0.0f;
+        }
+
+        // the maximum possible vertical displacement of the summed waves
+        float computeTotalAmplitude(std::vector<GerstnerWave> const& gerstnerWaves);
+
+        // packs the waves into std140 element layout (out_packed is resized to gerstnerWaves.size())
+        void packGerstnerWavesStd140(std::vector<GerstnerWave> const& gerstnerWaves, std::vector<GerstnerWaveStd140> &out_packed);
+
+        // parameters for randomly generating a wind-driven sea state
+        // reference: https://developer.nvidia.com/gpugems/gpugems/part-i-natural-effects/chapter-1-effective-water-simulation-physical-models (section 1.2.4 - "Selecting Parameters")
+        struct SeaStateParameters {
+            unsigned int waveCount{64}; // in range [1, inf)
+            float medianWavelength{8.0f}; // in range (0.0, inf)
+            float totalAmplitude{0.3f}; // in range [0.0, inf), the generated amplitudes (proportional to wavelength) are normalized to sum to this
+            float windDirectionInDegrees{0.0f}; // in range [0.0, 360.0), measured from +X towards +Z
+            float directionalSpreadInDegrees{60.0f}; // in range [0.0, 180.0], each wave direction is within +/- this of the wind direction
+            float steepness{0.8f}; // in range [0.0, 1.0]
+            unsigned int seed{0};
+        };
+
+        // wavelengths are drawn from [median / 2, median x 2] and speeds follow the deep water dispersion relation
+        std::vector<GerstnerWave> generateSeaState(SeaStateParameters const& parameters);
+    }
+}
+
+#endif // WAVE_TOOL_GERSTNER_WAVE_H_
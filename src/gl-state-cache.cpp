@@ -0,0 +1,218 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include "gl-state-cache.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace wave_tool {
+    void GLStateCache::useProgram(GLuint const program) {
+        if (isRedundant(s_program, program)) return;
+        glUseProgram(program);
+    }
+
+    void GLStateCache::bindVertexArray(GLuint const vao) {
+        if (isRedundant(s_vao, vao)) return;
+        glBindVertexArray(vao);
+    }
+
+    void GLStateCache::bindFramebuffer(GLuint const framebuffer) {
+        if (isRedundant(s_framebuffer, framebuffer)) return;
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    }
+
+    void GLStateCache::polygonMode(GLenum const mode) {
+        if (isRedundant(s_polygonMode, mode)) return;
+        glPolygonMode(GL_FRONT_AND_BACK, mode);
+    }
+
+    void GLStateCache::cullFace(GLenum const mode) {
+        if (isRedundant(s_cullFace, mode)) return;
+        glCullFace(mode);
+    }
+
+    void GLStateCache::frontFace(GLenum const mode) {
+        if (isRedundant(s_frontFace, mode)) return;
+        glFrontFace(mode);
+    }
+
+    void GLStateCache::depthMask(GLboolean const flag) {
+        if (isRedundant(s_depthMask, flag)) return;
+        glDepthMask(flag);
+    }
+
+    void GLStateCache::setEnabled(GLenum const capability, bool const isEnabled) {
+        int const capabilityIndex{findCapability(capability)};
+        if (-1 == capabilityIndex) ++s_issuedCallCount;
+        else if (isRedundant(s_capabilities.at(capabilityIndex), isEnabled)) return;
+
+        if (isEnabled) glEnable(capability);
+        else glDisable(capability);
+    }
+
+    void GLStateCache::activeTexture(GLenum const unit) {
+        if (isRedundant(s_activeTextureUnit, unit - GL_TEXTURE0)) return;
+        glActiveTexture(unit);
+    }
+
+    void GLStateCache::bindTexture(GLenum const target, GLuint const texture) {
+        int const targetIndex{findTextureTarget(target)};
+        if (-1 == targetIndex || UNKNOWN == s_activeTextureUnit) {
+            ++s_issuedCallCount;
+        } else {
+            if (s_activeTextureUnit >= s_textureBindings.size()) s_textureBindings.resize(s_activeTextureUnit + 1, {UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN});
+            if (isRedundant(s_textureBindings.at(s_activeTextureUnit).at(targetIndex), texture)) return;
+        }
+        glBindTexture(target, texture);
+    }
+
+    void GLStateCache::bindTextureToUnit(GLuint const unit, GLenum const target, GLuint const texture) {
+        int const targetIndex{findTextureTarget(target)};
+        if (-1 != targetIndex && unit < s_textureBindings.size() && texture == s_textureBindings.at(unit).at(targetIndex)) {
+            // both the unit switch and the bind are skipped
+            s_filteredCallCount += 2;
+            return;
+        }
+        activeTexture(GL_TEXTURE0 + unit);
+        bindTexture(target, texture);
+    }
+
+    void GLStateCache::deleteTextures(GLsizei const count, GLuint const* textures) {
+        for (GLsizei i = 0; i < count; ++i) {
+            if (0 == textures[i]) continue;
+            for (std::array<GLuint, TEXTURE_TARGETS.size()> &unitBindings : s_textureBindings) std::replace(unitBindings.begin(), unitBindings.end(), textures[i], 0u);
+        }
+        glDeleteTextures(count, textures);
+    }
+
+    void GLStateCache::deleteVertexArrays(GLsizei const count, GLuint const* vaos) {
+        for (GLsizei i = 0; i < count; ++i) {
+            if (0 != vaos[i] && vaos[i] == s_vao) s_vao = 0;
+        }
+        glDeleteVertexArrays(count, vaos);
+    }
+
+    void GLStateCache::deleteFramebuffers(GLsizei const count, GLuint const* framebuffers) {
+        for (GLsizei i = 0; i < count; ++i) {
+            if (0 != framebuffers[i] && framebuffers[i] == s_framebuffer) s_framebuffer = 0;
+        }
+        glDeleteFramebuffers(count, framebuffers);
+    }
+
+    void GLStateCache::invalidate() {
+        s_program = UNKNOWN;
+        s_vao = UNKNOWN;
+        s_framebuffer = UNKNOWN;
+        s_polygonMode = UNKNOWN;
+        s_cullFace = UNKNOWN;
+        s_frontFace = UNKNOWN;
+        s_depthMask = UNKNOWN;
+        s_capabilities.fill(UNKNOWN);
+        s_activeTextureUnit = UNKNOWN;
+        s_textureBindings.clear();
+    }
+
+    unsigned int GLStateCache::validate() {
+        unsigned int mismatchCount{0};
+        auto const check{[&mismatchCount](char const* name, GLuint const shadowedValue, GLint const actualValue) {
+            if (UNKNOWN == shadowedValue || shadowedValue == (GLuint)actualValue) return;
+            std::cout << "ERROR: gl-state-cache.cpp - shadowed " << name << " (" << shadowedValue << ") does not match the GL state (" << actualValue << ")!" << std::endl;
+            ++mismatchCount;
+        }};
+
+        GLint value{0};
+        glGetIntegerv(GL_CURRENT_PROGRAM, &value);
+        check("program", s_program, value);
+        glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &value);
+        check("vertex array", s_vao, value);
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &value);
+        check("framebuffer", s_framebuffer, value);
+        //NOTE: the front and back modes are returned, but they are always set together
+        GLint polygonModes[2]{0, 0};
+        glGetIntegerv(GL_POLYGON_MODE, polygonModes);
+        check("polygon mode", s_polygonMode, polygonModes[0]);
+        glGetIntegerv(GL_CULL_FACE_MODE, &value);
+        check("cull face", s_cullFace, value);
+        glGetIntegerv(GL_FRONT_FACE, &value);
+        check("front face", s_frontFace, value);
+        glGetIntegerv(GL_DEPTH_WRITEMASK, &value);
+        check("depth mask", s_depthMask, value);
+        for (unsigned int capabilityIndex = 0; capabilityIndex < CAPABILITIES.size(); ++capabilityIndex) {
+            check("capability", s_capabilities.at(capabilityIndex), glIsEnabled(CAPABILITIES.at(capabilityIndex)));
+        }
+
+        GLint activeTexture{GL_TEXTURE0};
+        glGetIntegerv(GL_ACTIVE_TEXTURE, &activeTexture);
+        check("active texture unit", s_activeTextureUnit, activeTexture - GL_TEXTURE0);
+        std::array<GLenum, TEXTURE_TARGETS.size()> const TEXTURE_BINDINGS{GL_TEXTURE_BINDING_1D, GL_TEXTURE_BINDING_2D, GL_TEXTURE_BINDING_2D_ARRAY, GL_TEXTURE_BINDING_BUFFER, GL_TEXTURE_BINDING_CUBE_MAP};
+        for (GLuint unit = 0; unit < s_textureBindings.size(); ++unit) {
+            glActiveTexture(GL_TEXTURE0 + unit);
+            for (unsigned int targetIndex = 0; targetIndex < TEXTURE_TARGETS.size(); ++targetIndex) {
+                glGetIntegerv(TEXTURE_BINDINGS.at(targetIndex), &value);
+                check("texture binding", s_textureBindings.at(unit).at(targetIndex), value);
+            }
+        }
+        glActiveTexture(activeTexture);
+
+        return mismatchCount;
+    }
+
+    void GLStateCache::resetCallCounts() {
+        s_issuedCallCount = 0;
+        s_filteredCallCount = 0;
+    }
+
+    int GLStateCache::findTextureTarget(GLenum const target) {
+        for (unsigned int targetIndex = 0; targetIndex < TEXTURE_TARGETS.size(); ++targetIndex) {
+            if (target == TEXTURE_TARGETS.at(targetIndex)) return (int)targetIndex;
+        }
+        return -1;
+    }
+
+    int GLStateCache::findCapability(GLenum const capability) {
+        for (unsigned int capabilityIndex = 0; capabilityIndex < CAPABILITIES.size(); ++capabilityIndex) {
+            if (capability == CAPABILITIES.at(capabilityIndex)) return (int)capabilityIndex;
+        }
+        return -1;
+    }
+
+    bool GLStateCache::isRedundant(GLuint &shadowedValue, GLuint const value) {
+        if (value == shadowedValue) {
+            ++s_filteredCallCount;
+            return true;
+        }
+        shadowedValue = value;
+        ++s_issuedCallCount;
+        return false;
+    }
+}
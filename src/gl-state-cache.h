@@ -0,0 +1,111 @@
+#ifndef WAVE_TOOL_GL_STATE_CACHE_H_
+#define WAVE_TOOL_GL_STATE_CACHE_H_
+
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <glad/glad.h>
+
+#include <array>
+#include <vector>
+
+namespace wave_tool {
+    // shadows the GL state that is changed around every draw, so a change to the value that is already set is filtered out before it reaches the driver
+    // (the render-state analogue of ShaderProgram skipping unchanged uniform uploads)
+    //NOTE: the shadowed state assumes every change to it goes through here, so anything else that touches it (e.g. the ImGui backend) must be followed by invalidate()
+    //NOTE: a value that isn't known (e.g. right after invalidate()) always issues the call
+    class GLStateCache {
+        public:
+            static void useProgram(GLuint const program);
+            static void bindVertexArray(GLuint const vao);
+            // binds both the draw and read framebuffer (GL_FRAMEBUFFER)
+            static void bindFramebuffer(GLuint const framebuffer);
+            // for GL_FRONT_AND_BACK (the only face allowed by the core profile)
+            static void polygonMode(GLenum const mode);
+            static void cullFace(GLenum const mode);
+            static void frontFace(GLenum const mode);
+            static void depthMask(GLboolean const flag);
+            // glEnable/glDisable
+            static void setEnabled(GLenum const capability, bool const isEnabled);
+            // unit is GL_TEXTURE0 + i
+            static void activeTexture(GLenum const unit);
+            // binds to the active unit
+            static void bindTexture(GLenum const target, GLuint const texture);
+            // binds to the given unit (unit is i, NOT GL_TEXTURE0 + i), the active unit is only switched if the texture isn't already bound there
+            static void bindTextureToUnit(GLuint const unit, GLenum const target, GLuint const texture);
+
+            // deleting a bound object reverts its bindings to 0, these do the same to the shadowed state (so a recycled name isn't mistaken for a bound one)
+            static void deleteTextures(GLsizei const count, GLuint const* textures);
+            static void deleteVertexArrays(GLsizei const count, GLuint const* vaos);
+            static void deleteFramebuffers(GLsizei const count, GLuint const* framebuffers);
+
+            // forgets all of the shadowed state (the next call of each kind is always issued)
+            static void invalidate();
+            // debug check of the shadowed (known) state against glGet*, prints an ERROR for every mismatch and returns the mismatch count
+            //NOTE: this stalls on the driver and switches the active texture unit around (restoring it), so it is meant for debugging only
+            static unsigned int validate();
+
+            // the calls issued/filtered since the last reset (the RenderEngine resets them once per frame)
+            static unsigned int getIssuedCallCount() { return s_issuedCallCount; }
+            static unsigned int getFilteredCallCount() { return s_filteredCallCount; }
+            static void resetCallCounts();
+        private:
+            // stands in for a value that isn't known
+            inline static GLuint const UNKNOWN{0xFFFFFFFF};
+            // the texture targets and capabilities that are shadowed (others are passed through, and count as issued)
+            inline static std::array<GLenum, 5> const TEXTURE_TARGETS{GL_TEXTURE_1D, GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BUFFER, GL_TEXTURE_CUBE_MAP};
+            inline static std::array<GLenum, 7> const CAPABILITIES{GL_BLEND, GL_CLIP_DISTANCE0, GL_CULL_FACE, GL_DEPTH_TEST, GL_LINE_SMOOTH, GL_PRIMITIVE_RESTART, GL_RASTERIZER_DISCARD};
+
+            inline static unsigned int s_issuedCallCount{0};
+            inline static unsigned int s_filteredCallCount{0};
+
+            inline static GLuint s_program{UNKNOWN};
+            inline static GLuint s_vao{UNKNOWN};
+            inline static GLuint s_framebuffer{UNKNOWN};
+            inline static GLuint s_polygonMode{UNKNOWN};
+            inline static GLuint s_cullFace{UNKNOWN};
+            inline static GLuint s_frontFace{UNKNOWN};
+            inline static GLuint s_depthMask{UNKNOWN};
+            inline static std::array<GLuint, CAPABILITIES.size()> s_capabilities{UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN};
+            inline static GLuint s_activeTextureUnit{UNKNOWN}; // i, NOT GL_TEXTURE0 + i
+            // [unit][target], grown on demand (the RenderEngine uses the texture's name as its unit)
+            inline static std::vector<std::array<GLuint, TEXTURE_TARGETS.size()>> s_textureBindings;
+
+            // returns the index into TEXTURE_TARGETS / CAPABILITIES, or -1 if it isn't shadowed
+            static int findTextureTarget(GLenum const target);
+            static int findCapability(GLenum const capability);
+            // true (and counted as filtered) if the shadowed value is already the wanted one, otherwise it is updated (and counted as issued)
+            static bool isRedundant(GLuint &shadowedValue, GLuint const value);
+    };
+}
+
+#endif // WAVE_TOOL_GL_STATE_CACHE_H_
@@ -0,0 +1,143 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include "gpu-benchmark.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <utility>
+
+#include "render-engine.h"
+#include "water-grid.h"
+
+namespace wave_tool {
+    std::unique_ptr<GPUBenchmark> GPUBenchmark::create(std::string const& name, unsigned int const frameCount) {
+        Timer const frameTimer{"frame", [](RenderEngine const& renderEngine) { return renderEngine.getFrameGPUTimeInMilliseconds(); }};
+
+        // the sky cubemap's full update (all 6 faces, every frame), drawn once per face vs. once into the layered attachment
+        if ("sky-cubemap" == name) {
+            std::vector<Case> cases;
+            for (bool const isLayered : {false, true}) {
+                cases.push_back(Case{isLayered ? "layered" : "per-face", [isLayered](RenderEngine &renderEngine) {
+                    renderEngine.isAnimatingTimeOfDay = false; // no amortising, every update is a full one
+                    renderEngine.isRenderingSkyCubemapLayered = isLayered;
+                    renderEngine.invalidateSkyCubemap();
+                }, {}});
+            }
+            std::vector<Timer> timers{Timer{"sky cubemap", [](RenderEngine const& renderEngine) { return renderEngine.getSkyCubemapGPUTimeInMilliseconds(); }}, frameTimer};
+            return std::unique_ptr<GPUBenchmark>{new GPUBenchmark{name, std::move(timers), std::move(cases), frameCount}};
+        }
+
+        // the local reflections + refractions passes at 1/1, 1/2 and 1/4 of the window size (both passes at once), and the water draw that (depth-aware) upsamples them
+        if ("local-passes" == name) {
+            std::vector<Case> cases;
+            for (unsigned int const downscale : {1u, 2u, 4u}) {
+                cases.push_back(Case{"downscale " + std::to_string(downscale), [downscale](RenderEngine &renderEngine) {
+                    renderEngine.localReflectionsDownscale = downscale;
+                    renderEngine.localRefractionsDownscale = downscale;
+                }, {}});
+            }
+            std::vector<Timer> timers{Timer{"local passes", [](RenderEngine const& renderEngine) { return renderEngine.getLocalPassesGPUTimeInMilliseconds(); }},
+                                      Timer{"water draw", [](RenderEngine const& renderEngine) { return renderEngine.getWaterSurfaceDrawGPUTimeInMilliseconds(); }}, frameTimer};
+            return std::unique_ptr<GPUBenchmark>{new GPUBenchmark{name, std::move(timers), std::move(cases), frameCount}};
+        }
+
+        // the projected grid displaced once into the transform feedback capture and then drawn from it vs. displaced by the water draw itself, at the default grid level
+        //NOTE: the capture only applies to the pre-built projected grid, so the clipmap and tessellation are switched off and the resolution governor is held
+        if ("water-capture" == name) {
+            std::vector<Case> cases;
+            for (bool const isCapturing : {false, true}) {
+                cases.push_back(Case{isCapturing ? "capture + reuse" : "re-displace", [isCapturing](RenderEngine &renderEngine) {
+                    renderEngine.isUsingWaterClipmap = false;
+                    renderEngine.isUsingWaterTessellation = false;
+                    renderEngine.getWaterGridResolutionGovernor().isAdaptive = false;
+                    renderEngine.getWaterGridResolutionGovernor().setLevel(WaterGrid::DEFAULT_LEVEL);
+                    renderEngine.isUsingWaterSurfaceCapture = isCapturing;
+                }, {}});
+            }
+            std::vector<Timer> timers{Timer{"water capture", [](RenderEngine const& renderEngine) { return renderEngine.getWaterSurfaceCaptureGPUTimeInMilliseconds(); }},
+                                      Timer{"water draw", [](RenderEngine const& renderEngine) { return renderEngine.getWaterSurfaceDrawGPUTimeInMilliseconds(); }},
+                                      Timer{"water capture + draw", [](RenderEngine const& renderEngine) { return renderEngine.getWaterSurfaceCaptureGPUTimeInMilliseconds() + renderEngine.getWaterSurfaceDrawGPUTimeInMilliseconds(); }}, frameTimer};
+            return std::unique_ptr<GPUBenchmark>{new GPUBenchmark{name, std::move(timers), std::move(cases), frameCount}};
+        }
+
+        std::cout << "ERROR: unknown GPU benchmark: " << name << std::endl;
+        std::cout << "available GPU benchmarks: sky-cubemap, local-passes, water-capture" << std::endl;
+        return nullptr;
+    }
+
+    GPUBenchmark::GPUBenchmark(std::string const& name, std::vector<Timer> &&timers, std::vector<Case> &&cases, unsigned int const frameCount)
+        : m_name(name), m_timers(std::move(timers)), m_cases(std::move(cases)), m_frameCount(std::max(frameCount, 1u)) {
+        for (Case &benchmarkCase : m_cases) benchmarkCase.timesInMilliseconds.resize(m_timers.size());
+        std::cout << m_name << " GPU benchmark (" << m_cases.size() << " cases, " << WARM_UP_FRAME_COUNT << " warm-up + " << m_frameCount << " measured frames each)" << std::endl;
+    }
+
+    bool GPUBenchmark::update(RenderEngine &renderEngine) {
+        if (m_caseIndex >= m_cases.size()) return false;
+
+        Case &currentCase{m_cases.at(m_caseIndex)};
+        //NOTE: the timers read now are from a frame or two ago, which the warm-up keeps inside this case
+        if (m_caseFrame >= WARM_UP_FRAME_COUNT) {
+            for (unsigned int i = 0; i < m_timers.size(); ++i) currentCase.timesInMilliseconds.at(i).push_back(m_timers.at(i).read(renderEngine));
+        }
+        if (++m_caseFrame == WARM_UP_FRAME_COUNT + m_frameCount) {
+            m_caseFrame = 0;
+            if (++m_caseIndex == m_cases.size()) {
+                printReport();
+                return false;
+            }
+        }
+        m_cases.at(m_caseIndex).apply(renderEngine);
+        return true;
+    }
+
+    void GPUBenchmark::printReport() const {
+        std::vector<float> firstCaseMeanTimesInMilliseconds(m_timers.size(), 0.0f);
+        for (Case const& benchmarkCase : m_cases) {
+            std::cout << "  " << benchmarkCase.name << ":" << std::endl;
+            for (unsigned int i = 0; i < m_timers.size(); ++i) {
+                std::vector<float> times{benchmarkCase.timesInMilliseconds.at(i)};
+                std::sort(times.begin(), times.end());
+                float const meanTimeInMilliseconds{std::accumulate(times.begin(), times.end(), 0.0f) / times.size()};
+                if (&benchmarkCase == &m_cases.front()) firstCaseMeanTimesInMilliseconds.at(i) = meanTimeInMilliseconds;
+                float const firstCaseMeanTimeInMilliseconds{firstCaseMeanTimesInMilliseconds.at(i)};
+                std::cout << std::fixed << std::setprecision(3)
+                          << "    " << m_timers.at(i).name << ": mean " << meanTimeInMilliseconds << " ms, median " << times.at(times.size() / 2) << " ms, min " << times.front() << " ms";
+                // (a timer that's 0.0 in the first case, e.g. a pass it doesn't run, has nothing to compare against)
+                if (firstCaseMeanTimeInMilliseconds > 0.0f) std::cout << std::setprecision(2) << " (" << meanTimeInMilliseconds / firstCaseMeanTimeInMilliseconds << "x " << m_cases.front().name << ")";
+                std::cout << std::endl;
+            }
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef WAVE_TOOL_GPU_BENCHMARK_H_
+#define WAVE_TOOL_GPU_BENCHMARK_H_
+
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace wave_tool {
+    class RenderEngine;
+
+    // GPU timings of the renderer's alternatives, which (unlike the headless benchmarks, see benchmarks.h) need the application's window, GL context and scene
+    // each case is set up on the RenderEngine, warmed up, then the benchmark's GPU timers are averaged over frameCount frames, and once every case is done the report is printed
+    //NOTE: run from the cmd-line with: wave-tool --gpu-benchmark <name> (the window should stay on-screen and unobscured, and the camera where it starts)
+    class GPUBenchmark {
+        public:
+            inline static unsigned int const DEFAULT_FRAME_COUNT{300};
+            // frames skipped after switching cases, so render targets are re-allocated and the double-buffered GPU timers report the new case
+            inline static unsigned int const WARM_UP_FRAME_COUNT{30};
+
+            // prints the list of GPU benchmarks and returns null for an unknown name
+            static std::unique_ptr<GPUBenchmark> create(std::string const& name, unsigned int const frameCount = DEFAULT_FRAME_COUNT);
+
+            // call once per frame before RenderEngine::render(), applies the current case and records the GPU times of the frame that was just read back
+            // returns false once every case was measured and the report printed
+            bool update(RenderEngine &renderEngine);
+        private:
+            struct Timer {
+                std::string name;
+                std::function<float(RenderEngine const&)> read; // one of the RenderEngine's get*GPUTimeInMilliseconds()
+            };
+            struct Case {
+                std::string name;
+                std::function<void(RenderEngine&)> apply; // called every frame of the case (so anything the renderer resets, e.g. the sky cubemap's stale faces, stays forced)
+                std::vector<std::vector<float>> timesInMilliseconds; // per timer, per measured frame
+            };
+
+            GPUBenchmark(std::string const& name, std::vector<Timer> &&timers, std::vector<Case> &&cases, unsigned int const frameCount);
+
+            void printReport() const;
+
+            std::string m_name;
+            std::vector<Timer> m_timers;
+            std::vector<Case> m_cases;
+            unsigned int m_frameCount{DEFAULT_FRAME_COUNT};
+            unsigned int m_caseIndex{0};
+            unsigned int m_caseFrame{0};
+    };
+}
+
+#endif // WAVE_TOOL_GPU_BENCHMARK_H_
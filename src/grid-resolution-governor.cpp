@@ -0,0 +1,119 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include "grid-resolution-governor.h"
+
+#include <algorithm>
+
+namespace wave_tool {
+    GridResolutionGovernor::GridResolutionGovernor(unsigned int const levelCount, unsigned int const initialLevel)
+        : m_levelCount{std::max(levelCount, 1u)}, m_level{std::min(initialLevel, m_levelCount - 1)}, m_previousLevel{m_level}
+    {}
+
+    bool GridResolutionGovernor::update(float const frameTimeInMilliseconds) {
+        m_frameTimeHistoryInMilliseconds.at(m_frameTimeHistoryOffset) = frameTimeInMilliseconds;
+        m_frameTimeHistoryOffset = (m_frameTimeHistoryOffset + 1) % HISTORY_LENGTH;
+
+        if (!m_isSmoothedFrameTimeValid) {
+            m_smoothedFrameTimeInMilliseconds = frameTimeInMilliseconds;
+            m_isSmoothedFrameTimeValid = true;
+        } else {
+            m_smoothedFrameTimeInMilliseconds += SMOOTHING * (frameTimeInMilliseconds - m_smoothedFrameTimeInMilliseconds);
+        }
+        if (!isAdaptive) return false;
+
+        bool const isOverBudget{m_smoothedFrameTimeInMilliseconds > targetFrameTimeInMilliseconds};
+        bool const isWellUnderBudget{m_smoothedFrameTimeInMilliseconds < UPSCALE_THRESHOLD * targetFrameTimeInMilliseconds};
+        m_overBudgetFrameCount = isOverBudget ? m_overBudgetFrameCount + 1 : 0;
+        m_underBudgetFrameCount = isWellUnderBudget ? m_underBudgetFrameCount + 1 : 0;
+
+        unsigned int const previousLevel{m_level};
+        if (m_overBudgetFrameCount >= SETTLE_FRAME_COUNT && m_level > 0) {
+            --m_level;
+        } else if (m_underBudgetFrameCount >= SETTLE_FRAME_COUNT && m_level + 1 < m_levelCount) {
+            ++m_level;
+        } else {
+            return false;
+        }
+
+        ++m_switchCount;
+        m_previousLevel = previousLevel;
+        m_lastSwitchFrameTimeInMilliseconds = m_smoothedFrameTimeInMilliseconds;
+        restartSmoothing();
+        return true;
+    }
+
+    unsigned int GridResolutionGovernor::getLevel() const {
+        return m_level;
+    }
+
+    unsigned int GridResolutionGovernor::getLevelCount() const {
+        return m_levelCount;
+    }
+
+    float GridResolutionGovernor::getSmoothedFrameTimeInMilliseconds() const {
+        return m_smoothedFrameTimeInMilliseconds;
+    }
+
+    unsigned int GridResolutionGovernor::getSwitchCount() const {
+        return m_switchCount;
+    }
+
+    std::array<float, GridResolutionGovernor::HISTORY_LENGTH> const& GridResolutionGovernor::getFrameTimeHistoryInMilliseconds() const {
+        return m_frameTimeHistoryInMilliseconds;
+    }
+
+    unsigned int GridResolutionGovernor::getFrameTimeHistoryOffset() const {
+        return m_frameTimeHistoryOffset;
+    }
+
+    unsigned int GridResolutionGovernor::getPreviousLevel() const {
+        return m_previousLevel;
+    }
+
+    float GridResolutionGovernor::getLastSwitchFrameTimeInMilliseconds() const {
+        return m_lastSwitchFrameTimeInMilliseconds;
+    }
+
+    void GridResolutionGovernor::setLevel(unsigned int const level) {
+        unsigned int const clampedLevel{std::min(level, m_levelCount - 1)};
+        if (clampedLevel == m_level) return;
+
+        m_level = clampedLevel;
+        restartSmoothing();
+    }
+
+    void GridResolutionGovernor::restartSmoothing() {
+        m_isSmoothedFrameTimeValid = false;
+        m_overBudgetFrameCount = 0;
+        m_underBudgetFrameCount = 0;
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef WAVE_TOOL_GRID_RESOLUTION_GOVERNOR_H_
+#define WAVE_TOOL_GRID_RESOLUTION_GOVERNOR_H_
+
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <array>
+
+namespace wave_tool {
+    // picks a resolution level (0 = coarsest) from measured frame times against a target budget
+    // hysteresis: it only steps down while over budget and only steps up while well under it (the next level has ~4x the vertices), and either has to hold for SETTLE_FRAME_COUNT frames in a row
+    //NOTE: after a switch the smoothing restarts, so the old level's frame times can't trigger another switch
+    class GridResolutionGovernor {
+        public:
+            inline static float const DEFAULT_TARGET_FRAME_TIME_IN_MILLISECONDS{1000.0f / 60.0f};
+            // exponential moving average weight of each new frame time
+            inline static float const SMOOTHING{0.1f};
+            // step up only once the smoothed frame time is below this fraction of the target
+            inline static float const UPSCALE_THRESHOLD{0.5f};
+            inline static unsigned int const SETTLE_FRAME_COUNT{30};
+            // how many of the last fed frame times are kept (for the UI's graph)
+            inline static unsigned int const HISTORY_LENGTH{120};
+
+            GridResolutionGovernor(unsigned int const levelCount, unsigned int const initialLevel);
+
+            bool isAdaptive{true}; // false holds the current level
+            float targetFrameTimeInMilliseconds{DEFAULT_TARGET_FRAME_TIME_IN_MILLISECONDS};
+
+            // feeds one measured frame time, returns true if the level changed
+            bool update(float const frameTimeInMilliseconds);
+
+            unsigned int getLevel() const;
+            unsigned int getLevelCount() const;
+            float getSmoothedFrameTimeInMilliseconds() const;
+            unsigned int getSwitchCount() const;
+            // the last HISTORY_LENGTH fed frame times (0 until fed), a ring whose oldest entry is at getFrameTimeHistoryOffset()
+            std::array<float, HISTORY_LENGTH> const& getFrameTimeHistoryInMilliseconds() const;
+            unsigned int getFrameTimeHistoryOffset() const;
+            // the level before the last switch and the smoothed frame time that triggered it (the current level/0 before the first switch)
+            unsigned int getPreviousLevel() const;
+            float getLastSwitchFrameTimeInMilliseconds() const;
+            // manually picks a level (clamped), e.g. while not adaptive
+            void setLevel(unsigned int const level);
+        private:
+            unsigned int m_levelCount;
+            unsigned int m_level;
+            unsigned int m_overBudgetFrameCount{0};
+            unsigned int m_underBudgetFrameCount{0};
+            float m_smoothedFrameTimeInMilliseconds{0.0f};
+            bool m_isSmoothedFrameTimeValid{false};
+            unsigned int m_switchCount{0};
+            std::array<float, HISTORY_LENGTH> m_frameTimeHistoryInMilliseconds{};
+            unsigned int m_frameTimeHistoryOffset{0};
+            unsigned int m_previousLevel;
+            float m_lastSwitchFrameTimeInMilliseconds{0.0f};
+
+            void restartSmoothing();
+    };
+}
+
+#endif // WAVE_TOOL_GRID_RESOLUTION_GOVERNOR_H_
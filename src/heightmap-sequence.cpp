@@ -0,0 +1,223 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include "heightmap-sequence.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+#include <stb/stb_image.h>
+
+namespace wave_tool {
+    std::unique_ptr<HeightmapSequence> HeightmapSequence::open(std::string const& pathPattern, unsigned int const queueCapacity) {
+        std::vector<std::string> framePaths;
+        int width{0};
+        int height{0};
+        bool is16Bit{false};
+        for (unsigned int i = 0; ; ++i) {
+            int const pathLength{std::snprintf(nullptr, 0, pathPattern.c_str(), i)};
+            if (pathLength <= 0) break;
+            std::vector<char> pathBuffer((std::size_t)pathLength + 1);
+            std::snprintf(pathBuffer.data(), pathBuffer.size(), pathPattern.c_str(), i);
+            std::string const path{pathBuffer.data()};
+            // a pattern without a frame index is just a single frame
+            if (!framePaths.empty() && path == framePaths.back()) break;
+
+            //NOTE: only the header is read here, the pixels are decoded later by the background thread
+            int frameWidth{0};
+            int frameHeight{0};
+            int frameChannelCount{0};
+            if (0 == stbi_info(path.c_str(), &frameWidth, &frameHeight, &frameChannelCount)) break;
+            bool const isFrame16Bit{0 != stbi_is_16_bit(path.c_str())};
+
+            if (framePaths.empty()) {
+                width = frameWidth;
+                height = frameHeight;
+                is16Bit = isFrame16Bit;
+            } else if (frameWidth != width || frameHeight != height || isFrame16Bit != is16Bit) {
+                std::cout << "ERROR: heightmap-sequence.cpp - frame " << path << " doesn't match the size/bit depth of frame 0!" << std::endl;
+                return nullptr;
+            }
+            framePaths.push_back(path);
+        }
+
+        if (framePaths.empty()) {
+            std::cout << "ERROR: heightmap-sequence.cpp - failed to read the first frame of sequence: " << pathPattern << std::endl;
+            return nullptr;
+        }
+
+        return std::unique_ptr<HeightmapSequence>{new HeightmapSequence{std::move(framePaths), (unsigned int)width, (unsigned int)height, is16Bit ? 2u : 1u, queueCapacity}};
+    }
+
+    HeightmapSequence::HeightmapSequence(std::vector<std::string> &&framePaths, unsigned int const width, unsigned int const height, unsigned int const bytesPerTexel, unsigned int const queueCapacity)
+        : m_framePaths{std::move(framePaths)}
+        , m_width{width}
+        , m_height{height}
+        , m_bytesPerTexel{bytesPerTexel}
+        , m_queueCapacity{0 == queueCapacity ? 1 : queueCapacity}
+    {
+        // every frame allocation that can ever be live (queued + decoding + 1 held by the caller), so recycling never reallocates
+        m_recycledFrames.reserve(m_queueCapacity + 2);
+        m_decoder = std::thread{&HeightmapSequence::decodeLoop, this};
+    }
+
+    HeightmapSequence::~HeightmapSequence() {
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_isStopping = true;
+        }
+        m_spaceAvailable.notify_all();
+        m_decoder.join();
+    }
+
+    std::size_t HeightmapSequence::getMemoryInBytes() const {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        std::size_t memoryInBytes{m_decodingFrameCount * getFrameSizeInBytes()};
+        for (HeightmapFrame const& frame : m_queue) memoryInBytes += frame.texels.capacity();
+        for (HeightmapFrame const& frame : m_recycledFrames) memoryInBytes += frame.texels.capacity();
+        return memoryInBytes;
+    }
+
+    bool HeightmapSequence::peekNextFrameIndex(unsigned int &out_frameIndex) const {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (m_queue.empty()) return false;
+        out_frameIndex = m_queue.front().index;
+        return true;
+    }
+
+    bool HeightmapSequence::tryPopFrame(HeightmapFrame &out_frame) {
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            if (m_queue.empty()) return false;
+            // hand the caller's old allocation back to the decoder in exchange
+            std::swap(out_frame, m_queue.front());
+            if (0 != m_queue.front().texels.capacity()) m_recycledFrames.push_back(std::move(m_queue.front()));
+            m_queue.pop_front();
+        }
+        m_spaceAvailable.notify_one();
+        return true;
+    }
+
+    void HeightmapSequence::seek(unsigned int const frameIndex) {
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            for (HeightmapFrame &frame : m_queue) m_recycledFrames.push_back(std::move(frame));
+            m_queue.clear();
+            m_nextDecodeIndex = frameIndex % getFrameCount();
+            ++m_seekGeneration;
+        }
+        m_spaceAvailable.notify_one();
+    }
+
+    void HeightmapSequence::decodeLoop() {
+        //NOTE: the render thread's loads toggle the global flip flag (2D textures flip, cubemaps don't), so this thread pins its own copy to "unflipped" and does the flip itself
+        stbi_set_flip_vertically_on_load_thread(0);
+
+        unsigned int consecutiveFailureCount{0};
+        std::unique_lock<std::mutex> lock{m_mutex};
+        while (true) {
+            m_spaceAvailable.wait(lock, [this]() { return m_isStopping || m_queue.size() < m_queueCapacity; });
+            if (m_isStopping) return;
+
+            unsigned int const frameIndex{m_nextDecodeIndex};
+            unsigned int const seekGeneration{m_seekGeneration};
+            HeightmapFrame frame;
+            if (!m_recycledFrames.empty()) {
+                frame = std::move(m_recycledFrames.back());
+                m_recycledFrames.pop_back();
+            }
+            m_decodingFrameCount = 1;
+
+            // decode without holding the lock, so the render thread never waits on it...
+            lock.unlock();
+            bool const isDecoded{decodeFrame(frameIndex, frame)};
+            lock.lock();
+
+            m_decodingFrameCount = 0;
+            // a seek happened in the meantime, so this frame is no longer the one wanted next
+            if (seekGeneration != m_seekGeneration) {
+                m_recycledFrames.push_back(std::move(frame));
+                continue;
+            }
+
+            m_nextDecodeIndex = (frameIndex + 1) % getFrameCount();
+            if (isDecoded) {
+                consecutiveFailureCount = 0;
+                frame.index = frameIndex;
+                m_queue.push_back(std::move(frame));
+            } else {
+                // a broken frame is skipped (playback will hold the previous frame over it)
+                m_recycledFrames.push_back(std::move(frame));
+                if (++consecutiveFailureCount == getFrameCount()) {
+                    std::cout << "ERROR: heightmap-sequence.cpp - no frame could be decoded, stopping the decoder!" << std::endl;
+                    return;
+                }
+            }
+        }
+    }
+
+    bool HeightmapSequence::decodeFrame(unsigned int const frameIndex, HeightmapFrame &out_frame) const {
+        std::string const& path{m_framePaths.at(frameIndex)};
+
+        // decoded top row first (the decoder thread's flip flag is pinned off), then flipped below so the bottom row comes first
+        int width{0};
+        int height{0};
+        int channelCount{0};
+        void *data{2 == m_bytesPerTexel ? (void*)stbi_load_16(path.c_str(), &width, &height, &channelCount, 0) : (void*)stbi_load(path.c_str(), &width, &height, &channelCount, 0)};
+        if (nullptr == data || (unsigned int)width != m_width || (unsigned int)height != m_height) {
+            std::cout << "ERROR: heightmap-sequence.cpp - failed to decode frame: " << path << std::endl;
+            stbi_image_free(data);
+            return false;
+        }
+
+        out_frame.texels.resize(getFrameSizeInBytes());
+        std::size_t const sourceStride{(std::size_t)channelCount};
+        for (unsigned int row = 0; row < m_height; ++row) {
+            std::size_t const sourceRowBegin{(std::size_t)(m_height - 1 - row) * m_width * sourceStride};
+            std::size_t const destinationRowBegin{(std::size_t)row * m_width};
+            // keep only the first channel...
+            if (2 == m_bytesPerTexel) {
+                stbi_us const* source{(stbi_us const*)data + sourceRowBegin};
+                stbi_us *destination{(stbi_us*)out_frame.texels.data() + destinationRowBegin};
+                for (unsigned int column = 0; column < m_width; ++column) destination[column] = source[column * sourceStride];
+            } else {
+                stbi_uc const* source{(stbi_uc const*)data + sourceRowBegin};
+                stbi_uc *destination{out_frame.texels.data() + destinationRowBegin};
+                for (unsigned int column = 0; column < m_width; ++column) destination[column] = source[column * sourceStride];
+            }
+        }
+
+        stbi_image_free(data);
+        return true;
+    }
+}
@@ -0,0 +1,110 @@
+#ifndef WAVE_TOOL_HEIGHTMAP_SEQUENCE_H_
+#define WAVE_TOOL_HEIGHTMAP_SEQUENCE_H_
+
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace wave_tool {
+    // one decoded frame of a HeightmapSequence
+    struct HeightmapFrame {
+        unsigned int index{0};
+        // width x height texels of getBytesPerTexel() each (native-endian for 16-bit), bottom row first (ready for glTexSubImage2D)
+        std::vector<unsigned char> texels;
+    };
+
+    // streams a numbered image sequence (e.g. 00.png, 01.png, ...) as single-channel R8/R16 frames
+    // frames are decoded in playback order (looping) on a background thread into a small bounded queue, so the render thread only ever pops ready frames
+    //NOTE: only the first channel of each image is kept (the same channel the water shader reads)
+    //NOTE: peekNextFrameIndex(), tryPopFrame() and seek() are meant to be called from a single (render) thread
+    class HeightmapSequence {
+        public:
+            inline static unsigned int const DEFAULT_QUEUE_CAPACITY{4};
+
+            // pathPattern is printf-style with a single unsigned int for the frame index (e.g. "waves3/%02u.png"), frames are counted from 0 until the first one that can't be read
+            // returns null if frame 0 can't be read, or if the frames don't all share the same size and bit depth
+            static std::unique_ptr<HeightmapSequence> open(std::string const& pathPattern, unsigned int const queueCapacity = DEFAULT_QUEUE_CAPACITY);
+
+            ~HeightmapSequence();
+
+            HeightmapSequence(HeightmapSequence const&) = delete;
+            HeightmapSequence& operator=(HeightmapSequence const&) = delete;
+
+            inline unsigned int getFrameCount() const { return (unsigned int)m_framePaths.size(); }
+            inline unsigned int getWidth() const { return m_width; }
+            inline unsigned int getHeight() const { return m_height; }
+            // 1 (R8) or 2 (R16)
+            inline unsigned int getBytesPerTexel() const { return m_bytesPerTexel; }
+            inline std::size_t getFrameSizeInBytes() const { return (std::size_t)m_width * m_height * m_bytesPerTexel; }
+            // CPU memory currently held by decoded frames (queued + being decoded + spare allocations), not counting a frame held by the caller
+            std::size_t getMemoryInBytes() const;
+
+            // non-blocking, returns false if no frame has been decoded yet
+            bool peekNextFrameIndex(unsigned int &out_frameIndex) const;
+            // non-blocking, returns false if no frame has been decoded yet (out_frame is left untouched)
+            //NOTE: out_frame's previous allocation is handed back to the decoder for reuse, so popping into the same frame every time allocates nothing once warmed up
+            bool tryPopFrame(HeightmapFrame &out_frame);
+            // drops everything queued and restarts decoding at frameIndex (mod the frame count)
+            void seek(unsigned int const frameIndex);
+        private:
+            HeightmapSequence(std::vector<std::string> &&framePaths, unsigned int const width, unsigned int const height, unsigned int const bytesPerTexel, unsigned int const queueCapacity);
+
+            void decodeLoop();
+            bool decodeFrame(unsigned int const frameIndex, HeightmapFrame &out_frame) const;
+
+            std::vector<std::string> m_framePaths;
+            unsigned int m_width{0};
+            unsigned int m_height{0};
+            unsigned int m_bytesPerTexel{1};
+            unsigned int m_queueCapacity{DEFAULT_QUEUE_CAPACITY};
+
+            mutable std::mutex m_mutex;
+            std::condition_variable m_spaceAvailable;
+            std::deque<HeightmapFrame> m_queue;
+            std::vector<HeightmapFrame> m_recycledFrames;
+            unsigned int m_nextDecodeIndex{0};
+            unsigned int m_seekGeneration{0}; // incremented per seek(), so a decode that was in flight during a seek can be thrown away
+            unsigned int m_decodingFrameCount{0}; // 0 or 1, for memory reporting
+            bool m_isStopping{false};
+            std::thread m_decoder;
+    };
+}
+
+#endif // WAVE_TOOL_HEIGHTMAP_SEQUENCE_H_
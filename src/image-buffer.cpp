@@ -50,6 +50,8 @@
 
 #include "image-buffer.h"
 
+#include "gl-state-cache.h"
+
 #include <algorithm>
 #include <iostream>
 
@@ -137,11 +139,11 @@ namespace wave_tool {
 
     void ImageBuffer::Destroy() {
         if (m_framebufferObject) {
-            glDeleteFramebuffers(1, &m_framebufferObject);
+            GLStateCache::deleteFramebuffers(1, &m_framebufferObject);
             m_framebufferObject = 0;
         }
         if (m_textureName) {
-            glDeleteTextures(1, &m_textureName);
+            GLStateCache::deleteTextures(1, &m_textureName);
             m_textureName = 0;
         }
     }
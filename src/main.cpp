@@ -37,6 +37,7 @@
 #include <string>
 #include <vector>
 
+#include "benchmarks.h"
 #include "program.h"
 
 //NOTE: apparently this is the proper way to forward declare namespaced-functions (you can't do "int wave_tool::program(int argc, char *argv[]);")
@@ -55,9 +56,43 @@ namespace wave_tool {
     // user-defined program...
     int program(int argc, char *argv[]) {
         // handle cmd-line args/options...
+        // --benchmark <name> [args...] runs a headless benchmark instead of the application
+        if (argc >= 3 && std::string{"--benchmark"} == argv[1]) return benchmarks::run(argv[2], argc - 3, argv + 3);
+
+        // --local-reflections-downscale <1|2|4> / --local-refractions-downscale <1|2|4> set the size of the local passes (see RenderEngine)
+        // --gpu-benchmark <name> runs a GPU benchmark in the application's window, then exits (see GPUBenchmark)
+        ProgramOptions options;
+        for (int i{1}; i < argc; ++i) {
+            std::string const option{argv[i]};
+            if ("--gpu-benchmark" == option) {
+                if (i + 1 >= argc) {
+                    std::cout << "ERROR: main.cpp - " << option << " expects a benchmark name" << std::endl;
+                    return EXIT_FAILURE;
+                }
+                options.gpuBenchmark = argv[++i];
+                continue;
+            }
+
+            unsigned int *downscale{nullptr};
+            if ("--local-reflections-downscale" == option) downscale = &options.localReflectionsDownscale;
+            else if ("--local-refractions-downscale" == option) downscale = &options.localRefractionsDownscale;
+            else {
+                std::cout << "ERROR: main.cpp - unknown option " << option << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            std::string const value{i + 1 < argc ? argv[++i] : ""};
+            if ("1" == value) *downscale = 1;
+            else if ("2" == value) *downscale = 2;
+            else if ("4" == value) *downscale = 4;
+            else {
+                std::cout << "ERROR: main.cpp - " << option << " expects 1, 2 or 4" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
 
         // execute the rest of your program...
-        Program program;
+        Program program{options};
         bool const programResult = program.start();
 
         return programResult ? EXIT_SUCCESS : EXIT_FAILURE;
@@ -31,6 +31,8 @@
 
 #include "mesh-object.h"
 
+#include "gl-state-cache.h"
+
 #include <glm/gtx/transform.hpp>
 
 namespace wave_tool {
@@ -49,10 +51,10 @@ namespace wave_tool {
         glDeleteBuffers(1, &normalBuffer);
         glDeleteBuffers(1, &colourBuffer);
         glDeleteBuffers(1, &indexBuffer);
-        glDeleteVertexArrays(1, &vao);
+        GLStateCache::deleteVertexArrays(1, &vao);
 
         // delete the texture object since it never gets reused...
-        glDeleteTextures(1, &textureID);
+        GLStateCache::deleteTextures(1, &textureID);
     }
 
     void MeshObject::updateModel() {
@@ -0,0 +1,243 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include "ocean-fft.h"
+
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <random>
+
+#include "thread-pool.h"
+
+namespace wave_tool {
+    float const OceanFFT::GRAVITY{9.81f};
+
+    bool OceanFFTParameters::operator==(OceanFFTParameters const& other) const {
+        return resolution == other.resolution &&
+               patchLength == other.patchLength &&
+               spectrum == other.spectrum &&
+               windSpeed == other.windSpeed &&
+               windDirectionInDegrees == other.windDirectionInDegrees &&
+               amplitudeScale == other.amplitudeScale &&
+               choppiness == other.choppiness &&
+               jonswapFetch == other.jonswapFetch &&
+               jonswapPeakEnhancement == other.jonswapPeakEnhancement &&
+               smallWaveCutoff == other.smallWaveCutoff &&
+               seed == other.seed;
+    }
+
+    OceanFFT::OceanFFT(OceanFFTParameters const& parameters, std::shared_ptr<ThreadPool> threadPool)
+        : m_parameters(parameters), m_threadPool(threadPool)
+    {
+        // force an initial generation
+        m_parameters.resolution = 0;
+        setParameters(parameters);
+    }
+
+    bool OceanFFT::setParameters(OceanFFTParameters const& parameters) {
+        if (parameters == m_parameters) return false;
+        assert(parameters.resolution >= 2 && 0 == (parameters.resolution & (parameters.resolution - 1)));
+        assert(parameters.patchLength > 0.0f);
+
+        bool const isResizing{parameters.resolution != m_parameters.resolution};
+        m_parameters = parameters;
+
+        if (isResizing) {
+            std::size_t const texelCount{(std::size_t)m_parameters.resolution * m_parameters.resolution};
+            m_fft = std::make_unique<FFT>(m_parameters.resolution);
+            m_angularFrequencies.assign(texelCount, 0.0f);
+            m_h0Real.assign(texelCount, 0.0f);
+            m_h0Imaginary.assign(texelCount, 0.0f);
+            m_h0MinusKConjugateReal.assign(texelCount, 0.0f);
+            m_h0MinusKConjugateImaginary.assign(texelCount, 0.0f);
+            for (unsigned int i = 0; i < FFT_COUNT_PER_UPDATE; ++i) {
+                m_fftReal[i].assign(texelCount, 0.0f);
+                m_fftImaginary[i].assign(texelCount, 0.0f);
+            }
+            m_rowMaxHeights.assign(m_parameters.resolution, 0.0f);
+            m_rowMaxHorizontalDisplacements.assign(m_parameters.resolution, 0.0f);
+            m_displacements.assign(texelCount, glm::vec4{0.0f});
+            m_normals.assign(texelCount, glm::vec4{0.0f, 1.0f, 0.0f, 0.0f});
+        }
+
+        generateInitialSpectrum();
+
+        return isResizing;
+    }
+
+    // returns the directional wave energy spectrum E(k) (m^4), so that the variance of the height field is the integral of E over all k
+    float OceanFFT::evaluateSpectrum(glm::vec2 const& k) const {
+        float const kLength{glm::length(k)};
+        if (kLength < 0.000001f) return 0.0f;
+
+        float const windDirectionInRadians{glm::radians(m_parameters.windDirectionInDegrees)};
+        glm::vec2 const windDirection{glm::cos(windDirectionInRadians), glm::sin(windDirectionInRadians)};
+        float const cosTheta{glm::dot(k / kLength, windDirection)};
+        float const smallWaveDamping{glm::exp(-kLength * kLength * m_parameters.smallWaveCutoff * m_parameters.smallWaveCutoff)};
+
+        if (OceanSpectrum::PHILLIPS == m_parameters.spectrum) {
+            // reference: Tessendorf eq. 40 - 41
+            //NOTE: the constant here was picked so the default settings give roughly 1 unit tall crests with the default patch/wind (this is an artistic spectrum anyways)
+            float const PHILLIPS_CONSTANT{0.0005f};
+            float const largestWavelength_L{m_parameters.windSpeed * m_parameters.windSpeed / GRAVITY};
+            float const kL{kLength * largestWavelength_L};
+            return PHILLIPS_CONSTANT * glm::exp(-1.0f / (kL * kL)) / (kLength * kLength * kLength * kLength) * cosTheta * cosTheta * smallWaveDamping;
+        }
+
+        // JONSWAP frequency spectrum S(omega), converted to wavenumber with E(k) = S(omega(k)) x (d omega / dk) / k x D(theta)
+        // reference: https://wikiwaves.org/Ocean-Wave_Spectra
+        float const omega{glm::sqrt(GRAVITY * kLength)};
+        float const windSpeed{glm::max(m_parameters.windSpeed, 0.001f)};
+        float const fetch{glm::max(m_parameters.jonswapFetch, 0.001f)};
+        float const alpha{0.076f * glm::pow(windSpeed * windSpeed / (fetch * GRAVITY), 0.22f)};
+        float const peakOmega{22.0f * glm::pow(GRAVITY * GRAVITY / (windSpeed * fetch), 1.0f / 3.0f)};
+        float const sigma{omega <= peakOmega ? 0.07f : 0.09f};
+        float const peakExponent{glm::exp(-(omega - peakOmega) * (omega - peakOmega) / (2.0f * sigma * sigma * peakOmega * peakOmega))};
+        float const omegaRatio{peakOmega / omega};
+        float const S{alpha * GRAVITY * GRAVITY / glm::pow(omega, 5.0f) * glm::exp(-1.25f * omegaRatio * omegaRatio * omegaRatio * omegaRatio) * glm::pow(glm::max(m_parameters.jonswapPeakEnhancement, 1.0f), peakExponent)};
+        float const dOmega_dk{GRAVITY / (2.0f * omega)};
+        // cos^2 spreading (normalized over the half-plane facing the wind)
+        float const D{cosTheta > 0.0f ? (2.0f / glm::pi<float>()) * cosTheta * cosTheta : 0.0f};
+        return S * dOmega_dk / kLength * D * smallWaveDamping;
+    }
+
+    void OceanFFT::generateInitialSpectrum() {
+        unsigned int const N{m_parameters.resolution};
+        float const deltaK{glm::two_pi<float>() / m_parameters.patchLength};
+
+        //NOTE: generated serially so that a seed always gives the same ocean (regardless of thread count)
+        std::mt19937 generator{m_parameters.seed};
+        std::normal_distribution<float> gaussian{0.0f, 1.0f};
+        for (unsigned int m = 0; m < N; ++m) {
+            for (unsigned int n = 0; n < N; ++n) {
+                std::size_t const i{(std::size_t)m * N + n};
+                glm::vec2 const k{deltaK * ((int)n - (int)N / 2), deltaK * ((int)m - (int)N / 2)};
+                // h0(k) = (xi_r + i x xi_i) x sqrt(E(k) / 2) x dk (Tessendorf eq. 42, with the spectrum in absolute units)
+                float const amplitude{m_parameters.amplitudeScale * glm::sqrt(0.5f * evaluateSpectrum(k)) * deltaK};
+                float const xi_r{gaussian(generator)};
+                float const xi_i{gaussian(generator)};
+                m_h0Real.at(i) = xi_r * amplitude;
+                m_h0Imaginary.at(i) = xi_i * amplitude;
+                m_angularFrequencies.at(i) = glm::sqrt(GRAVITY * glm::length(k));
+            }
+        }
+
+        for (unsigned int m = 0; m < N; ++m) {
+            for (unsigned int n = 0; n < N; ++n) {
+                std::size_t const minusKIndex{(std::size_t)((N - m) % N) * N + (N - n) % N};
+                m_h0MinusKConjugateReal.at((std::size_t)m * N + n) = m_h0Real.at(minusKIndex);
+                m_h0MinusKConjugateImaginary.at((std::size_t)m * N + n) = -m_h0Imaginary.at(minusKIndex);
+            }
+        }
+    }
+
+    void OceanFFT::update(float const timeInSeconds) {
+        unsigned int const N{m_parameters.resolution};
+        float const deltaK{glm::two_pi<float>() / m_parameters.patchLength};
+
+        // 1. evolve the spectrum to this time and pack the 5 real fields into 3 complex spectra...
+        parallelFor(N, [&](std::size_t const begin, std::size_t const end) {
+            for (std::size_t m = begin; m < end; ++m) {
+                float const kz{deltaK * ((int)m - (int)N / 2)};
+                for (unsigned int n = 0; n < N; ++n) {
+                    std::size_t const i{m * N + n};
+                    float const kx{deltaK * ((int)n - (int)N / 2)};
+                    float const kLength{glm::sqrt(kx * kx + kz * kz)};
+                    float const kxUnit{kLength > 0.0f ? kx / kLength : 0.0f};
+                    float const kzUnit{kLength > 0.0f ? kz / kLength : 0.0f};
+
+                    // h(k, t) = h0(k) x exp(i x omega x t) + conj(h0(-k)) x exp(-i x omega x t) (Tessendorf eq. 43)
+                    float const omegaT{m_angularFrequencies[i] * timeInSeconds};
+                    float const c{std::cos(omegaT)};
+                    float const s{std::sin(omegaT)};
+                    float const hRe{m_h0Real[i] * c - m_h0Imaginary[i] * s + m_h0MinusKConjugateReal[i] * c + m_h0MinusKConjugateImaginary[i] * s};
+                    float const hIm{m_h0Real[i] * s + m_h0Imaginary[i] * c + m_h0MinusKConjugateImaginary[i] * c - m_h0MinusKConjugateReal[i] * s};
+
+                    // choppy displacement D(k) = -i x (k / |k|) x h(k) (Tessendorf eq. 44)
+                    float const dispXRe{kxUnit * hIm}, dispXIm{-kxUnit * hRe};
+                    float const dispZRe{kzUnit * hIm}, dispZIm{-kzUnit * hRe};
+                    // slope = i x k x h(k) (Tessendorf eq. 37)
+                    float const slopeXRe{-kx * hIm}, slopeXIm{kx * hRe};
+                    float const slopeZRe{-kz * hIm}, slopeZIm{kz * hRe};
+
+                    // A + i x B (both real in the spatial domain, so they come back out as the real/imaginary parts)
+                    m_fftReal[0][i] = hRe - dispXIm;
+                    m_fftImaginary[0][i] = hIm + dispXRe;
+                    m_fftReal[1][i] = dispZRe - slopeXIm;
+                    m_fftImaginary[1][i] = dispZIm + slopeXRe;
+                    m_fftReal[2][i] = slopeZRe;
+                    m_fftImaginary[2][i] = slopeZIm;
+                }
+            }
+        });
+
+        // 2. back to the spatial domain...
+        for (unsigned int i = 0; i < FFT_COUNT_PER_UPDATE; ++i) m_fft->transform2D(m_fftReal[i].data(), m_fftImaginary[i].data(), true, m_threadPool.get());
+
+        // 3. unpack into the output textures...
+        float const choppiness{m_parameters.choppiness};
+        parallelFor(N, [&](std::size_t const begin, std::size_t const end) {
+            for (std::size_t z = begin; z < end; ++z) {
+                float rowMaxHeight{0.0f};
+                float rowMaxHorizontalDisplacement{0.0f};
+                for (unsigned int x = 0; x < N; ++x) {
+                    std::size_t const i{z * N + x};
+                    // undo the centering of k (the transform assumed k starts at 0, not at -N/2)
+                    float const sign{(0 == ((x + z) & 1)) ? 1.0f : -1.0f};
+                    float const height{sign * m_fftReal[0][i]};
+                    float const dispX{sign * choppiness * m_fftImaginary[0][i]};
+                    float const dispZ{sign * choppiness * m_fftReal[1][i]};
+                    float const slopeX{sign * m_fftImaginary[1][i]};
+                    float const slopeZ{sign * m_fftReal[2][i]};
+
+                    m_displacements[i] = glm::vec4{dispX, height, dispZ, 0.0f};
+                    m_normals[i] = glm::vec4{glm::normalize(glm::vec3{-slopeX, 1.0f, -slopeZ}), 0.0f};
+                    rowMaxHeight = glm::max(rowMaxHeight, glm::abs(height));
+                    rowMaxHorizontalDisplacement = glm::max(rowMaxHorizontalDisplacement, glm::max(glm::abs(dispX), glm::abs(dispZ)));
+                }
+                m_rowMaxHeights[z] = rowMaxHeight;
+                m_rowMaxHorizontalDisplacements[z] = rowMaxHorizontalDisplacement;
+            }
+        });
+
+        m_maxHeight = *std::max_element(m_rowMaxHeights.begin(), m_rowMaxHeights.end());
+        m_maxHorizontalDisplacement = *std::max_element(m_rowMaxHorizontalDisplacements.begin(), m_rowMaxHorizontalDisplacements.end());
+    }
+
+    void OceanFFT::parallelFor(std::size_t const count, std::function<void(std::size_t const begin, std::size_t const end)> const& task) const {
+        if (nullptr != m_threadPool) m_threadPool->parallelFor(count, 0, task);
+        else task(0, count);
+    }
+}
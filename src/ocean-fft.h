@@ -0,0 +1,127 @@
+#ifndef WAVE_TOOL_OCEAN_FFT_H_
+#define WAVE_TOOL_OCEAN_FFT_H_
+
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <glm/glm.hpp>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "fft.h"
+
+namespace wave_tool {
+    class ThreadPool;
+
+    enum OceanSpectrum {
+        PHILLIPS = 0,
+        JONSWAP = 1
+    };
+
+    struct OceanFFTParameters {
+        unsigned int resolution{256}; // power of 2 in range [2, inf), the number of samples along each side of the patch
+        float patchLength{64.0f}; // in range (0.0, inf), world-space side length of the (tiling) patch
+        OceanSpectrum spectrum{OceanSpectrum::PHILLIPS};
+        float windSpeed{8.0f}; // in range (0.0, inf), m/s at 10m above the surface
+        float windDirectionInDegrees{0.0f}; // in range [0.0, 360.0), measured from +X towards +Z
+        float amplitudeScale{1.0f}; // in range [0.0, inf), artistic multiplier on the spectrum amplitudes
+        float choppiness{1.0f}; // in range [0.0, inf), lambda scaling of the horizontal displacement
+        float jonswapFetch{100000.0f}; // in range (0.0, inf), distance (m) over which the wind has blown
+        float jonswapPeakEnhancement{3.3f}; // in range [1.0, inf), gamma
+        float smallWaveCutoff{0.01f}; // in range [0.0, inf), wavelengths shorter than roughly this (m) are damped out
+        unsigned int seed{0};
+
+        bool operator==(OceanFFTParameters const& other) const;
+        inline bool operator!=(OceanFFTParameters const& other) const { return !(*this == other); }
+    };
+
+    // statistical ocean surface, evolved entirely on the CPU
+    // reference: https://people.cs.clemson.edu/~jtessen/reports/papers_files/coursenotes2004.pdf (Tessendorf - Simulating Ocean Water)
+    // reference: https://www.researchgate.net/publication/264839743_Simulating_Ocean_Water (JONSWAP, section 3)
+    //NOTE: each update runs 3 inverse FFTs by packing 2 real fields per complex transform - (height + i x dispX), (dispZ + i x slopeX), (slopeZ)
+    class OceanFFT {
+        public:
+            // number of 2D FFTs per update() (for throughput reporting)
+            static unsigned int const FFT_COUNT_PER_UPDATE{3};
+
+            //NOTE: a null threadPool runs single-threaded
+            OceanFFT(OceanFFTParameters const& parameters, std::shared_ptr<ThreadPool> threadPool);
+
+            inline OceanFFTParameters const& getParameters() const { return m_parameters; }
+            // regenerates the initial spectrum only if something changed, returns true if the resolution changed (textures need reallocating)
+            bool setParameters(OceanFFTParameters const& parameters);
+
+            // evaluates the surface at the given time, the results are available from the getters below until the next update
+            void update(float const timeInSeconds);
+
+            // resolution x resolution texels, row-major (row = z), texel (x, z) is at world-space (x, z) x patchLength / resolution
+            // xyz = displacement (choppy x, height, choppy z), w = 0
+            inline std::vector<glm::vec4> const& getDisplacements() const { return m_displacements; }
+            // xyz = unit surface normal, w = 0
+            inline std::vector<glm::vec4> const& getNormals() const { return m_normals; }
+            // the largest |height| and the largest |horizontal displacement| of the last update (used to bound the projected grid volume)
+            inline float getMaxHeight() const { return m_maxHeight; }
+            inline float getMaxHorizontalDisplacement() const { return m_maxHorizontalDisplacement; }
+        private:
+            static float const GRAVITY;
+
+            OceanFFTParameters m_parameters;
+            std::shared_ptr<ThreadPool> m_threadPool = nullptr;
+            std::unique_ptr<FFT> m_fft = nullptr;
+
+            // per-frequency constants (centered, index n -> k = 2 x pi x (n - resolution / 2) / patchLength)
+            std::vector<float> m_angularFrequencies; // omega(k), deep water dispersion
+            std::vector<float> m_h0Real; // h0(k)
+            std::vector<float> m_h0Imaginary;
+            std::vector<float> m_h0MinusKConjugateReal; // conj(h0(-k))
+            std::vector<float> m_h0MinusKConjugateImaginary;
+
+            // FFT work buffers (3 packed transforms)
+            std::vector<float> m_fftReal[FFT_COUNT_PER_UPDATE];
+            std::vector<float> m_fftImaginary[FFT_COUNT_PER_UPDATE];
+            std::vector<float> m_rowMaxHeights;
+            std::vector<float> m_rowMaxHorizontalDisplacements;
+
+            std::vector<glm::vec4> m_displacements;
+            std::vector<glm::vec4> m_normals;
+            float m_maxHeight{0.0f};
+            float m_maxHorizontalDisplacement{0.0f};
+
+            void generateInitialSpectrum();
+            float evaluateSpectrum(glm::vec2 const& k) const;
+            void parallelFor(std::size_t const count, std::function<void(std::size_t const begin, std::size_t const end)> const& task) const;
+    };
+}
+
+#endif // WAVE_TOOL_OCEAN_FFT_H_
@@ -41,6 +41,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <string>
 
 #include <imgui/imgui.h>
@@ -52,15 +53,19 @@
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 
+#include "gpu-benchmark.h"
 #include "image-buffer.h"
 #include "input-handler.h"
 #include "mesh-object.h"
 #include "object-loader.h"
 #include "render-engine.h"
+#include "water-grid.h"
 
 namespace wave_tool {
     Program::Program() {}
 
+    Program::Program(ProgramOptions const& options) : m_options(options) {}
+
     Program::~Program() {}
 
     std::shared_ptr<RenderEngine> Program::getRenderEngine() const {
@@ -71,9 +76,20 @@ namespace wave_tool {
         if (!setupWindow()) return false;
 
         m_renderEngine = std::make_shared<RenderEngine>(m_window);
+        m_renderEngine->localReflectionsDownscale = m_options.localReflectionsDownscale;
+        m_renderEngine->localRefractionsDownscale = m_options.localRefractionsDownscale;
 
         initScene();
 
+        std::unique_ptr<GPUBenchmark> gpuBenchmark{nullptr};
+        if (!m_options.gpuBenchmark.empty()) {
+            gpuBenchmark = GPUBenchmark::create(m_options.gpuBenchmark);
+            if (nullptr == gpuBenchmark) {
+                cleanup();
+                return false;
+            }
+        }
+
         //image.Initialize();
         //do a bunch of raytracing into texture
         //image.SaveToFile("image.png"); // no need to put in loop since we dont update image
@@ -88,6 +104,9 @@ namespace wave_tool {
 
             buildUI();
 
+            // a GPU benchmark sets the RenderEngine up for each of its cases in turn, then ends the program
+            if (nullptr != gpuBenchmark && !gpuBenchmark->update(*m_renderEngine)) break;
+
             // rendering...
             ImGui::Render();
             //image.Render();
@@ -195,6 +214,68 @@ namespace wave_tool {
         if (ImGui::Button("LOCAL REFLECTIONS##0")) m_renderEngine->renderMode = RenderMode::LOCAL_REFLECTIONS;
         ImGui::SameLine();
         if (ImGui::Button("LOCAL REFRACTIONS##0")) m_renderEngine->renderMode = RenderMode::LOCAL_REFRACTIONS;
+        ImGui::SameLine();
+        if (ImGui::Button("WORLD-SPACE DEPTH##0")) m_renderEngine->renderMode = RenderMode::WORLD_SPACE_DEPTH;
+        ImGui::Text("UNIFORM UPLOADS: %u (%u SKIPPED AS UNCHANGED)", m_renderEngine->getIssuedUniformCount(), m_renderEngine->getSkippedUniformCount());
+        ImGui::Text("GL STATE CALLS: %u (%u FILTERED AS REDUNDANT)", m_renderEngine->getIssuedGLStateCallCount(), m_renderEngine->getFilteredGLStateCallCount());
+        ImGui::Text("VALIDATE GL STATE:");
+        ImGui::SameLine();
+        if (ImGui::Button("ON##glstate")) m_renderEngine->isValidatingGLState = true;
+        ImGui::SameLine();
+        if (ImGui::Button("OFF##glstate")) m_renderEngine->isValidatingGLState = false;
+        ImGui::SameLine();
+        ImGui::TextDisabled("(?)");
+        if (ImGui::IsItemHovered()) ImGui::SetTooltip("note: compares the cached GL state against the driver's at the end of each frame (slow, mismatches are printed).");
+        if (m_renderEngine->isValidatingGLState) {
+            ImGui::SameLine();
+            ImGui::Text("%u MISMATCHES", m_renderEngine->getGLStateMismatchCount());
+        }
+        ImGui::Text("SCENE BLOCKS: %.1f KiB (%u RANGE BINDS)", m_renderEngine->getSceneBlocksSizeInBytes() / 1024.0f, m_renderEngine->getSceneBlockBindCount());
+        ImGui::SameLine();
+        ImGui::TextDisabled("(?)");
+        if (ImGui::IsItemHovered()) ImGui::SetTooltip("note: the frame and pass uniform blocks written to 1 uniform buffer per frame (then bound by offset per pass), plus the per-object data fetched by object index (see object-data.glsl).");
+        ImGui::Text("BATCH SCENE DRAWS:");
+        ImGui::SameLine();
+        if (ImGui::Button("ON##batch")) m_renderEngine->isBatchingSceneDraws = true;
+        ImGui::SameLine();
+        if (ImGui::Button("OFF##batch")) m_renderEngine->isBatchingSceneDraws = false;
+        ImGui::SameLine();
+        ImGui::TextDisabled("(?)");
+        if (ImGui::IsItemHovered()) ImGui::SetTooltip("note: the objects are sorted by program, texture, VAO and depth either way. ON packs their meshes into shared buffers (%.1f KiB) and draws each run of same-state objects with 1 multi-draw, OFF draws them 1 by 1 from their own VAOs. Run with --benchmark render-queue for a stress scene.", m_renderEngine->getSceneBatchSizeInBytes() / 1024.0f);
+        ImGui::Text("SCENE DRAWS: %u CALLS FOR %u OBJECT DRAWS (ALL PASSES)", m_renderEngine->getSceneDrawCallCount(), m_renderEngine->getSceneObjectDrawCount());
+        ImGui::Text("SCENE PASSES: %u / 5", m_renderEngine->getScenePassCount());
+        ImGui::SameLine();
+        ImGui::TextDisabled("(?)");
+        if (ImGui::IsItemHovered()) ImGui::SetTooltip("note: the local reflections, local refractions and depth passes are only rendered while some water is in view (or while their debug render mode shows them), the world-space depth pass only while its debug render mode shows it.");
+        FrameGraph const& frameGraph{m_renderEngine->getFrameGraph()};
+        ImGui::Text("FRAME GRAPH: %u / %u PASSES, %.1f MiB TRANSIENT (%.1f MiB UNALIASED)", frameGraph.getLivePassCount(), frameGraph.getPassCount(), frameGraph.getAliasedSizeInBytes() / (1024.0f * 1024.0f), frameGraph.getTransientSizeInBytes() / (1024.0f * 1024.0f));
+        ImGui::SameLine();
+        if (ImGui::Button("DUMP##framegraph")) m_renderEngine->isDumpingFrameGraph = true;
+        ImGui::SameLine();
+        ImGui::TextDisabled("(?)");
+        if (ImGui::IsItemHovered()) ImGui::SetTooltip("note: the passes that nothing visible depends on are culled, and the render targets whose lifetimes don't overlap share 1 texture. %.1f MiB of targets are pooled (an idle one is freed after %u frames). DUMP prints the passes, targets and memory use to stdout, run with --benchmark frame-graph for the other configurations.", frameGraph.getPooledSizeInBytes() / (1024.0f * 1024.0f), FrameGraph::MAX_IDLE_FRAMES);
+        ImGui::Text("LOCAL REFLECTIONS SCALE:");
+        ImGui::SameLine();
+        if (ImGui::Button("1##reflectionsscale")) m_renderEngine->localReflectionsDownscale = 1;
+        ImGui::SameLine();
+        if (ImGui::Button("1/2##reflectionsscale")) m_renderEngine->localReflectionsDownscale = 2;
+        ImGui::SameLine();
+        if (ImGui::Button("1/4##reflectionsscale")) m_renderEngine->localReflectionsDownscale = 4;
+        ImGui::SameLine();
+        ImGui::Text("%d x %d", m_renderEngine->getLocalReflectionsWidth(), m_renderEngine->getLocalReflectionsHeight());
+        ImGui::Text("LOCAL REFRACTIONS SCALE:");
+        ImGui::SameLine();
+        if (ImGui::Button("1##refractionsscale")) m_renderEngine->localRefractionsDownscale = 1;
+        ImGui::SameLine();
+        if (ImGui::Button("1/2##refractionsscale")) m_renderEngine->localRefractionsDownscale = 2;
+        ImGui::SameLine();
+        if (ImGui::Button("1/4##refractionsscale")) m_renderEngine->localRefractionsDownscale = 4;
+        ImGui::SameLine();
+        ImGui::Text("%d x %d", m_renderEngine->getLocalRefractionsWidth(), m_renderEngine->getLocalRefractionsHeight());
+        ImGui::SameLine();
+        ImGui::TextDisabled("(?)");
+        if (ImGui::IsItemHovered()) ImGui::SetTooltip("note: the scale of each pass's width and height (1/2 is a quarter of the fill), the water then upsamples them depth-aware. Also settable with --local-reflections-downscale / --local-refractions-downscale <1|2|4>, run with --gpu-benchmark local-passes to time 1, 1/2 and 1/4.");
+        ImGui::Text("LOCAL PASSES: %.3f MS GPU", m_renderEngine->getLocalPassesGPUTimeInMilliseconds());
 
         ImGui::Separator();
 
@@ -224,6 +305,47 @@ namespace wave_tool {
             m_renderEngine->timeOfDayInHours = glm::mod(m_renderEngine->timeOfDayInHours, 24.0f);
         }
 
+        ImGui::Text("AMORTISE SKY CUBEMAP:");
+        ImGui::SameLine();
+        if (ImGui::Button("ON##skycubemap")) m_renderEngine->isAmortisingSkyCubemap = true;
+        ImGui::SameLine();
+        if (ImGui::Button("OFF##skycubemap")) m_renderEngine->isAmortisingSkyCubemap = false;
+        ImGui::SameLine();
+        ImGui::TextDisabled("(?)");
+        if (ImGui::IsItemHovered()) ImGui::SetTooltip("note: the sky cubemap is only re-rendered when the time of day, clouds, sun, fog or sky layers change. ON refreshes just 1 face per frame while the time of day animates, OFF refreshes all 6.");
+        ImGui::SameLine();
+        ImGui::Text("%u / 6 FACES RENDERED", m_renderEngine->getSkyCubemapFaceRenderCount());
+        ImGui::Text("LAYERED SKY CUBEMAP:");
+        ImGui::SameLine();
+        if (ImGui::Button("ON##skylayered")) m_renderEngine->isRenderingSkyCubemapLayered = true;
+        ImGui::SameLine();
+        if (ImGui::Button("OFF##skylayered")) m_renderEngine->isRenderingSkyCubemapLayered = false;
+        ImGui::SameLine();
+        ImGui::TextDisabled("(?)");
+        if (ImGui::IsItemHovered()) ImGui::SetTooltip("note: ON draws each sky layer once into all 6 faces (a geometry shader picks the face with gl_Layer) whenever the whole cubemap is re-rendered, OFF draws every layer once per face. Compare the GPU time of a full update (e.g. while dragging the time of day) with each, or run: wave-tool --gpu-benchmark sky-cubemap");
+        ImGui::SameLine();
+        ImGui::Text("LAST UPDATE: %.3f MS GPU", m_renderEngine->getSkyCubemapGPUTimeInMilliseconds());
+        ImGui::Text("SKY CUBEMAP LENGTH:");
+        ImGui::SameLine();
+        if (ImGui::Button("MATCH VIEWPORT##skylength")) m_renderEngine->isMatchingSkyCubemapToViewport = true;
+        for (GLsizei const length : {256, 512, 1024, 2048}) {
+            ImGui::SameLine();
+            std::string const label{std::to_string(length) + "##skylength"};
+            if (ImGui::Button(label.c_str())) {
+                m_renderEngine->isMatchingSkyCubemapToViewport = false;
+                m_renderEngine->skyCubemapLength = length;
+            }
+        }
+        ImGui::SameLine();
+        ImGui::TextDisabled("(?)");
+        if (ImGui::IsItemHovered()) ImGui::SetTooltip("note: MATCH VIEWPORT picks the smallest power of 2 with at least 1 texel per pixel at the centre of the view (from the window height and FOV). The fill is per sky layer (stars, skysphere, clouds, fog) of a full update.");
+        GLsizei const skyCubemapLength{m_renderEngine->getSkyCubemapLength()};
+        ImGui::Text("SKY CUBEMAP: %d x %d x 6, %.1f MiB WITH MIPS, %.1f MPIXELS FILL PER LAYER", skyCubemapLength, skyCubemapLength, m_renderEngine->getSkyCubemapSizeInBytes() / (1024.0f * 1024.0f), 6.0f * skyCubemapLength * skyCubemapLength / 1000000.0f);
+        if (ImGui::SliderFloat("SKY REFLECTION DISTANCE LOD", &m_renderEngine->skyReflectionDistanceLOD, 0.0f, 8.0f)) {
+            // force-clamp (handle CTRL + LEFT_CLICK)
+            if (m_renderEngine->skyReflectionDistanceLOD < 0.0f) m_renderEngine->skyReflectionDistanceLOD = 0.0f;
+        }
+
         if (ImGui::SliderFloat("CLOUD PROPORTION", &m_renderEngine->cloudProportion, 0.0f, 1.0f)) {
             // force-clamp (handle CTRL + LEFT_CLICK)
             m_renderEngine->cloudProportion = glm::clamp(m_renderEngine->cloudProportion, 0.0f, 1.0f);
@@ -359,53 +481,363 @@ namespace wave_tool {
                 if (ImGui::Button("FULL##4")) m_waterGrid->m_polygonMode = PolygonMode::FILL;
                 ImGui::SameLine();
                 if (ImGui::Button("WIREFRAME##4")) m_waterGrid->m_polygonMode = PolygonMode::LINE;
+                ImGui::Text("MODE:");
+                ImGui::SameLine();
+                if (ImGui::Button("PROJECTED GRID##4")) m_renderEngine->isUsingWaterClipmap = false;
+                ImGui::SameLine();
+                if (ImGui::Button("CLIPMAP##4")) m_renderEngine->isUsingWaterClipmap = true;
+                ImGui::SameLine();
+                ImGui::TextDisabled("(?)");
+                if (ImGui::IsItemHovered()) ImGui::SetTooltip("note: the projected grid spreads its vertices evenly over the visible water (in projector space), while the clipmap is a set of nested camera-centred rings that stay put in world-space (no swimming), each doubling the cell size of the last. Compare the counts and GPU draw time below between the two. The clipmap has a fixed resolution (the RESOLUTION settings only apply to the projected grid) and has no SURFACE CAPTURE.");
+                if (m_renderEngine->isUsingWaterClipmap) {
+                    if (ImGui::SliderFloat("CLIPMAP CELL SIZE##4", &m_renderEngine->waterClipmapBaseCellSize, 0.01f, 1.0f)) {
+                        // force-clamp (handle CTRL + LEFT_CLICK)
+                        if (m_renderEngine->waterClipmapBaseCellSize < 0.01f) m_renderEngine->waterClipmapBaseCellSize = 0.01f;
+                    }
+                    WaterClipmap const& waterClipmap{m_renderEngine->getWaterClipmap()};
+                    ImGui::Text("LEVELS: %u, TILES: %u of %u (%u culled)", waterClipmap.getLevelCount(), waterClipmap.getTileCount() - waterClipmap.getCulledTileCount(), waterClipmap.getTileCount(), waterClipmap.getCulledTileCount());
+                }
+                ImGui::Text("TESSELLATION:");
+                ImGui::SameLine();
+                if (ImGui::Button("ON##tess4")) m_renderEngine->isUsingWaterTessellation = true;
+                ImGui::SameLine();
+                if (ImGui::Button("OFF##tess4")) m_renderEngine->isUsingWaterTessellation = false;
+                ImGui::SameLine();
+                ImGui::TextDisabled("(?)");
+                if (ImGui::IsItemHovered()) ImGui::SetTooltip("note: ON draws the projected grid as a coarse 33 x 33 grid of patches, and lets the GPU subdivide each patch edge by its on-screen length (and the on-screen size of the waves), so only a few KB of indices are needed. Only applies to the projected grid, has no SURFACE CAPTURE and always uses the ANALYTIC normals. The triangle count below is read back from the GPU.");
+                if (m_renderEngine->isUsingWaterTessellation) {
+                    if (0 == m_renderEngine->getWaterGridTessellationProgram()) ImGui::Text("(tessellation shaders unavailable)");
+                    if (ImGui::SliderFloat("PIXELS PER SEGMENT##4", &m_renderEngine->waterTessellationPixelsPerSegment, 1.0f, 64.0f)) {
+                        // force-clamp (handle CTRL + LEFT_CLICK)
+                        if (m_renderEngine->waterTessellationPixelsPerSegment < 1.0f) m_renderEngine->waterTessellationPixelsPerSegment = 1.0f;
+                    }
+                    if (ImGui::SliderFloat("MIN AMPLITUDE IN PIXELS##4", &m_renderEngine->waterTessellationMinAmplitudeInPixels, 0.1f, 16.0f)) {
+                        // force-clamp (handle CTRL + LEFT_CLICK)
+                        if (m_renderEngine->waterTessellationMinAmplitudeInPixels < 0.1f) m_renderEngine->waterTessellationMinAmplitudeInPixels = 0.1f;
+                    }
+                    ImGui::Text("MAX LEVEL: %d", m_renderEngine->getMaxWaterTessellationLevel());
+                }
+                ImGui::Text("VERTICES: %u, TRIANGLES: %u, GPU DRAW: %.3f ms", m_renderEngine->getWaterVertexCount(), m_renderEngine->getWaterTriangleCount(), m_renderEngine->getWaterSurfaceDrawGPUTimeInMilliseconds());
+                if (!m_renderEngine->isUsingWaterClipmap) {
+                    ProjectedGrid &projectedGrid{m_renderEngine->getProjectedGrid()};
+                    ImGui::Text("GRID FIT:");
+                    ImGui::SameLine();
+                    if (ImGui::Button("BOUNDS##fit4")) projectedGrid.isUsingHullFit = false;
+                    ImGui::SameLine();
+                    if (ImGui::Button("HULL QUAD##fit4")) projectedGrid.isUsingHullFit = true;
+                    ImGui::SameLine();
+                    ImGui::TextDisabled("(?)");
+                    if (ImGui::IsItemHovered()) ImGui::SetTooltip("note: BOUNDS stretches the grid over the axis-aligned bounds of the visible water (in projector space), HULL QUAD over the smallest quad around its convex hull, so fewer vertices are wasted off-screen. Compare the ON-SCREEN share below between the two (it is measured on the flat base plane).");
+                    ImGui::Text("ON-SCREEN: %.1f%% of the grid vertices, HULL POINTS: %u", 100.0f * m_renderEngine->getWaterGridVisibleVertexFraction(), projectedGrid.getHullPointCount());
+                }
+                GridResolutionGovernor &gridResolutionGovernor{m_renderEngine->getWaterGridResolutionGovernor()};
+                ImGui::Text("RESOLUTION:");
+                ImGui::SameLine();
+                if (ImGui::Button("ADAPTIVE##4")) gridResolutionGovernor.isAdaptive = true;
+                ImGui::SameLine();
+                if (ImGui::Button("FIXED##4")) gridResolutionGovernor.isAdaptive = false;
+                ImGui::SameLine();
+                ImGui::TextDisabled("(?)");
+                if (ImGui::IsItemHovered()) ImGui::SetTooltip("note: ADAPTIVE steps the grid down a level while the frame time is over the target, and back up once it is under half of it (each has to hold for a while, to avoid thrashing). The frame time is the larger of the GPU and CPU time of a frame, since the vsync'd frametime above hides any headroom.");
+                int waterGridLevel{(int)gridResolutionGovernor.getLevel()};
+                if (ImGui::SliderInt("LEVEL##4", &waterGridLevel, 0, (int)WaterGrid::getLevelCount() - 1)) {
+                    // force-clamp (handle CTRL + LEFT_CLICK)
+                    if (waterGridLevel < 0) waterGridLevel = 0;
+                    gridResolutionGovernor.setLevel((unsigned int)waterGridLevel);
+                }
+                if (ImGui::SliderFloat("TARGET FRAME TIME (ms)##4", &gridResolutionGovernor.targetFrameTimeInMilliseconds, 1.0f, 50.0f)) {
+                    // force-clamp (handle CTRL + LEFT_CLICK)
+                    if (gridResolutionGovernor.targetFrameTimeInMilliseconds < 1.0f) gridResolutionGovernor.targetFrameTimeInMilliseconds = 1.0f;
+                }
+                ImGui::Text("GRID: %u x %u, FRAME: %.3f ms (GPU %.3f ms, CPU %.3f ms), SWITCHES: %u", WaterGrid::getGridLength(gridResolutionGovernor.getLevel()), WaterGrid::getGridLength(gridResolutionGovernor.getLevel()),
+                            gridResolutionGovernor.getSmoothedFrameTimeInMilliseconds(), m_renderEngine->getFrameGPUTimeInMilliseconds(), m_renderEngine->getFrameCPUTimeInMilliseconds(), gridResolutionGovernor.getSwitchCount());
+                if (gridResolutionGovernor.getSwitchCount() > 0) {
+                    ImGui::Text("LAST SWITCH: %u x %u -> %u x %u (AT %.3f ms)", WaterGrid::getGridLength(gridResolutionGovernor.getPreviousLevel()), WaterGrid::getGridLength(gridResolutionGovernor.getPreviousLevel()),
+                                WaterGrid::getGridLength(gridResolutionGovernor.getLevel()), WaterGrid::getGridLength(gridResolutionGovernor.getLevel()), gridResolutionGovernor.getLastSwitchFrameTimeInMilliseconds());
+                }
+                // the fed frame times, scaled so that the target sits in the middle of the graph
+                std::array<float, GridResolutionGovernor::HISTORY_LENGTH> const& frameTimeHistory{gridResolutionGovernor.getFrameTimeHistoryInMilliseconds()};
+                ImGui::PlotLines("FRAME TIMES (ms)##4", frameTimeHistory.data(), (int)frameTimeHistory.size(), (int)gridResolutionGovernor.getFrameTimeHistoryOffset(), nullptr, 0.0f, 2.0f * gridResolutionGovernor.targetFrameTimeInMilliseconds);
+                ImGui::Text("INDEX LAYOUT:");
+                ImGui::SameLine();
+                if (ImGui::Button("ROW LIST##layout4")) m_renderEngine->assignWaterGridLevelIndexBuffers(*m_waterGrid, WaterGrid::IndexLayout::ROW_LIST);
+                ImGui::SameLine();
+                if (ImGui::Button("TILED LIST##layout4")) m_renderEngine->assignWaterGridLevelIndexBuffers(*m_waterGrid, WaterGrid::IndexLayout::TILED_LIST);
+                ImGui::SameLine();
+                if (ImGui::Button("TILED STRIP##layout4")) m_renderEngine->assignWaterGridLevelIndexBuffers(*m_waterGrid, WaterGrid::IndexLayout::TILED_STRIP);
+                ImGui::SameLine();
+                ImGui::TextDisabled("(?)");
+                if (ImGui::IsItemHovered()) ImGui::SetTooltip("note: the tiled layouts walk the grid in narrow column strips (so the vertex cache re-uses each row) with 16-bit indices per band of rows. Run with --benchmark water-grid-indices for the simulated cache miss ratios.");
+                ImGui::Text("INDEX BUFFERS (ALL LEVELS + CLIPMAP + PATCHES): %.1f MiB", WaterGrid::getIndexMemoryInBytes(m_waterGrid->indexLayout) / (1024.0f * 1024.0f));
+                ImGui::Text("NORMALS:");
+                ImGui::SameLine();
+                if (ImGui::Button("ANALYTIC##4")) m_renderEngine->isUsingFiniteDifferenceWaterNormals = false;
+                ImGui::SameLine();
+                if (ImGui::Button("FINITE-DIFFERENCE##4")) m_renderEngine->isUsingFiniteDifferenceWaterNormals = true;
+                ImGui::SameLine();
+                ImGui::TextDisabled("(?)");
+                if (ImGui::IsItemHovered()) ImGui::SetTooltip("note: compare the avg. frametime above between the two modes (the finite-difference mode re-evaluates the whole surface at 4 neighbours per vertex).");
+                ImGui::Text("WAVE LOD:");
+                ImGui::SameLine();
+                if (ImGui::Button("ON##4")) m_renderEngine->isUsingWaveLOD = true;
+                ImGui::SameLine();
+                if (ImGui::Button("OFF##4")) m_renderEngine->isUsingWaveLOD = false;
+                ImGui::SameLine();
+                ImGui::TextDisabled("(?)");
+                if (ImGui::IsItemHovered()) ImGui::SetTooltip("note: waves (and the heightmap) shorter than the local grid cell size can't be represented and only cause shimmer, so they are faded out and then skipped.");
+                if (ImGui::SliderFloat("LOD MIN SAMPLES PER WAVELENGTH", &m_renderEngine->waveLODMinSamplesPerWavelength, 0.5f, 8.0f)) {
+                    // force-clamp (handle CTRL + LEFT_CLICK)
+                    if (m_renderEngine->waveLODMinSamplesPerWavelength < 0.5f) m_renderEngine->waveLODMinSamplesPerWavelength = 0.5f;
+                }
+                ImGui::Text("SURFACE CAPTURE:");
+                ImGui::SameLine();
+                if (ImGui::Button("ON##capture4")) m_renderEngine->isUsingWaterSurfaceCapture = true;
+                ImGui::SameLine();
+                if (ImGui::Button("OFF##capture4")) m_renderEngine->isUsingWaterSurfaceCapture = false;
+                ImGui::SameLine();
+                ImGui::TextDisabled("(?)");
+                if (ImGui::IsItemHovered()) ImGui::SetTooltip("note: ON displaces the grid once per frame into a transform feedback buffer, then draws it with a pass-through vertex shader. Every extra consumer of the surface then costs the draw time only, instead of the full recomputation (the draw time with capture OFF). Run with --gpu-benchmark water-capture to time both.");
+                ImGui::Text("GPU CAPTURE: %.3f ms, GPU DRAW: %.3f ms", m_renderEngine->getWaterSurfaceCaptureGPUTimeInMilliseconds(), m_renderEngine->getWaterSurfaceDrawGPUTimeInMilliseconds());
+                if (ImGui::Button("READBACK##4")) m_renderEngine->requestWaterSurfaceReadback();
+                ImGui::SameLine();
+                if (m_renderEngine->isWaterSurfaceReadbackPending()) ImGui::Text("%s", m_renderEngine->isUsingWaterSurfaceCapture ? "(in flight)" : "(waiting for capture ON)");
+                else if (!m_renderEngine->getWaterSurfaceReadback().empty()) {
+                    WaterSurfaceVertex const& centreVertex{m_renderEngine->getWaterSurfaceReadback().at(m_renderEngine->getWaterSurfaceReadback().size() / 2)};
+                    ImGui::Text("%zu vertices, centre at (%.2f, %.2f, %.2f)", m_renderEngine->getWaterSurfaceReadback().size(), centreVertex.position.x, centreVertex.position.y, centreVertex.position.z);
+                }
                 ImGui::Separator();
                 ImGui::TreePop();
             }
             ImGui::Separator();
         }
 
-        if (!m_renderEngine->gerstnerWaves.empty()) {
-            if (ImGui::TreeNode("GERSTNER WAVES")) {
+        if (ImGui::TreeNode("GERSTNER WAVES")) {
+            std::vector<geometry::GerstnerWave> &gerstnerWaves{m_renderEngine->gerstnerWaves};
+            unsigned int const gerstnerWaveCapacity{m_renderEngine->getGerstnerWaveCapacity()};
+
+            ImGui::Separator();
+            ImGui::Text("COUNT: %u / %u", (unsigned int)gerstnerWaves.size(), gerstnerWaveCapacity);
+            ImGui::SameLine();
+            if (ImGui::Button("ADD##5") && gerstnerWaves.size() < gerstnerWaveCapacity) gerstnerWaves.emplace_back(0.0f, 1.0f, 1.0f, 0.0f, glm::vec2{1.0f, 0.0f});
+            ImGui::SameLine();
+            if (ImGui::Button("CLEAR##5")) gerstnerWaves.clear();
+
+            if (ImGui::TreeNode("SEA STATE GENERATOR")) {
+                ImGui::Separator();
+                int waveCount{(int)m_seaStateParameters.waveCount};
+                if (ImGui::SliderInt("Wave Count", &waveCount, 1, (int)glm::max(gerstnerWaveCapacity, 1u))) {
+                    // force-clamp (handle CTRL + LEFT_CLICK)
+                    m_seaStateParameters.waveCount = (unsigned int)glm::clamp(waveCount, 1, (int)glm::max(gerstnerWaveCapacity, 1u));
+                }
+                if (ImGui::SliderFloat("Median Wavelength", &m_seaStateParameters.medianWavelength, 0.1f, 50.0f)) {
+                    // force-clamp (handle CTRL + LEFT_CLICK)
+                    if (m_seaStateParameters.medianWavelength < 0.1f) m_seaStateParameters.medianWavelength = 0.1f;
+                }
+                if (ImGui::SliderFloat("Total Amplitude", &m_seaStateParameters.totalAmplitude, 0.0f, 2.0f)) {
+                    // force-clamp (handle CTRL + LEFT_CLICK)
+                    if (m_seaStateParameters.totalAmplitude < 0.0f) m_seaStateParameters.totalAmplitude = 0.0f;
+                }
+                ImGui::SameLine();
+                ImGui::TextDisabled("(?)");
+                if (ImGui::IsItemHovered()) ImGui::SetTooltip("note: the amplitudes are normalized to sum to this, since the projected grid volume (and therefore the overdraw) grows with the total amplitude.");
+                if (ImGui::SliderFloat("Wind Direction (degrees)", &m_seaStateParameters.windDirectionInDegrees, 0.0f, 360.0f)) {
+                    // force-clamp (handle CTRL + LEFT_CLICK)
+                    m_seaStateParameters.windDirectionInDegrees = glm::clamp(m_seaStateParameters.windDirectionInDegrees, 0.0f, 360.0f);
+                }
+                if (ImGui::SliderFloat("Directional Spread (degrees)", &m_seaStateParameters.directionalSpreadInDegrees, 0.0f, 180.0f)) {
+                    // force-clamp (handle CTRL + LEFT_CLICK)
+                    m_seaStateParameters.directionalSpreadInDegrees = glm::clamp(m_seaStateParameters.directionalSpreadInDegrees, 0.0f, 180.0f);
+                }
+                if (ImGui::SliderFloat("Steepness", &m_seaStateParameters.steepness, 0.0f, 1.0f)) {
+                    // force-clamp (handle CTRL + LEFT_CLICK)
+                    m_seaStateParameters.steepness = glm::clamp(m_seaStateParameters.steepness, 0.0f, 1.0f);
+                }
+                int seed{(int)m_seaStateParameters.seed};
+                if (ImGui::InputInt("Seed", &seed)) m_seaStateParameters.seed = (unsigned int)glm::max(seed, 0);
+                if (ImGui::Button("GENERATE##5")) gerstnerWaves = geometry::generateSeaState(m_seaStateParameters);
                 ImGui::Separator();
-                for (unsigned int i = 0; i < m_renderEngine->gerstnerWaves.size(); ++i) {
-                    if (nullptr == m_renderEngine->gerstnerWaves.at(i)) continue;
+                ImGui::TreePop();
+            }
 
-                    if (ImGui::TreeNode(std::string{"wave" + std::to_string(i)}.c_str())) {
-                        ImGui::Separator();
-                        if (ImGui::SliderFloat(std::string{"Amplitude##" + std::to_string(i)}.c_str(), &m_renderEngine->gerstnerWaves.at(i)->amplitude_A, 0.0f, 1.0f)) {
-                            // force-clamp (handle CTRL + LEFT_CLICK)
-                            if (m_renderEngine->gerstnerWaves.at(i)->amplitude_A < 0.0f) m_renderEngine->gerstnerWaves.at(i)->amplitude_A = 0.0f;
-                        }
-                        if (ImGui::SliderFloat(std::string{"Frequency##" + std::to_string(i)}.c_str(), &m_renderEngine->gerstnerWaves.at(i)->frequency_w, 0.0f, 1.0f)) {
-                            // force-clamp (handle CTRL + LEFT_CLICK)
-                            if (m_renderEngine->gerstnerWaves.at(i)->frequency_w < 0.0f) m_renderEngine->gerstnerWaves.at(i)->frequency_w = 0.0f;
-                        }
-                        if (ImGui::SliderFloat(std::string{"Phase Constant (~Speed)##" + std::to_string(i)}.c_str(), &m_renderEngine->gerstnerWaves.at(i)->phaseConstant_phi, 0.0f, 10.0f)) {
-                            // force-clamp (handle CTRL + LEFT_CLICK)
-                            if (m_renderEngine->gerstnerWaves.at(i)->phaseConstant_phi < 0.0f) m_renderEngine->gerstnerWaves.at(i)->phaseConstant_phi = 0.0f;
-                        }
-                        if (ImGui::SliderFloat(std::string{"Steepness##" + std::to_string(i)}.c_str(), &m_renderEngine->gerstnerWaves.at(i)->steepness_Q, 0.0f, 1.0f)) {
-                            // force-clamp (handle CTRL + LEFT_CLICK)
-                            m_renderEngine->gerstnerWaves.at(i)->steepness_Q = glm::clamp(m_renderEngine->gerstnerWaves.at(i)->steepness_Q, 0.0f, 1.0f);
-                        }
-                        if (ImGui::SliderFloat2(std::string{"XZ-Direction##" + std::to_string(i)}.c_str(), (float*)&m_renderEngine->gerstnerWaves.at(i)->xzDirection_D, -1.0f, 1.0f)) {
-                            // force-clamp (handle CTRL + LEFT_CLICK)
-                            m_renderEngine->gerstnerWaves.at(i)->xzDirection_D = glm::clamp(m_renderEngine->gerstnerWaves.at(i)->xzDirection_D, glm::vec2{-1.0f, -1.0f}, glm::vec2{1.0f, 1.0f});
-                            //TODO: use an epsilon???
-                            // we can't normalize the 0 vector, so reset to a dummy
-                            if (0.0f == glm::length(m_renderEngine->gerstnerWaves.at(i)->xzDirection_D)) m_renderEngine->gerstnerWaves.at(i)->xzDirection_D = glm::vec2{0.0f, 1.0f};
-                            else m_renderEngine->gerstnerWaves.at(i)->xzDirection_D = glm::normalize(m_renderEngine->gerstnerWaves.at(i)->xzDirection_D);
-                        }
-                        ImGui::Separator();
-                        ImGui::TreePop();
-                    }
+            if (ImGui::TreeNode("LOOPING ATLAS")) {
+                GerstnerAtlasParameters &gerstnerAtlasParameters{m_renderEngine->gerstnerAtlasParameters};
+                ImGui::Separator();
+                ImGui::Text("PLAYBACK:");
+                ImGui::SameLine();
+                if (ImGui::Button("LIVE##7")) m_renderEngine->isUsingGerstnerAtlas = false;
+                ImGui::SameLine();
+                if (ImGui::Button("ATLAS##7")) m_renderEngine->isUsingGerstnerAtlas = nullptr != m_renderEngine->getGerstnerAtlas() || m_renderEngine->bakeGerstnerAtlas();
+                ImGui::SameLine();
+                if (ImGui::Button("RE-BAKE##7")) m_renderEngine->bakeGerstnerAtlas();
+                ImGui::SameLine();
+                ImGui::TextDisabled("(?)");
+                if (ImGui::IsItemHovered()) ImGui::SetTooltip("note: the atlas is a snapshot of the waves at bake time (wave vectors/speeds are snapped so it tiles and loops), re-bake after editing the waves. bakes are cached on disk in the working directory.");
+                if (nullptr != m_renderEngine->getGerstnerAtlas()) ImGui::Text("BAKED: loop period = %.2f s, %u waves", m_renderEngine->getGerstnerAtlas()->getLoopPeriodInSeconds(), (unsigned int)m_renderEngine->getGerstnerAtlas()->getSnappedWaves().size());
+                ImGui::Text("RESOLUTION:");
+                ImGui::SameLine();
+                if (ImGui::Button("64##7")) gerstnerAtlasParameters.resolution = 64;
+                ImGui::SameLine();
+                if (ImGui::Button("128##7")) gerstnerAtlasParameters.resolution = 128;
+                ImGui::SameLine();
+                if (ImGui::Button("256##7")) gerstnerAtlasParameters.resolution = 256;
+                int frameCount{(int)gerstnerAtlasParameters.frameCount};
+                if (ImGui::SliderInt("Frames Per Loop##7", &frameCount, 2, 256)) {
+                    // force-clamp (handle CTRL + LEFT_CLICK)
+                    gerstnerAtlasParameters.frameCount = (unsigned int)glm::clamp(frameCount, 2, 256);
+                }
+                if (ImGui::SliderFloat("Tile Length##7", &gerstnerAtlasParameters.tileLength, 1.0f, 256.0f)) {
+                    // force-clamp (handle CTRL + LEFT_CLICK)
+                    if (gerstnerAtlasParameters.tileLength < 1.0f) gerstnerAtlasParameters.tileLength = 1.0f;
+                }
+                if (ImGui::SliderFloat("Min Loop Period (s)##7", &gerstnerAtlasParameters.minLoopPeriodInSeconds, 1.0f, gerstnerAtlasParameters.maxLoopPeriodInSeconds)) {
+                    // force-clamp (handle CTRL + LEFT_CLICK)
+                    gerstnerAtlasParameters.minLoopPeriodInSeconds = glm::clamp(gerstnerAtlasParameters.minLoopPeriodInSeconds, 1.0f, gerstnerAtlasParameters.maxLoopPeriodInSeconds);
+                }
+                if (ImGui::SliderFloat("Max Loop Period (s)##7", &gerstnerAtlasParameters.maxLoopPeriodInSeconds, gerstnerAtlasParameters.minLoopPeriodInSeconds, 120.0f)) {
+                    // force-clamp (handle CTRL + LEFT_CLICK)
+                    if (gerstnerAtlasParameters.maxLoopPeriodInSeconds < gerstnerAtlasParameters.minLoopPeriodInSeconds) gerstnerAtlasParameters.maxLoopPeriodInSeconds = gerstnerAtlasParameters.minLoopPeriodInSeconds;
                 }
                 ImGui::Separator();
                 ImGui::TreePop();
             }
+
             ImGui::Separator();
+            for (unsigned int i = 0; i < gerstnerWaves.size(); ++i) {
+                if (ImGui::TreeNode(std::string{"wave" + std::to_string(i)}.c_str())) {
+                    geometry::GerstnerWave &gerstnerWave{gerstnerWaves.at(i)};
+                    ImGui::Separator();
+                    if (ImGui::SliderFloat(std::string{"Amplitude##" + std::to_string(i)}.c_str(), &gerstnerWave.amplitude_A, 0.0f, 1.0f)) {
+                        // force-clamp (handle CTRL + LEFT_CLICK)
+                        if (gerstnerWave.amplitude_A < 0.0f) gerstnerWave.amplitude_A = 0.0f;
+                    }
+                    if (ImGui::SliderFloat(std::string{"Frequency##" + std::to_string(i)}.c_str(), &gerstnerWave.frequency_w, 0.0f, 1.0f)) {
+                        // force-clamp (handle CTRL + LEFT_CLICK)
+                        if (gerstnerWave.frequency_w < 0.0f) gerstnerWave.frequency_w = 0.0f;
+                    }
+                    if (ImGui::SliderFloat(std::string{"Phase Constant (~Speed)##" + std::to_string(i)}.c_str(), &gerstnerWave.phaseConstant_phi, 0.0f, 10.0f)) {
+                        // force-clamp (handle CTRL + LEFT_CLICK)
+                        if (gerstnerWave.phaseConstant_phi < 0.0f) gerstnerWave.phaseConstant_phi = 0.0f;
+                    }
+                    if (ImGui::SliderFloat(std::string{"Steepness##" + std::to_string(i)}.c_str(), &gerstnerWave.steepness_Q, 0.0f, 1.0f)) {
+                        // force-clamp (handle CTRL + LEFT_CLICK)
+                        gerstnerWave.steepness_Q = glm::clamp(gerstnerWave.steepness_Q, 0.0f, 1.0f);
+                    }
+                    if (ImGui::SliderFloat2(std::string{"XZ-Direction##" + std::to_string(i)}.c_str(), (float*)&gerstnerWave.xzDirection_D, -1.0f, 1.0f)) {
+                        // force-clamp (handle CTRL + LEFT_CLICK)
+                        gerstnerWave.xzDirection_D = glm::clamp(gerstnerWave.xzDirection_D, glm::vec2{-1.0f, -1.0f}, glm::vec2{1.0f, 1.0f});
+                        //TODO: use an epsilon???
+                        // we can't normalize the 0 vector, so reset to a dummy
+                        if (0.0f == glm::length(gerstnerWave.xzDirection_D)) gerstnerWave.xzDirection_D = glm::vec2{0.0f, 1.0f};
+                        else gerstnerWave.xzDirection_D = glm::normalize(gerstnerWave.xzDirection_D);
+                    }
+                    bool const isRemoving{ImGui::Button(std::string{"REMOVE##wave" + std::to_string(i)}.c_str())};
+                    ImGui::Separator();
+                    ImGui::TreePop();
+                    //NOTE: erase after popping so the tree stays balanced, then stop iterating since the indices have shifted
+                    if (isRemoving) {
+                        gerstnerWaves.erase(gerstnerWaves.begin() + i);
+                        break;
+                    }
+                }
+            }
+            ImGui::Separator();
+            ImGui::TreePop();
         }
+        ImGui::Separator();
+
+        if (ImGui::TreeNode("FFT OCEAN")) {
+            OceanFFTParameters &oceanFFTParameters{m_renderEngine->oceanFFTParameters};
+
+            ImGui::Separator();
+            ImGui::Text("DETAIL:");
+            ImGui::SameLine();
+            if (ImGui::Button("HEIGHTMAP##6")) m_renderEngine->isUsingOceanFFT = false;
+            ImGui::SameLine();
+            if (ImGui::Button("FFT OCEAN##6")) m_renderEngine->isUsingOceanFFT = true;
+            ImGui::SameLine();
+            ImGui::TextDisabled("(?)");
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("note: the FFT ocean is evaluated on the CPU every frame, see the update time below (or run with --benchmark ocean-fft).");
+            ImGui::Text("CPU UPDATE: %.3f ms (%u threads)", m_renderEngine->getOceanFFTUpdateTimeInMilliseconds(), m_renderEngine->getThreadPool()->getThreadCount());
+            ImGui::Text("RESOLUTION:");
+            ImGui::SameLine();
+            if (ImGui::Button("128##6")) oceanFFTParameters.resolution = 128;
+            ImGui::SameLine();
+            if (ImGui::Button("256##6")) oceanFFTParameters.resolution = 256;
+            ImGui::SameLine();
+            if (ImGui::Button("512##6")) oceanFFTParameters.resolution = 512;
+            ImGui::Text("SPECTRUM:");
+            ImGui::SameLine();
+            if (ImGui::Button("PHILLIPS##6")) oceanFFTParameters.spectrum = OceanSpectrum::PHILLIPS;
+            ImGui::SameLine();
+            if (ImGui::Button("JONSWAP##6")) oceanFFTParameters.spectrum = OceanSpectrum::JONSWAP;
+            if (ImGui::SliderFloat("Patch Length##6", &oceanFFTParameters.patchLength, 1.0f, 256.0f)) {
+                // force-clamp (handle CTRL + LEFT_CLICK)
+                if (oceanFFTParameters.patchLength < 1.0f) oceanFFTParameters.patchLength = 1.0f;
+            }
+            if (ImGui::SliderFloat("Wind Speed##6", &oceanFFTParameters.windSpeed, 0.1f, 30.0f)) {
+                // force-clamp (handle CTRL + LEFT_CLICK)
+                if (oceanFFTParameters.windSpeed < 0.1f) oceanFFTParameters.windSpeed = 0.1f;
+            }
+            if (ImGui::SliderFloat("Wind Direction (degrees)##6", &oceanFFTParameters.windDirectionInDegrees, 0.0f, 360.0f)) {
+                // force-clamp (handle CTRL + LEFT_CLICK)
+                oceanFFTParameters.windDirectionInDegrees = glm::clamp(oceanFFTParameters.windDirectionInDegrees, 0.0f, 360.0f);
+            }
+            if (ImGui::SliderFloat("Amplitude Scale##6", &oceanFFTParameters.amplitudeScale, 0.0f, 4.0f)) {
+                // force-clamp (handle CTRL + LEFT_CLICK)
+                if (oceanFFTParameters.amplitudeScale < 0.0f) oceanFFTParameters.amplitudeScale = 0.0f;
+            }
+            if (ImGui::SliderFloat("Choppiness##6", &oceanFFTParameters.choppiness, 0.0f, 2.0f)) {
+                // force-clamp (handle CTRL + LEFT_CLICK)
+                if (oceanFFTParameters.choppiness < 0.0f) oceanFFTParameters.choppiness = 0.0f;
+            }
+            if (ImGui::SliderFloat("Small Wave Cutoff##6", &oceanFFTParameters.smallWaveCutoff, 0.0f, 1.0f)) {
+                // force-clamp (handle CTRL + LEFT_CLICK)
+                if (oceanFFTParameters.smallWaveCutoff < 0.0f) oceanFFTParameters.smallWaveCutoff = 0.0f;
+            }
+            if (OceanSpectrum::JONSWAP == oceanFFTParameters.spectrum) {
+                if (ImGui::SliderFloat("Fetch##6", &oceanFFTParameters.jonswapFetch, 1000.0f, 1000000.0f)) {
+                    // force-clamp (handle CTRL + LEFT_CLICK)
+                    if (oceanFFTParameters.jonswapFetch < 1.0f) oceanFFTParameters.jonswapFetch = 1.0f;
+                }
+                if (ImGui::SliderFloat("Peak Enhancement##6", &oceanFFTParameters.jonswapPeakEnhancement, 1.0f, 7.0f)) {
+                    // force-clamp (handle CTRL + LEFT_CLICK)
+                    if (oceanFFTParameters.jonswapPeakEnhancement < 1.0f) oceanFFTParameters.jonswapPeakEnhancement = 1.0f;
+                }
+            }
+            int oceanSeed{(int)oceanFFTParameters.seed};
+            if (ImGui::InputInt("Seed##6", &oceanSeed)) oceanFFTParameters.seed = (unsigned int)glm::max(oceanSeed, 0);
+            ImGui::Separator();
+            ImGui::TreePop();
+        }
+        ImGui::Separator();
+
+        if (ImGui::TreeNode("HEIGHTMAP SEQUENCE")) {
+            HeightmapSequence const* heightmapSequence{m_renderEngine->getHeightmapSequence()};
+
+            ImGui::Separator();
+            ImGui::Text("HEIGHTMAP:");
+            ImGui::SameLine();
+            if (ImGui::Button("STATIC##8")) m_renderEngine->isUsingHeightmapSequence = false;
+            ImGui::SameLine();
+            if (ImGui::Button("SEQUENCE##8")) m_renderEngine->isUsingHeightmapSequence = true;
+            ImGui::SameLine();
+            ImGui::TextDisabled("(?)");
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("note: frames are decoded on a background thread and streamed through pixel-unpack buffers (at most 1 upload per frame), the FFT ocean replaces both.");
+            if (nullptr == heightmapSequence) {
+                ImGui::Text("(no sequence loaded)");
+            } else {
+                ImGui::Text("FRAMES: %u (%u x %u R%u)", heightmapSequence->getFrameCount(), heightmapSequence->getWidth(), heightmapSequence->getHeight(), 8 * heightmapSequence->getBytesPerTexel());
+                ImGui::Text("MEMORY: %.2f MiB (CPU + GPU)", m_renderEngine->getHeightmapSequenceMemoryInBytes() / (1024.0f * 1024.0f));
+                ImGui::Text("LAST UPLOAD: %.3f ms", m_renderEngine->getHeightmapSequenceUploadTimeInMilliseconds());
+            }
+            if (ImGui::SliderFloat("Frames Per Second##8", &m_renderEngine->heightmapSequenceFramesPerSecond, 0.1f, 60.0f)) {
+                // force-clamp (handle CTRL + LEFT_CLICK)
+                if (m_renderEngine->heightmapSequenceFramesPerSecond < 0.1f) m_renderEngine->heightmapSequenceFramesPerSecond = 0.1f;
+            }
+            ImGui::Separator();
+            ImGui::TreePop();
+        }
+        ImGui::Separator();
 
         if (ImGui::SliderFloat("WATER BUMP ROUGHNESS", &m_renderEngine->heightmapSampleScale, 0.0f, 1.0f)) {
             // force-clamp (handle CTRL + LEFT_CLICK)
@@ -678,50 +1110,18 @@ namespace wave_tool {
             }
         }
 
-        m_waterGrid = std::make_shared<MeshObject>();
+        m_waterGrid = std::make_shared<WaterGrid>();
         //m_waterGrid->m_polygonMode = PolygonMode::POINT; //NOTE: doing this atm makes a cool pixel art world
-        //TEMP: hacking some indices together to draw grid as tri-mesh (should move this to MeshObject in the future)...
-        //TODO: explain this better in the future (with diagrams)
-
-        // first, store indices into a length * length square grid
-        //NOTE: atm, this must match the constant of the same name in render-engine.cpp, but will be changed in the future
-        GLuint const GRID_LENGTH = 513;
-        //NOTE: must use vector instead of array to handle larger grid lengths
-        // zero-fill
-        std::vector<std::vector<GLuint>> gridIndices(GRID_LENGTH, std::vector<GLuint>(GRID_LENGTH, 0));
-        // now fill with the proper indices in the same layout that shader expects
-        // not that it really matters, but visualize it as [row][col] = [0][0] as the bottom-left element of 2D array
-        GLuint counterIndex = 0;
-        for (GLuint row = 0; row < GRID_LENGTH; ++row) {
-            for (GLuint col = 0; col < GRID_LENGTH; ++col) {
-                gridIndices.at(row).at(col) = counterIndex;
-                ++counterIndex;
-            }
-        }
-
-        // now using the vertex indices in this format, we can easily tesselate this grid into triangles as so...
-        //TODO: draw a diagram comment here to better explain this
-        for (GLuint row = 0; row < GRID_LENGTH - 1; ++row) {
-            for (GLuint col = 0; col < GRID_LENGTH - 1; ++col) {
-                // make 2 triangles (thus a square) from each of these indices acting as the bottom-left corner
-                // ensures that the winding of all triangles is counter-clockwise
-
-                m_waterGrid->drawFaces.push_back(gridIndices.at(row).at(col));
-                m_waterGrid->drawFaces.push_back(gridIndices.at(row + 1).at(col + 1));
-                m_waterGrid->drawFaces.push_back(gridIndices.at(row + 1).at(col));
-
-                m_waterGrid->drawFaces.push_back(gridIndices.at(row).at(col));
-                m_waterGrid->drawFaces.push_back(gridIndices.at(row).at(col + 1));
-                m_waterGrid->drawFaces.push_back(gridIndices.at(row + 1).at(col + 1));
-            }
-        }
+        //NOTE: the grid's triangulation (one index buffer per resolution level) is built by RenderEngine::assignWaterGridBuffers()
 
         m_waterGrid->textureID = m_renderEngine->load2DTexture("../../assets/textures/noise/waves/waves3/00.png"); //WARNING: THIS MAY HAVE TO BE CHANGED TO LOAD IN SPECIFICALLY WITH 8-bits (or may work, but should be optimized)
         // fallback #1 (no water grid)
         if (0 == m_waterGrid->textureID) m_waterGrid = nullptr;
         if (nullptr != m_waterGrid) {
             m_waterGrid->shaderProgramID = m_renderEngine->getWaterGridProgram();
-            m_renderEngine->assignBuffers(*m_waterGrid);
+            m_renderEngine->assignWaterGridBuffers(*m_waterGrid);
+            //NOTE: the static heightmap above is kept as the fallback (shown while the first frames decode, or if the sequence can't be opened)
+            m_renderEngine->loadHeightmapSequence("../../assets/textures/noise/waves/waves3/%02u.png");
         }
 
         //TODO: in the future, allow users to load in different terrains? (it would be nice to get program to work dynamically with whatever terrain it comes across) - probably not since finding terrain that works with my loader is hell
@@ -44,18 +44,29 @@
 #include <string>
 #include <vector>
 
+#include "gerstner-wave.h"
+
 struct GLFWwindow;
 
 namespace wave_tool {
     class Camera;
     class MeshObject;
     class RenderEngine;
+    class WaterGrid;
+
+    // the settings that can be given on the command line (see main.cpp)
+    struct ProgramOptions {
+        unsigned int localReflectionsDownscale{2}; // 1, 2 or 4 (see RenderEngine::localReflectionsDownscale)
+        unsigned int localRefractionsDownscale{2}; // 1, 2 or 4 (see RenderEngine::localRefractionsDownscale)
+        std::string gpuBenchmark; // empty, or the name of the GPUBenchmark to run (the application then exits once it's done)
+    };
 
     class Program {
         public:
             static unsigned int const s_IMAGE_SAVE_AS_NAME_CHAR_LIMIT{128};
 
             Program();
+            Program(ProgramOptions const& options);
             ~Program();
 
             std::shared_ptr<RenderEngine> getRenderEngine() const;
@@ -65,12 +76,14 @@ namespace wave_tool {
         private:
             char m_imageSaveAsName[s_IMAGE_SAVE_AS_NAME_CHAR_LIMIT]{"image"};
             std::vector<std::shared_ptr<MeshObject>> m_meshObjects;
+            ProgramOptions m_options;
             std::shared_ptr<RenderEngine> m_renderEngine = nullptr;
+            geometry::SeaStateParameters m_seaStateParameters;
             std::shared_ptr<MeshObject> m_skyboxClouds = nullptr;
             std::shared_ptr<MeshObject> m_skyboxStars = nullptr;
             std::shared_ptr<MeshObject> m_skysphere = nullptr;
             std::shared_ptr<MeshObject> m_terrain = nullptr;
-            std::shared_ptr<MeshObject> m_waterGrid = nullptr;
+            std::shared_ptr<WaterGrid> m_waterGrid = nullptr;
             GLFWwindow *m_window = nullptr;
             std::shared_ptr<MeshObject> m_xyPlane = nullptr;
             std::shared_ptr<MeshObject> m_xzPlane = nullptr;
@@ -0,0 +1,498 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+// reference: https://fileadmin.cs.lth.se/graphics/theses/projects/projgrid/
+//NOTE: this code closely follows the algorithm laid out by the demo at the above reference
+
+#include "projected-grid.h"
+
+#include <algorithm>
+#include <cfloat>
+
+#include "geometry.h"
+
+namespace wave_tool {
+    bool ProjectedGrid::update(Camera const& camera, float const displaceableAmplitude) {
+        glm::mat4 const projection{camera.getProjectionMat()};
+        findIntersectionPoints(glm::inverse(projection * camera.getViewMat()), displaceableAmplitude);
+
+        // only continue to fit the grid, if there were intersection points
+        if (0 == m_intersectionPointCount) return false;
+
+        Camera const projector{placeProjector(camera, displaceableAmplitude)};
+
+        // project all intersection points onto base plane...
+        for (unsigned int i = 0; i < m_intersectionPointCount; ++i) {
+            m_intersectionPoints[i].y = 0.0f;
+        }
+
+        // transform all intersection points into NDC-space (for projector)
+        // reference: https://community.khronos.org/t/homogenous-normalized-device-coords-and-clipping/61965
+        // reference: https://stackoverflow.com/questions/21841598/when-does-the-transition-from-clip-space-to-screen-coordinates-happen
+        //NOTE: I was having a lot of issues before I divided by w, so hopefully everything works now
+        glm::mat4 const projector_viewProjectionMat{projector.getProjectionMat() * projector.getViewMat()};
+        for (unsigned int i = 0; i < m_intersectionPointCount; ++i) {
+            glm::vec4 const temp{projector_viewProjectionMat * m_intersectionPoints[i]}; // now in clip-space
+            m_intersectionPoints[i] = temp / temp.w; // now in NDC-space
+        }
+
+        // determine the xy-NDC bounds of the intersection points
+        float x_min = m_intersectionPoints[0].x;
+        float x_max = m_intersectionPoints[0].x;
+        float y_min = m_intersectionPoints[0].y;
+        float y_max = m_intersectionPoints[0].y;
+        for (unsigned int i = 1; i < m_intersectionPointCount; ++i) {
+            if (m_intersectionPoints[i].x < x_min) x_min = m_intersectionPoints[i].x;
+            else if (m_intersectionPoints[i].x > x_max) x_max = m_intersectionPoints[i].x;
+
+            if (m_intersectionPoints[i].y < y_min) y_min = m_intersectionPoints[i].y;
+            else if (m_intersectionPoints[i].y > y_max) y_max = m_intersectionPoints[i].y;
+        }
+
+        // the range starts out as these bounds (counter-clockwise from the bottom-left)...
+        std::array<glm::vec2, 4> rangeQuad{glm::vec2{x_min, y_min}, glm::vec2{x_max, y_min}, glm::vec2{x_max, y_max}, glm::vec2{x_min, y_max}};
+
+        // ...but whenever the intersection points don't fill their bounds (e.g. the trapezoid seen by an oblique camera), the grid vertices in the empty corners are wasted off-screen
+        // so instead, fit the smallest quad around their convex hull
+        m_hullPointCount = 0;
+        if (isUsingHullFit) {
+            findHullPoints();
+
+            // the projector's horizon is the image of the base plane's points at infinity (any 2 horizontal directions)
+            //NOTE: when the projector looks straight down its horizon is at infinity, and the ray through any NDC-space point hits the base plane
+            glm::vec3 horizon{0.0f, 0.0f, 1.0f};
+            glm::vec3 const horizontalForward{projector.getForward().x, 0.0f, projector.getForward().z};
+            glm::vec3 const horizontalRight{projector.getRight().x, 0.0f, projector.getRight().z};
+            glm::vec4 const horizonPoint0{projector_viewProjectionMat * glm::vec4{horizontalForward, 0.0f}};
+            glm::vec4 const horizonPoint1{projector_viewProjectionMat * glm::vec4{horizontalForward + horizontalRight, 0.0f}};
+            float const HORIZON_EPSILON{1.0e-4f};
+            if (horizonPoint0.w > HORIZON_EPSILON && horizonPoint1.w > HORIZON_EPSILON) {
+                glm::vec2 const p0{glm::vec2{horizonPoint0.x, horizonPoint0.y} / horizonPoint0.w};
+                glm::vec2 const p1{glm::vec2{horizonPoint1.x, horizonPoint1.y} / horizonPoint1.w};
+                glm::vec2 const horizonNormal{glm::normalize(glm::vec2{p0.y - p1.y, p1.x - p0.x})};
+                horizon = glm::vec3{horizonNormal, -glm::dot(horizonNormal, p0)};
+                // the intersection points are all below the horizon, so orient it to be positive on their side
+                glm::vec2 const boundsCentre{0.5f * (x_min + x_max), 0.5f * (y_min + y_max)};
+                if (glm::dot(horizon, glm::vec3{boundsCentre, 1.0f}) < 0.0f) horizon = -horizon;
+            }
+
+            fitHullQuad(horizon, rangeQuad);
+        }
+
+        // setup the range conversion matrix, will be used to convert from a special uv-space ("range-space")
+        glm::mat4 const rangeMat{computeRangeMat(rangeQuad)};
+
+        // compute M_projector...
+        //NOTE: the projector shares the camera's projection (only its position.y and pitch differ)
+        glm::mat4 const projectorMat{glm::inverse(projection * projector.getViewMat()) * rangeMat};
+
+        // compute the world-space coordinates of the four grid corners...
+        // init the corner positions in a special uv-space ("range-space") - (with z = -1 (near) for convenience for intersection test below)
+        std::array<glm::vec4, 4> cornerPoints{glm::vec4{0.0f, 0.0f, -1.0f, 1.0f},   // [0] - bottom-left
+                                              glm::vec4{0.0f, 1.0f, -1.0f, 1.0f},   // [1] - top-left
+                                              glm::vec4{1.0f, 0.0f, -1.0f, 1.0f},   // [2] - bottom-right
+                                              glm::vec4{1.0f, 1.0f, -1.0f, 1.0f}};  // [3] - top-right
+
+        // transform the coordinates to world-space...
+        // intersect projected rays with XZ-plane (base plane) to get world-space bounds of grid...
+        geometry::Plane const basePlane{0.0f, 1.0f, 0.0f, 0.0f};
+        for (unsigned int i = 0; i < cornerPoints.size(); ++i) {
+            glm::vec4 p0{cornerPoints[i]};
+            glm::vec4 p1{p0};
+            p1.z = 1.0f; // far
+
+            // transform both points to world-space...
+            p0 = projectorMat * p0;
+            p0 /= p0.w;
+            p1 = projectorMat * p1;
+            p1 /= p1.w;
+
+            // intersection test...
+            //NOTE: the projector always looks down at the base plane, so this can only fail for a degenerate (zero-area) range, which is treated as nothing to draw
+            if (p0 == p1) return false;
+            geometry::Line const line{p0, p1};
+            glm::vec3 intersectionPoint;
+            bool const isIntersection{utils::linePlaneIntersection(intersectionPoint, line, basePlane)};
+            if (!isIntersection) return false;
+            cornerPoints[i] = glm::vec4{intersectionPoint, 1.0f};
+        }
+
+        m_cornerPoints = cornerPoints;
+        m_projectorMat = projectorMat;
+        m_rangeQuad = rangeQuad;
+        return true;
+    }
+
+    std::array<glm::vec4, 4> const& ProjectedGrid::getCornerPoints() const {
+        return m_cornerPoints;
+    }
+
+    unsigned int ProjectedGrid::getHullPointCount() const {
+        return m_hullPointCount;
+    }
+
+    unsigned int ProjectedGrid::getIntersectionPointCount() const {
+        return m_intersectionPointCount;
+    }
+
+    glm::mat4 const& ProjectedGrid::getProjectorMat() const {
+        return m_projectorMat;
+    }
+
+    std::array<glm::vec2, 4> const& ProjectedGrid::getRangeQuad() const {
+        return m_rangeQuad;
+    }
+
+    unsigned int ProjectedGrid::countVisibleGridVertices(std::array<glm::vec4, 4> const& cornerPoints, glm::mat4 const& viewProjection, unsigned int const gridLength) {
+        if (gridLength < 2) return 0;
+
+        unsigned int visibleCount{0};
+        for (unsigned int row = 0; row < gridLength; ++row) {
+            float const v{(float)row / (gridLength - 1)};
+            for (unsigned int col = 0; col < gridLength; ++col) {
+                float const u{(float)col / (gridLength - 1)};
+                // [0] - bottom-left, [1] - top-left, [2] - bottom-right, [3] - top-right
+                glm::vec4 const position{glm::mix(glm::mix(cornerPoints[0], cornerPoints[2], u), glm::mix(cornerPoints[1], cornerPoints[3], u), v)};
+                glm::vec4 const clip{viewProjection * position};
+                if (glm::abs(clip.x) <= clip.w && glm::abs(clip.y) <= clip.w && glm::abs(clip.z) <= clip.w) ++visibleCount;
+            }
+        }
+        return visibleCount;
+    }
+
+    void ProjectedGrid::fitHullQuad(glm::vec3 const& horizon, std::array<glm::vec2, 4> &rangeQuad) {
+        unsigned int const edgeCount{m_hullPointCount};
+        if (edgeCount < 3) return;
+
+        // how close the hull itself gets to the horizon
+        float minHorizonDistance{FLT_MAX};
+        for (unsigned int i = 0; i < edgeCount; ++i) minHorizonDistance = glm::min(minHorizonDistance, glm::dot(horizon, glm::vec3{m_hullPoints[i], 1.0f}));
+        float const HORIZON_TOLERANCE{1.0e-5f};
+
+        // intersect every ordered pair of (extended) hull edges...
+        //NOTE: edge i runs from hull point i to i + 1, a pair is only usable as consecutive quad sides if the turn from i to j is counter-clockwise (and not near-parallel)
+        float const MIN_TURN_SINE{1.0e-3f};
+        for (unsigned int i = 0; i < edgeCount; ++i) {
+            glm::vec2 const& pointI{m_hullPoints[i]};
+            glm::vec2 const edgeI{m_hullPoints[(i + 1) % edgeCount] - pointI};
+            for (unsigned int j = 0; j < edgeCount; ++j) {
+                glm::vec2 const& pointJ{m_hullPoints[j]};
+                glm::vec2 const edgeJ{m_hullPoints[(j + 1) % edgeCount] - pointJ};
+                float const turn{edgeI.x * edgeJ.y - edgeI.y * edgeJ.x};
+                bool isValid{turn > MIN_TURN_SINE * glm::length(edgeI) * glm::length(edgeJ)};
+                if (isValid) {
+                    glm::vec2 const pointIToJ{pointJ - pointI};
+                    glm::vec2 const intersection{pointI + ((pointIToJ.x * edgeJ.y - pointIToJ.y * edgeJ.x) / turn) * edgeI};
+                    isValid = glm::dot(horizon, glm::vec3{intersection, 1.0f}) >= minHorizonDistance - HORIZON_TOLERANCE;
+                    m_hullEdgeIntersections[i][j] = intersection;
+                }
+                m_isHullEdgeIntersectionValid[i][j] = isValid;
+            }
+        }
+
+        // shoelace formula (counter-clockwise is positive)
+        auto const computeArea = [](std::array<glm::vec2, 4> const& quad) {
+            float doubleArea{0.0f};
+            for (unsigned int i = 0; i < quad.size(); ++i) {
+                glm::vec2 const& p0{quad[i]};
+                glm::vec2 const& p1{quad[(i + 1) % quad.size()]};
+                doubleArea += p0.x * p1.y - p1.x * p0.y;
+            }
+            return 0.5f * doubleArea;
+        };
+
+        // try every 4 hull edges (in counter-clockwise order a < b < c < d) as the quad's sides...
+        //NOTE: the truly smallest enclosing quad only needs 1 side flush with the hull, but the hull only has a handful of points so this is cheap and close (and never worse than the bounds)
+        float minArea{computeArea(rangeQuad)};
+        bool isQuadFound{false};
+        std::array<glm::vec2, 4> bestQuad;
+        for (unsigned int a = 0; a < edgeCount; ++a) {
+            for (unsigned int b = a + 1; b < edgeCount; ++b) {
+                if (!m_isHullEdgeIntersectionValid[a][b]) continue;
+                for (unsigned int c = b + 1; c < edgeCount; ++c) {
+                    if (!m_isHullEdgeIntersectionValid[b][c]) continue;
+                    for (unsigned int d = c + 1; d < edgeCount; ++d) {
+                        if (!m_isHullEdgeIntersectionValid[c][d] || !m_isHullEdgeIntersectionValid[d][a]) continue;
+
+                        // side a runs from the d/a corner to the a/b corner
+                        std::array<glm::vec2, 4> const quad{m_hullEdgeIntersections[d][a], m_hullEdgeIntersections[a][b], m_hullEdgeIntersections[b][c], m_hullEdgeIntersections[c][d]};
+                        float const area{computeArea(quad)};
+                        if (area < minArea) {
+                            minArea = area;
+                            bestQuad = quad;
+                            isQuadFound = true;
+                        }
+                    }
+                }
+            }
+        }
+        if (!isQuadFound) return;
+
+        // start from the corner whose outgoing side points the most to the right, so the grid's rows still run along the horizon (like the bounds' rows do)
+        unsigned int bottomLeftIndex{0};
+        float maxRightness{-FLT_MAX};
+        for (unsigned int i = 0; i < bestQuad.size(); ++i) {
+            glm::vec2 const side{bestQuad[(i + 1) % bestQuad.size()] - bestQuad[i]};
+            float const rightness{side.x / glm::length(side)};
+            if (rightness > maxRightness) {
+                maxRightness = rightness;
+                bottomLeftIndex = i;
+            }
+        }
+        for (unsigned int i = 0; i < rangeQuad.size(); ++i) rangeQuad[i] = bestQuad[(bottomLeftIndex + i) % bestQuad.size()];
+    }
+
+    void ProjectedGrid::findIntersectionPoints(glm::mat4 const& inverseViewProjection, float const displaceableAmplitude) {
+        m_intersectionPointCount = 0;
+
+        geometry::Plane const upperPlane{0.0f, 1.0f, 0.0f, displaceableAmplitude};
+        geometry::Plane const lowerPlane{0.0f, 1.0f, 0.0f, -displaceableAmplitude};
+
+        // reference: https://gamedev.stackexchange.com/questions/29999/how-do-i-create-a-bounding-frustum-from-a-view-projection-matrix
+        // reference: https://stackoverflow.com/questions/7692988/opengl-math-projecting-screen-space-to-world-space-coords
+        // reference: https://www.gamedev.net/forums/topic/644571-calculating-frustum-corners-from-a-projection-matrix/
+        // initialize in NDC-space
+        std::array<glm::vec4, 8> frustumCornerPoints{glm::vec4{-1.0f, -1.0f, -1.0f, 1.0f},  // [0] - (lbn) - left / bottom / near
+                                                     glm::vec4{-1.0f, -1.0f, 1.0f, 1.0f},   // [1] - (lbf) - left / bottom / far
+                                                     glm::vec4{-1.0f, 1.0f, -1.0f, 1.0f},   // [2] - (ltn) - left / top / near
+                                                     glm::vec4{-1.0f, 1.0f, 1.0f, 1.0f},    // [3] - (ltf) - left / top / far
+                                                     glm::vec4{1.0f, -1.0f, -1.0f, 1.0f},   // [4] - (rbn) - right / bottom / near
+                                                     glm::vec4{1.0f, -1.0f, 1.0f, 1.0f},    // [5] - (rbf) - right / bottom / far
+                                                     glm::vec4{1.0f, 1.0f, -1.0f, 1.0f},    // [6] - (rtn) - right / top / near
+                                                     glm::vec4{1.0f, 1.0f, 1.0f, 1.0f}};    // [7] - (rtf) - right / top / far
+
+        // scale XY-NDC to account for Gerstner wave XZ-world displacement...
+        //TODO: also scale the grid resolution so it stays roughly the same, so that it doesnt change based on these settings
+        //TODO: this still needs a lot of work (i.e. account for FOV / window size ???)
+        for (unsigned int i = 0; i < frustumCornerPoints.size(); ++i) {
+            frustumCornerPoints[i].x *= SAFETY_PADDING_SCALAR;
+            frustumCornerPoints[i].y *= SAFETY_PADDING_SCALAR;
+        }
+
+        // transform into world-space...
+        for (unsigned int i = 0; i < frustumCornerPoints.size(); ++i) {
+            glm::vec4 const temp{inverseViewProjection * frustumCornerPoints[i]};
+            frustumCornerPoints[i] = temp / temp.w;
+        }
+
+        // stores indices into frustumCornerPoints
+        // 12 edges between pairs of points
+        static std::array<unsigned int, 24> const FRUSTUM_EDGES{0,1,   // [0]  - lbn ---> lbf (across-edge)
+                                                                0,2,   // [1]  - lbn ---> ltn (near-edge)
+                                                                0,4,   // [2]  - lbn ---> rbn (near-edge)
+                                                                1,3,   // [3]  - lbf ---> ltf (far-edge)
+                                                                1,5,   // [4]  - lbf ---> rbf (far-edge)
+                                                                2,3,   // [5]  - ltn ---> ltf (across-edge)
+                                                                2,6,   // [6]  - ltn ---> rtn (near-edge)
+                                                                3,7,   // [7]  - ltf ---> rtf (far-edge)
+                                                                4,5,   // [8]  - rbn ---> rbf (across-edge)
+                                                                4,6,   // [9]  - rbn ---> rtn (near-edge)
+                                                                5,7,   // [10] - rbf ---> rtf (far-edge)
+                                                                6,7};  // [11] - rtn ---> rtf (across-edge)
+
+        // intersection testing with upper/lower bound planes...
+        // for each frustum edge...
+        for (unsigned int i = 0; i < 12; ++i) {
+            unsigned int const src{FRUSTUM_EDGES[i * 2]};
+            unsigned int const dest{FRUSTUM_EDGES[i * 2 + 1]};
+
+            geometry::Line const line{frustumCornerPoints[src], frustumCornerPoints[dest]};
+
+            // upper-bound plane
+            // first, we do a quick intersection check (plane in this case can be described by all points with y = d, since the normal is <0,1,0>)
+            if (glm::min(line.p0.y, line.p1.y) <= upperPlane.d && upperPlane.d <= glm::max(line.p0.y, line.p1.y)) {
+                glm::vec3 intersectionPoint;
+                bool const isIntersection{utils::linePlaneIntersection(intersectionPoint, line, upperPlane)};
+                //NOTE: we can't currently assert this is true, since there is the rare chance that the line lies in the plane (which is currently treated as no intersection for simplicity)
+                if (isIntersection) m_intersectionPoints[m_intersectionPointCount++] = glm::vec4{intersectionPoint, 1.0f};
+            }
+
+            // lower-bound plane
+            // first, we do a quick intersection check (plane in this case can be described by all points with y = d, since the normal is <0,1,0>)
+            if (glm::min(line.p0.y, line.p1.y) <= lowerPlane.d && lowerPlane.d <= glm::max(line.p0.y, line.p1.y)) {
+                glm::vec3 intersectionPoint;
+                bool const isIntersection{utils::linePlaneIntersection(intersectionPoint, line, lowerPlane)};
+                //NOTE: we can't currently assert this is true, since there is the rare chance that the line lies in the plane (which is currently treated as no intersection for simplicity)
+                if (isIntersection) m_intersectionPoints[m_intersectionPointCount++] = glm::vec4{intersectionPoint, 1.0f};
+            }
+        }
+
+        // include any frustum vertices that lie within (intersect) the displaceable volume (between upper and lower bounding planes)
+        // for each frustum vertex...
+        for (unsigned int i = 0; i < frustumCornerPoints.size(); ++i) {
+            glm::vec4 const& frustumCornerPoint{frustumCornerPoints[i]};
+            // we do a quick intersection check (planes in this case can be described by all points with y = d, since both have normals as <0, 1, 0>)
+            if (lowerPlane.d <= frustumCornerPoint.y && frustumCornerPoint.y <= upperPlane.d) m_intersectionPoints[m_intersectionPointCount++] = frustumCornerPoint;
+        }
+    }
+
+    void ProjectedGrid::findHullPoints() {
+        m_hullPointCount = 0;
+        if (m_intersectionPointCount < 3) return;
+
+        // sort the xy's lexicographically...
+        std::array<glm::vec2, MAX_INTERSECTION_POINT_COUNT> sortedPoints;
+        for (unsigned int i = 0; i < m_intersectionPointCount; ++i) sortedPoints[i] = glm::vec2{m_intersectionPoints[i].x, m_intersectionPoints[i].y};
+        std::sort(sortedPoints.begin(), sortedPoints.begin() + m_intersectionPointCount, [](glm::vec2 const& p0, glm::vec2 const& p1) {
+            return p0.x < p1.x || (p0.x == p1.x && p0.y < p1.y);
+        });
+
+        // then build the lower and upper chains, popping any point that doesn't make a strict left turn (so duplicates and collinear points are dropped)
+        // reference: https://en.wikibooks.org/wiki/Algorithm_Implementation/Geometry/Convex_hull/Monotone_chain
+        auto const isLeftTurn = [](glm::vec2 const& p0, glm::vec2 const& p1, glm::vec2 const& p2) {
+            return (p1.x - p0.x) * (p2.y - p0.y) - (p1.y - p0.y) * (p2.x - p0.x) > 0.0f;
+        };
+        unsigned int count{0};
+        for (unsigned int i = 0; i < m_intersectionPointCount; ++i) {
+            while (count >= 2 && !isLeftTurn(m_hullPoints[count - 2], m_hullPoints[count - 1], sortedPoints[i])) --count;
+            m_hullPoints[count++] = sortedPoints[i];
+        }
+        unsigned int const lowerCount{count + 1};
+        for (unsigned int i = m_intersectionPointCount - 1; i > 0; --i) {
+            while (count >= lowerCount && !isLeftTurn(m_hullPoints[count - 2], m_hullPoints[count - 1], sortedPoints[i - 1])) --count;
+            m_hullPoints[count++] = sortedPoints[i - 1];
+        }
+        // the last point closes the chain (it is the first point again)
+        m_hullPointCount = count - 1;
+    }
+
+    Camera ProjectedGrid::placeProjector(Camera const& camera, float const displaceableAmplitude) {
+        ///////////////////////////////////////////////////////////////////////////////////
+        // create projector...
+        // rules...
+        //  1. should never aim away from base plane
+        //  2. eye position must be outside visible volume (thus eye.y <= lowerPlane.d OR eye.y >= upperPlane.d)
+        //  3. provide the most "pleasant" possible projector transformation
+        //NOTE: due to how the triangle mesh is tessellated, the winding will always be counter-clockwise, regardless of whether the projector is above or below the base plane
+        //NOTE: the projector will only differ from the camera in its position.y and pitch, thus we can just clone the camera and then apply a translation + set pitch
+        //NOTE: there are two aimpoints that get interpolated between based on the camera's forward vector - two extreme cases (1. abs(cameraForward • <0,1,0>) == 1 (bird's eye) and 2. cameraForward • <0,1,0> == 0 (horizon)
+
+        geometry::Plane const basePlane{0.0f, 1.0f, 0.0f, 0.0f};
+
+        Camera projector{camera};
+
+        float const cameraDistanceFromBasePlane{camera.getPosition().y};
+        bool const isUnderwater{cameraDistanceFromBasePlane < 0.0f};
+        float const MINIMUM_PROJECTOR_DISTANCE_FROM_BASE_PLANE{displaceableAmplitude + PROJECTOR_ELEVATION_FROM_CAMERA};
+
+        // translate the y-position of the projector, so that it lies outside the displaceable volume (with some extra elevation padding)
+        if (cameraDistanceFromBasePlane < MINIMUM_PROJECTOR_DISTANCE_FROM_BASE_PLANE) {
+            if (isUnderwater) projector.translate(glm::vec3{0.0f, MINIMUM_PROJECTOR_DISTANCE_FROM_BASE_PLANE - 2.0f * cameraDistanceFromBasePlane, 0.0f});
+            else projector.translate(glm::vec3{0.0f, MINIMUM_PROJECTOR_DISTANCE_FROM_BASE_PLANE - cameraDistanceFromBasePlane, 0.0f});
+        }
+
+        // safely handle when the camera is looking too close to the horizon (shift the forward vector a bit to ensure the intersection test succeeds for aimpoint_1)
+        glm::vec3 cameraForwardIntersectionSafe{camera.getForward()};
+        float const SAFE_EPSILON{0.001f};
+        if (glm::abs(cameraForwardIntersectionSafe.y) < SAFE_EPSILON) {
+            float const sign{cameraForwardIntersectionSafe.y >= 0.0f ? 1.0f : -1.0f};
+            cameraForwardIntersectionSafe.y = sign * SAFE_EPSILON;
+            //NOTE: there is no need to normalize this (and I don't want to cause the ypos will decrease)
+        }
+
+        // compute aimpoint for method 1 (bird's eye)...
+        glm::vec3 aimpoint_1;
+        bool const isLookingDown{cameraForwardIntersectionSafe.y < 0.0f};
+        bool const isLookingDown_XOR_isUnderwater{isLookingDown != isUnderwater};
+        if (isLookingDown_XOR_isUnderwater) {
+            bool const isIntersection{utils::linePlaneIntersection(aimpoint_1, geometry::Line{camera.getPosition(), camera.getPosition() + cameraForwardIntersectionSafe}, basePlane)};
+            assert(isIntersection);
+        } else {
+            glm::vec3 const cameraForwardIntersectionSafeMirrored{glm::reflect(cameraForwardIntersectionSafe, basePlane.getNormalVec())};
+            bool const isIntersection{utils::linePlaneIntersection(aimpoint_1, geometry::Line{camera.getPosition(), camera.getPosition() + cameraForwardIntersectionSafeMirrored}, basePlane)};
+            assert(isIntersection);
+        }
+
+        // compute aimpoint for method 2 (horizon)...
+        //TODO: make this a UI property? auto-generate it?
+        float const FORWARD_FIXED_LENGTH{1.0f};
+        glm::vec3 aimpoint_2{camera.getPosition() + FORWARD_FIXED_LENGTH * camera.getForward()};
+        // project this point onto the base plane
+        aimpoint_2.y = 0.0f;
+
+        //NOTE: the grid changes abruptly when aimpoint_final == aimpoint2 (a == 0), but this will never occur since...
+        //      I made the camera's forward vector (for the math only) intersection safe (aimpoint_1 will be defined and a != 0.0)
+        // compute the interpolation coefficient in range [SAFE_EPSILON, 1.0]...
+        float const a{glm::abs(cameraForwardIntersectionSafe.y)};
+
+        // compute the final aimpoint as an interpolation between the two aimpoints...
+        glm::vec3 const aimpoint_final{glm::mix(aimpoint_2, aimpoint_1, a)};
+
+        // compute the projector's pitch in order to aim at this aimpoint...
+        glm::vec3 const projectorNewForwardVec{glm::normalize(aimpoint_final - projector.getPosition())};
+        glm::vec3 const projectorNewForwardVecXZProjection{glm::normalize(glm::vec3{projectorNewForwardVec.x, 0.0f, projectorNewForwardVec.z})};
+        //NOTE: the projector's position will always be above water, thus the pitch will always be negative
+        float projectorNewPitchDegrees{-glm::degrees(glm::acos(glm::dot(projectorNewForwardVec, projectorNewForwardVecXZProjection)))};
+
+        // now, aim the projector...
+        projector.setRotation(projector.getYaw(), projectorNewPitchDegrees);
+        ///////////////////////////////////////////////////////////////////////////////////
+
+        return projector;
+    }
+
+    glm::mat4 ProjectedGrid::computeRangeMat(std::array<glm::vec2, 4> const& rangeQuad) {
+        // the unit square's corners [0, 0], [1, 0], [1, 1], [0, 1] go to the quad's corners q0, q1, q2, q3, via
+        // x = (a * u + b * v + c) / (g * u + h * v + 1) and y = (d * u + e * v + f) / (g * u + h * v + 1)
+        glm::vec2 const& q0{rangeQuad[0]};
+        glm::vec2 const& q1{rangeQuad[1]};
+        glm::vec2 const& q2{rangeQuad[2]};
+        glm::vec2 const& q3{rangeQuad[3]};
+        glm::vec2 const sum{q0 - q1 + q2 - q3};
+        float g{0.0f};
+        float h{0.0f};
+        // a parallelogram (e.g. the axis-aligned bounds) is just an affine map, otherwise solve for the perspective terms
+        if (0.0f != sum.x || 0.0f != sum.y) {
+            glm::vec2 const delta1{q1 - q2};
+            glm::vec2 const delta2{q3 - q2};
+            float const denominator{delta1.x * delta2.y - delta2.x * delta1.y};
+            if (0.0f != denominator) {
+                g = (sum.x * delta2.y - delta2.x * sum.y) / denominator;
+                h = (delta1.x * sum.y - sum.x * delta1.y) / denominator;
+            }
+        }
+        glm::vec2 const uColumn{q1 - q0 + g * q1};
+        glm::vec2 const vColumn{q3 - q0 + h * q3};
+
+        // as a matrix (in column-major order), leaving z alone (it only picks a point along the projector ray, which is the same for any w > 0)
+        //
+        // |a, b, 0, c|
+        // |d, e, 0, f|
+        // |0, 0, 1, 0|
+        // |g, h, 0, 1|
+        //
+        //NOTE: for the axis-aligned bounds this is the original range matrix (a = x_max - x_min, e = y_max - y_min, c = x_min, f = y_min, the rest 0)
+        return glm::mat4{uColumn.x, uColumn.y, 0.0f, g,
+                         vColumn.x, vColumn.y, 0.0f, h,
+                         0.0f, 0.0f, 1.0f, 0.0f,
+                         q0.x, q0.y, 0.0f, 1.0f};
+    }
+}
@@ -0,0 +1,103 @@
+#ifndef WAVE_TOOL_PROJECTED_GRID_H_
+#define WAVE_TOOL_PROJECTED_GRID_H_
+
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+// reference: https://fileadmin.cs.lth.se/graphics/theses/projects/projgrid/
+
+#include <glm/glm.hpp>
+
+#include <array>
+
+#include "camera.h"
+
+namespace wave_tool {
+    // fits the projected grid to the part of the camera frustum that intersects the displaceable volume (the slab between the lower and upper bounding planes around the base plane y = 0)
+    //NOTE: no GL dependencies and no heap allocation per update, all intermediate points live in fixed-capacity member storage
+    class ProjectedGrid {
+        public:
+            // 12 frustum edges can each cross both bounding planes, plus the 8 frustum corners
+            inline static unsigned int const MAX_INTERSECTION_POINT_COUNT{12 * 2 + 8};
+            // scale of XY-NDC to account for Gerstner wave XZ-world displacement
+            //TODO: dynamically set this scale based on wave settings (so that the frustum is as small as possible - reduce overdraw)
+            inline static float const SAFETY_PADDING_SCALAR{1.2f};
+            //TODO: make this a UI property
+            inline static float const PROJECTOR_ELEVATION_FROM_CAMERA{1.0f};
+
+            bool isUsingHullFit{true}; // true fits the projector range to a quad around the convex hull of the intersection points, false to their axis-aligned bounds (the original fit)
+
+            // returns false if the camera frustum doesn't intersect the displaceable volume (nothing to draw), in which case the previous projector/corners are kept
+            bool update(Camera const& camera, float const displaceableAmplitude);
+
+            // the world-space grid corners on the base plane, indexed [0] - bottom-left, [1] - top-left, [2] - bottom-right, [3] - top-right
+            std::array<glm::vec4, 4> const& getCornerPoints() const;
+            // the number of convex hull vertices the range quad was fit around during the last update (0 while !isUsingHullFit)
+            unsigned int getHullPointCount() const;
+            // the number of points the projector range was fit to during the last update
+            unsigned int getIntersectionPointCount() const;
+            // the projector's (inverse view-projection) matrix, taking "range-space" (the grid's uv in [0, 1]^2 with z along the projector ray) to world-space
+            glm::mat4 const& getProjectorMat() const;
+            // the projector range in its NDC-space, ordered counter-clockwise from the grid's bottom-left corner (uv = [0, 0], [1, 0], [1, 1], [0, 1])
+            std::array<glm::vec2, 4> const& getRangeQuad() const;
+
+            // counts the vertices of a gridLength x gridLength grid between the corners (interpolated as in water-grid.vert) that land inside the view-projection's frustum
+            //NOTE: this is on the base plane (the displacement isn't known on the CPU), so it measures how much of the grid the fit wastes off-screen
+            static unsigned int countVisibleGridVertices(std::array<glm::vec4, 4> const& cornerPoints, glm::mat4 const& viewProjection, unsigned int const gridLength);
+        private:
+            std::array<glm::vec4, 4> m_cornerPoints{glm::vec4{0.0f}, glm::vec4{0.0f}, glm::vec4{0.0f}, glm::vec4{0.0f}};
+            // the intersection of the (extended) hull edges i and j, only valid if j turns counter-clockwise from i by less than 180 degrees and the point is below the projector's horizon
+            std::array<std::array<glm::vec2, MAX_INTERSECTION_POINT_COUNT>, MAX_INTERSECTION_POINT_COUNT> m_hullEdgeIntersections;
+            std::array<std::array<bool, MAX_INTERSECTION_POINT_COUNT>, MAX_INTERSECTION_POINT_COUNT> m_isHullEdgeIntersectionValid;
+            // counter-clockwise (monotone chain), with room for the points the chain pushes and later pops again
+            std::array<glm::vec2, 2 * MAX_INTERSECTION_POINT_COUNT> m_hullPoints;
+            unsigned int m_hullPointCount{0};
+            std::array<glm::vec4, MAX_INTERSECTION_POINT_COUNT> m_intersectionPoints;
+            unsigned int m_intersectionPointCount{0};
+            glm::mat4 m_projectorMat{1.0f};
+            std::array<glm::vec2, 4> m_rangeQuad{glm::vec2{0.0f}, glm::vec2{0.0f}, glm::vec2{0.0f}, glm::vec2{0.0f}};
+
+            // replaces rangeQuad (initially the axis-aligned bounds) with the smallest quad around m_hullPoints whose sides all lie on hull edges, if there is a smaller one
+            //NOTE: horizon is the projector's horizon line in its NDC-space (a, b, c with a * x + b * y + c >= 0 below it), no quad corner may get closer to it than the hull itself does (or the corner's ray would run off towards the horizon)
+            void fitHullQuad(glm::vec3 const& horizon, std::array<glm::vec2, 4> &rangeQuad);
+            // appends the frustum/volume intersection points of the camera to m_intersectionPoints (world-space)
+            void findIntersectionPoints(glm::mat4 const& inverseViewProjection, float const displaceableAmplitude);
+            // the convex hull of the (NDC-space) intersection points' xy, into m_hullPoints
+            void findHullPoints();
+            // returns the projector, which only differs from the camera in its position.y and pitch
+            static Camera placeProjector(Camera const& camera, float const displaceableAmplitude);
+            // the (perspective) map from range-space to the projector's NDC-space that takes the unit square onto a convex quad
+            // reference: https://www.cs.cmu.edu/~ph/texfund/texfund.pdf (Heckbert, section 3.2.3 - square to quadrilateral)
+            static glm::mat4 computeRangeMat(std::array<glm::vec2, 4> const& rangeQuad);
+    };
+}
+
+#endif // WAVE_TOOL_PROJECTED_GRID_H_
@@ -31,41 +31,155 @@
 
 #include "render-engine.h"
 
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
 #include <string>
 #include <vector>
 
-#define STB_IMAGE_IMPLEMENTATION
 #include <stb/stb_image.h>
 
 namespace wave_tool {
+    bool SkyCubemapLayerKey::operator==(SkyCubemapLayerKey const& other) const {
+        return object == other.object &&
+               isVisible == other.isVisible &&
+               textureID == other.textureID &&
+               polygonMode == other.polygonMode;
+    }
+
+    bool SkyCubemapKey::operator==(SkyCubemapKey const& other) const {
+        return timeOfDayInHours == other.timeOfDayInHours &&
+               cloudProportion == other.cloudProportion &&
+               overcastStrength == other.overcastStrength &&
+               sunHorizonDarkness == other.sunHorizonDarkness &&
+               sunShininess == other.sunShininess &&
+               sunStrength == other.sunStrength &&
+               fogColourFarAtNoon == other.fogColourFarAtNoon &&
+               isFogLayerVisible == other.isFogLayerVisible &&
+               layers == other.layers;
+    }
+
     RenderEngine::RenderEngine(GLFWwindow *window) {
         glfwGetWindowSize(window, &m_windowWidth, &m_windowHeight);
 
         // hard-coded defaults
-        gerstnerWaves.at(0) = std::make_shared<geometry::GerstnerWave>(0.06f, 1.0f, 2.0f, 1.0f, glm::vec2{1.0f, 0.0f});
-        gerstnerWaves.at(1) = std::make_shared<geometry::GerstnerWave>(0.1f, 1.0f, 0.2f, 0.0f, glm::normalize(glm::vec2{1.0f, 1.0f}));
-        gerstnerWaves.at(2) = std::make_shared<geometry::GerstnerWave>(0.0f, 0.0f, 0.0f, 0.0f, glm::vec2{0.0f, 1.0f});
-        gerstnerWaves.at(3) = std::make_shared<geometry::GerstnerWave>(0.0f, 0.0f, 0.0f, 0.0f, glm::vec2{0.0f, 1.0f});
+        //NOTE: the 2 flat waves are kept since steepness_Q_i is normalized by the wave count (removing them would change the look of the defaults)
+        gerstnerWaves.emplace_back(0.06f, 1.0f, 2.0f, 1.0f, glm::vec2{1.0f, 0.0f});
+        gerstnerWaves.emplace_back(0.1f, 1.0f, 0.2f, 0.0f, glm::normalize(glm::vec2{1.0f, 1.0f}));
+        gerstnerWaves.emplace_back(0.0f, 0.0f, 0.0f, 0.0f, glm::vec2{0.0f, 1.0f});
+        gerstnerWaves.emplace_back(0.0f, 0.0f, 0.0f, 0.0f, glm::vec2{0.0f, 1.0f});
+
+        // shared by all the multithreaded CPU work (e.g. the FFT ocean)
+        m_threadPool = std::make_shared<ThreadPool>();
 
         //NOTE: near distance must be small enough to not conflict with skybox size
         m_camera = std::make_shared<Camera>(72.0f, (float)m_windowWidth / m_windowHeight, Z_NEAR, Z_FAR, glm::vec3(0.0f, 4.0f, 70.0f));
 
         //TODO: assert these are not 0, or wrap them and assert non-null
-        depthProgram = ShaderTools::compileShaders("../../assets/shaders/depth.vert", "../../assets/shaders/depth.frag");
-        screenSpaceQuadProgram = ShaderTools::compileShaders("../../assets/shaders/screen-space-quad.vert", "../../assets/shaders/screen-space-quad.frag");
-        skyboxCloudsProgram = ShaderTools::compileShaders("../../assets/shaders/skybox-clouds.vert", "../../assets/shaders/skybox-clouds.frag");
-        skyboxStarsProgram = ShaderTools::compileShaders("../../assets/shaders/skybox-stars.vert", "../../assets/shaders/skybox-stars.frag");
-        skyboxTrivialProgram = ShaderTools::compileShaders("../../assets/shaders/skybox-trivial.vert", "../../assets/shaders/skybox-trivial.frag");
-        skysphereProgram = ShaderTools::compileShaders("../../assets/shaders/skysphere.vert", "../../assets/shaders/skysphere.frag");
-        trivialProgram = ShaderTools::compileShaders("../../assets/shaders/trivial.vert", "../../assets/shaders/trivial.frag");
-        mainProgram = ShaderTools::compileShaders("../../assets/shaders/main.vert", "../../assets/shaders/main.frag");
-        waterGridProgram = ShaderTools::compileShaders("../../assets/shaders/water-grid.vert", "../../assets/shaders/water-grid.frag");
-        worldSpaceDepthProgram = ShaderTools::compileShaders("../../assets/shaders/world-space-depth.vert", "../../assets/shaders/world-space-depth.frag");
+        depthProgram = ShaderProgram{ShaderTools::compileShaders("../../assets/shaders/depth.vert", "../../assets/shaders/depth.frag")};
+        screenSpaceQuadProgram = ShaderProgram{ShaderTools::compileShaders("../../assets/shaders/screen-space-quad.vert", "../../assets/shaders/screen-space-quad.frag")};
+        skyboxCloudsProgram = ShaderProgram{ShaderTools::compileShaders("../../assets/shaders/skybox-clouds.vert", "../../assets/shaders/skybox-clouds.frag")};
+        skyboxStarsProgram = ShaderProgram{ShaderTools::compileShaders("../../assets/shaders/skybox-stars.vert", "../../assets/shaders/skybox-stars.frag")};
+        skyboxTrivialProgram = ShaderProgram{ShaderTools::compileShaders("../../assets/shaders/skybox-trivial.vert", "../../assets/shaders/skybox-trivial.frag")};
+        skysphereProgram = ShaderProgram{ShaderTools::compileShaders("../../assets/shaders/skysphere.vert", "../../assets/shaders/skysphere.frag")};
+        // the sky programs again, with a geometry stage that draws into all 6 faces of the sky cubemap at once (see renderSkyCubemapLayers())
+        screenSpaceQuadLayeredProgram = ShaderProgram{ShaderTools::compileShaders("../../assets/shaders/screen-space-quad.vert", "../../assets/shaders/screen-space-quad-layers.geom", "../../assets/shaders/screen-space-quad.frag")};
+        skyboxCloudsLayeredProgram = ShaderProgram{ShaderTools::compileShaders("../../assets/shaders/skybox-clouds.vert", "../../assets/shaders/sky-cubemap-layers.geom", "../../assets/shaders/skybox-clouds.frag")};
+        skyboxStarsLayeredProgram = ShaderProgram{ShaderTools::compileShaders("../../assets/shaders/skybox-stars.vert", "../../assets/shaders/sky-cubemap-layers.geom", "../../assets/shaders/skybox-stars.frag")};
+        skysphereLayeredProgram = ShaderProgram{ShaderTools::compileShaders("../../assets/shaders/skysphere.vert", "../../assets/shaders/sky-cubemap-layers.geom", "../../assets/shaders/skysphere.frag")};
+        trivialProgram = ShaderProgram{ShaderTools::compileShaders("../../assets/shaders/trivial.vert", "../../assets/shaders/trivial.frag")};
+        mainProgram = ShaderProgram{ShaderTools::compileShaders("../../assets/shaders/main.vert", "../../assets/shaders/main.frag")};
+        waterGridProgram = ShaderProgram{ShaderTools::compileShaders("../../assets/shaders/water-grid.vert", "../../assets/shaders/water-grid.frag")};
+        // the same vertex stage, but writing the displaced surface into a transform feedback buffer (see WaterSurfaceVertex), and its pass-through twin that draws from that buffer
+        waterGridCaptureProgram = ShaderProgram{ShaderTools::compileTransformFeedbackShader("../../assets/shaders/water-grid.vert", {"worldPosition", "worldNormal", "xyPositionNDCSpaceHeight0"})};
+        waterGridCapturedProgram = ShaderProgram{ShaderTools::compileShaders("../../assets/shaders/water-grid-captured.vert", "../../assets/shaders/water-grid.frag")};
+        // the coarse patch grid, subdivided by the tessellator and displaced in the evaluation stage (same fragment stage)
+        waterGridTessellationProgram = ShaderProgram{ShaderTools::compileTessellationShaders("../../assets/shaders/water-grid-patches.vert", "../../assets/shaders/water-grid.tesc", "../../assets/shaders/water-grid.tese", "../../assets/shaders/water-grid.frag")};
+        glGetIntegerv(GL_MAX_TESS_GEN_LEVEL, &m_maxWaterTessellationLevel);
+        worldSpaceDepthProgram = ShaderProgram{ShaderTools::compileShaders("../../assets/shaders/world-space-depth.vert", "../../assets/shaders/world-space-depth.frag")};
+        m_scenePrograms = {SceneProgram{&trivialProgram, trivialProgram.getUniform<GLint>("textureData")}, SceneProgram{&mainProgram, mainProgram.getUniform<GLint>("textureData")}};
+
+        ///////////////////////////////////////////////////
+        // UNIFORM BLOCK BINDINGS...
+        //NOTE: GLSL 4.10 has no layout(binding = N) for uniform blocks, so every program points the blocks it uses at the fixed binding points here
+        //NOTE: the sizes are checked against the C++ mirrors (see scene-blocks.h), the GerstnerWaveBlock's size is its capacity instead (see below)
+        struct UniformBlock {
+            char const* name;
+            UniformBlockBinding binding;
+            GLint sizeInBytes; // 0 = not checked
+        };
+        std::array<UniformBlock, 4> const uniformBlocks{UniformBlock{"GerstnerWaveBlock", UniformBlockBinding::GERSTNER_WAVES, 0},
+                                                        UniformBlock{"FrameBlock", UniformBlockBinding::FRAME, (GLint)sizeof(FrameBlockStd140)},
+                                                        UniformBlock{"PassBlock", UniformBlockBinding::PASS, (GLint)sizeof(PassBlockStd140)},
+                                                        UniformBlock{"SkyCubemapBlock", UniformBlockBinding::SKY_CUBEMAP, (GLint)sizeof(SkyCubemapBlockStd140)}};
+        for (ShaderProgram const* program : {&depthProgram, &screenSpaceQuadProgram, &skyboxCloudsProgram, &skyboxStarsProgram, &skyboxTrivialProgram, &skysphereProgram, &trivialProgram,
+                                             &screenSpaceQuadLayeredProgram, &skyboxCloudsLayeredProgram, &skyboxStarsLayeredProgram, &skysphereLayeredProgram, &mainProgram, &waterGridCaptureProgram, &waterGridCapturedProgram, &waterGridProgram, &waterGridTessellationProgram, &worldSpaceDepthProgram}) {
+            if (!program->isValid()) continue;
+            for (UniformBlock const& uniformBlock : uniformBlocks) {
+                GLuint const blockIndex{program->getUniformBlockIndex(uniformBlock.name)};
+                if (GL_INVALID_INDEX == blockIndex) continue;
+                glUniformBlockBinding(program->getID(), blockIndex, uniformBlock.binding);
+                if (0 == uniformBlock.sizeInBytes) continue;
+                GLint blockSizeInBytes{0};
+                glGetActiveUniformBlockiv(program->getID(), blockIndex, GL_UNIFORM_BLOCK_DATA_SIZE, &blockSizeInBytes);
+                if (blockSizeInBytes != uniformBlock.sizeInBytes) std::cout << "ERROR: render-engine.cpp - " << uniformBlock.name << " size (" << blockSizeInBytes << ") does not match the std140 layout in scene-blocks.h!" << std::endl;
+            }
+        }
+        ///////////////////////////////////////////////////
+
+        ///////////////////////////////////////////////////
+        // SCENE UBOS (frame and pass blocks) + OBJECT DATA BUFFERS...
+        // reference: https://www.khronos.org/opengl/wiki/Uniform_Buffer_Object
+        //NOTE: the storage is (re-)specified every frame when the buffer is orphaned, so it is only generated here
+        GLint uniformBufferOffsetAlignment{0};
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformBufferOffsetAlignment);
+        std::size_t const alignment{(std::size_t)glm::max(uniformBufferOffsetAlignment, 1)};
+        m_frameBlockStride = (sizeof(FrameBlockStd140) + alignment - 1) / alignment * alignment;
+        m_passBlockStride = (sizeof(PassBlockStd140) + alignment - 1) / alignment * alignment;
+        glGenBuffers(SCENE_UNIFORM_BUFFER_COUNT, m_sceneUBOs.data());
+        // the object data is read through a texture buffer (any number of objects, unlike a uniform block), whose buffer is switched to the one written each frame
+        // reference: https://www.khronos.org/opengl/wiki/Buffer_Texture
+        //NOTE: GL_MAX_TEXTURE_BUFFER_SIZE is at least 65536 texels, i.e. 13107 objects
+        glGenBuffers(SCENE_UNIFORM_BUFFER_COUNT, m_objectDataBuffers.data());
+        glGenTextures(1, &m_objectDataTexture);
+        for (ShaderProgram *program : {&depthProgram, &trivialProgram, &mainProgram, &worldSpaceDepthProgram}) program->set<GLint>("objectData", m_objectDataTexture);
+        ///////////////////////////////////////////////////
+
+        ///////////////////////////////////////////////////
+        // GERSTNER WAVE UBO...
+        // reference: https://learnopengl.com/Advanced-OpenGL/Advanced-GLSL (uniform buffer objects)
+        //NOTE: the capacity comes from the block size reported by the linked program, so the array length in gerstner-waves.glsl is the only place it is defined
+        GLint gerstnerWaveBlockSize{0};
+        GLuint const gerstnerWaveBlockIndex{waterGridProgram.getUniformBlockIndex("GerstnerWaveBlock")};
+        if (GL_INVALID_INDEX == gerstnerWaveBlockIndex) {
+            std::cout << "ERROR: render-engine.cpp - GerstnerWaveBlock not found in water grid program!" << std::endl;
+        } else {
+            glGetActiveUniformBlockiv(waterGridProgram.getID(), gerstnerWaveBlockIndex, GL_UNIFORM_BLOCK_DATA_SIZE, &gerstnerWaveBlockSize);
+            if (gerstnerWaveBlockSize < (GLint)sizeof(geometry::GerstnerWaveBlockHeaderStd140)) {
+                std::cout << "ERROR: render-engine.cpp - GerstnerWaveBlock size (" << gerstnerWaveBlockSize << ") does not match the std140 layout in gerstner-wave.h!" << std::endl;
+                gerstnerWaveBlockSize = 0;
+            } else {
+                m_gerstnerWaveCapacity = (gerstnerWaveBlockSize - sizeof(geometry::GerstnerWaveBlockHeaderStd140)) / sizeof(geometry::GerstnerWaveStd140);
+            }
+        }
+        glGenBuffers(1, &m_gerstnerWaveUBO);
+        glBindBuffer(GL_UNIFORM_BUFFER, m_gerstnerWaveUBO);
+        // allocate the full block once (zeroed count until the first update)
+        std::vector<unsigned char> const zeroedGerstnerWaveBlock(glm::max(gerstnerWaveBlockSize, (GLint)sizeof(geometry::GerstnerWaveBlockHeaderStd140)), 0);
+        glBufferData(GL_UNIFORM_BUFFER, zeroedGerstnerWaveBlock.size(), zeroedGerstnerWaveBlock.data(), GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        //NOTE: indexed binding points are global state, so this only has to be done once
+        glBindBufferBase(GL_UNIFORM_BUFFER, UniformBlockBinding::GERSTNER_WAVES, m_gerstnerWaveUBO);
+        ///////////////////////////////////////////////////
 
         // Set OpenGL state
-        glEnable(GL_DEPTH_TEST);
-        glEnable(GL_LINE_SMOOTH);
+        GLStateCache::setEnabled(GL_DEPTH_TEST, true);
+        // filter across the cubemap face edges (most visible on the coarser mips)
+        GLStateCache::setEnabled(GL_TEXTURE_CUBE_MAP_SEAMLESS, true);
+        GLStateCache::setEnabled(GL_LINE_SMOOTH, true);
         glPointSize(30.0f);
         glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
         ///////////////////////////////////////////////////
@@ -75,27 +189,213 @@ namespace wave_tool {
         glGenVertexArrays(1, &m_emptyVAO);
         ///////////////////////////////////////////////////
 
+        ///////////////////////////////////////////////////
+        // GPU timers (water surface capture vs. draw, whole frame)...
+        for (std::array<GLuint, GPU_TIMER_COUNT> &queries : m_gpuTimerQueries) glGenQueries(GPU_TIMER_COUNT, queries.data());
+        ///////////////////////////////////////////////////
+
+        ///////////////////////////////////////////////////
+        // 1x1x1 array texture for array samplers that currently have nothing to sample
+        float const placeholderTexel[4]{0.0f, 1.0f, 0.0f, 0.0f};
+        m_placeholderTexture2DArray = Texture::create2DTextureArrayRGBA16F(placeholderTexel, 1, 1, 1);
+        ///////////////////////////////////////////////////
+
         ///////////////////////////////////////////////////
         // init stuff for dynamic skybox texture updating...
         // reference: https://www.youtube.com/watch?v=21UsMuFTN0k
         // reference: https://www.youtube.com/watch?v=lW_iqrtJORc
         glGenFramebuffers(1, &m_skyboxFBO);
-        glBindFramebuffer(GL_FRAMEBUFFER, m_skyboxFBO);
+        GLStateCache::bindFramebuffer(m_skyboxFBO);
         // attach colour buffer to FBO
         glDrawBuffer(GL_COLOR_ATTACHMENT0);
         // unbind / reset to default screen framebuffer
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        GLStateCache::bindFramebuffer(0);
 
         //TODO: refactor this to own function, along with part in loadCubemap()
         glGenTextures(1, &m_skyboxCubemap);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, m_skyboxCubemap);
+        GLStateCache::bindTexture(GL_TEXTURE_CUBE_MAP, m_skyboxCubemap);
         // set options on currently bound texture object...
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        // trilinear, the water's reflections pick coarser mips for distant (and noisy) reflection vectors
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // unbind
+        GLStateCache::bindTexture(GL_TEXTURE_CUBE_MAP, 0);
+
+        // the whole cubemap as 1 layered attachment (the geometry stage then picks the face with gl_Layer)
+        // reference: https://www.khronos.org/opengl/wiki/Framebuffer_Object#Layered_images
+        glGenFramebuffers(1, &m_skyboxLayeredFBO);
+        // the storage (and the layered FBO's attachment) is sized to match the viewport, and re-sized whenever the chosen length changes (see render())
+        resizeSkyCubemap(getSkyCubemapLengthForViewport(m_windowHeight, m_camera->getFOV()));
+
+        // the faces' view-projections never change, so they are uploaded (and bound) once
+        SkyCubemapBlockStd140 skyCubemapBlock;
+        for (unsigned int i = 0; i < 6; ++i) skyCubemapBlock.faceVPs[i] = CUBEMAP_VP_NO_TRANSLATION_MATS.at(i);
+        glGenBuffers(1, &m_skyCubemapUBO);
+        glBindBuffer(GL_UNIFORM_BUFFER, m_skyCubemapUBO);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(SkyCubemapBlockStd140), &skyCubemapBlock, GL_STATIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        glBindBufferBase(GL_UNIFORM_BUFFER, UniformBlockBinding::SKY_CUBEMAP, m_skyCubemapUBO);
+        ///////////////////////////////////////////////////
+
+        //NOTE: the render targets of the other passes (depth, world-space depth, local reflections/refractions) are transients of the frame graph, allocated once a live pass first uses them (see buildFrameGraph())
+    }
+
+    RenderEngine::~RenderEngine() {
+        m_frameGraph.releasePool();
+
+        GLStateCache::deleteTextures(1, &m_skyboxCubemap);
+        GLStateCache::deleteFramebuffers(1, &m_skyboxFBO);
+        GLStateCache::deleteFramebuffers(1, &m_skyboxLayeredFBO);
+        glDeleteBuffers(1, &m_skyCubemapUBO);
+
+        GLStateCache::deleteVertexArrays(1, &m_emptyVAO);
+
+        glDeleteBuffers(1, &m_gerstnerWaveUBO);
+        glDeleteBuffers(SCENE_UNIFORM_BUFFER_COUNT, m_sceneUBOs.data());
+        GLStateCache::deleteTextures(1, &m_objectDataTexture);
+        glDeleteBuffers(SCENE_UNIFORM_BUFFER_COUNT, m_objectDataBuffers.data());
+
+        GLStateCache::deleteTextures(1, &m_oceanDisplacementTexture2D);
+        GLStateCache::deleteTextures(1, &m_oceanNormalTexture2D);
+
+        GLStateCache::deleteTextures(1, &m_gerstnerAtlasDisplacementTexture2DArray);
+        GLStateCache::deleteTextures(1, &m_gerstnerAtlasNormalTexture2DArray);
+        GLStateCache::deleteTextures(1, &m_placeholderTexture2DArray);
+
+        GLStateCache::deleteTextures(HEIGHTMAP_SEQUENCE_TEXTURE_COUNT, m_heightmapSequenceTextures.data());
+        glDeleteBuffers(HEIGHTMAP_SEQUENCE_PBO_COUNT, m_heightmapSequencePBOs.data());
+
+        if (nullptr != m_waterSurfaceReadbackFence) glDeleteSync(m_waterSurfaceReadbackFence);
+        GLStateCache::deleteVertexArrays(1, &m_waterSurfaceCaptureVAO);
+        glDeleteBuffers(1, &m_waterSurfaceCaptureBuffer);
+        glDeleteBuffers(1, &m_waterSurfaceReadbackBuffer);
+        for (std::array<GLuint, GPU_TIMER_COUNT> &queries : m_gpuTimerQueries) glDeleteQueries(GPU_TIMER_COUNT, queries.data());
+
+        glDeleteProgram(mainProgram.getID());
+        glDeleteProgram(screenSpaceQuadProgram.getID());
+        glDeleteProgram(screenSpaceQuadLayeredProgram.getID());
+        glDeleteProgram(skyboxCloudsLayeredProgram.getID());
+        glDeleteProgram(skyboxStarsLayeredProgram.getID());
+        glDeleteProgram(skysphereLayeredProgram.getID());
+        glDeleteProgram(skyboxCloudsProgram.getID());
+        glDeleteProgram(skyboxStarsProgram.getID());
+        glDeleteProgram(skyboxTrivialProgram.getID());
+        glDeleteProgram(skysphereProgram.getID());
+        glDeleteProgram(trivialProgram.getID());
+        glDeleteProgram(waterGridCaptureProgram.getID());
+        glDeleteProgram(waterGridCapturedProgram.getID());
+        glDeleteProgram(waterGridProgram.getID());
+        glDeleteProgram(waterGridTessellationProgram.getID());
+        glDeleteProgram(worldSpaceDepthProgram.getID());
+    }
+
+    std::shared_ptr<Camera> RenderEngine::getCamera() const {
+        return m_camera;
+    }
+
+    unsigned int RenderEngine::roundLocalPassDownscale(unsigned int const downscale) {
+        return downscale >= 3 ? 4 : downscale >= 2 ? 2 : 1;
+    }
+
+    FrameGraphHandles RenderEngine::buildFrameGraph(FrameGraph &frameGraph, FrameGraphInputs const& inputs) {
+        FrameGraphHandles graph;
+        bool const isShowingDebugTexture{RenderMode::DEFAULT != inputs.renderMode};
+        GLsizei const localReflectionsWidth{glm::max(inputs.windowWidth / (int)inputs.localReflectionsDownscale, 1)};
+        GLsizei const localReflectionsHeight{glm::max(inputs.windowHeight / (int)inputs.localReflectionsDownscale, 1)};
+        GLsizei const localRefractionsWidth{glm::max(inputs.windowWidth / (int)inputs.localRefractionsDownscale, 1)};
+        GLsizei const localRefractionsHeight{glm::max(inputs.windowHeight / (int)inputs.localRefractionsDownscale, 1)};
+
+        frameGraph.reset(inputs.windowWidth, inputs.windowHeight);
+
+        // persistent resources...
+        graph.skyCubemap = frameGraph.importResource("sky cubemap", inputs.skyCubemapSizeInBytes);
+        graph.backbuffer = frameGraph.importResource("backbuffer", 0);
+
+        // transient render targets...
+        //NOTE: the local passes get their own depth buffers, since they may be rendered at a reduced size (and the water reads them back for the depth-aware upsample)
+        graph.localReflectionsTexture = frameGraph.createTexture("local reflections", {localReflectionsWidth, localReflectionsHeight, GL_RGBA8});
+        graph.localReflectionsDepthTexture = frameGraph.createTexture("local reflections depth", {localReflectionsWidth, localReflectionsHeight, GL_DEPTH_COMPONENT24});
+        graph.localRefractionsTexture = frameGraph.createTexture("local refractions", {localRefractionsWidth, localRefractionsHeight, GL_RGBA8});
+        graph.localRefractionsDepthTexture = frameGraph.createTexture("local refractions depth", {localRefractionsWidth, localRefractionsHeight, GL_DEPTH_COMPONENT24});
+        graph.worldSpaceDepthTexture = frameGraph.createTexture("world-space depth", {inputs.windowWidth, inputs.windowHeight, GL_RGBA8});
+        graph.worldSpaceDepthBufferTexture = frameGraph.createTexture("world-space depth buffer", {inputs.windowWidth, inputs.windowHeight, GL_DEPTH_COMPONENT24});
+        graph.depthTexture = frameGraph.createTexture("depth", {inputs.windowWidth, inputs.windowHeight, GL_DEPTH_COMPONENT24});
+
+        // passes (in execution order)...
+        // the sky cubemap is cached across frames, so its pass always stays (it just has nothing to do while no face is stale)
+        graph.skyPass = frameGraph.addPass("sky cubemap");
+        frameGraph.write(graph.skyPass, graph.skyCubemap);
+
+        graph.localReflectionsPass = frameGraph.addPass("local reflections");
+        frameGraph.write(graph.localReflectionsPass, graph.localReflectionsTexture);
+        frameGraph.write(graph.localReflectionsPass, graph.localReflectionsDepthTexture);
+
+        graph.localRefractionsPass = frameGraph.addPass("local refractions");
+        frameGraph.write(graph.localRefractionsPass, graph.localRefractionsTexture);
+        frameGraph.write(graph.localRefractionsPass, graph.localRefractionsDepthTexture);
+
+        graph.worldSpaceDepthPass = frameGraph.addPass("world-space depth");
+        frameGraph.write(graph.worldSpaceDepthPass, graph.worldSpaceDepthTexture);
+        frameGraph.write(graph.worldSpaceDepthPass, graph.worldSpaceDepthBufferTexture);
+
+        graph.depthPass = frameGraph.addPass("depth");
+        frameGraph.write(graph.depthPass, graph.depthTexture);
+
+        // the skybox and the scene objects, only drawn when no debug render mode covers them
+        graph.opaquePass = frameGraph.addPass("opaque");
+        frameGraph.read(graph.opaquePass, graph.skyCubemap);
+        if (!isShowingDebugTexture) frameGraph.write(graph.opaquePass, graph.backbuffer);
+
+        graph.waterPass = frameGraph.addPass("water");
+        frameGraph.read(graph.waterPass, graph.skyCubemap);
+        frameGraph.read(graph.waterPass, graph.localReflectionsTexture);
+        frameGraph.read(graph.waterPass, graph.localRefractionsTexture);
+        frameGraph.read(graph.waterPass, graph.depthTexture);
+        if (1 != inputs.localReflectionsDownscale) frameGraph.read(graph.waterPass, graph.localReflectionsDepthTexture);
+        if (1 != inputs.localRefractionsDownscale) frameGraph.read(graph.waterPass, graph.localRefractionsDepthTexture);
+        if (inputs.isWaterInView && !isShowingDebugTexture) frameGraph.write(graph.waterPass, graph.backbuffer);
+
+        graph.debugPass = frameGraph.addPass("debug");
+        if (RenderMode::LOCAL_REFLECTIONS == inputs.renderMode) frameGraph.read(graph.debugPass, graph.localReflectionsTexture);
+        else if (RenderMode::LOCAL_REFRACTIONS == inputs.renderMode) frameGraph.read(graph.debugPass, graph.localRefractionsTexture);
+        else if (RenderMode::WORLD_SPACE_DEPTH == inputs.renderMode) frameGraph.read(graph.debugPass, graph.worldSpaceDepthTexture);
+        if (isShowingDebugTexture) frameGraph.write(graph.debugPass, graph.backbuffer);
+
+        //NOTE: the GUI is drawn by the Program right after render() returns, it is only declared here to complete the frame (e.g. in the dump)
+        graph.uiPass = frameGraph.addPass("ui");
+        frameGraph.write(graph.uiPass, graph.backbuffer);
+
+        frameGraph.compile();
+        return graph;
+    }
+
+    std::size_t RenderEngine::getSkyCubemapSizeInBytes() const {
+        std::size_t sizeInBytes{0};
+        for (GLsizei length = m_skyCubemapLength; length > 0; length /= 2) sizeInBytes += 6 * 4 * (std::size_t)length * length;
+        return sizeInBytes;
+    }
+
+    GLsizei RenderEngine::getSkyCubemapLengthForViewport(int const viewportHeight, float const fovYInDegrees) {
+        return roundUpSkyCubemapLength(viewportHeight / glm::tan(glm::radians(0.5f * fovYInDegrees)));
+    }
+
+    GLsizei RenderEngine::roundUpSkyCubemapLength(float const length) {
+        GLsizei roundedLength{CUBEMAP_MIN_LENGTH};
+        while (roundedLength < CUBEMAP_MAX_LENGTH && (float)roundedLength < length) roundedLength *= 2;
+        return roundedLength;
+    }
+
+    void RenderEngine::resizeSkyCubemap(GLsizei const length) {
+        if (0 == m_skyboxCubemap) return;
+
+        m_skyCubemapLength = length;
+        GLint mipCount{0};
+        for (GLsizei mipLength = length; mipLength > 0; mipLength /= 2) ++mipCount;
 
+        GLStateCache::bindTexture(GL_TEXTURE_CUBE_MAP, m_skyboxCubemap);
         /*
         enum order (incremented by 1)
         GL_TEXTURE_CUBE_MAP_POSITIVE_X
@@ -105,176 +405,552 @@ namespace wave_tool {
         GL_TEXTURE_CUBE_MAP_POSITIVE_Z
         GL_TEXTURE_CUBE_MAP_NEGATIVE_Z
         */
-        for (unsigned int i = 0; i < 6; ++i) {
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGBA, CUBEMAP_LENGTH, CUBEMAP_LENGTH, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr); // allocate empty chunk in VRAM
+        //NOTE: glTexStorage2D is GL 4.2, so every level is specified by hand (the mips are filled by glGenerateMipmap after each sky update)
+        for (GLint level = 0; level < mipCount; ++level) {
+            for (unsigned int i = 0; i < 6; ++i) {
+                glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, level, GL_RGBA, length >> level, length >> level, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr); // allocate empty chunk in VRAM
+            }
         }
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, mipCount - 1);
         // unbind
-        glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
-        ///////////////////////////////////////////////////
+        GLStateCache::bindTexture(GL_TEXTURE_CUBE_MAP, 0);
+
+        if (0 != m_skyboxLayeredFBO) {
+            GLStateCache::bindFramebuffer(m_skyboxLayeredFBO);
+            glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_skyboxCubemap, 0);
+            glDrawBuffer(GL_COLOR_ATTACHMENT0);
+            if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) std::cout << "ERROR: render-engine.cpp - layered skybox FBO setup failed!" << std::endl;
+            // unbind / reset to default screen framebuffer
+            GLStateCache::bindFramebuffer(0);
+        }
 
-        ///////////////////////////////////////////////////
-        // reference: https://learnopengl.com/Advanced-OpenGL/Framebuffers
-        // REUSABLE DEPTH/STENCIL RBO...
-        glGenRenderbuffers(1, &m_depth24Stencil8RBO);
-        glBindRenderbuffer(GL_RENDERBUFFER, m_depth24Stencil8RBO);
-        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_windowWidth, m_windowHeight);
-        // unbind
-        glBindRenderbuffer(GL_RENDERBUFFER, 0);
-        ///////////////////////////////////////////////////
+        // the old contents are gone, so the next update has to render every face (and can't be amortised)
+        m_skyCubemapStaleFaces = ALL_SKY_CUBEMAP_FACES;
+        m_isSkyCubemapComplete = false;
+    }
 
-        ///////////////////////////////////////////////////
-        // reference: https://learnopengl.com/Advanced-Lighting/Shadows/Shadow-Mapping
-        // REUSABLE DEPTH TEXTURE (2D)...
-        glGenTextures(1, &m_depthTexture2D);
-        glBindTexture(GL_TEXTURE_2D, m_depthTexture2D);
-        // set options on currently bound texture object...
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        // generate empty texture (2D)...
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, m_windowWidth, m_windowHeight, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-        // unbind
-        glBindTexture(GL_TEXTURE_2D, 0);
-        ///////////////////////////////////////////////////
+    // re-packs the waves and only touches the UBO if the packed bytes differ from what was last uploaded
+    //NOTE: only the header and the live waves are uploaded (not the full capacity)
+    void RenderEngine::updateGerstnerWaveBlock() {
+        if (0 == m_gerstnerWaveUBO) return;
 
-        ///////////////////////////////////////////////////
-        // LOCAL REFLECTIONS TEXTURE (2D)...
-        glGenTextures(1, &m_localReflectionsTexture2D);
-        glBindTexture(GL_TEXTURE_2D, m_localReflectionsTexture2D);
-        // set options on currently bound texture object...
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        // generate empty texture (2D)...
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_windowWidth, m_windowHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-        // unbind
-        glBindTexture(GL_TEXTURE_2D, 0);
+        if (gerstnerWaves.size() > m_gerstnerWaveCapacity) {
+            std::cout << "WARNING: render-engine.cpp - " << gerstnerWaves.size() << " gerstner waves exceeds the shader capacity of " << m_gerstnerWaveCapacity << ", extras are ignored!" << std::endl;
+            gerstnerWaves.erase(gerstnerWaves.begin() + m_gerstnerWaveCapacity, gerstnerWaves.end());
+        }
 
-        // LOCAL REFLECTIONS FBO...
-        glGenFramebuffers(1, &m_localReflectionsFBO);
-        glBindFramebuffer(GL_FRAMEBUFFER, m_localReflectionsFBO);
-        // attach colour buffer to FBO
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_localReflectionsTexture2D, 0);
-        // attach depth/stencil buffer to FBO
-        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depth24Stencil8RBO);
-        // set fragment shader (location = 0) output
-        glDrawBuffer(GL_COLOR_ATTACHMENT0);
-        // check FBO setup status...
-        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) std::cout << "ERROR: render-engine.cpp - local reflections FBO setup failed!" << std::endl;
-        // unbind / reset to default screen framebuffer
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        ///////////////////////////////////////////////////
+        geometry::packGerstnerWavesStd140(gerstnerWaves, m_gerstnerWavesPacked);
 
-        ///////////////////////////////////////////////////
-        // LOCAL REFRACTIONS TEXTURE (2D)...
-        glGenTextures(1, &m_localRefractionsTexture2D);
-        glBindTexture(GL_TEXTURE_2D, m_localRefractionsTexture2D);
-        // set options on currently bound texture object...
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        // generate empty texture (2D)...
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_windowWidth, m_windowHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-        // unbind
-        glBindTexture(GL_TEXTURE_2D, 0);
+        bool const isUnchanged{m_isGerstnerWaveUBOValid &&
+                               m_gerstnerWavesPacked.size() == m_gerstnerWavesUploaded.size() &&
+                               (m_gerstnerWavesPacked.empty() || 0 == std::memcmp(m_gerstnerWavesPacked.data(), m_gerstnerWavesUploaded.data(), m_gerstnerWavesPacked.size() * sizeof(geometry::GerstnerWaveStd140)))};
+        if (isUnchanged) return;
 
-        // LOCAL REFRACTIONS FBO...
-        glGenFramebuffers(1, &m_localRefractionsFBO);
-        glBindFramebuffer(GL_FRAMEBUFFER, m_localRefractionsFBO);
-        // attach colour buffer to FBO
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_localRefractionsTexture2D, 0);
-        // attach depth/stencil buffer to FBO
-        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depth24Stencil8RBO);
-        // set fragment shader (location = 0) output
-        glDrawBuffer(GL_COLOR_ATTACHMENT0);
-        // check FBO setup status...
-        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) std::cout << "ERROR: render-engine.cpp - local refractions FBO setup failed!" << std::endl;
-        // unbind / reset to default screen framebuffer
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        ///////////////////////////////////////////////////
+        geometry::GerstnerWaveBlockHeaderStd140 const header{(std::uint32_t)m_gerstnerWavesPacked.size(), {0, 0, 0}};
+        glBindBuffer(GL_UNIFORM_BUFFER, m_gerstnerWaveUBO);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(header), &header);
+        if (!m_gerstnerWavesPacked.empty()) glBufferSubData(GL_UNIFORM_BUFFER, sizeof(header), m_gerstnerWavesPacked.size() * sizeof(geometry::GerstnerWaveStd140), m_gerstnerWavesPacked.data());
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
-        ///////////////////////////////////////////////////
-        // WORLD-SPACE DEPTH TEXTURE (2D)...
-        glGenTextures(1, &m_worldSpaceDepthTexture2D);
-        glBindTexture(GL_TEXTURE_2D, m_worldSpaceDepthTexture2D);
-        // set options on currently bound texture object...
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        // generate empty texture (2D)...
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_windowWidth, m_windowHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-        // unbind
-        glBindTexture(GL_TEXTURE_2D, 0);
+        m_gerstnerWavesUploaded = m_gerstnerWavesPacked;
+        m_isGerstnerWaveUBOValid = true;
+    }
 
-        // WORLD-SPACE DEPTH FBO...
-        glGenFramebuffers(1, &m_worldSpaceDepthFBO);
-        glBindFramebuffer(GL_FRAMEBUFFER, m_worldSpaceDepthFBO);
-        // attach colour buffer to FBO
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_worldSpaceDepthTexture2D, 0);
-        // attach depth/stencil buffer to FBO
-        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depth24Stencil8RBO);
-        // set fragment shader (location = 0) output
-        glDrawBuffer(GL_COLOR_ATTACHMENT0);
-        // check FBO setup status...
-        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) std::cout << "ERROR: render-engine.cpp - world-space depth FBO setup failed!" << std::endl;
-        // unbind / reset to default screen framebuffer
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        ///////////////////////////////////////////////////
+    // bakes (or loads the cached bake of) the gerstner atlas and swaps its texture arrays in for the previous ones
+    bool RenderEngine::bakeGerstnerAtlas() {
+        std::chrono::steady_clock::time_point const startTime{std::chrono::steady_clock::now()};
+
+        //NOTE: the cache lives in the working directory (the build directory), next to the executable
+        std::unique_ptr<GerstnerAtlas> gerstnerAtlas{GerstnerAtlas::bakeOrLoad(gerstnerWaves, gerstnerAtlasParameters, m_threadPool.get(), ".")};
+        if (nullptr == gerstnerAtlas) return false;
+
+        GerstnerAtlasParameters const& parameters{gerstnerAtlas->getParameters()};
+        GLuint const displacementTexture2DArray{Texture::create2DTextureArrayRGBA16F(glm::value_ptr(gerstnerAtlas->getDisplacements().front()), parameters.resolution, parameters.resolution, parameters.frameCount)};
+        GLuint const normalTexture2DArray{Texture::create2DTextureArrayRGBA16F(glm::value_ptr(gerstnerAtlas->getNormals().front()), parameters.resolution, parameters.resolution, parameters.frameCount)};
+        if (0 == displacementTexture2DArray || 0 == normalTexture2DArray) {
+            std::cout << "ERROR: render-engine.cpp - failed to create gerstner atlas textures!" << std::endl;
+            GLStateCache::deleteTextures(1, &displacementTexture2DArray);
+            GLStateCache::deleteTextures(1, &normalTexture2DArray);
+            return false;
+        }
 
-        ///////////////////////////////////////////////////
-        // DEPTH FBO...
-        glGenFramebuffers(1, &m_depthFBO);
-        glBindFramebuffer(GL_FRAMEBUFFER, m_depthFBO);
-        // attach depth buffer to FBO
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, m_depthTexture2D, 0);
-        // since we don't have a colour buffer, we must explicitly declare not to render any colour data
-        glDrawBuffer(GL_NONE);
-        glReadBuffer(GL_NONE);
-        // check FBO setup status...
-        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) std::cout << "ERROR: render-engine.cpp - depth FBO setup failed!" << std::endl;
-        // unbind / reset to default screen framebuffer
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        ///////////////////////////////////////////////////
+        GLStateCache::deleteTextures(1, &m_gerstnerAtlasDisplacementTexture2DArray);
+        GLStateCache::deleteTextures(1, &m_gerstnerAtlasNormalTexture2DArray);
+        m_gerstnerAtlasDisplacementTexture2DArray = displacementTexture2DArray;
+        m_gerstnerAtlasNormalTexture2DArray = normalTexture2DArray;
+
+        // the GPU copy is all that is needed from now on
+        gerstnerAtlas->releaseTexelData();
+        m_gerstnerAtlas = std::move(gerstnerAtlas);
+
+        std::cout << "gerstner atlas " << (m_gerstnerAtlas->wasLoadedFromCache() ? "loaded from cache" : "baked") << " in " << std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count() << " ms (loop period = " << m_gerstnerAtlas->getLoopPeriodInSeconds() << " s)" << std::endl;
+
+        return true;
     }
 
-    RenderEngine::~RenderEngine() {
-        glDeleteRenderbuffers(1, &m_depth24Stencil8RBO);
-        glDeleteTextures(1, &m_depthTexture2D);
-
-        glDeleteTextures(1, &m_localReflectionsTexture2D);
-        glDeleteFramebuffers(1, &m_localReflectionsFBO);
-        glDeleteTextures(1, &m_localRefractionsTexture2D);
-        glDeleteFramebuffers(1, &m_localRefractionsFBO);
-        glDeleteTextures(1, &m_worldSpaceDepthTexture2D);
-        glDeleteFramebuffers(1, &m_worldSpaceDepthFBO);
-        glDeleteFramebuffers(1, &m_depthFBO);
-
-        glDeleteTextures(1, &m_skyboxCubemap);
-        glDeleteFramebuffers(1, &m_skyboxFBO);
-
-        glDeleteVertexArrays(1, &m_emptyVAO);
-
-        glDeleteProgram(mainProgram);
-        glDeleteProgram(screenSpaceQuadProgram);
-        glDeleteProgram(skyboxCloudsProgram);
-        glDeleteProgram(skyboxStarsProgram);
-        glDeleteProgram(skyboxTrivialProgram);
-        glDeleteProgram(skysphereProgram);
-        glDeleteProgram(trivialProgram);
-        glDeleteProgram(waterGridProgram);
-        glDeleteProgram(worldSpaceDepthProgram);
+    // returns the ring slot holding the given frame, or -1 if it isn't resident
+    int RenderEngine::findHeightmapSequenceTextureSlot(unsigned int const frameIndex) const {
+        for (unsigned int slot = 0; slot < HEIGHTMAP_SEQUENCE_TEXTURE_COUNT; ++slot) {
+            if ((int)frameIndex == m_heightmapSequenceTextureFrames.at(slot)) return (int)slot;
+        }
+        return -1;
     }
 
-    std::shared_ptr<Camera> RenderEngine::getCamera() const {
-        return m_camera;
+    std::size_t RenderEngine::getHeightmapSequenceMemoryInBytes() const {
+        if (nullptr == m_heightmapSequence) return 0;
+        std::size_t const frameSizeInBytes{m_heightmapSequence->getFrameSizeInBytes()};
+        return m_heightmapSequence->getMemoryInBytes() + m_heightmapSequenceFrame.texels.capacity() + (HEIGHTMAP_SEQUENCE_TEXTURE_COUNT + HEIGHTMAP_SEQUENCE_PBO_COUNT) * frameSizeInBytes;
+    }
+
+    // picks the sequence frames for the current wave time and streams in at most 1 decoded frame
+    //NOTE: this never waits on the decoder, if a wanted frame isn't resident yet the current frame is held (or the static heightmap is shown until the first one arrives)
+    void RenderEngine::updateHeightmapSequence() {
+        unsigned int const frameCount{m_heightmapSequence->getFrameCount()};
+        double const playbackFrame{(double)waveAnimationTimeInSeconds * heightmapSequenceFramesPerSecond};
+        unsigned int const frame{(unsigned int)std::fmod(std::floor(playbackFrame), (double)frameCount)};
+        // frames that should be resident, as a lead (in frames) ahead of the current one
+        unsigned int const wantedFrameCount{glm::min(frameCount, HEIGHTMAP_SEQUENCE_TEXTURE_COUNT)};
+
+        unsigned int nextFrameIndex;
+        while (m_heightmapSequence->peekNextFrameIndex(nextFrameIndex)) {
+            bool isEverythingResident{true};
+            for (unsigned int lead = 0; lead < wantedFrameCount; ++lead) isEverythingResident = isEverythingResident && -1 != findHeightmapSequenceTextureSlot((frame + lead) % frameCount);
+            // leave the rest queued (the decoder just idles once the queue is full)
+            if (isEverythingResident) break;
+
+            unsigned int const lead{(nextFrameIndex + frameCount - frame) % frameCount};
+            // the decoder is behind the playback (e.g. a time jump or a big fps change), so restart it at the current frame
+            if (lead >= wantedFrameCount) {
+                m_heightmapSequence->seek(frame);
+                break;
+            }
+
+            m_heightmapSequence->tryPopFrame(m_heightmapSequenceFrame);
+            if (-1 != findHeightmapSequenceTextureSlot(nextFrameIndex)) continue;
+
+            // evict a frame that is no longer wanted...
+            for (unsigned int slot = 0; slot < HEIGHTMAP_SEQUENCE_TEXTURE_COUNT; ++slot) {
+                int const slotFrame{m_heightmapSequenceTextureFrames.at(slot)};
+                if (-1 != slotFrame && ((unsigned int)slotFrame + frameCount - frame) % frameCount < wantedFrameCount) continue;
+                m_heightmapSequenceTextureFrames.at(slot) = uploadHeightmapSequenceFrame(slot) ? (int)nextFrameIndex : -1;
+                break;
+            }
+            // only 1 upload per render
+            break;
+        }
+
+        m_heightmapSequenceSlot = findHeightmapSequenceTextureSlot(frame);
+        m_heightmapSequenceNextSlot = findHeightmapSequenceTextureSlot((frame + 1) % frameCount);
+        //NOTE: a missing next frame holds the current one instead of blending towards it (a blend of 0 also lets the shader skip the second fetch)
+        if (-1 == m_heightmapSequenceNextSlot) m_heightmapSequenceNextSlot = m_heightmapSequenceSlot;
+        m_heightmapSequenceFrameBlend = (m_heightmapSequenceNextSlot != m_heightmapSequenceSlot) ? (float)(playbackFrame - std::floor(playbackFrame)) : 0.0f;
+    }
+
+    // copies m_heightmapSequenceFrame into the next pixel-unpack buffer of the ring, then has the driver transfer it into the slot's texture asynchronously
+    // reference: https://www.khronos.org/opengl/wiki/Pixel_Buffer_Object
+    // reference: https://www.khronos.org/opengl/wiki/Buffer_Object_Streaming
+    bool RenderEngine::uploadHeightmapSequenceFrame(unsigned int const textureSlot) {
+        std::chrono::steady_clock::time_point const startTime{std::chrono::steady_clock::now()};
+
+        unsigned int const width{m_heightmapSequence->getWidth()};
+        unsigned int const height{m_heightmapSequence->getHeight()};
+        unsigned int const bytesPerTexel{m_heightmapSequence->getBytesPerTexel()};
+        std::size_t const frameSizeInBytes{m_heightmapSequence->getFrameSizeInBytes()};
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_heightmapSequencePBOs.at(m_heightmapSequenceNextPBO));
+        m_heightmapSequenceNextPBO = (m_heightmapSequenceNextPBO + 1) % HEIGHTMAP_SEQUENCE_PBO_COUNT;
+        //NOTE: orphaning gives the buffer fresh storage if the driver is still reading the old one, so the map below never stalls
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, frameSizeInBytes, nullptr, GL_STREAM_DRAW);
+        void *mappedBuffer{glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, frameSizeInBytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT)};
+        if (nullptr == mappedBuffer) {
+            std::cout << "ERROR: render-engine.cpp - failed to map the heightmap sequence pixel-unpack buffer!" << std::endl;
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            return false;
+        }
+        std::memcpy(mappedBuffer, m_heightmapSequenceFrame.texels.data(), frameSizeInBytes);
+        // the buffer contents can (rarely) be lost, e.g. on a display mode change
+        if (GL_FALSE == glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER)) {
+            std::cout << "WARNING: render-engine.cpp - the heightmap sequence pixel-unpack buffer was corrupted, the frame is skipped!" << std::endl;
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            return false;
+        }
+
+        // with a pixel-unpack buffer bound, the data pointer is an offset into it, and this call returns without waiting for the transfer
+        GLStateCache::bindTexture(GL_TEXTURE_2D, m_heightmapSequenceTextures.at(textureSlot));
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RED, 2 == bytesPerTexel ? GL_UNSIGNED_SHORT : GL_UNSIGNED_BYTE, nullptr);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        GLStateCache::bindTexture(GL_TEXTURE_2D, 0);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        m_heightmapSequenceUploadTimeInMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        return true;
+    }
+
+    // packs the blocks at their aligned offsets, then streams them into the next buffer of the ring the same way as the heightmap sequence frames (orphan + map + copy)
+    //NOTE: every object gets its data (visible or not), so its index into the object data is just its index in the render list
+    void RenderEngine::updateSceneBlocks(FrameBlockStd140 const& frameBlock, std::array<PassBlockStd140, SCENE_PASS_COUNT> const& passBlocks, std::vector<std::shared_ptr<MeshObject>> const& objects) {
+        m_sceneBlocksStaging.assign(m_frameBlockStride + SCENE_PASS_COUNT * m_passBlockStride, 0);
+        std::memcpy(m_sceneBlocksStaging.data(), &frameBlock, sizeof(FrameBlockStd140));
+        for (unsigned int pass = 0; pass < SCENE_PASS_COUNT; ++pass) std::memcpy(m_sceneBlocksStaging.data() + m_frameBlockStride + pass * m_passBlockStride, &passBlocks.at(pass), sizeof(PassBlockStd140));
+        //NOTE: at least 1 (unused) entry, since an empty buffer can't be mapped
+        m_objectDataStaging.assign(std::max(objects.size(), (std::size_t)1), ObjectData{glm::mat4{1.0f}, glm::vec4{0.0f}});
+        for (std::size_t objectIndex = 0; objectIndex < objects.size(); ++objectIndex) {
+            MeshObject const& object{*objects.at(objectIndex)};
+            //TODO: handle isTextured better
+            m_objectDataStaging.at(objectIndex) = ObjectData{object.getModel(), glm::vec4{object.normals.empty() ? 0.0f : 1.0f, object.hasTexture ? 1.0f : 0.0f, 0.0f, 0.0f}};
+        }
+
+        m_sceneUBOIndex = (m_sceneUBOIndex + 1) % SCENE_UNIFORM_BUFFER_COUNT;
+        GLuint const sceneUBO{m_sceneUBOs.at(m_sceneUBOIndex)};
+        streamBufferData(GL_UNIFORM_BUFFER, sceneUBO, m_sceneBlocksStaging.data(), m_sceneBlocksStaging.size(), "scene uniform buffer");
+        GLuint const objectDataBuffer{m_objectDataBuffers.at(m_sceneUBOIndex)};
+        streamBufferData(GL_TEXTURE_BUFFER, objectDataBuffer, m_objectDataStaging.data(), m_objectDataStaging.size() * sizeof(ObjectData), "object data buffer");
+
+        //NOTE: indexed binding points are global state, so the frame block is bound once for every program
+        glBindBufferRange(GL_UNIFORM_BUFFER, UniformBlockBinding::FRAME, sceneUBO, 0, sizeof(FrameBlockStd140));
+        m_sceneBlockBindCount = 1;
+        // same for the object data (its texture unit is its name, like every other texture)
+        GLStateCache::bindTextureToUnit(m_objectDataTexture, GL_TEXTURE_BUFFER, m_objectDataTexture);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, objectDataBuffer);
+    }
+
+    void RenderEngine::bindPassBlock(unsigned int const pass) {
+        glBindBufferRange(GL_UNIFORM_BUFFER, UniformBlockBinding::PASS, m_sceneUBOs.at(m_sceneUBOIndex), m_frameBlockStride + pass * m_passBlockStride, sizeof(PassBlockStd140));
+        ++m_sceneBlockBindCount;
+    }
+
+    //NOTE: the sort depth is the distance from the main camera to the object's origin, which is only roughly front-to-back for the mirrored passes (and for big objects)
+    void RenderEngine::buildRenderQueue(std::vector<std::shared_ptr<MeshObject>> const& objects) {
+        if (isBatchingSceneDraws) m_sceneBatch.update(objects);
+
+        glm::vec3 const cameraPosition{m_camera->getPosition()};
+        m_renderQueue.clear();
+        for (std::size_t objectIndex = 0; objectIndex < objects.size(); ++objectIndex) {
+            MeshObject const& object{*objects.at(objectIndex)};
+            assert(0 != object.shaderProgramID);
+            // don't render invisible objects...
+            if (!object.m_isVisible) continue;
+
+            DrawState const state{object.shaderProgramID, object.textureID, isBatchingSceneDraws ? m_sceneBatch.getVAO() : object.vao, (GLenum)object.m_polygonMode, (GLenum)object.m_primitiveMode};
+            m_renderQueue.push((std::uint32_t)objectIndex, state, glm::distance(cameraPosition, glm::vec3{object.getModel()[3]}));
+        }
+        m_renderQueue.sort();
+    }
+
+    // walks the queue in runs of the same (pass) state, which are bound once and then drawn with 1 multi-draw (batched) or 1 draw per object
+    void RenderEngine::drawSceneObjects(std::vector<std::shared_ptr<MeshObject>> const& objects, bool const isMainProgramOnly, ShaderProgram const* depthOnlyProgram) {
+        auto const isDrawn{[&](RenderQueue::Item const& item) {
+            if (isMainProgramOnly && item.state.program != mainProgram.getID()) return false;
+            if (nullptr != depthOnlyProgram && Tag::GENERIC != objects.at(item.objectIndex)->getTag()) return false;
+            return true;
+        }};
+        // the state an object is drawn with in this pass
+        auto const getPassState{[&](RenderQueue::Item const& item) {
+            return nullptr == depthOnlyProgram ? item.state : DrawState{depthOnlyProgram->getID(), 0, item.state.vao, item.state.polygonMode, item.state.primitiveMode};
+        }};
+
+        std::vector<RenderQueue::Item> const& items{m_renderQueue.getItems()};
+        std::size_t itemIndex{0};
+        while (itemIndex < items.size()) {
+            if (!isDrawn(items.at(itemIndex))) {
+                ++itemIndex;
+                continue;
+            }
+
+            // bind the run's state...
+            DrawState const state{getPassState(items.at(itemIndex))};
+            GLStateCache::useProgram(state.program);
+            for (SceneProgram &sceneProgram : m_scenePrograms) {
+                if (state.program == sceneProgram.program->getID() && sceneProgram.textureData.isResolved()) Texture::bind2DTexture(*sceneProgram.program, state.texture, sceneProgram.textureData);
+            }
+            // POINT, LINE or FILL...
+            GLStateCache::polygonMode(state.polygonMode);
+
+            if (isBatchingSceneDraws) {
+                // gather the run (the skipped objects in between don't end it)...
+                m_sceneMultiDrawIndexOffsets.clear();
+                m_sceneMultiDrawIndexCounts.clear();
+                for (; itemIndex < items.size(); ++itemIndex) {
+                    RenderQueue::Item const& item{items.at(itemIndex)};
+                    if (!isDrawn(item)) continue;
+                    if (!RenderQueue::isSameRun(state, getPassState(item), true)) break;
+
+                    void const* indexOffset{m_sceneBatch.getIndexOffset(item.objectIndex)};
+                    GLsizei const indexCount{m_sceneBatch.getIndexCount(item.objectIndex)};
+                    // meshes that are neighbours in the shared index buffer merge into 1 draw
+                    if (!m_sceneMultiDrawIndexOffsets.empty() && (std::uintptr_t)m_sceneMultiDrawIndexOffsets.back() + m_sceneMultiDrawIndexCounts.back() * sizeof(GLuint) == (std::uintptr_t)indexOffset) {
+                        m_sceneMultiDrawIndexCounts.back() += indexCount;
+                    } else {
+                        m_sceneMultiDrawIndexOffsets.push_back(indexOffset);
+                        m_sceneMultiDrawIndexCounts.push_back(indexCount);
+                    }
+                    ++m_sceneObjectDrawCount;
+                }
+
+                GLStateCache::bindVertexArray(m_sceneBatch.getVAO());
+                glMultiDrawElements(state.primitiveMode, m_sceneMultiDrawIndexCounts.data(), GL_UNSIGNED_INT, m_sceneMultiDrawIndexOffsets.data(), (GLsizei)m_sceneMultiDrawIndexCounts.size());
+            } else {
+                RenderQueue::Item const& item{items.at(itemIndex)};
+                MeshObject const& object{*objects.at(item.objectIndex)};
+                GLStateCache::bindVertexArray(object.vao);
+                // the object's own VAO has no object index attribute, so the constant value is read instead (see object-data.glsl)
+                glVertexAttribI1ui(SceneBatch::OBJECT_INDEX_ATTRIBUTE, item.objectIndex);
+                glDrawElements(state.primitiveMode, object.drawFaces.size(), GL_UNSIGNED_INT, (void*)0);
+                ++m_sceneObjectDrawCount;
+                ++itemIndex;
+            }
+            ++m_sceneDrawCallCount;
+        }
+
+        // unbind (once, so the binds shared by consecutive objects are filtered)
+        GLStateCache::bindVertexArray(0);
+    }
+
+    void RenderEngine::streamBufferData(GLenum const target, GLuint const buffer, void const* data, std::size_t const sizeInBytes, char const* bufferName) {
+        glBindBuffer(target, buffer);
+        //NOTE: orphaning gives the buffer fresh storage if the GPU is still reading the old one, so the map below never stalls
+        glBufferData(target, sizeInBytes, nullptr, GL_STREAM_DRAW);
+        void *mappedBuffer{glMapBufferRange(target, 0, sizeInBytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT)};
+        if (nullptr == mappedBuffer) {
+            std::cout << "ERROR: render-engine.cpp - failed to map the " << bufferName << "!" << std::endl;
+        } else {
+            std::memcpy(mappedBuffer, data, sizeInBytes);
+            // the buffer contents can (rarely) be lost, e.g. on a display mode change
+            if (GL_FALSE == glUnmapBuffer(target)) std::cout << "WARNING: render-engine.cpp - the " << bufferName << " was corrupted, this frame's data is undefined!" << std::endl;
+        }
+        glBindBuffer(target, 0);
+    }
+
+    void RenderEngine::requestWaterSurfaceReadback() {
+        m_isWaterSurfaceReadbackRequested = true;
+    }
+
+    // polls the in-flight readback copy, and only maps it once the GPU has signalled it is done (so the map never waits)
+    //NOTE: the fence is flushed by the buffer swap at the end of every frame, so a zero timeout poll is enough
+    void RenderEngine::updateWaterSurfaceReadback() {
+        if (nullptr == m_waterSurfaceReadbackFence) return;
+
+        GLenum const status{glClientWaitSync(m_waterSurfaceReadbackFence, 0, 0)};
+        if (GL_TIMEOUT_EXPIRED == status) return;
+        glDeleteSync(m_waterSurfaceReadbackFence);
+        m_waterSurfaceReadbackFence = nullptr;
+        if (GL_WAIT_FAILED == status) {
+            std::cout << "ERROR: render-engine.cpp - failed to wait on the water surface readback fence!" << std::endl;
+            return;
+        }
+
+        glBindBuffer(GL_COPY_READ_BUFFER, m_waterSurfaceReadbackBuffer);
+        GLint readbackSizeInBytes{0};
+        glGetBufferParameteriv(GL_COPY_READ_BUFFER, GL_BUFFER_SIZE, &readbackSizeInBytes);
+        void const* mappedBuffer{glMapBufferRange(GL_COPY_READ_BUFFER, 0, readbackSizeInBytes, GL_MAP_READ_BIT)};
+        if (nullptr == mappedBuffer) {
+            std::cout << "ERROR: render-engine.cpp - failed to map the water surface readback buffer!" << std::endl;
+        } else {
+            m_waterSurfaceReadback.resize(readbackSizeInBytes / sizeof(WaterSurfaceVertex));
+            std::memcpy(m_waterSurfaceReadback.data(), mappedBuffer, m_waterSurfaceReadback.size() * sizeof(WaterSurfaceVertex));
+            glUnmapBuffer(GL_COPY_READ_BUFFER);
+        }
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    }
+
+    // moves on to the other set of timer queries, first collecting its results from 2 frames ago (only if they are already available, so this never stalls)
+    bool RenderEngine::updateGPUTimers() {
+        m_gpuTimerFrame = (m_gpuTimerFrame + 1) % m_gpuTimerQueries.size();
+        std::array<GLuint64, GPU_TIMER_COUNT> results{};
+        std::array<bool, GPU_TIMER_COUNT> isResultAvailable{};
+        for (unsigned int timer = 0; timer < GPU_TIMER_COUNT; ++timer) {
+            if (!m_isGPUTimerQueryIssued.at(m_gpuTimerFrame).at(timer)) continue;
+
+            GLuint const query{m_gpuTimerQueries.at(m_gpuTimerFrame).at(timer)};
+            GLint isAvailable{GL_FALSE};
+            glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+            if (GL_FALSE == isAvailable) continue;
+
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &results.at(timer));
+            isResultAvailable.at(timer) = true;
+        }
+
+        // GL_TIME_ELAPSED timers...
+        for (unsigned int const timer : {WATER_SURFACE_CAPTURE_TIMER, WATER_SURFACE_DRAW_TIMER, SKY_CUBEMAP_TIMER, LOCAL_PASSES_TIMER}) {
+            if (!isResultAvailable.at(timer)) continue;
+            float &timeInMilliseconds{WATER_SURFACE_CAPTURE_TIMER == timer ? m_waterSurfaceCaptureGPUTimeInMilliseconds : WATER_SURFACE_DRAW_TIMER == timer ? m_waterSurfaceDrawGPUTimeInMilliseconds :
+                                      SKY_CUBEMAP_TIMER == timer ? m_skyCubemapGPUTimeInMilliseconds : m_localPassesGPUTimeInMilliseconds};
+            timeInMilliseconds = results.at(timer) / 1000000.0f;
+            m_isGPUTimerQueryIssued.at(m_gpuTimerFrame).at(timer) = false;
+        }
+
+        // GL_PRIMITIVES_GENERATED counters...
+        if (isResultAvailable.at(WATER_TESSELLATION_PRIMITIVES_GENERATED)) {
+            m_waterTessellatedTriangleCount = results.at(WATER_TESSELLATION_PRIMITIVES_GENERATED);
+            m_isGPUTimerQueryIssued.at(m_gpuTimerFrame).at(WATER_TESSELLATION_PRIMITIVES_GENERATED) = false;
+        }
+
+        // GL_TIMESTAMP pairs (the frame's start timestamp is only released together with its end)...
+        if (!isResultAvailable.at(FRAME_START_TIMESTAMP) || !isResultAvailable.at(FRAME_END_TIMESTAMP)) return false;
+        m_frameGPUTimeInMilliseconds = (results.at(FRAME_END_TIMESTAMP) - results.at(FRAME_START_TIMESTAMP)) / 1000000.0f;
+        m_isGPUTimerQueryIssued.at(m_gpuTimerFrame).at(FRAME_START_TIMESTAMP) = false;
+        m_isGPUTimerQueryIssued.at(m_gpuTimerFrame).at(FRAME_END_TIMESTAMP) = false;
+        return true;
+    }
+
+    // steps the FFT ocean to the current wave time and uploads its textures
+    //NOTE: the parameters are only re-applied when they change (regenerating the initial spectrum is much more expensive than an update)
+    void RenderEngine::updateOceanFFT() {
+        std::chrono::steady_clock::time_point const startTime{std::chrono::steady_clock::now()};
+
+        bool isResized{false};
+        if (nullptr == m_oceanFFT) {
+            m_oceanFFT = std::make_unique<OceanFFT>(oceanFFTParameters, m_threadPool);
+            isResized = true;
+        } else {
+            isResized = m_oceanFFT->setParameters(oceanFFTParameters);
+        }
+
+        unsigned int const resolution{m_oceanFFT->getParameters().resolution};
+        if (isResized || 0 == m_oceanDisplacementTexture2D || 0 == m_oceanNormalTexture2D) {
+            GLStateCache::deleteTextures(1, &m_oceanDisplacementTexture2D);
+            GLStateCache::deleteTextures(1, &m_oceanNormalTexture2D);
+            m_oceanDisplacementTexture2D = Texture::create2DTextureRGBA32F(nullptr, resolution, resolution);
+            m_oceanNormalTexture2D = Texture::create2DTextureRGBA32F(nullptr, resolution, resolution);
+        }
+
+        m_oceanFFT->update(waveAnimationTimeInSeconds);
+        Texture::update2DTextureRGBA32F(m_oceanDisplacementTexture2D, glm::value_ptr(m_oceanFFT->getDisplacements().front()), resolution, resolution);
+        Texture::update2DTextureRGBA32F(m_oceanNormalTexture2D, glm::value_ptr(m_oceanFFT->getNormals().front()), resolution, resolution);
+
+        m_oceanFFTUpdateTimeInMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    }
+
+    void RenderEngine::renderSkyCubemapLayers(bool const isLayered, std::shared_ptr<const MeshObject> skyboxStars, std::shared_ptr<const MeshObject> skysphere, std::shared_ptr<const MeshObject> skyboxClouds, glm::vec4 const& fogColourFarAtCurrentTime) {
+        ShaderProgram &starProgram{isLayered ? skyboxStarsLayeredProgram : skyboxStarsProgram};
+        ShaderProgram &sphereProgram{isLayered ? skysphereLayeredProgram : skysphereProgram};
+        ShaderProgram &cloudProgram{isLayered ? skyboxCloudsLayeredProgram : skyboxCloudsProgram};
+        ShaderProgram &fogProgram{isLayered ? screenSpaceQuadLayeredProgram : screenSpaceQuadProgram};
+
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        float const oneMinusCloudProportion = 1.0f - cloudProportion;
+
+        // now render star skybox then skysphere then cloud skybox then fog...
+        //NOTE: in the future, I could also render more objects (like far mountains/land) on top of everything
+
+        // render skybox (star layer) on top of clear colour...
+        // reference: https://learnopengl.com/Advanced-OpenGL/Cubemaps
+        // reference: http://antongerdelan.net/opengl/cubemaps.html
+        if (nullptr != skyboxStars && skyboxStars->m_isVisible) {
+            // enable star shader program
+            GLStateCache::useProgram(starProgram.getID());
+            // bind geometry data...
+            GLStateCache::bindVertexArray(skyboxStars->vao);
+
+            // set uniforms...
+            //TODO: refactor into own function
+            // bind texture...
+            GLStateCache::bindTextureToUnit(skyboxStars->textureID, GL_TEXTURE_CUBE_MAP, skyboxStars->textureID);
+            starProgram.set<GLint>("skyboxStars", skyboxStars->textureID);
+
+            // POINT, LINE or FILL...
+            GLStateCache::polygonMode(skyboxStars->m_polygonMode);
+            glDrawElements(skyboxStars->m_primitiveMode, skyboxStars->drawFaces.size(), GL_UNSIGNED_INT, (void*)0);
+
+            //TODO: refactor into own function
+            // unbind texture...
+            GLStateCache::bindTexture(GL_TEXTURE_CUBE_MAP, 0);
+            // unbind
+            GLStateCache::bindVertexArray(0);
+        }
+
+        // render skysphere on top of stars...
+        if (nullptr != skysphere && skysphere->m_isVisible) {
+            // enable skysphere shader program
+            GLStateCache::useProgram(sphereProgram.getID());
+            // bind geometry data...
+            GLStateCache::bindVertexArray(skysphere->vao);
+
+            // set uniforms...
+            Texture::bind1DTexture(sphereProgram, skysphere->textureID, "skysphere");
+            sphereProgram.set<float>("sunHorizonDarkness", sunHorizonDarkness);
+
+            // POINT, LINE or FILL...
+            GLStateCache::polygonMode(skysphere->m_polygonMode);
+            glDrawElements(skysphere->m_primitiveMode, skysphere->drawFaces.size(), GL_UNSIGNED_INT, (void*)0);
+
+            Texture::unbind1DTexture();
+            // unbind
+            GLStateCache::bindVertexArray(0);
+        }
+
+        // render skybox (cloud layer) on top of skysphere...
+        // reference: https://learnopengl.com/Advanced-OpenGL/Cubemaps
+        // reference: http://antongerdelan.net/opengl/cubemaps.html
+        if (nullptr != skyboxClouds && skyboxClouds->m_isVisible) {
+            // enable cloud shader program
+            GLStateCache::useProgram(cloudProgram.getID());
+            // bind geometry data...
+            GLStateCache::bindVertexArray(skyboxClouds->vao);
+
+            // set uniforms...
+            cloudProgram.set<float>("oneMinusCloudProportion", oneMinusCloudProportion);
+            cloudProgram.set<float>("overcastStrength", overcastStrength);
+            //TODO: refactor into own function
+            // bind texture...
+            GLStateCache::bindTextureToUnit(skyboxClouds->textureID, GL_TEXTURE_CUBE_MAP, skyboxClouds->textureID);
+            cloudProgram.set<GLint>("skyboxClouds", skyboxClouds->textureID);
+
+            // POINT, LINE or FILL...
+            GLStateCache::polygonMode(skyboxClouds->m_polygonMode);
+            glDrawElements(skyboxClouds->m_primitiveMode, skyboxClouds->drawFaces.size(), GL_UNSIGNED_INT, (void*)0);
+
+            //TODO: refactor into own function
+            // unbind texture...
+            GLStateCache::bindTexture(GL_TEXTURE_CUBE_MAP, 0);
+            // unbind
+            GLStateCache::bindVertexArray(0);
+        }
+
+        // render fog layer on top of clouds...
+        if (0 != m_emptyVAO) {
+            // enable screen-space-quad shader program
+            GLStateCache::useProgram(fogProgram.getID());
+            // bind geometry data...
+            GLStateCache::bindVertexArray(m_emptyVAO);
+
+            // set uniforms...
+            fogProgram.set<GLint>("isTextured", GL_FALSE);
+            Texture::bind2DTexture(fogProgram, 0, "textureData"); // no texture
+            fogProgram.set<glm::vec4>("solidColour", fogColourFarAtCurrentTime);
+
+            // POINT, LINE or FILL...
+            GLStateCache::polygonMode(PolygonMode::FILL);
+            glDrawArrays(PrimitiveMode::TRIANGLE_STRIP, 0, 4);
+
+            Texture::unbind2DTexture();
+            // unbind
+            GLStateCache::bindVertexArray(0);
+        }
     }
 
     // Called to render provided objects under view matrix
-    void RenderEngine::render(std::shared_ptr<const MeshObject> skyboxStars, std::shared_ptr<const MeshObject> skysphere, std::shared_ptr<const MeshObject> skyboxClouds, std::shared_ptr<const MeshObject> waterGrid, std::vector<std::shared_ptr<MeshObject>> const& objects) {
+    void RenderEngine::render(std::shared_ptr<const MeshObject> skyboxStars, std::shared_ptr<const MeshObject> skysphere, std::shared_ptr<const MeshObject> skyboxClouds, std::shared_ptr<const WaterGrid> waterGrid, std::vector<std::shared_ptr<MeshObject>> const& objects) {
+        std::chrono::steady_clock::time_point const frameStartTime{std::chrono::steady_clock::now()};
+
+        // the debug render modes replace the whole frame with 1 of the intermediate textures (see the end of this method)
+        bool const isShowingDebugTexture{0 != m_emptyVAO && RenderMode::DEFAULT != renderMode};
+
+        // the governor is fed once per measured frame, with whichever of the GPU/CPU is the bottleneck
+        //NOTE: the clipmap and the tessellated grid don't use the pre-built levels, so the governor is paused (not fed) while either is in use
+        //NOTE: same for the debug render modes, which skip the water (and most of the other passes) entirely
+        if (updateGPUTimers() && !isUsingWaterClipmap && !isUsingWaterTessellation && !isShowingDebugTexture) {
+            m_waterGridResolutionGovernor.update(glm::max(m_frameGPUTimeInMilliseconds, m_frameCPUTimeInMilliseconds));
+        }
+        glQueryCounter(m_gpuTimerQueries.at(m_gpuTimerFrame).at(FRAME_START_TIMESTAMP), GL_TIMESTAMP);
+        m_isGPUTimerQueryIssued.at(m_gpuTimerFrame).at(FRAME_START_TIMESTAMP) = true;
+        ShaderProgram::resetUniformCounts();
+        //NOTE: the GUI (and anything else outside of this method) changes the GL state behind the cache's back between frames
+        GLStateCache::invalidate();
+        GLStateCache::resetCallCounts();
+
         glm::mat4 const view = m_camera->getViewMat();
         Camera cameraOnlyYaw{*m_camera};
         cameraOnlyYaw.setRotation(cameraOnlyYaw.getYaw(), 0.0f);
@@ -283,7 +959,6 @@ namespace wave_tool {
         glm::mat4 const projection = m_camera->getProjectionMat();
         glm::mat4 const viewProjection = projection * view;
         glm::mat4 const VPNoTranslation{projection * viewNoTranslation};
-        glm::mat4 const inverseViewProjection = glm::inverse(viewProjection);
 
         // compute sun position...
         float const timeOfDayInDays{timeOfDayInHours / 24.0f};
@@ -294,399 +969,309 @@ namespace wave_tool {
         // tint fades to black when sun is lower in sky
         glm::vec4 const fogColourFarAtCurrentTime{glm::clamp(sunPosition.y, 0.0f, 1.0f) * glm::vec3{fogColourFarAtNoon}, fogColourFarAtNoon.a};
 
-        float const oneMinusCloudProportion = 1.0f - cloudProportion;
-
         float const verticalBounceWavePhaseShift{verticalBounceWavePhase * glm::two_pi<float>()};
         float const verticalBounceWaveDisplacement{verticalBounceWaveAmplitude * glm::sin(verticalBounceWavePhaseShift)};
 
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
         ///////////////////////////////////////////////////
-        // dynamic skybox rendering (render 6 faces of cubemap to textures)...
-        // bind FBO (switch to render to textures)
-        glBindFramebuffer(GL_FRAMEBUFFER, m_skyboxFBO);
+        // SCENE UNIFORM BLOCKS...
+        // everything shared between programs is written once here (see scene-blocks.glsl), each pass/draw below then only binds its range of the buffer
+        FrameBlockStd140 const frameBlock{view, projection, viewProjection, viewMatOnlyYaw, fogColourFarAtCurrentTime,
+                                          m_camera->getPosition(), fogDepthRadiusFar, lightVec, fogDepthRadiusNear, sunPosition, sunShininess,
+                                          glm::vec2{(float)m_windowWidth, (float)m_windowHeight}, sunStrength, waveAnimationTimeInSeconds, verticalBounceWaveDisplacement, Z_NEAR, Z_FAR, 0.0f};
 
-        //TODO: see if this is even needed
-        // disable depth writing to draw everything in layers (NOTE: the FBO doesn't have a depth buffer)
-        glDepthMask(GL_FALSE);
-        // set a square viewport
-        glViewport(0, 0, CUBEMAP_LENGTH, CUBEMAP_LENGTH);
+        // in column-major order
+        // mirrors world-space position about the XZ-plane
+        glm::mat4 const LOCAL_REFLECTIONS_MATRIX{1.0f, 0.0f, 0.0f, 0.0f,
+                                                 0.0f, -1.0f, 0.0f, 0.0f,
+                                                 0.0f, 0.0f, 1.0f, 0.0f,
+                                                 0.0f, 0.0f, 0.0f, 1.0f};
+        // <A, B, C, D> where Ax + By + Cz = D
+        // clipping test will succeed if underneath XZ-plane
+        //TODO: see if any padding is needed to hide artifacts when grazing the surface
+        glm::vec4 const LOCAL_REFLECTIONS_CLIP_PLANE{0.0f, -1.0f, 0.0f, 0.0f};
 
-        //TODO: if I ever get around to allowing exporting of the skybox, I might have to flip the image data since we are on the inside
+        // in column-major order
+        // shrinks/shallows world-space position in the Y-axis by the refractive index ratio of air (n_1 = 1.0003) / water (n_2 = 1.33) ~= 0.75
+        glm::mat4 const LOCAL_REFRACTIONS_MATRIX{1.0f, 0.0f, 0.0f, 0.0f,
+                                                 0.0f, 0.75f, 0.0f, 0.0f,
+                                                 0.0f, 0.0f, 1.0f, 0.0f,
+                                                 0.0f, 0.0f, 0.0f, 1.0f};
+        // <A, B, C, D> where Ax + By + Cz = D
+        //TODO: this might be improved by accounting for amplitude
+        // clipping test will succeed if underneath XZ-plane
+        //TODO: see if any padding is needed to hide artifacts when grazing the surface
+        glm::vec4 const LOCAL_REFRACTIONS_CLIP_PLANE{0.0f, -1.0f, 0.0f, 0.0f};
 
-        // render each side of skybox to texture
-        //TODO: should probably only set the uniforms once
-        for (unsigned int i = 0; i < 6; ++i) {
-            // attach the next cube map face texture as the color attachment to render colours to
-            //TODO: I think I can move this call into the FBO setup
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, m_skyboxCubemap, 0);
-
-            glClear(GL_COLOR_BUFFER_BIT);
-
-            // now render star skybox then skysphere then cloud skybox then fog...
-            //NOTE: in the future, I could also render more objects (like far mountains/land) on top of everything
-            //TODO: refactor this into own function
-
-            // render skybox (star layer) on top of clear colour...
-            // reference: https://learnopengl.com/Advanced-OpenGL/Cubemaps
-            // reference: http://antongerdelan.net/opengl/cubemaps.html
-            if (nullptr != skyboxStars && skyboxStars->m_isVisible) {
-                // enable star shader program
-                glUseProgram(skyboxStarsProgram);
-                // bind geometry data...
-                glBindVertexArray(skyboxStars->vao);
-
-                // set uniforms...
-                //TODO: refactor into own function
-                // bind texture...
-                glActiveTexture(GL_TEXTURE0 + skyboxStars->textureID);
-                glBindTexture(GL_TEXTURE_CUBE_MAP, skyboxStars->textureID);
-                glUniform1i(glGetUniformLocation(skyboxStarsProgram, "skyboxStars"), skyboxStars->textureID);
-                glUniformMatrix4fv(glGetUniformLocation(skyboxStarsProgram, "VPNoTranslation"), 1, GL_FALSE, glm::value_ptr(CUBEMAP_VP_NO_TRANSLATION_MATS.at(i)));
+        // pass a symbolic clip plane singularity to ensure the manual clipping test succeeds for all vertices (in the passes without one) - avoids driver bugs that ignore enable/disable state of clip distances
+        std::array<PassBlockStd140, SCENE_PASS_COUNT> passBlocks;
+        for (unsigned int i = 0; i < 6; ++i) passBlocks.at(CUBEMAP_FACE_0_PASS + i) = PassBlockStd140{glm::mat4{1.0f}, CUBEMAP_VP_NO_TRANSLATION_MATS.at(i), SYMBOLIC_CLIP_PLANE_SINGULARITY, GL_FALSE, {0, 0, 0}};
+        passBlocks.at(LOCAL_REFLECTIONS_PASS) = PassBlockStd140{LOCAL_REFLECTIONS_MATRIX, VPNoTranslation, LOCAL_REFLECTIONS_CLIP_PLANE, GL_TRUE, {0, 0, 0}};
+        passBlocks.at(LOCAL_REFRACTIONS_PASS) = PassBlockStd140{LOCAL_REFRACTIONS_MATRIX, VPNoTranslation, LOCAL_REFRACTIONS_CLIP_PLANE, GL_FALSE, {0, 0, 0}};
+        passBlocks.at(DEPTH_PASS) = PassBlockStd140{glm::mat4{1.0f}, VPNoTranslation, SYMBOLIC_CLIP_PLANE_SINGULARITY, GL_FALSE, {0, 0, 0}};
+        passBlocks.at(MAIN_PASS) = PassBlockStd140{glm::mat4{1.0f}, VPNoTranslation, SYMBOLIC_CLIP_PLANE_SINGULARITY, GL_FALSE, {0, 0, 0}};
+        passBlocks.at(SKY_CUBEMAP_LAYERED_PASS) = PassBlockStd140{glm::mat4{1.0f}, glm::mat4{1.0f}, SYMBOLIC_CLIP_PLANE_SINGULARITY, GL_FALSE, {0, 0, 0}};
+
+        updateSceneBlocks(frameBlock, passBlocks, objects);
+        buildRenderQueue(objects);
+        m_sceneDrawCallCount = 0;
+        m_sceneObjectDrawCount = 0;
+        ///////////////////////////////////////////////////
 
-                // POINT, LINE or FILL...
-                glPolygonMode(GL_FRONT_AND_BACK, skyboxStars->m_polygonMode);
-                glDrawElements(skyboxStars->m_primitiveMode, skyboxStars->drawFaces.size(), GL_UNSIGNED_INT, (void*)0);
+        ///////////////////////////////////////////////////
+        // WATER VISIBILITY...
+        // worked out ahead of the other passes, since the local reflections/refractions and the depth texture are only consumed by the water
+        //NOTE: the wave sources are still updated while the water is out of view (only not while it is hidden), so they don't jump once it comes back
+        bool const isDrawingWater{!isShowingDebugTexture && nullptr != waterGrid && waterGrid->m_isVisible && 0 != m_skyboxCubemap};
+        bool const isPlayingHeightmapSequence{isDrawingWater && isUsingHeightmapSequence && !isUsingOceanFFT && nullptr != m_heightmapSequence};
+        if (isDrawingWater) {
+            updateGerstnerWaveBlock();
+            if (isUsingOceanFFT) updateOceanFFT();
+            else m_oceanFFTUpdateTimeInMilliseconds = 0.0f;
+            if (isPlayingHeightmapSequence) updateHeightmapSequence();
+            updateWaterSurfaceReadback();
+        }
 
-                //TODO: refactor into own function
-                // unbind texture...
-                glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
-                // unbind
-                glBindVertexArray(0);
-            }
+        // the displaceable volume is defined by the maximum possible amplitude of all the wave summations
+        //NOTE: the FFT ocean replaces the heightmap, so its (measured) max height is used instead
+        float const DETAIL_AMPLITUDE{isUsingOceanFFT && nullptr != m_oceanFFT ? m_oceanFFT->getMaxHeight() : heightmapDisplacementScale};
+        bool const isPlayingGerstnerAtlas{isUsingGerstnerAtlas && nullptr != m_gerstnerAtlas};
+        float const GERSTNER_AMPLITUDE{geometry::computeTotalAmplitude(isPlayingGerstnerAtlas ? m_gerstnerAtlas->getSnappedWaves() : gerstnerWaves)};
+        float const DISPLACEABLE_AMPLITUDE = GERSTNER_AMPLITUDE + DETAIL_AMPLITUDE + verticalBounceWaveAmplitude;
+
+        // either fit the projected grid to the part of the camera frustum that intersects the displaceable volume, or re-centre the clipmap levels and cull their tiles against the same frustum/volume...
+        // only continue to render the water grid, if there were intersection points (or visible tiles)
+        m_waterVertexCount = 0;
+        m_waterTriangleCount = 0;
+        m_waterGridVisibleVertexFraction = 0.0f;
+        bool const isWaterInView{isDrawingWater && (isUsingWaterClipmap ? m_waterClipmap.update(m_camera->getPosition(), viewProjection, DISPLACEABLE_AMPLITUDE, waterClipmapBaseCellSize, Z_FAR)
+                                                                        : m_projectedGrid.update(*m_camera, DISPLACEABLE_AMPLITUDE))};
+        ///////////////////////////////////////////////////
 
-            // render skysphere on top of stars...
-            if (nullptr != skysphere && skysphere->m_isVisible) {
-                // enable skysphere shader program
-                glUseProgram(skysphereProgram);
-                // bind geometry data...
-                glBindVertexArray(skysphere->vao);
-
-                // set uniforms...
-                Texture::bind1DTexture(skysphereProgram, skysphere->textureID, "skysphere");
-                glUniform1f(glGetUniformLocation(skysphereProgram, "sunHorizonDarkness"), sunHorizonDarkness);
-                glUniform3fv(glGetUniformLocation(skysphereProgram, "sunPosition"), 1, glm::value_ptr(sunPosition));
-                glUniform1f(glGetUniformLocation(skysphereProgram, "sunShininess"), sunShininess);
-                glUniform1f(glGetUniformLocation(skysphereProgram, "sunStrength"), sunStrength);
-                glUniformMatrix4fv(glGetUniformLocation(skysphereProgram, "VPNoTranslation"), 1, GL_FALSE, glm::value_ptr(CUBEMAP_VP_NO_TRANSLATION_MATS.at(i)));
-
-                // POINT, LINE or FILL...
-                glPolygonMode(GL_FRONT_AND_BACK, skysphere->m_polygonMode);
-                glDrawElements(skysphere->m_primitiveMode, skysphere->drawFaces.size(), GL_UNSIGNED_INT, (void*)0);
-
-                Texture::unbind1DTexture();
-                // unbind
-                glBindVertexArray(0);
-            }
+        ///////////////////////////////////////////////////
+        // FRAME GRAPH...
+        // every pass is declared with what it reads and writes, so the ones nothing consumes this frame are culled (and their targets never allocated), the rest run in the declared order below
+        //NOTE: the transients aren't kept across frames (they may be aliased or freed), which is fine since nothing samples them before they are rendered again
+        m_localReflectionsAllocatedDownscale = roundLocalPassDownscale(localReflectionsDownscale);
+        m_localRefractionsAllocatedDownscale = roundLocalPassDownscale(localRefractionsDownscale);
+        FrameGraphHandles const graph{buildFrameGraph(m_frameGraph, FrameGraphInputs{m_windowWidth, m_windowHeight, m_localReflectionsAllocatedDownscale, m_localRefractionsAllocatedDownscale, isWaterInView,
+                                                                                      isShowingDebugTexture ? renderMode : RenderMode::DEFAULT, getSkyCubemapSizeInBytes()})};
+        m_scenePassCount = (unsigned int)m_frameGraph.isPassLive(graph.localReflectionsPass) + (unsigned int)m_frameGraph.isPassLive(graph.localRefractionsPass) + (unsigned int)m_frameGraph.isPassLive(graph.worldSpaceDepthPass) + (unsigned int)m_frameGraph.isPassLive(graph.depthPass) + (unsigned int)m_frameGraph.isPassLive(graph.opaquePass);
+        if (isDumpingFrameGraph) {
+            m_frameGraph.dump(std::cout);
+            isDumpingFrameGraph = false;
+        }
+        ///////////////////////////////////////////////////
 
-            // render skybox (cloud layer) on top of skysphere...
-            // reference: https://learnopengl.com/Advanced-OpenGL/Cubemaps
-            // reference: http://antongerdelan.net/opengl/cubemaps.html
-            if (nullptr != skyboxClouds && skyboxClouds->m_isVisible) {
-                // enable cloud shader program
-                glUseProgram(skyboxCloudsProgram);
-                // bind geometry data...
-                glBindVertexArray(skyboxClouds->vao);
-
-                // set uniforms...
-                glUniform1f(glGetUniformLocation(skyboxCloudsProgram, "oneMinusCloudProportion"), oneMinusCloudProportion);
-                glUniform1f(glGetUniformLocation(skyboxCloudsProgram, "overcastStrength"), overcastStrength);
-                //TODO: refactor into own function
-                // bind texture...
-                glActiveTexture(GL_TEXTURE0 + skyboxClouds->textureID);
-                glBindTexture(GL_TEXTURE_CUBE_MAP, skyboxClouds->textureID);
-                glUniform1i(glGetUniformLocation(skyboxCloudsProgram, "skyboxClouds"), skyboxClouds->textureID);
-                glUniform3fv(glGetUniformLocation(skyboxCloudsProgram, "sunPosition"), 1, glm::value_ptr(sunPosition));
-                glUniformMatrix4fv(glGetUniformLocation(skyboxCloudsProgram, "VPNoTranslation"), 1, GL_FALSE, glm::value_ptr(CUBEMAP_VP_NO_TRANSLATION_MATS.at(i)));
+        GLStateCache::setEnabled(GL_BLEND, true);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-                // POINT, LINE or FILL...
-                glPolygonMode(GL_FRONT_AND_BACK, skyboxClouds->m_polygonMode);
-                glDrawElements(skyboxClouds->m_primitiveMode, skyboxClouds->drawFaces.size(), GL_UNSIGNED_INT, (void*)0);
+        ///////////////////////////////////////////////////
+        // dynamic skybox rendering (render the stale faces of the cubemap to textures)...
+        // the sky only depends on a handful of inputs, so its faces are only re-rendered once one of them changes
+        SkyCubemapKey skyCubemapKey{timeOfDayInHours, cloudProportion, overcastStrength, sunHorizonDarkness, sunShininess, sunStrength, fogColourFarAtNoon, 0 != m_emptyVAO, {}};
+        std::array<std::shared_ptr<const MeshObject>, 3> const skyLayers{skyboxStars, skysphere, skyboxClouds};
+        for (unsigned int i = 0; i < skyLayers.size(); ++i) {
+            if (nullptr != skyLayers.at(i)) skyCubemapKey.layers.at(i) = SkyCubemapLayerKey{skyLayers.at(i).get(), skyLayers.at(i)->m_isVisible, skyLayers.at(i)->textureID, skyLayers.at(i)->m_polygonMode};
+        }
+        // a new length re-allocates the cubemap (which makes every face stale), the viewport matched length only changes on a window resize or a zoom past a power of 2
+        GLsizei const skyCubemapTargetLength{isMatchingSkyCubemapToViewport ? getSkyCubemapLengthForViewport(m_windowHeight, m_camera->getFOV()) : roundUpSkyCubemapLength((float)skyCubemapLength)};
+        if (skyCubemapTargetLength != m_skyCubemapLength) resizeSkyCubemap(skyCubemapTargetLength);
+        if (skyCubemapKey != m_skyCubemapKey) {
+            m_skyCubemapKey = skyCubemapKey;
+            m_skyCubemapStaleFaces = ALL_SKY_CUBEMAP_FACES;
+        }
 
-                //TODO: refactor into own function
-                // unbind texture...
-                glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
-                // unbind
-                glBindVertexArray(0);
+        // while the time of day animates, the key changes every frame, so only 1 face (round-robin) is brought up to date per frame
+        //NOTE: the faces then lag up to 5 frames behind each other, which is hard to spot at any sane animation speed
+        bool const isAmortisingThisFrame{isAmortisingSkyCubemap && isAnimatingTimeOfDay && m_isSkyCubemapComplete};
+        // when every face is stale (and not amortised), each layer is drawn just once into all 6 faces by the layered programs
+        //NOTE: their geometry stage only takes triangles, so a sky layer drawn as points/lines falls back to the per-face loop
+        bool isRenderingLayeredThisFrame{isRenderingSkyCubemapLayered && ALL_SKY_CUBEMAP_FACES == m_skyCubemapStaleFaces && !isAmortisingThisFrame && 0 != m_skyboxLayeredFBO &&
+                                         screenSpaceQuadLayeredProgram.isValid() && skyboxCloudsLayeredProgram.isValid() && skyboxStarsLayeredProgram.isValid() && skysphereLayeredProgram.isValid()};
+        for (std::shared_ptr<const MeshObject> const& skyLayer : skyLayers) {
+            if (nullptr == skyLayer || !skyLayer->m_isVisible) continue;
+            isRenderingLayeredThisFrame = isRenderingLayeredThisFrame && (PrimitiveMode::TRIANGLES == skyLayer->m_primitiveMode || PrimitiveMode::TRIANGLE_STRIP == skyLayer->m_primitiveMode || PrimitiveMode::TRIANGLE_FAN == skyLayer->m_primitiveMode);
+        }
+        m_skyCubemapFaceRenderCount = 0;
+        if (m_frameGraph.beginPass(graph.skyPass) && 0 != m_skyCubemapStaleFaces) {
+            glBeginQuery(GL_TIME_ELAPSED, m_gpuTimerQueries.at(m_gpuTimerFrame).at(SKY_CUBEMAP_TIMER));
+
+            //TODO: see if this is even needed
+            // disable depth writing to draw everything in layers (NOTE: the FBO doesn't have a depth buffer)
+            GLStateCache::depthMask(GL_FALSE);
+            // set a square viewport (shared by all the layers of a layered attachment)
+            glViewport(0, 0, m_skyCubemapLength, m_skyCubemapLength);
+
+            //TODO: if I ever get around to allowing exporting of the skybox, I might have to flip the image data since we are on the inside
+
+            if (isRenderingLayeredThisFrame) {
+                // bind FBO (switch to render to all 6 faces at once)
+                GLStateCache::bindFramebuffer(m_skyboxLayeredFBO);
+                //NOTE: the vertex stages get the identity view-projection, the geometry stage applies each face's (see sky-cubemap-layers.geom)
+                bindPassBlock(SKY_CUBEMAP_LAYERED_PASS);
+                renderSkyCubemapLayers(true, skyboxStars, skysphere, skyboxClouds, fogColourFarAtCurrentTime);
+                m_skyCubemapStaleFaces = 0;
+                m_skyCubemapFaceRenderCount = 6;
+            } else {
+                // bind FBO (switch to render to textures)
+                GLStateCache::bindFramebuffer(m_skyboxFBO);
+
+                // render each stale side of skybox to texture
+                for (unsigned int i = 0; i < 6; ++i) {
+                    unsigned int const face{(m_skyCubemapNextFace + i) % 6};
+                    if (0 == (m_skyCubemapStaleFaces & (1u << face))) continue;
+
+                    //NOTE: only the view-projection changes between the faces, which is in each face's PassBlock (the rest of the uniforms are skipped as unchanged by ShaderProgram)
+                    bindPassBlock(CUBEMAP_FACE_0_PASS + face);
+                    // attach the cube map face texture as the color attachment to render colours to
+                    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, m_skyboxCubemap, 0);
+                    renderSkyCubemapLayers(false, skyboxStars, skysphere, skyboxClouds, fogColourFarAtCurrentTime);
+                    m_skyCubemapStaleFaces &= ~(1u << face);
+                    ++m_skyCubemapFaceRenderCount;
+
+                    if (isAmortisingThisFrame) {
+                        m_skyCubemapNextFace = (face + 1) % 6;
+                        break;
+                    }
+                }
             }
+            if (0 == m_skyCubemapStaleFaces) m_isSkyCubemapComplete = true;
 
-            // render fog layer on top of clouds...
-            if (0 != m_emptyVAO) {
-                // enable screen-space-quad shader program
-                glUseProgram(screenSpaceQuadProgram);
-                // bind geometry data...
-                glBindVertexArray(m_emptyVAO);
-
-                // set uniforms...
-                glUniform1i(glGetUniformLocation(screenSpaceQuadProgram, "isTextured"), GL_FALSE);
-                Texture::bind2DTexture(screenSpaceQuadProgram, 0, "textureData"); // no texture
-                glUniform4fv(glGetUniformLocation(screenSpaceQuadProgram, "solidColour"), 1, glm::value_ptr(fogColourFarAtCurrentTime));
-
-                // POINT, LINE or FILL...
-                glPolygonMode(GL_FRONT_AND_BACK, PolygonMode::FILL);
-                glDrawArrays(PrimitiveMode::TRIANGLE_STRIP, 0, 4);
-
-                Texture::unbind2DTexture();
-                // unbind
-                glBindVertexArray(0);
-            }
+            // rebuild the mip chain the water's reflections sample from (the amortised faces included, so the mips never lag behind their face)
+            GLStateCache::bindTexture(GL_TEXTURE_CUBE_MAP, m_skyboxCubemap);
+            glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+            GLStateCache::bindTexture(GL_TEXTURE_CUBE_MAP, 0);
+
+            glEndQuery(GL_TIME_ELAPSED);
+            m_isGPUTimerQueryIssued.at(m_gpuTimerFrame).at(SKY_CUBEMAP_TIMER) = true;
         }
 
         // reset viewport back to match GLFW window
         glViewport(0, 0, m_windowWidth, m_windowHeight);
-        // re-enable depth writing for the rest of the scene
-        glDepthMask(GL_TRUE);
+        // (re-)enable depth writing for the rest of the scene
+        GLStateCache::depthMask(GL_TRUE);
         // unbind / reset to default screen framebuffer
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        GLStateCache::bindFramebuffer(0);
+        m_frameGraph.endPass(graph.skyPass);
         ///////////////////////////////////////////////////
 
+        // both local passes are timed together (see getLocalPassesGPUTimeInMilliseconds())
+        bool const isTimingLocalPasses{m_frameGraph.isPassLive(graph.localReflectionsPass) || m_frameGraph.isPassLive(graph.localRefractionsPass)};
+        if (isTimingLocalPasses) glBeginQuery(GL_TIME_ELAPSED, m_gpuTimerQueries.at(m_gpuTimerFrame).at(LOCAL_PASSES_TIMER));
+
         ///////////////////////////////////////////////////
         // RENDER LOCAL REFLECTIONS TO TEXTURE...
-        glBindFramebuffer(GL_FRAMEBUFFER, m_localReflectionsFBO);
+        // its targets are bound by the frame graph, possibly at a reduced size (see localReflectionsDownscale)
+        if (m_frameGraph.beginPass(graph.localReflectionsPass)) {
+            GLStateCache::setEnabled(GL_CLIP_DISTANCE0, true);
 
-        glEnable(GL_CLIP_DISTANCE0);
+            GLStateCache::setEnabled(GL_CULL_FACE, true);
+            GLStateCache::cullFace(GL_BACK);
+            //NOTE: this must be clockwise since we are mirroring our scene across the XZ-plane which will flip the winding
+            GLStateCache::frontFace(GL_CW);
 
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_BACK);
-        //NOTE: this must be clockwise since we are mirroring our scene across the XZ-plane which will flip the winding
-        glFrontFace(GL_CW);
+            // alpha of 0.0 is used to indicate no local reflection at fragment (i.e. the skybox is here and is already handled in global reflections)
+            glClearColor(1.0f, 1.0f, 1.0f, 0.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // alpha of 0.0 is used to indicate no local reflection at fragment (i.e. the skybox is here and is already handled in global reflections)
-        glClearColor(1.0f, 1.0f, 1.0f, 0.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            // the mirror matrix, clip plane and normal flip are in this pass's PassBlock
+            bindPassBlock(LOCAL_REFLECTIONS_PASS);
 
-        // render other objects...
-        //TODO: currently not rendering any objects using trivial shader program (cause I don't want to change those shaders), but this is fine since only the debug planes currently are shaded this way
-        //      I could create a modified trivial shader program, or switch everything to the main shader program and then just skip rendering objects flagged as DEBUG
-        //TODO: optimize by batch-drawing objects that use the same shader program, as well as removing redundant uniform setting
-        //TODO: design some sort of wrapper around shader programs that can dynamically set all uniforms properly
+            // render other objects...
+            //TODO: currently not rendering any objects using trivial shader program (cause I don't want to change those shaders), but this is fine since only the debug planes currently are shaded this way
+            //      I could create a modified trivial shader program, or switch everything to the main shader program and then just skip rendering objects flagged as DEBUG
+            drawSceneObjects(objects, true, nullptr);
 
-        // in column-major order
-        // mirrors world-space position about the XZ-plane
-        glm::mat4 const LOCAL_REFLECTIONS_MATRIX{1.0f, 0.0f, 0.0f, 0.0f,
-                                                 0.0f, -1.0f, 0.0f, 0.0f,
-                                                 0.0f, 0.0f, 1.0f, 0.0f,
-                                                 0.0f, 0.0f, 0.0f, 1.0f};
-
-        // <A, B, C, D> where Ax + By + Cz = D
-        // clipping test will succeed if underneath XZ-plane
-        //TODO: see if any padding is needed to hide artifacts when grazing the surface
-        glm::vec4 const LOCAL_REFLECTIONS_CLIP_PLANE{0.0f, -1.0f, 0.0f, 0.0f};
+            // reset
+            GLStateCache::frontFace(GL_CCW);
+            GLStateCache::setEnabled(GL_CULL_FACE, false);
 
-        for (std::shared_ptr<MeshObject const> o : objects) {
-            assert(0 != o->shaderProgramID);
+            GLStateCache::setEnabled(GL_CLIP_DISTANCE0, false);
 
-            // don't render invisible objects...
-            if (!o->m_isVisible) continue;
-
-            if (o->shaderProgramID == mainProgram) {
-                glm::mat4 const modelMat{LOCAL_REFLECTIONS_MATRIX * o->getModel()};
-                glm::mat4 const modelViewMat{view * modelMat};
-                glm::mat4 const mvpMat{projection * modelViewMat};
-
-                // enable shader program...
-                glUseProgram(mainProgram);
-                // bind geometry data...
-                glBindVertexArray(o->vao);
-
-                // set uniforms...
-                glUniform4fv(glGetUniformLocation(mainProgram, "clipPlane0"), 1, glm::value_ptr(LOCAL_REFLECTIONS_CLIP_PLANE));
-                glUniform4fv(glGetUniformLocation(mainProgram, "fogColourFarAtCurrentTime"), 1, glm::value_ptr(fogColourFarAtCurrentTime));
-                glUniform1f(glGetUniformLocation(mainProgram, "fogDepthRadiusFar"), fogDepthRadiusFar);
-                glUniform1f(glGetUniformLocation(mainProgram, "fogDepthRadiusNear"), fogDepthRadiusNear);
-                glUniform1i(glGetUniformLocation(mainProgram, "forceFlipNormals"), GL_TRUE);
-                glUniform1i(glGetUniformLocation(mainProgram, "hasNormals"), !o->normals.empty());
-                //TODO: handle this better
-                glUniform1i(glGetUniformLocation(mainProgram, "isTextured"), o->hasTexture);
-                glUniform3fv(glGetUniformLocation(mainProgram, "lightVec"), 1, glm::value_ptr(lightVec));
-                Texture::bind2DTexture(mainProgram, o->textureID, "textureData");
-                glUniformMatrix4fv(glGetUniformLocation(mainProgram, "modelMat"), 1, GL_FALSE, glm::value_ptr(modelMat));
-                glUniformMatrix4fv(glGetUniformLocation(mainProgram, "modelViewMat"), 1, GL_FALSE, glm::value_ptr(modelViewMat));
-                glUniformMatrix4fv(glGetUniformLocation(mainProgram, "mvpMat"), 1, GL_FALSE, glm::value_ptr(mvpMat));
-                glUniform1f(glGetUniformLocation(mainProgram, "zFar"), Z_FAR);
-
-                // POINT, LINE or FILL...
-                glPolygonMode(GL_FRONT_AND_BACK, o->m_polygonMode);
-                glDrawElements(o->m_primitiveMode, o->drawFaces.size(), GL_UNSIGNED_INT, (void*)0);
-
-                Texture::unbind2DTexture();
-                // unbind
-                glBindVertexArray(0);
-            }
+            m_frameGraph.endPass(graph.localReflectionsPass);
         }
-
-        // reset
-        glFrontFace(GL_CCW);
-        glDisable(GL_CULL_FACE);
-
-        glDisable(GL_CLIP_DISTANCE0);
-
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
         ///////////////////////////////////////////////////
 
         ///////////////////////////////////////////////////
         // RENDER LOCAL REFRACTIONS TO TEXTURE...
-        glBindFramebuffer(GL_FRAMEBUFFER, m_localRefractionsFBO);
+        // its targets are bound by the frame graph, possibly at a reduced size (see localRefractionsDownscale)
+        if (m_frameGraph.beginPass(graph.localRefractionsPass)) {
+            GLStateCache::setEnabled(GL_CLIP_DISTANCE0, true);
 
-        glEnable(GL_CLIP_DISTANCE0);
+            GLStateCache::setEnabled(GL_CULL_FACE, true);
+            GLStateCache::cullFace(GL_BACK);
+            //NOTE: this must be our standard counter-clockwise
+            GLStateCache::frontFace(GL_CCW);
 
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_BACK);
-        //NOTE: this must be our standard counter-clockwise
-        glFrontFace(GL_CCW);
-
-        // alpha of 0.0 is used to indicate no local refraction at fragment (i.e. the skybox is here and gets handled as deepest water)
-        glClearColor(1.0f, 1.0f, 1.0f, 0.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            // alpha of 0.0 is used to indicate no local refraction at fragment (i.e. the skybox is here and gets handled as deepest water)
+            glClearColor(1.0f, 1.0f, 1.0f, 0.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // render other objects...
-        //TODO: currently not rendering any objects using trivial shader program (cause I don't want to change those shaders), but this is fine since only the debug planes currently are shaded this way
-        //      I could create a modified trivial shader program, or switch everything to the main shader program and then just skip rendering objects flagged as DEBUG
-        //TODO: optimize by batch-drawing objects that use the same shader program, as well as removing redundant uniform setting
-        //TODO: design some sort of wrapper around shader programs that can dynamically set all uniforms properly
+            // the shallowing matrix and clip plane are in this pass's PassBlock
+            bindPassBlock(LOCAL_REFRACTIONS_PASS);
 
-        // in column-major order
-        // shrinks/shallows world-space position in the Y-axis by the refractive index ratio of air (n_1 = 1.0003) / water (n_2 = 1.33) ~= 0.75
-        glm::mat4 const LOCAL_REFRACTIONS_MATRIX{1.0f, 0.0f, 0.0f, 0.0f,
-                                                 0.0f, 0.75f, 0.0f, 0.0f,
-                                                 0.0f, 0.0f, 1.0f, 0.0f,
-                                                 0.0f, 0.0f, 0.0f, 1.0f};
+            // render other objects...
+            //TODO: currently not rendering any objects using trivial shader program (cause I don't want to change those shaders), but this is fine since only the debug planes currently are shaded this way
+            //      I could create a modified trivial shader program, or switch everything to the main shader program and then just skip rendering objects flagged as DEBUG
+            drawSceneObjects(objects, true, nullptr);
 
-        // <A, B, C, D> where Ax + By + Cz = D
-        //TODO: this might be improved by accounting for amplitude
-        // clipping test will succeed if underneath XZ-plane
-        //TODO: see if any padding is needed to hide artifacts when grazing the surface
-        glm::vec4 const LOCAL_REFRACTIONS_CLIP_PLANE{0.0f, -1.0f, 0.0f, 0.0f};
+            // reset
+            GLStateCache::setEnabled(GL_CULL_FACE, false);
 
-        for (std::shared_ptr<MeshObject const> o : objects) {
-            assert(0 != o->shaderProgramID);
+            GLStateCache::setEnabled(GL_CLIP_DISTANCE0, false);
 
-            // don't render invisible objects...
-            if (!o->m_isVisible) continue;
-
-            if (o->shaderProgramID == mainProgram) {
-                glm::mat4 const modelMat{LOCAL_REFRACTIONS_MATRIX * o->getModel()};
-                glm::mat4 const modelViewMat{view * modelMat};
-                glm::mat4 const mvpMat{projection * modelViewMat};
-
-                // enable shader program...
-                glUseProgram(mainProgram);
-                // bind geometry data...
-                glBindVertexArray(o->vao);
-
-                // set uniforms...
-                glUniform4fv(glGetUniformLocation(mainProgram, "clipPlane0"), 1, glm::value_ptr(LOCAL_REFRACTIONS_CLIP_PLANE));
-                glUniform4fv(glGetUniformLocation(mainProgram, "fogColourFarAtCurrentTime"), 1, glm::value_ptr(fogColourFarAtCurrentTime));
-                glUniform1f(glGetUniformLocation(mainProgram, "fogDepthRadiusFar"), fogDepthRadiusFar);
-                glUniform1f(glGetUniformLocation(mainProgram, "fogDepthRadiusNear"), fogDepthRadiusNear);
-                glUniform1i(glGetUniformLocation(mainProgram, "forceFlipNormals"), GL_FALSE);
-                glUniform1i(glGetUniformLocation(mainProgram, "hasNormals"), !o->normals.empty());
-                //TODO: handle this better
-                glUniform1i(glGetUniformLocation(mainProgram, "isTextured"), o->hasTexture);
-                glUniform3fv(glGetUniformLocation(mainProgram, "lightVec"), 1, glm::value_ptr(lightVec));
-                Texture::bind2DTexture(mainProgram, o->textureID, "textureData");
-                glUniformMatrix4fv(glGetUniformLocation(mainProgram, "modelMat"), 1, GL_FALSE, glm::value_ptr(modelMat));
-                glUniformMatrix4fv(glGetUniformLocation(mainProgram, "modelViewMat"), 1, GL_FALSE, glm::value_ptr(modelViewMat));
-                glUniformMatrix4fv(glGetUniformLocation(mainProgram, "mvpMat"), 1, GL_FALSE, glm::value_ptr(mvpMat));
-                glUniform1f(glGetUniformLocation(mainProgram, "zFar"), Z_FAR);
-
-                // POINT, LINE or FILL...
-                glPolygonMode(GL_FRONT_AND_BACK, o->m_polygonMode);
-                glDrawElements(o->m_primitiveMode, o->drawFaces.size(), GL_UNSIGNED_INT, (void*)0);
-
-                Texture::unbind2DTexture();
-                // unbind
-                glBindVertexArray(0);
-            }
+            m_frameGraph.endPass(graph.localRefractionsPass);
         }
+        ///////////////////////////////////////////////////
 
-        // reset
-        glDisable(GL_CULL_FACE);
-
-        glDisable(GL_CLIP_DISTANCE0);
+        if (isTimingLocalPasses) {
+            glEndQuery(GL_TIME_ELAPSED);
+            m_isGPUTimerQueryIssued.at(m_gpuTimerFrame).at(LOCAL_PASSES_TIMER) = true;
+        }
 
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        ///////////////////////////////////////////////////
-/*
         ///////////////////////////////////////////////////
         // RENDER WORLD-SPACE DEPTH TEXTURE (of all generic objects, other than water-grid)
-        glBindFramebuffer(GL_FRAMEBUFFER, m_worldSpaceDepthFBO);
-
-        glDisable(GL_BLEND);
-
-        // since the skybox is at infinity, we can just render it with the clear colour
-        // alpha of 0.0 is used to indicate the skybox fragments (max depth of 1.0)
-        glClearColor(1.0f, 1.0f, 1.0f, 0.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-        // enable shader program...
-        glUseProgram(worldSpaceDepthProgram);
-
-        for (std::shared_ptr<MeshObject const> o : objects) {
-            // don't render invisible objects or non-generics...
-            if (!o->m_isVisible || Tag::GENERIC != o->getTag()) continue;
+        //NOTE: only the WORLD_SPACE_DEPTH debug render mode reads this texture, so the frame graph culls the pass (and never allocates its targets) otherwise
+        if (m_frameGraph.beginPass(graph.worldSpaceDepthPass)) {
+            GLStateCache::setEnabled(GL_BLEND, false);
 
-            glm::mat4 const modelViewMat{view * o->getModel()};
-            glm::mat4 const mvpMat{projection * modelViewMat};
+            // since the skybox is at infinity, we can just render it with the clear colour
+            // alpha of 0.0 is used to indicate the skybox fragments (max depth of 1.0)
+            glClearColor(1.0f, 1.0f, 1.0f, 0.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-            // bind geometry data...
-            glBindVertexArray(o->vao);
+            // enable shader program...
+            GLStateCache::useProgram(worldSpaceDepthProgram.getID());
 
-            // set uniforms...
-            glUniformMatrix4fv(glGetUniformLocation(worldSpaceDepthProgram, "modelViewMat"), 1, GL_FALSE, glm::value_ptr(modelViewMat));
-            glUniformMatrix4fv(glGetUniformLocation(worldSpaceDepthProgram, "mvpMat"), 1, GL_FALSE, glm::value_ptr(mvpMat));
-            glUniform1f(glGetUniformLocation(worldSpaceDepthProgram, "zFar"), Z_FAR);
+            bindPassBlock(DEPTH_PASS);
 
-            // POINT, LINE or FILL...
-            glPolygonMode(GL_FRONT_AND_BACK, o->m_polygonMode);
-            glDrawElements(o->m_primitiveMode, o->drawFaces.size(), GL_UNSIGNED_INT, (void*)0);
+            drawSceneObjects(objects, false, &worldSpaceDepthProgram);
 
-            // unbind
-            glBindVertexArray(0);
+            // disable
+            GLStateCache::useProgram(0);
+            // reset
+            GLStateCache::setEnabled(GL_BLEND, true);
+            m_frameGraph.endPass(graph.worldSpaceDepthPass);
         }
-
-        // disable
-        glUseProgram(0);
-        // reset
-        glEnable(GL_BLEND);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
         ///////////////////////////////////////////////////
-*/
+
         ///////////////////////////////////////////////////
         // RENDER DEPTH TEXTURE (of all generic objects, other than water-grid)
-        glBindFramebuffer(GL_FRAMEBUFFER, m_depthFBO);
-
-        // since the skybox is at infinity, its depth is handled by clearing the depth buffer
-        glClear(GL_DEPTH_BUFFER_BIT);
-
-        // enable shader program...
-        glUseProgram(depthProgram);
-
-        for (std::shared_ptr<MeshObject const> o : objects) {
-            // don't render invisible objects or non-generics...
-            if (!o->m_isVisible || Tag::GENERIC != o->getTag()) continue;
-
-            glm::mat4 const mvpMat{viewProjection * o->getModel()};
+        if (m_frameGraph.beginPass(graph.depthPass)) {
+            // since the skybox is at infinity, its depth is handled by clearing the depth buffer
+            glClear(GL_DEPTH_BUFFER_BIT);
 
-            // bind geometry data...
-            glBindVertexArray(o->vao);
+            // enable shader program...
+            GLStateCache::useProgram(depthProgram.getID());
 
-            // set uniforms...
-            glUniformMatrix4fv(glGetUniformLocation(depthProgram, "mvpMat"), 1, GL_FALSE, glm::value_ptr(mvpMat));
+            bindPassBlock(DEPTH_PASS);
 
-            // POINT, LINE or FILL...
-            glPolygonMode(GL_FRONT_AND_BACK, o->m_polygonMode);
-            glDrawElements(o->m_primitiveMode, o->drawFaces.size(), GL_UNSIGNED_INT, (void*)0);
+            drawSceneObjects(objects, false, &depthProgram);
 
-            // unbind
-            glBindVertexArray(0);
+            // disable
+            GLStateCache::useProgram(0);
+            m_frameGraph.endPass(graph.depthPass);
         }
-
-        // disable
-        glUseProgram(0);
-        // reset
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
         ///////////////////////////////////////////////////
 
         ///////////////////////////////////////////////////
@@ -694,469 +1279,331 @@ namespace wave_tool {
         glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+        bindPassBlock(MAIN_PASS);
+
+        // (culled while a debug render mode covers the whole frame anyway)
+        bool const isRenderingOpaque{m_frameGraph.beginPass(graph.opaquePass)};
+
         // COMBINED SKYBOX...
         // render the combined skybox from our main camera...
         // render combined skybox (all layers) on top of clear colour...
         // reference: https://learnopengl.com/Advanced-OpenGL/Cubemaps
         // reference: http://antongerdelan.net/opengl/cubemaps.html
-        if (nullptr != skyboxStars && 0 != m_skyboxCubemap) {
+        if (isRenderingOpaque && nullptr != skyboxStars && 0 != m_skyboxCubemap) {
             // disable depth writing to draw the skybox in the background
-            glDepthMask(GL_FALSE);
+            GLStateCache::depthMask(GL_FALSE);
             // enable trivial skybox shader program
-            glUseProgram(skyboxTrivialProgram);
+            GLStateCache::useProgram(skyboxTrivialProgram.getID());
             // bind geometry data...
             //NOTE: I might as well use the star skybox geometry since I just need a cube
-            glBindVertexArray(skyboxStars->vao);
+            GLStateCache::bindVertexArray(skyboxStars->vao);
 
             // set uniforms...
             //TODO: refactor into own function
             // bind texture...
-            glActiveTexture(GL_TEXTURE0 + m_skyboxCubemap);
-            glBindTexture(GL_TEXTURE_CUBE_MAP, m_skyboxCubemap);
-            glUniform1i(glGetUniformLocation(skyboxTrivialProgram, "skybox"), m_skyboxCubemap);
-            glUniformMatrix4fv(glGetUniformLocation(skyboxTrivialProgram, "VPNoTranslation"), 1, GL_FALSE, glm::value_ptr(VPNoTranslation));
+            GLStateCache::bindTextureToUnit(m_skyboxCubemap, GL_TEXTURE_CUBE_MAP, m_skyboxCubemap);
+            skyboxTrivialProgram.set<GLint>("skybox", m_skyboxCubemap);
 
             // POINT, LINE or FILL...
-            glPolygonMode(GL_FRONT_AND_BACK, PolygonMode::FILL);
+            GLStateCache::polygonMode(PolygonMode::FILL);
             glDrawElements(skyboxStars->m_primitiveMode, skyboxStars->drawFaces.size(), GL_UNSIGNED_INT, (void*)0);
 
             //TODO: refactor into own function
             // unbind texture...
-            glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+            GLStateCache::bindTexture(GL_TEXTURE_CUBE_MAP, 0);
             // unbind
-            glBindVertexArray(0);
+            GLStateCache::bindVertexArray(0);
             // re-enable depth writing for the rest of the scene
-            glDepthMask(GL_TRUE);
+            GLStateCache::depthMask(GL_TRUE);
         }
 
         // render other objects...
-        //TODO: optimize by batch-drawing objects that use the same shader program, as well as removing redundant uniform setting
-        //TODO: design some sort of wrapper around shader programs that can dynamically set all uniforms properly
-        for (std::shared_ptr<MeshObject const> o : objects) {
-            assert(0 != o->shaderProgramID);
-
-            // don't render invisible objects...
-            if (!o->m_isVisible) continue;
-
-            if (o->shaderProgramID == mainProgram) {
-                glm::mat4 const modelMat{o->getModel()};
-                glm::mat4 const modelViewMat{view * modelMat};
-                glm::mat4 const mvpMat{projection * modelViewMat};
-
-                // enable shader program...
-                glUseProgram(mainProgram);
-                // bind geometry data...
-                glBindVertexArray(o->vao);
-
-                // set uniforms...
-                // pass a symbolic clip plane singularity to ensure this manual clipping test succeeds for all vertices - avoids driver bugs that ignore enable/disable state of clip distances
-                glUniform4fv(glGetUniformLocation(mainProgram, "clipPlane0"), 1, glm::value_ptr(SYMBOLIC_CLIP_PLANE_SINGULARITY));
-                glUniform4fv(glGetUniformLocation(mainProgram, "fogColourFarAtCurrentTime"), 1, glm::value_ptr(fogColourFarAtCurrentTime));
-                glUniform1f(glGetUniformLocation(mainProgram, "fogDepthRadiusFar"), fogDepthRadiusFar);
-                glUniform1f(glGetUniformLocation(mainProgram, "fogDepthRadiusNear"), fogDepthRadiusNear);
-                glUniform1i(glGetUniformLocation(mainProgram, "forceFlipNormals"), GL_FALSE);
-                glUniform1i(glGetUniformLocation(mainProgram, "hasNormals"), !o->normals.empty());
-                //TODO: handle this better
-                glUniform1i(glGetUniformLocation(mainProgram, "isTextured"), o->hasTexture);
-                glUniform3fv(glGetUniformLocation(mainProgram, "lightVec"), 1, glm::value_ptr(lightVec));
-                Texture::bind2DTexture(mainProgram, o->textureID, "textureData");
-                glUniformMatrix4fv(glGetUniformLocation(mainProgram, "modelMat"), 1, GL_FALSE, glm::value_ptr(modelMat));
-                glUniformMatrix4fv(glGetUniformLocation(mainProgram, "modelViewMat"), 1, GL_FALSE, glm::value_ptr(modelViewMat));
-                glUniformMatrix4fv(glGetUniformLocation(mainProgram, "mvpMat"), 1, GL_FALSE, glm::value_ptr(mvpMat));
-                glUniform1f(glGetUniformLocation(mainProgram, "zFar"), Z_FAR);
-
-                // POINT, LINE or FILL...
-                glPolygonMode(GL_FRONT_AND_BACK, o->m_polygonMode);
-                glDrawElements(o->m_primitiveMode, o->drawFaces.size(), GL_UNSIGNED_INT, (void*)0);
-
-                Texture::unbind2DTexture();
-                // unbind
-                glBindVertexArray(0);
-            } else if (o->shaderProgramID == trivialProgram) {
-                glm::mat4 const mvp{viewProjection * o->getModel()};
-
-                // enable shader program...
-                glUseProgram(trivialProgram);
-                // bind geometry data...
-                glBindVertexArray(o->vao);
-
-                // set uniforms...
-                glUniformMatrix4fv(glGetUniformLocation(trivialProgram, "mvp"), 1, GL_FALSE, glm::value_ptr(mvp));
-
-                // POINT, LINE or FILL...
-                glPolygonMode(GL_FRONT_AND_BACK, o->m_polygonMode);
-                glDrawElements(o->m_primitiveMode, o->drawFaces.size(), GL_UNSIGNED_INT, (void*)0);
-
-                // unbind
-                glBindVertexArray(0);
-            } else assert(false);
-        }
+        if (isRenderingOpaque) drawSceneObjects(objects, false, nullptr);
+        m_frameGraph.endPass(graph.opaquePass);
 
         //NOTE: the order of drawing matters for alpha-blending
-        // render water...
-        if (nullptr != waterGrid && waterGrid->m_isVisible && 0 != m_skyboxCubemap) {
-
+        // render water (if any of it is in view, see above)...
+        if (m_frameGraph.beginPass(graph.waterPass)) {
             // reference: https://fileadmin.cs.lth.se/graphics/theses/projects/projgrid/
-            //NOTE: this code closely follows the algorithm laid out by the demo at the above reference
-
-            // the displaceable volume is defined by the maximum possible amplitude of all the wave summations
-            float const DISPLACEABLE_AMPLITUDE = geometry::GerstnerWave::TotalAmplitude() + heightmapDisplacementScale + verticalBounceWaveAmplitude;
-            //TODO: figure out if the below line causes any issues (cause it seems like it would be slightly more efficient)
-            //float const DISPLACEABLE_AMPLITUDE = geometry::GerstnerWave::TotalAmplitude() + heightmapDisplacementScale + glm::abs(verticalBounceWaveDisplacement);
-
-            geometry::Plane const upperPlane{0.0f, 1.0f, 0.0f, DISPLACEABLE_AMPLITUDE};
-            geometry::Plane const basePlane{0.0f, 1.0f, 0.0f, 0.0f};
-            geometry::Plane const lowerPlane{0.0f, 1.0f, 0.0f, -DISPLACEABLE_AMPLITUDE};
-
-            // reference: https://gamedev.stackexchange.com/questions/29999/how-do-i-create-a-bounding-frustum-from-a-view-projection-matrix
-            // reference: https://stackoverflow.com/questions/7692988/opengl-math-projecting-screen-space-to-world-space-coords
-            // reference: https://www.gamedev.net/forums/topic/644571-calculating-frustum-corners-from-a-projection-matrix/
-            // initialize in NDC-space
-            std::array<glm::vec4, 8> frustumCornerPoints{glm::vec4{-1.0f, -1.0f, -1.0f, 1.0f},  // [0] - (lbn) - left / bottom / near
-                                                         glm::vec4{-1.0f, -1.0f, 1.0f, 1.0f},   // [1] - (lbf) - left / bottom / far
-                                                         glm::vec4{-1.0f, 1.0f, -1.0f, 1.0f},   // [2] - (ltn) - left / top / near
-                                                         glm::vec4{-1.0f, 1.0f, 1.0f, 1.0f},    // [3] - (ltf) - left / top / far
-                                                         glm::vec4{1.0f, -1.0f, -1.0f, 1.0f},   // [4] - (rbn) - right / bottom / near
-                                                         glm::vec4{1.0f, -1.0f, 1.0f, 1.0f},    // [5] - (rbf) - right / bottom / far
-                                                         glm::vec4{1.0f, 1.0f, -1.0f, 1.0f},    // [6] - (rtn) - right / top / near
-                                                         glm::vec4{1.0f, 1.0f, 1.0f, 1.0f}};    // [7] - (rtf) - right / top / far
-
-            // scale XY-NDC to account for Gerstner wave XZ-world displacement...
-            //TODO: dynamically set this scale based on wave settings (so that the frustum is as small as possible - reduce overdraw)
-            //TODO: also scale the grid resolution so it stays roughly the same, so that it doesnt change based on these settings
-            //TODO: this still needs a lot of work (i.e. account for FOV / window size ???)
-            float const SAFETY_PADDING_SCALAR = 1.2f;
-            for (unsigned int i = 0; i < frustumCornerPoints.size(); ++i) {
-                frustumCornerPoints.at(i).x *= SAFETY_PADDING_SCALAR;
-                frustumCornerPoints.at(i).y *= SAFETY_PADDING_SCALAR;
+            //NOTE: the grid setup closely follows the algorithm laid out by the demo at the above reference (see ProjectedGrid)
+
+            // set useful aliases for the grid corners (unused by the clipmap)
+            std::array<glm::vec4, 4> const& waterGridCornerPoints{m_projectedGrid.getCornerPoints()};
+            glm::vec4 const& bottomLeftGridPointInWorld{waterGridCornerPoints.at(0)};
+            glm::vec4 const& topLeftGridPointInWorld{waterGridCornerPoints.at(1)};
+            glm::vec4 const& bottomRightGridPointInWorld{waterGridCornerPoints.at(2)};
+            glm::vec4 const& topRightGridPointInWorld{waterGridCornerPoints.at(3)};
+            if (!isUsingWaterClipmap) {
+                m_waterGridVisibleVertexFraction = (float)ProjectedGrid::countVisibleGridVertices(waterGridCornerPoints, viewProjection, WATER_GRID_VISIBILITY_SAMPLE_LENGTH) / (WATER_GRID_VISIBILITY_SAMPLE_LENGTH * WATER_GRID_VISIBILITY_SAMPLE_LENGTH);
             }
 
-            // transform into world-space...
-            for (unsigned int i = 0; i < frustumCornerPoints.size(); ++i) {
-                glm::vec4 const temp{inverseViewProjection * frustumCornerPoints.at(i)};
-                frustumCornerPoints.at(i) = temp / temp.w;
+            // now render...
+            //NOTE: the resolution level is picked by the governor (from the frame times), every level's index buffer is pre-built so switching is just a re-bind
+            //TODO: might even split this into a width/height (or hres/vres) in the future for non-square grids
+            //NOTE: the clipmap levels all share 1 grid length (and index buffer)
+            //NOTE: the tessellated grid is always the coarse patch grid, the tessellator picks the resolution per patch edge instead
+            bool const isTessellatingWater{isUsingWaterTessellation && !isUsingWaterClipmap && waterGridTessellationProgram.isValid()};
+            unsigned int const waterGridLevel{m_waterGridResolutionGovernor.getLevel()};
+            GLuint const GRID_LENGTH{isUsingWaterClipmap ? WaterClipmap::getGridLength() : (isTessellatingWater ? WaterGrid::PATCH_GRID_LENGTH : WaterGrid::getGridLength(waterGridLevel))};
+            GLuint const waterGridIndexBuffer{isUsingWaterClipmap ? waterGrid->clipmapIndexBuffer : (isTessellatingWater ? waterGrid->patchIndexBuffer : waterGrid->levelIndexBuffers.at(waterGridLevel))};
+
+            // with the capture mode the surface is displaced once by the (vertex-only) capture program, and the actual draw uses the pass-through program
+            //NOTE: the capture covers a single grid, so it isn't available for the clipmap (which is a draw per level) or the tessellated grid (whose vertices only exist after the tessellator)
+            bool const isCapturingWaterSurface{isUsingWaterSurfaceCapture && !isUsingWaterClipmap && !isTessellatingWater && waterGridCaptureProgram.isValid() && waterGridCapturedProgram.isValid()};
+            if (isCapturingWaterSurface && 0 == m_waterSurfaceCaptureBuffer) {
+                glGenBuffers(1, &m_waterSurfaceCaptureBuffer);
+                glGenBuffers(1, &m_waterSurfaceReadbackBuffer);
+
+                glGenVertexArrays(1, &m_waterSurfaceCaptureVAO);
+                GLStateCache::bindVertexArray(m_waterSurfaceCaptureVAO);
+                glBindBuffer(GL_ARRAY_BUFFER, m_waterSurfaceCaptureBuffer);
+                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(WaterSurfaceVertex), (void*)offsetof(WaterSurfaceVertex, position));
+                glEnableVertexAttribArray(0);
+                glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(WaterSurfaceVertex), (void*)offsetof(WaterSurfaceVertex, normal));
+                glEnableVertexAttribArray(1);
+                glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(WaterSurfaceVertex), (void*)offsetof(WaterSurfaceVertex, xyPositionNDCSpaceHeight0));
+                glEnableVertexAttribArray(2);
+                GLStateCache::bindVertexArray(0);
+                glBindBuffer(GL_ARRAY_BUFFER, 0);
             }
-
-            // stores indices into frustumCornerPoints
-            // 12 edges between pairs of points
-            std::array<unsigned int, 24> const FRUSTUM_EDGES{0,1,   // [0]  - lbn ---> lbf (across-edge)
-                                                             0,2,   // [1]  - lbn ---> ltn (near-edge)
-                                                             0,4,   // [2]  - lbn ---> rbn (near-edge)
-                                                             1,3,   // [3]  - lbf ---> ltf (far-edge)
-                                                             1,5,   // [4]  - lbf ---> rbf (far-edge)
-                                                             2,3,   // [5]  - ltn ---> ltf (across-edge)
-                                                             2,6,   // [6]  - ltn ---> rtn (near-edge)
-                                                             3,7,   // [7]  - ltf ---> rtf (far-edge)
-                                                             4,5,   // [8]  - rbn ---> rbf (across-edge)
-                                                             4,6,   // [9]  - rbn ---> rtn (near-edge)
-                                                             5,7,   // [10] - rbf ---> rtf (far-edge)
-                                                             6,7};  // [11] - rtn ---> rtf (across-edge)
-
-            // stores intersection points of camera frustum with the displaceable volume (between upper and lower bounding planes)
-            std::vector<glm::vec4> intersectionPoints;
-
-            // intersection testing with upper/lower bound planes...
-            // for each frustum edge...
-            for (unsigned int i = 0; i < 12; ++i) {
-                unsigned int const src{FRUSTUM_EDGES.at(i * 2)};
-                unsigned int const dest{FRUSTUM_EDGES.at(i * 2 + 1)};
-
-                geometry::Line const line{frustumCornerPoints.at(src), frustumCornerPoints.at(dest)};
-
-                // upper-bound plane
-                // first, we do a quick intersection check (plane in this case can be described by all points with y = d, since the normal is <0,1,0>)
-                if (glm::min(line.p0.y, line.p1.y) <= upperPlane.d && upperPlane.d <= glm::max(line.p0.y, line.p1.y)) {
-                    glm::vec3 intersectionPoint;
-                    bool const isIntersection{utils::linePlaneIntersection(intersectionPoint, line, upperPlane)};
-                    //NOTE: we can't currently assert this is true, since there is the rare chance that the line lies in the plane (which is currently treated as no intersection for simplicity)
-                    if (isIntersection) intersectionPoints.push_back(glm::vec4{intersectionPoint, 1.0f});
+            // (re)allocate the capture/readback storage for the current grid length...
+            if (isCapturingWaterSurface && GRID_LENGTH != m_waterSurfaceCaptureGridLength) {
+                // a readback still in flight would map the wrong size, so it is dropped and re-requested
+                if (nullptr != m_waterSurfaceReadbackFence) {
+                    glDeleteSync(m_waterSurfaceReadbackFence);
+                    m_waterSurfaceReadbackFence = nullptr;
+                    m_isWaterSurfaceReadbackRequested = true;
                 }
-
-                // lower-bound plane
-                // first, we do a quick intersection check (plane in this case can be described by all points with y = d, since the normal is <0,1,0>)
-                if (glm::min(line.p0.y, line.p1.y) <= lowerPlane.d && lowerPlane.d <= glm::max(line.p0.y, line.p1.y)) {
-                    glm::vec3 intersectionPoint;
-                    bool const isIntersection{utils::linePlaneIntersection(intersectionPoint, line, lowerPlane)};
-                    //NOTE: we can't currently assert this is true, since there is the rare chance that the line lies in the plane (which is currently treated as no intersection for simplicity)
-                    if (isIntersection) intersectionPoints.push_back(glm::vec4{intersectionPoint, 1.0f});
-                }
-            }
-
-            // include any frustum vertices that lie within (intersect) the displaceable volume (between upper and lower bounding planes)
-            // for each frustum vertex...
-            for (unsigned int i = 0; i < frustumCornerPoints.size(); ++i) {
-                glm::vec4 const& frustumCornerPoint{frustumCornerPoints.at(i)};
-                // we do a quick intersection check (planes in this case can be described by all points with y = d, since both have normals as <0, 1, 0>)
-                if (lowerPlane.d <= frustumCornerPoint.y && frustumCornerPoint.y <= upperPlane.d) intersectionPoints.push_back(frustumCornerPoint);
+                GLsizeiptr const waterSurfaceCaptureSizeInBytes{(GLsizeiptr)(GRID_LENGTH * GRID_LENGTH * sizeof(WaterSurfaceVertex))};
+                glBindBuffer(GL_ARRAY_BUFFER, m_waterSurfaceCaptureBuffer);
+                glBufferData(GL_ARRAY_BUFFER, waterSurfaceCaptureSizeInBytes, nullptr, GL_DYNAMIC_COPY);
+                glBindBuffer(GL_ARRAY_BUFFER, 0);
+                glBindBuffer(GL_COPY_WRITE_BUFFER, m_waterSurfaceReadbackBuffer);
+                glBufferData(GL_COPY_WRITE_BUFFER, waterSurfaceCaptureSizeInBytes, nullptr, GL_STREAM_READ);
+                glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+                m_waterSurfaceCaptureGridLength = GRID_LENGTH;
             }
+            if (!isCapturingWaterSurface) m_waterSurfaceCaptureGPUTimeInMilliseconds = 0.0f;
 
-            // only continue to render the water grid, if there were intersection points
-            if (!intersectionPoints.empty()) {
-                ///////////////////////////////////////////////////////////////////////////////////
-                // create projector...
-                // rules...
-                //  1. should never aim away from base plane
-                //  2. eye position must be outside visible volume (thus eye.y <= lowerPlane.d OR eye.y >= upperPlane.d)
-                //  3. provide the most "pleasant" possible projector transformation
-                //NOTE: due to how the triangle mesh is tessellated, the winding will always be counter-clockwise, regardless of whether the projector is above or below the base plane
-                //NOTE: the projector will only differ from the camera in its position.y and pitch, thus we can just clone the camera and then apply a translation + set pitch
-                //NOTE: there are two aimpoints that get interpolated between based on the camera's forward vector - two extreme cases (1. abs(cameraForward • <0,1,0>) == 1 (bird's eye) and 2. cameraForward • <0,1,0> == 0 (horizon)
-
-                Camera projector{*m_camera};
-
-                float const cameraDistanceFromBasePlane{m_camera->getPosition().y};
-                bool const isUnderwater{cameraDistanceFromBasePlane < 0.0f};
-                //TODO: make this a UI property
-                float const PROJECTOR_ELEVATION_FROM_CAMERA{1.0f};
-                float const MINIMUM_PROJECTOR_DISTANCE_FROM_BASE_PLANE{DISPLACEABLE_AMPLITUDE + PROJECTOR_ELEVATION_FROM_CAMERA};
-
-                // translate the y-position of the projector, so that it lies outside the displaceable volume (with some extra elevation padding)
-                if (cameraDistanceFromBasePlane < MINIMUM_PROJECTOR_DISTANCE_FROM_BASE_PLANE) {
-                    if (isUnderwater) projector.translate(glm::vec3{0.0f, MINIMUM_PROJECTOR_DISTANCE_FROM_BASE_PLANE - 2.0f * cameraDistanceFromBasePlane, 0.0f});
-                    else projector.translate(glm::vec3{0.0f, MINIMUM_PROJECTOR_DISTANCE_FROM_BASE_PLANE - cameraDistanceFromBasePlane, 0.0f});
-                }
-
-                // safely handle when the camera is looking too close to the horizon (shift the forward vector a bit to ensure the intersection test succeeds for aimpoint_1)
-                glm::vec3 cameraForwardIntersectionSafe{m_camera->getForward()};
-                float const SAFE_EPSILON{0.001f};
-                if (glm::abs(cameraForwardIntersectionSafe.y) < SAFE_EPSILON) {
-                    float const sign{cameraForwardIntersectionSafe.y >= 0.0f ? 1.0f : -1.0f};
-                    cameraForwardIntersectionSafe.y = sign * SAFE_EPSILON;
-                    //NOTE: there is no need to normalize this (and I don't want to cause the ypos will decrease)
+            // set uniforms...
+            //NOTE: these are set once per frame, so they are looked up by name (in the reflected uniforms, see ShaderProgram), and most of them are skipped as unchanged
+            //NOTE: the camera, fog, sun and wave time are shared with the other programs through the FrameBlock (see updateSceneBlocks), only the water's own parameters are set here
+            //NOTE: in capture mode both programs get the full set, a uniform that a program doesn't have is just ignored (unresolved)
+            std::array<ShaderProgram*, 2> const waterPrograms{isCapturingWaterSurface ? &waterGridCaptureProgram : (isTessellatingWater ? &waterGridTessellationProgram : &waterGridProgram), &waterGridCapturedProgram};
+            for (unsigned int programIndex = 0; programIndex < (isCapturingWaterSurface ? 2u : 1u); ++programIndex) {
+                ShaderProgram &waterProgram{*waterPrograms.at(programIndex)};
+                GLStateCache::useProgram(waterProgram.getID());
+
+                waterProgram.set<glm::vec4>("bottomLeftGridPointInWorld", bottomLeftGridPointInWorld);
+                waterProgram.set<glm::vec4>("bottomRightGridPointInWorld", bottomRightGridPointInWorld);
+                Texture::bind2DTexture(waterProgram, m_frameGraph.getTexture(graph.depthTexture), "depthTexture2D");
+                waterProgram.set<float>("displaceableAmplitude", DISPLACEABLE_AMPLITUDE);
+
+                //NOTE: the gerstner waves are sourced from the GerstnerWaveBlock UBO (see updateGerstnerWaveBlock)
+                // ...or from the baked atlas, which only needs the 2 layers bracketing the current (looped) time
+                waterProgram.set<GLint>("isUsingGerstnerAtlas", isPlayingGerstnerAtlas);
+                //NOTE: the array samplers must always point at an array texture, otherwise they default to unit 0 alongside the 2D samplers (mixing sampler types on 1 unit fails the draw)
+                Texture::bind2DTextureArray(waterProgram, 0 != m_gerstnerAtlasDisplacementTexture2DArray ? m_gerstnerAtlasDisplacementTexture2DArray : m_placeholderTexture2DArray, "gerstnerAtlasDisplacementTexture2DArray");
+                Texture::bind2DTextureArray(waterProgram, 0 != m_gerstnerAtlasNormalTexture2DArray ? m_gerstnerAtlasNormalTexture2DArray : m_placeholderTexture2DArray, "gerstnerAtlasNormalTexture2DArray");
+                if (isPlayingGerstnerAtlas) {
+                    GerstnerAtlasParameters const& atlasParameters{m_gerstnerAtlas->getParameters()};
+                    float const loopedFrame{glm::fract(waveAnimationTimeInSeconds / m_gerstnerAtlas->getLoopPeriodInSeconds()) * atlasParameters.frameCount};
+                    unsigned int const layer0{glm::min((unsigned int)loopedFrame, atlasParameters.frameCount - 1)};
+                    waterProgram.set<float>("gerstnerAtlasLayer0", (float)layer0);
+                    waterProgram.set<float>("gerstnerAtlasLayer1", (float)((layer0 + 1) % atlasParameters.frameCount));
+                    waterProgram.set<float>("gerstnerAtlasLayerBlend", loopedFrame - layer0);
+                    waterProgram.set<float>("gerstnerAtlasTileLength", atlasParameters.tileLength);
                 }
 
-                // compute aimpoint for method 1 (bird's eye)...
-                glm::vec3 aimpoint_1;
-                bool const isLookingDown{cameraForwardIntersectionSafe.y < 0.0f};
-                bool const isLookingDown_XOR_isUnderwater{isLookingDown != isUnderwater};
-                if (isLookingDown_XOR_isUnderwater) {
-                    bool const isIntersection{utils::linePlaneIntersection(aimpoint_1, geometry::Line{m_camera->getPosition(), m_camera->getPosition() + cameraForwardIntersectionSafe}, basePlane)};
-                    assert(isIntersection);
+                waterProgram.set<GLuint>("gridLength", GRID_LENGTH);
+                waterProgram.set<GLint>("isUsingClipmap", isUsingWaterClipmap);
+                //NOTE: the static heightmap stands in until the sequence's current frame is resident
+                if (isPlayingHeightmapSequence && -1 != m_heightmapSequenceSlot) {
+                    Texture::bind2DTexture(waterProgram, m_heightmapSequenceTextures.at(m_heightmapSequenceSlot), "heightmap");
+                    Texture::bind2DTexture(waterProgram, m_heightmapSequenceTextures.at(m_heightmapSequenceNextSlot), "heightmapNext");
+                    waterProgram.set<float>("heightmapFrameBlend", m_heightmapSequenceFrameBlend);
                 } else {
-                    glm::vec3 const cameraForwardIntersectionSafeMirrored{glm::reflect(cameraForwardIntersectionSafe, basePlane.getNormalVec())};
-                    bool const isIntersection{utils::linePlaneIntersection(aimpoint_1, geometry::Line{m_camera->getPosition(), m_camera->getPosition() + cameraForwardIntersectionSafeMirrored}, basePlane)};
-                    assert(isIntersection);
+                    Texture::bind2DTexture(waterProgram, waterGrid->textureID, "heightmap");
+                    Texture::bind2DTexture(waterProgram, waterGrid->textureID, "heightmapNext");
+                    waterProgram.set<float>("heightmapFrameBlend", 0.0f);
                 }
-
-                // compute aimpoint for method 2 (horizon)...
-                //TODO: make this a UI property? auto-generate it?
-                float const FORWARD_FIXED_LENGTH{1.0f};
-                glm::vec3 aimpoint_2{m_camera->getPosition() + FORWARD_FIXED_LENGTH * m_camera->getForward()};
-                // project this point onto the base plane
-                aimpoint_2.y = 0.0f;
-
-                //NOTE: the grid changes abruptly when aimpoint_final == aimpoint2 (a == 0), but this will never occur since...
-                //      I made the camera's forward vector (for the math only) intersection safe (aimpoint_1 will be defined and a != 0.0)
-                // compute the interpolation coefficient in range [SAFE_EPSILON, 1.0]...
-                float const a{glm::abs(cameraForwardIntersectionSafe.y)};
-
-                // compute the final aimpoint as an interpolation between the two aimpoints...
-                glm::vec3 const aimpoint_final{glm::mix(aimpoint_2, aimpoint_1, a)};
-
-                // compute the projector's pitch in order to aim at this aimpoint...
-                glm::vec3 const projectorNewForwardVec{glm::normalize(aimpoint_final - projector.getPosition())};
-                glm::vec3 const projectorNewForwardVecXZProjection{glm::normalize(glm::vec3{projectorNewForwardVec.x, 0.0f, projectorNewForwardVec.z})};
-                //NOTE: the projector's position will always be above water, thus the pitch will always be negative
-                float projectorNewPitchDegrees{-glm::degrees(glm::acos(glm::dot(projectorNewForwardVec, projectorNewForwardVecXZProjection)))};
-
-                // now, aim the projector...
-                projector.setRotation(projector.getYaw(), projectorNewPitchDegrees);
-                ///////////////////////////////////////////////////////////////////////////////////
-
-                // project all intersection points onto base plane...
-                for (unsigned int i = 0; i < intersectionPoints.size(); ++i) {
-                    intersectionPoints.at(i).y = 0.0f;
+                waterProgram.set<float>("heightmapDisplacementScale", heightmapDisplacementScale);
+                waterProgram.set<float>("heightmapSampleScale", heightmapSampleScale);
+                waterProgram.set<GLint>("isUsingFiniteDifferenceNormals", isUsingFiniteDifferenceWaterNormals);
+                waterProgram.set<GLint>("isUsingWaveLOD", isUsingWaveLOD);
+                waterProgram.set<GLint>("isUsingOceanFFT", isUsingOceanFFT);
+                if (isUsingOceanFFT) {
+                    Texture::bind2DTexture(waterProgram, m_oceanDisplacementTexture2D, "oceanDisplacementTexture2D");
+                    Texture::bind2DTexture(waterProgram, m_oceanNormalTexture2D, "oceanNormalTexture2D");
+                    waterProgram.set<float>("oceanPatchLength", m_oceanFFT->getParameters().patchLength);
                 }
+                bool const isUpsamplingLocalReflections{1 != m_localReflectionsAllocatedDownscale};
+                bool const isUpsamplingLocalRefractions{1 != m_localRefractionsAllocatedDownscale};
+                Texture::bind2DTexture(waterProgram, m_frameGraph.getTexture(graph.localReflectionsTexture), "localReflectionsTexture2D");
+                Texture::bind2DTexture(waterProgram, m_frameGraph.getTexture(graph.localRefractionsTexture), "localRefractionsTexture2D");
+                //NOTE: the pass depths are only read (and so only kept alive) for the upsample, otherwise the colour textures stand in for the unused samplers
+                Texture::bind2DTexture(waterProgram, m_frameGraph.getTexture(isUpsamplingLocalReflections ? graph.localReflectionsDepthTexture : graph.localReflectionsTexture), "localReflectionsDepthTexture2D");
+                Texture::bind2DTexture(waterProgram, m_frameGraph.getTexture(isUpsamplingLocalRefractions ? graph.localRefractionsDepthTexture : graph.localRefractionsTexture), "localRefractionsDepthTexture2D");
+                waterProgram.set<GLint>("isUpsamplingLocalReflections", isUpsamplingLocalReflections);
+                waterProgram.set<GLint>("isUpsamplingLocalRefractions", isUpsamplingLocalRefractions);
 
-                // transform all intersection points into NDC-space (for projector)
-                // reference: https://community.khronos.org/t/homogenous-normalized-device-coords-and-clipping/61965
-                // reference: https://stackoverflow.com/questions/21841598/when-does-the-transition-from-clip-space-to-screen-coordinates-happen
-                //NOTE: I was having a lot of issues before I divided by w, so hopefully everything works now
-                glm::mat4 const projector_viewProjectionMat{projector.getProjectionMat() * projector.getViewMat()};
-                for (unsigned int i = 0; i < intersectionPoints.size(); ++i) {
-                    glm::vec4 const temp{projector_viewProjectionMat * intersectionPoints.at(i)}; // now in clip-space
-                    intersectionPoints.at(i) = temp / temp.w; // now in NDC-space
-                }
+                //TODO: refactor into own function
+                // bind texture...
+                GLStateCache::bindTextureToUnit(m_skyboxCubemap, GL_TEXTURE_CUBE_MAP, m_skyboxCubemap);
+                waterProgram.set<GLint>("skybox", m_skyboxCubemap);
+                waterProgram.set<float>("skyboxReflectionDistanceLOD", skyReflectionDistanceLOD);
+
+                waterProgram.set<float>("softEdgesDeltaDepthThreshold", softEdgesDeltaDepthThreshold);
+                waterProgram.set<float>("tessellationMaxLevel", (float)glm::max(m_maxWaterTessellationLevel, 1));
+                waterProgram.set<float>("tessellationMinAmplitudeInPixels", waterTessellationMinAmplitudeInPixels);
+                waterProgram.set<float>("tessellationPixelsPerSegment", waterTessellationPixelsPerSegment);
+                waterProgram.set<float>("tintDeltaDepthThreshold", tintDeltaDepthThreshold);
+                waterProgram.set<glm::vec4>("topLeftGridPointInWorld", topLeftGridPointInWorld);
+                waterProgram.set<glm::vec4>("topRightGridPointInWorld", topRightGridPointInWorld);
+                waterProgram.set<float>("waterClarity", waterClarity);
+                waterProgram.set<float>("waveLODMinSamplesPerWavelength", waveLODMinSamplesPerWavelength);
+            }
 
-                // determine the xy-NDC bounds of the intersection points
-                float x_min = intersectionPoints.at(0).x;
-                float x_max = intersectionPoints.at(0).x;
-                float y_min = intersectionPoints.at(0).y;
-                float y_max = intersectionPoints.at(0).y;
-                for (unsigned int i = 1; i < intersectionPoints.size(); ++i) {
-                    if (intersectionPoints.at(i).x < x_min) x_min = intersectionPoints.at(i).x;
-                    else if (intersectionPoints.at(i).x > x_max) x_max = intersectionPoints.at(i).x;
-
-                    if (intersectionPoints.at(i).y < y_min) y_min = intersectionPoints.at(i).y;
-                    else if (intersectionPoints.at(i).y > y_max) y_max = intersectionPoints.at(i).y;
+            if (isCapturingWaterSurface) {
+                // displace every grid vertex exactly once (gl_VertexID = 0 ... GRID_LENGTH^2 - 1), nothing is rasterized...
+                GLStateCache::useProgram(waterGridCaptureProgram.getID());
+                GLStateCache::bindVertexArray(m_emptyVAO);
+                GLStateCache::setEnabled(GL_RASTERIZER_DISCARD, true);
+                glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, m_waterSurfaceCaptureBuffer);
+                glBeginQuery(GL_TIME_ELAPSED, m_gpuTimerQueries.at(m_gpuTimerFrame).at(WATER_SURFACE_CAPTURE_TIMER));
+                glBeginTransformFeedback(GL_POINTS);
+                glDrawArrays(GL_POINTS, 0, GRID_LENGTH * GRID_LENGTH);
+                glEndTransformFeedback();
+                glEndQuery(GL_TIME_ELAPSED);
+                m_isGPUTimerQueryIssued.at(m_gpuTimerFrame).at(WATER_SURFACE_CAPTURE_TIMER) = true;
+                glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+                GLStateCache::setEnabled(GL_RASTERIZER_DISCARD, false);
+
+                // GPU-side copy for the CPU readback (so the capture buffer is free to be overwritten next frame), then fence it...
+                if (m_isWaterSurfaceReadbackRequested && nullptr == m_waterSurfaceReadbackFence) {
+                    glBindBuffer(GL_COPY_READ_BUFFER, m_waterSurfaceCaptureBuffer);
+                    glBindBuffer(GL_COPY_WRITE_BUFFER, m_waterSurfaceReadbackBuffer);
+                    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, (GLsizeiptr)GRID_LENGTH * GRID_LENGTH * sizeof(WaterSurfaceVertex));
+                    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+                    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+                    m_waterSurfaceReadbackFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                    m_isWaterSurfaceReadbackRequested = false;
                 }
 
-                // setup the range conversion matrix (in column-major order)
-                // will be used to convert from a special uv-space ("range-space")
-                //
-                // |x_max - x_min,       0      , 0, x_min|
-                // |      0      , y_max - y_min, 0, y_min|
-                // |      0      ,       0      , 1,   0  |
-                // |      0      ,       0      , 0,   1  |
-                //
-                glm::mat4 const rangeMat{x_max - x_min, 0.0f, 0.0f, 0.0f,
-                                         0.0f, y_max - y_min, 0.0f, 0.0f,
-                                         0.0f, 0.0f, 1.0f, 0.0f,
-                                         x_min, y_min, 0.0f, 1.0f};
-
-                // compute M_projector...
-                glm::mat4 const projectorMat{glm::inverse(projection * projector.getViewMat()) * rangeMat};
-
-                // compute the world-space coordinates of the four grid corners...
-                // init the corner positions in a special uv-space ("range-space") - (with z = -1 (near) for convenience for intersection test below)
-                std::array<glm::vec4, 4> waterGridCornerPoints{glm::vec4{0.0f, 0.0f, -1.0f, 1.0f},   // [0] - bottom-left
-                                                               glm::vec4{0.0f, 1.0f, -1.0f, 1.0f},   // [1] - top-left
-                                                               glm::vec4{1.0f, 0.0f, -1.0f, 1.0f},   // [2] - bottom-right
-                                                               glm::vec4{1.0f, 1.0f, -1.0f, 1.0f}};  // [3] - top-right
-
-                // transform the coordinates to world-space...
-                // intersect projected rays with XZ-plane (base plane) to get world-space bounds of grid...
-                for (unsigned int i = 0; i < waterGridCornerPoints.size(); ++i) {
-                    glm::vec4 p0{waterGridCornerPoints.at(i)};
-                    glm::vec4 p1{p0};
-                    p1.z = 1.0f; // far
-
-                    // transform both points to world-space...
-                    p0 = projectorMat * p0;
-                    p0 /= p0.w;
-                    p1 = projectorMat * p1;
-                    p1 /= p1.w;
-
-                    // intersection test...
-                    geometry::Line const line{p0, p1};
-                    glm::vec3 intersectionPoint;
-                    bool const isIntersection{utils::linePlaneIntersection(intersectionPoint, line, basePlane)};
-                    assert(isIntersection);
-                    waterGridCornerPoints.at(i) = glm::vec4{intersectionPoint, 1.0f};
-                }
+                GLStateCache::useProgram(waterGridCapturedProgram.getID());
+                GLStateCache::bindVertexArray(m_waterSurfaceCaptureVAO);
+            } else {
+                GLStateCache::bindVertexArray(waterGrid->vao);
+            }
+            // the current level's triangulation (the element buffer binding is part of the bound vao)
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, waterGridIndexBuffer);
 
-                // set useful aliases for the grid corners
-                glm::vec4 const& bottomLeftGridPointInWorld{waterGridCornerPoints.at(0)};
-                glm::vec4 const& topLeftGridPointInWorld{waterGridCornerPoints.at(1)};
-                glm::vec4 const& bottomRightGridPointInWorld{waterGridCornerPoints.at(2)};
-                glm::vec4 const& topRightGridPointInWorld{waterGridCornerPoints.at(3)};
-
-                // now render...
-                glUseProgram(waterGridProgram);
-                glBindVertexArray(waterGrid->vao);
-
-                // set uniforms...
-                //TODO: should get uniform locations ONCE and store them (and error handle)
-
-                //TODO: right now this just matches a constant in program.cpp, but will be attached to MeshObject in the future
-                //TODO: make this a UI setting (and probably should store this with the mesh itself since drawFaces will be closely related)
-                //TODO: might even split this into a width/height (or hres/vres) in the future for non-square grids
-                //NOTE: this should be >= 2
-                GLuint const GRID_LENGTH = 513;
-
-                glUniform4fv(glGetUniformLocation(waterGridProgram, "bottomLeftGridPointInWorld"), 1, glm::value_ptr(bottomLeftGridPointInWorld));
-                glUniform4fv(glGetUniformLocation(waterGridProgram, "bottomRightGridPointInWorld"), 1, glm::value_ptr(bottomRightGridPointInWorld));
-                glUniform3fv(glGetUniformLocation(waterGridProgram, "cameraPosition"), 1, glm::value_ptr(m_camera->getPosition()));
-                Texture::bind2DTexture(waterGridProgram, m_depthTexture2D, "depthTexture2D");
-                glUniform4fv(glGetUniformLocation(waterGridProgram, "fogColourFarAtCurrentTime"), 1, glm::value_ptr(fogColourFarAtCurrentTime));
-                glUniform1f(glGetUniformLocation(waterGridProgram, "fogDepthRadiusFar"), fogDepthRadiusFar);
-                glUniform1f(glGetUniformLocation(waterGridProgram, "fogDepthRadiusNear"), fogDepthRadiusNear);
-
-                // reference: https://developer.nvidia.com/gpugems/gpugems/part-i-natural-effects/chapter-1-effective-water-simulation-physical-models
-                // reference: https://github.com/CaffeineViking/osgw/blob/master/share/shaders/gerstner.glsl
-                glUniform1ui(glGetUniformLocation(waterGridProgram, "gerstnerWaveCount"), geometry::GerstnerWave::Count());
-                for (unsigned int i = 0; i < gerstnerWaves.size(); ++i) {
-                    std::shared_ptr<geometry::GerstnerWave const> gerstnerWave{gerstnerWaves.at(i)};
-                    if (nullptr == gerstnerWave) continue;
-
-                    //NOTE: div by zero is just handled by setting to a symbolic 0.0
-                    float const steepness_Q_i{(gerstnerWave->frequency_w * gerstnerWave->amplitude_A) != 0.0f ? gerstnerWave->steepness_Q / (gerstnerWave->frequency_w * gerstnerWave->amplitude_A * geometry::GerstnerWave::Count()) : 0.0f};
-                    std::string const prefixStr{"gerstnerWaves[" + std::to_string(i) + "]."};
-
-                    glUniform1f(glGetUniformLocation(waterGridProgram, std::string{prefixStr + "amplitude_A"}.c_str()), gerstnerWave->amplitude_A);
-                    glUniform1f(glGetUniformLocation(waterGridProgram, std::string{prefixStr + "frequency_w"}.c_str()), gerstnerWave->frequency_w);
-                    glUniform1f(glGetUniformLocation(waterGridProgram, std::string{prefixStr + "phaseConstant_phi"}.c_str()), gerstnerWave->phaseConstant_phi);
-                    glUniform1f(glGetUniformLocation(waterGridProgram, std::string{prefixStr + "steepness_Q_i"}.c_str()), steepness_Q_i);
-                    glUniform2fv(glGetUniformLocation(waterGridProgram, std::string{prefixStr + "xzDirection_D"}.c_str()), 1, glm::value_ptr(gerstnerWave->xzDirection_D));
+            // draw...
+            // POINT, LINE or FILL...
+            GLStateCache::polygonMode(waterGrid->m_polygonMode);
+            glBeginQuery(GL_TIME_ELAPSED, m_gpuTimerQueries.at(m_gpuTimerFrame).at(WATER_SURFACE_DRAW_TIMER));
+            if (isUsingWaterClipmap) {
+                // 1 multi-draw per level, over the index ranges of its visible tiles...
+                std::array<void const*, WaterClipmap::TILE_COUNT> firstIndexOffsets;
+                for (unsigned int levelIndex = 0; levelIndex < m_waterClipmap.getLevelCount(); ++levelIndex) {
+                    WaterClipmap::Level const& level{m_waterClipmap.getLevel(levelIndex)};
+                    if (0 == level.drawCount) continue;
+
+                    waterGridProgram.set<glm::vec2>("clipmapOrigin", level.origin);
+                    waterGridProgram.set<float>("clipmapCellSize", level.cellSize);
+                    waterGridProgram.set<float>("clipmapMorphStartDistance", level.morphStartDistance);
+                    waterGridProgram.set<float>("clipmapMorphEndDistance", level.morphEndDistance);
+                    for (unsigned int draw = 0; draw < level.drawCount; ++draw) firstIndexOffsets[draw] = (void const*)(sizeof(GLuint) * level.firstIndices[draw]);
+                    glMultiDrawElements(waterGrid->m_primitiveMode, level.indexCounts.data(), GL_UNSIGNED_INT, firstIndexOffsets.data(), level.drawCount);
                 }
+                m_waterVertexCount = m_waterClipmap.getVertexCount();
+                m_waterTriangleCount = m_waterClipmap.getTriangleCount();
+            } else if (isTessellatingWater) {
+                // 4 corners per patch, the control stage picks the edge levels (0 culls the patch) and the evaluation stage displaces the generated vertices...
+                //NOTE: the tessellator's output size is only known on the GPU, so it is counted with a query (read back a frame or two later, like the timers)
+                glPatchParameteri(GL_PATCH_VERTICES, 4);
+                glBeginQuery(GL_PRIMITIVES_GENERATED, m_gpuTimerQueries.at(m_gpuTimerFrame).at(WATER_TESSELLATION_PRIMITIVES_GENERATED));
+                glDrawElements(GL_PATCHES, WaterGrid::getPatchIndexCount(), GL_UNSIGNED_INT, (void*)0);
+                glEndQuery(GL_PRIMITIVES_GENERATED);
+                m_isGPUTimerQueryIssued.at(m_gpuTimerFrame).at(WATER_TESSELLATION_PRIMITIVES_GENERATED) = true;
+                m_waterVertexCount = GRID_LENGTH * GRID_LENGTH;
+                m_waterTriangleCount = m_waterTessellatedTriangleCount;
+            } else {
+                // the level's index buffer covers 1 band of rows, re-drawn for every band with the band's first vertex as the base vertex (so gl_VertexID is still the grid index)...
+                WaterGrid::IndexLayout const indexLayout{waterGrid->indexLayout};
+                GLuint const bandCellRowCount{WaterGrid::getBandCellRowCount(waterGridLevel, indexLayout)};
+                unsigned int const bandCount{WaterGrid::getBandCount(waterGridLevel, indexLayout)};
+                m_waterGridBandIndexCounts.assign(bandCount, WaterGrid::getIndexCount(waterGridLevel, indexLayout));
+                m_waterGridBandFirstIndexOffsets.assign(bandCount, (void const*)0);
+                m_waterGridBandBaseVertices.resize(bandCount);
+                for (unsigned int band = 0; band < bandCount; ++band) m_waterGridBandBaseVertices.at(band) = band * bandCellRowCount * GRID_LENGTH;
+
+                bool const isStrip{WaterGrid::IndexLayout::TILED_STRIP == indexLayout};
+                if (isStrip) {
+                    GLStateCache::setEnabled(GL_PRIMITIVE_RESTART, true);
+                    glPrimitiveRestartIndex(WaterGrid::PRIMITIVE_RESTART_INDEX);
+                }
+                glMultiDrawElementsBaseVertex(isStrip ? GL_TRIANGLE_STRIP : waterGrid->m_primitiveMode, m_waterGridBandIndexCounts.data(), WaterGrid::getIndexType(indexLayout), m_waterGridBandFirstIndexOffsets.data(), bandCount, m_waterGridBandBaseVertices.data());
+                if (isStrip) GLStateCache::setEnabled(GL_PRIMITIVE_RESTART, false);
+                m_waterVertexCount = GRID_LENGTH * GRID_LENGTH;
+                m_waterTriangleCount = WaterGrid::getTriangleCount(waterGridLevel);
+            }
+            glEndQuery(GL_TIME_ELAPSED);
+            m_isGPUTimerQueryIssued.at(m_gpuTimerFrame).at(WATER_SURFACE_DRAW_TIMER) = true;
 
-                glUniform1ui(glGetUniformLocation(waterGridProgram, "gridLength"), GRID_LENGTH);
-                Texture::bind2DTexture(waterGridProgram, waterGrid->textureID, "heightmap");
-                glUniform1f(glGetUniformLocation(waterGridProgram, "heightmapDisplacementScale"), heightmapDisplacementScale);
-                glUniform1f(glGetUniformLocation(waterGridProgram, "heightmapSampleScale"), heightmapSampleScale);
-                Texture::bind2DTexture(waterGridProgram, m_localReflectionsTexture2D, "localReflectionsTexture2D");
-                Texture::bind2DTexture(waterGridProgram, m_localRefractionsTexture2D, "localRefractionsTexture2D");
+            // unbind texture...
+            GLStateCache::bindTexture(GL_TEXTURE_CUBE_MAP, 0);
 
-                //TODO: refactor into own function
-                // bind texture...
-                glActiveTexture(GL_TEXTURE0 + m_skyboxCubemap);
-                glBindTexture(GL_TEXTURE_CUBE_MAP, m_skyboxCubemap);
-                glUniform1i(glGetUniformLocation(waterGridProgram, "skybox"), m_skyboxCubemap);
-
-                glUniform1f(glGetUniformLocation(waterGridProgram, "softEdgesDeltaDepthThreshold"), softEdgesDeltaDepthThreshold);
-                glUniform3fv(glGetUniformLocation(waterGridProgram, "sunPosition"), 1, glm::value_ptr(sunPosition));
-                glUniform1f(glGetUniformLocation(waterGridProgram, "sunShininess"), sunShininess);
-                glUniform1f(glGetUniformLocation(waterGridProgram, "sunStrength"), sunStrength);
-                glUniform1f(glGetUniformLocation(waterGridProgram, "tintDeltaDepthThreshold"), tintDeltaDepthThreshold);
-                glUniform4fv(glGetUniformLocation(waterGridProgram, "topLeftGridPointInWorld"), 1, glm::value_ptr(topLeftGridPointInWorld));
-                glUniform4fv(glGetUniformLocation(waterGridProgram, "topRightGridPointInWorld"), 1, glm::value_ptr(topRightGridPointInWorld));
-                glUniform1f(glGetUniformLocation(waterGridProgram, "verticalBounceWaveDisplacement"), verticalBounceWaveDisplacement);
-                glUniformMatrix4fv(glGetUniformLocation(waterGridProgram, "viewMatOnlyYaw"), 1, GL_FALSE, glm::value_ptr(viewMatOnlyYaw));
-                glUniform2fv(glGetUniformLocation(waterGridProgram, "viewportWidthHeight"), 1, glm::value_ptr(glm::vec2{(float)m_windowWidth, (float)m_windowHeight}));
-                glUniformMatrix4fv(glGetUniformLocation(waterGridProgram, "viewProjection"), 1, GL_FALSE, glm::value_ptr(viewProjection));
-                glUniform1f(glGetUniformLocation(waterGridProgram, "waterClarity"), waterClarity);
-                glUniform1f(glGetUniformLocation(waterGridProgram, "waveAnimationTimeInSeconds"), waveAnimationTimeInSeconds);
-                glUniform1f(glGetUniformLocation(waterGridProgram, "zFar"), Z_FAR);
-                glUniform1f(glGetUniformLocation(waterGridProgram, "zNear"), Z_NEAR);
-
-                // draw...
-                // POINT, LINE or FILL...
-                glPolygonMode(GL_FRONT_AND_BACK, waterGrid->m_polygonMode);
-                glDrawElements(waterGrid->m_primitiveMode, waterGrid->drawFaces.size(), GL_UNSIGNED_INT, (void*)0);
-
-                // unbind texture...
-                glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
-
-                Texture::unbind2DTexture();
-                glBindVertexArray(0); // unbind VAO
-                glUseProgram(0); // unbind shader program
-            }
+            Texture::unbind2DTexture();
+            GLStateCache::bindVertexArray(0); // unbind VAO
+            GLStateCache::useProgram(0); // unbind shader program
+            m_frameGraph.endPass(graph.waterPass);
         }
         ///////////////////////////////////////////////////
 
         ///////////////////////////////////////////////////
         // SPECIAL DEBUG RENDER MODES
-        //TODO: optimize the layout so that we don't render most of the stuff above if want to render one of these debug modes...
-
-        if (0 != m_emptyVAO && RenderMode::DEFAULT != renderMode) {
-            glDisable(GL_BLEND);
-            glDepthMask(GL_FALSE);
+        //NOTE: the debug pass only reads the texture that is shown, so the frame graph culls every other pass (the main scene included)
+        if (m_frameGraph.beginPass(graph.debugPass)) {
+            GLStateCache::setEnabled(GL_BLEND, false);
+            GLStateCache::depthMask(GL_FALSE);
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
             // enable screen-space-quad shader program
-            glUseProgram(screenSpaceQuadProgram);
+            GLStateCache::useProgram(screenSpaceQuadProgram.getID());
             // bind geometry data...
-            glBindVertexArray(m_emptyVAO);
+            GLStateCache::bindVertexArray(m_emptyVAO);
 
             // set uniforms...
-            glUniform1i(glGetUniformLocation(screenSpaceQuadProgram, "isTextured"), GL_TRUE);
-            glUniform4fv(glGetUniformLocation(screenSpaceQuadProgram, "solidColour"), 1, glm::value_ptr(glm::vec4{1.0f, 1.0f, 1.0f, 1.0f})); // unused colour
-            if (RenderMode::LOCAL_REFLECTIONS == renderMode) Texture::bind2DTexture(screenSpaceQuadProgram, m_localReflectionsTexture2D, "textureData");
-            else if (RenderMode::LOCAL_REFRACTIONS == renderMode) Texture::bind2DTexture(screenSpaceQuadProgram, m_localRefractionsTexture2D, "textureData");
+            screenSpaceQuadProgram.set<GLint>("isTextured", GL_TRUE);
+            screenSpaceQuadProgram.set<glm::vec4>("solidColour", glm::vec4{1.0f, 1.0f, 1.0f, 1.0f}); // unused colour
+            if (RenderMode::LOCAL_REFLECTIONS == renderMode) Texture::bind2DTexture(screenSpaceQuadProgram, m_frameGraph.getTexture(graph.localReflectionsTexture), "textureData");
+            else if (RenderMode::LOCAL_REFRACTIONS == renderMode) Texture::bind2DTexture(screenSpaceQuadProgram, m_frameGraph.getTexture(graph.localRefractionsTexture), "textureData");
+            else if (RenderMode::WORLD_SPACE_DEPTH == renderMode) Texture::bind2DTexture(screenSpaceQuadProgram, m_frameGraph.getTexture(graph.worldSpaceDepthTexture), "textureData");
 
             // POINT, LINE or FILL...
-            glPolygonMode(GL_FRONT_AND_BACK, PolygonMode::FILL);
+            GLStateCache::polygonMode(PolygonMode::FILL);
             glDrawArrays(PrimitiveMode::TRIANGLE_STRIP, 0, 4);
 
             Texture::unbind2DTexture();
             // unbind
-            glBindVertexArray(0);
+            GLStateCache::bindVertexArray(0);
 
             // reset
-            glDepthMask(GL_TRUE);
-            glEnable(GL_BLEND);
+            GLStateCache::depthMask(GL_TRUE);
+            GLStateCache::setEnabled(GL_BLEND, true);
+            m_frameGraph.endPass(graph.debugPass);
         }
         ///////////////////////////////////////////////////
+
+        glQueryCounter(m_gpuTimerQueries.at(m_gpuTimerFrame).at(FRAME_END_TIMESTAMP), GL_TIMESTAMP);
+        m_isGPUTimerQueryIssued.at(m_gpuTimerFrame).at(FRAME_END_TIMESTAMP) = true;
+        m_issuedUniformCount = ShaderProgram::getIssuedUniformCount();
+        m_skippedUniformCount = ShaderProgram::getSkippedUniformCount();
+        m_issuedGLStateCallCount = GLStateCache::getIssuedCallCount();
+        m_filteredGLStateCallCount = GLStateCache::getFilteredCallCount();
+        m_glStateMismatchCount = isValidatingGLState ? GLStateCache::validate() : 0;
+        m_frameCPUTimeInMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - frameStartTime).count();
     }
 
     void RenderEngine::assignBuffers(MeshObject &object)
@@ -1167,8 +1614,11 @@ namespace wave_tool {
         std::vector<glm::vec3> const& colours = object.colours;
         std::vector<GLuint> const& faces = object.drawFaces;
 
+        // the shared copy of the scene meshes is re-packed (see SceneBatch)
+        m_sceneBatch.invalidate();
+
         glGenVertexArrays(1, &object.vao);
-        glBindVertexArray(object.vao);
+        GLStateCache::bindVertexArray(object.vao);
 
         // Vertex buffer
         // location 0 in vao
@@ -1220,14 +1670,57 @@ namespace wave_tool {
         }
 
         // unbind vao
-        glBindVertexArray(0);
+        GLStateCache::bindVertexArray(0);
     }
 
     //NOTE: this method assumes that the vector sizes have remained the same, the data in them has just changed
     //NOTE: it also assumes that the buffers have already been created and bound to the vao (by assignBuffers)
+    void RenderEngine::assignWaterGridBuffers(WaterGrid &waterGrid) {
+        // the grid has no vertex data (see water-grid.vert), so this only creates the vao
+        assignBuffers(waterGrid);
+
+        assignWaterGridLevelIndexBuffers(waterGrid, waterGrid.indexLayout);
+
+        std::vector<GLuint> indices;
+        // every clipmap level draws from the same index buffer (the tile ranges are known to WaterClipmap)
+        std::array<std::array<WaterClipmap::TileRange, WaterClipmap::TILE_COUNT>, WaterClipmap::VARIANT_COUNT> clipmapTileRanges;
+        WaterClipmap::generateTriangleIndices(indices, clipmapTileRanges);
+        glGenBuffers(1, &waterGrid.clipmapIndexBuffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, waterGrid.clipmapIndexBuffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, sizeof(GLuint) * indices.size(), indices.data(), GL_STATIC_DRAW);
+        // the coarse patch grid for the tessellation mode (a few KB, instead of the MBs of the finer levels)
+        WaterGrid::generatePatchIndices(WaterGrid::PATCH_GRID_LENGTH, indices);
+        glGenBuffers(1, &waterGrid.patchIndexBuffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, waterGrid.patchIndexBuffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, sizeof(GLuint) * indices.size(), indices.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+    void RenderEngine::assignWaterGridLevelIndexBuffers(WaterGrid &waterGrid, WaterGrid::IndexLayout const indexLayout) {
+        glDeleteBuffers(waterGrid.levelIndexBuffers.size(), waterGrid.levelIndexBuffers.data());
+        glGenBuffers(waterGrid.levelIndexBuffers.size(), waterGrid.levelIndexBuffers.data());
+
+        std::vector<GLuint> indices;
+        std::vector<GLushort> shortIndices;
+        for (unsigned int level = 0; level < WaterGrid::getLevelCount(); ++level) {
+            WaterGrid::generateIndices(WaterGrid::getGridLength(level), WaterGrid::getBandCellRowCount(level, indexLayout), indexLayout, indices);
+            //NOTE: uploaded through a generic target, since the element buffer binding needs a vao (it gets bound to the vao at draw time)
+            glBindBuffer(GL_COPY_WRITE_BUFFER, waterGrid.levelIndexBuffers.at(level));
+            if (GL_UNSIGNED_SHORT == WaterGrid::getIndexType(indexLayout)) {
+                shortIndices.assign(indices.begin(), indices.end());
+                glBufferData(GL_COPY_WRITE_BUFFER, sizeof(GLushort) * shortIndices.size(), shortIndices.data(), GL_STATIC_DRAW);
+            } else {
+                glBufferData(GL_COPY_WRITE_BUFFER, sizeof(GLuint) * indices.size(), indices.data(), GL_STATIC_DRAW);
+            }
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        waterGrid.indexLayout = indexLayout;
+    }
+
     void RenderEngine::updateBuffers(MeshObject &object, bool const updateVerts, bool const updateUVs, bool const updateNormals, bool const updateColours) {
         // nothing bound
         if (0 == object.vao) return;
+        m_sceneBatch.invalidate();
 
         if (updateVerts && 0 != object.vertexBuffer) {
             std::vector<glm::vec3> const& newVerts = object.drawVerts;
@@ -1348,7 +1841,7 @@ namespace wave_tool {
         // get here if all 6 image files were read correctly
         GLuint textureID;
         glGenTextures(1, &textureID);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+        GLStateCache::bindTexture(GL_TEXTURE_CUBE_MAP, textureID);
         // set options on currently bound texture object...
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -1375,6 +1868,29 @@ namespace wave_tool {
         return textureID;
     }
 
+    // the frame textures and pixel-unpack buffers are allocated here once (all frames share the same size), only their contents are streamed afterwards
+    bool RenderEngine::loadHeightmapSequence(std::string const& pathPattern) {
+        std::unique_ptr<HeightmapSequence> heightmapSequence{HeightmapSequence::open(pathPattern)};
+        if (nullptr == heightmapSequence) return false;
+
+        GLStateCache::deleteTextures(HEIGHTMAP_SEQUENCE_TEXTURE_COUNT, m_heightmapSequenceTextures.data());
+        glDeleteBuffers(HEIGHTMAP_SEQUENCE_PBO_COUNT, m_heightmapSequencePBOs.data());
+        for (unsigned int slot = 0; slot < HEIGHTMAP_SEQUENCE_TEXTURE_COUNT; ++slot) {
+            m_heightmapSequenceTextures.at(slot) = Texture::create2DTextureR8OrR16(nullptr, heightmapSequence->getWidth(), heightmapSequence->getHeight(), heightmapSequence->getBytesPerTexel());
+            m_heightmapSequenceTextureFrames.at(slot) = -1;
+        }
+        glGenBuffers(HEIGHTMAP_SEQUENCE_PBO_COUNT, m_heightmapSequencePBOs.data());
+        m_heightmapSequenceNextPBO = 0;
+        m_heightmapSequenceSlot = -1;
+        m_heightmapSequenceNextSlot = -1;
+        m_heightmapSequenceUploadTimeInMilliseconds = 0.0f;
+
+        m_heightmapSequence = std::move(heightmapSequence);
+        std::cout << "heightmap sequence of " << m_heightmapSequence->getFrameCount() << " frames (" << m_heightmapSequence->getWidth() << " x " << m_heightmapSequence->getHeight() << " R" << 8 * m_heightmapSequence->getBytesPerTexel() << ") opened: " << pathPattern << std::endl;
+
+        return true;
+    }
+
     // Sets projection and viewport for new width and height
     void RenderEngine::setWindowSize(int width, int height) {
         m_windowWidth = width;
@@ -1382,27 +1898,7 @@ namespace wave_tool {
         m_camera->setAspect((float)m_windowWidth / m_windowHeight);
         glViewport(0, 0, m_windowWidth, m_windowHeight);
 
-        //TODO: figure out if there are any driver bugs that require regenerating the FBO or rebinding the textures/buffers to it
-        // reference: https://stackoverflow.com/questions/44763449/updating-width-and-height-of-render-target-on-the-fly
-        // reallocate textures / buffers that must match new window dimensions...
-        glBindRenderbuffer(GL_RENDERBUFFER, m_depth24Stencil8RBO);
-        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_windowWidth, m_windowHeight);
-        glBindRenderbuffer(GL_RENDERBUFFER, 0);
-
-        glBindTexture(GL_TEXTURE_2D, m_depthTexture2D);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, m_windowWidth, m_windowHeight, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-        glBindTexture(GL_TEXTURE_2D, 0);
-
-        glBindTexture(GL_TEXTURE_2D, m_localReflectionsTexture2D);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_windowWidth, m_windowHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-        glBindTexture(GL_TEXTURE_2D, 0);
-
-        glBindTexture(GL_TEXTURE_2D, m_localRefractionsTexture2D);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_windowWidth, m_windowHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-        glBindTexture(GL_TEXTURE_2D, 0);
-
-        glBindTexture(GL_TEXTURE_2D, m_worldSpaceDepthTexture2D);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_windowWidth, m_windowHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        // the render targets that match the window are re-declared at the new size next frame, so none of the pooled ones will be claimed again
+        m_frameGraph.releasePool();
     }
 }
@@ -43,134 +43,109 @@
 #include <vector>
 
 #include "camera.h"
+#include "frame-graph.h"
+#include "geometry.h"
+#include "gl-state-cache.h"
+#include "gerstner-atlas.h"
+#include "gerstner-wave.h"
+#include "grid-resolution-governor.h"
+#include "heightmap-sequence.h"
 #include "mesh-object.h"
+#include "ocean-fft.h"
+#include "projected-grid.h"
+#include "render-queue.h"
+#include "scene-batch.h"
+#include "scene-blocks.h"
+#include "shader-program.h"
 #include "shader-tools.h"
 #include "texture.h"
+#include "thread-pool.h"
+#include "water-clipmap.h"
+#include "water-grid.h"
 
 namespace wave_tool {
-    //TODO: refactor these out to their own files...
-
-    namespace geometry {
-        // can be treated either as a line segment between the two end-points or an infite line (extrapolated from segment)
-        struct Line {
-            glm::vec3 p0;
-            glm::vec3 p1;
-
-            Line(glm::vec3 const& p0, glm::vec3 const& p1)
-                : p0{p0}, p1{p1}
-            {
-                assert(p0 != p1); // assert that the bi-direction vector is non-zero
-            }
-
-            float getSegmentLength() const { return glm::distance(p0, p1); }
-        };
-    }
-    
-    namespace geometry {
-        // reference: https://sites.math.washington.edu/~king/coursedir/m445w04/notes/vector/equations.html
-        // infinite plane equation - contains all points <x, y, z> satisfying: ax + by + cz = d
-        // plane normal vector = <a, b, c>
-        // plane displacement scalar from world origin (along plane normal) = d
-        struct Plane {
-            float a;
-            float b;
-            float c;
-            float d;
-
-            Plane(float const a, float const b, float const c, float const d)
-                : a{a}, b{b}, c{c}, d{d}
-            {
-                assert(0.0f != a || 0.0f != b || 0.0f != c); // assert that plane normal is non-zero
-                //TODO: change this cause the comparison is unstable!
-                assert(1.0f == a * a + b * b + c * c); // assert that normal vector is a unit vector
-            }
-
-            // returns a symbolic known-point that can be thought of as the "center" of our infinite plane
-            glm::vec3 getCenterPoint() const { return d * getNormalVec(); }
-
-            // returns the unit normal vector of the plane
-            glm::vec3 getNormalVec() const { return glm::vec3{a, b, c}; }
-        };
-    }
-
-    namespace utils {
-        // reference: https://doxygen.reactos.org/de/d57/dll_2directx_2wine_2d3dx9__36_2math_8c.html#a63d0fdac0a1bf065069709fcdc97ad16
-        // reference: https://stackoverflow.com/questions/23975555/how-to-do-ray-plane-intersection
-        //NOTE: my plane definition has the d value negated vs these references, thus the math is slightly different
-        // explanation...
-        // first, treat the line like a ray = <x, y, z> = rayOrigin + t * rayDirection
-        // second, remember that my plane is defined as A * x + B * y + C * z = d, with the planeNormal being <A, B, C> of course
-        // third, the intersection point on the plane will be at <x, y, z> such that that point is the tip of the ray
-        // plugging the ray components into the plane equation, we get...
-        // ---> A * (origin.x + t * direction.x) + B * (origin.y + t * direction.y) + C * (origin.z + t * direction.z) = d
-        // ---> (A * origin.x + B * origin.y + C * origin.z) + t * (A * direction.x + B * direction.y + C * direction.z) = d
-        // ---> (planeNormal • rayOrigin) + t * (planeNormal • rayDirection) = d
-        // ---> t = (d - (planeNormal • rayOrigin)) / (planeNormal • rayDirection)
-        //NOTE: now since we are dealing with a bi-directional line instead of a uni-directional ray, we don't care about the sign of t. 
-        // ---> intersectionPoint = rayOrigin + t * rayDirection
-        inline bool linePlaneIntersection(glm::vec3 &out_intersectionPoint, geometry::Line const& line, geometry::Plane const& plane) {
-            glm::vec3 const planeNormal{plane.getNormalVec()}; // already normalized
-            glm::vec3 const& rayOrigin{line.p0};
-            glm::vec3 const rayDirection{glm::normalize(line.p1 - line.p0)};
-
-            float const denom{glm::dot(planeNormal, rayDirection)}; // in range [-1.0f, 1.0f]
-            // if our line and plane are parallel, we would either have 0 or infinite intersection points, so we just treat both cases as one (no intersection)
-            if (0.0f == denom) return false;
-
-            float const t{(plane.d - glm::dot(planeNormal, rayOrigin)) / denom};
-
-            out_intersectionPoint = rayOrigin + t * rayDirection;
-            return true;
-        }
-    }
-
-    namespace geometry {
-        // reference: https://developer.nvidia.com/gpugems/gpugems/part-i-natural-effects/chapter-1-effective-water-simulation-physical-models
-        //TODO: the statics are very unsafe at the moment
-        struct GerstnerWave {
-            public:
-                static unsigned int const MAX_COUNT = 4;
-                static_assert(MAX_COUNT > 0);
-
-                inline static unsigned int Count() { return count; }
-                inline static float TotalAmplitude() { return totalAmplitude; }
-
-                float amplitude_A; // height of crest above equilibrium plane
-                float frequency_w; // w = 2/L (roughly), where L =:= wavelength (crest-to-crest distance)
-                float phaseConstant_phi; // phi = S x w, where S =:= speed (distance crest moves forward per second)
-                float steepness_Q; // controls "sharpness" of crest
-                glm::vec2 xzDirection_D; // horizontal unit vector perpendicular to the wave front along which the crest travels 
-
-                GerstnerWave(float const amplitude_A, float const frequency_w, float const phaseConstant_phi, float const steepness_Q, glm::vec2 const& xzDirection_D)
-                    : amplitude_A(amplitude_A), frequency_w(frequency_w), phaseConstant_phi(phaseConstant_phi), steepness_Q(steepness_Q), xzDirection_D(xzDirection_D)
-                {
-                    assert(count < MAX_COUNT);
-                    assert(amplitude_A >= 0.0f);
-                    assert(frequency_w >= 0.0f);
-                    assert(phaseConstant_phi >= 0.0f);
-                    assert(0.0f <= steepness_Q && steepness_Q <= 1.0f);
-                    float const EPSILON{0.001f};
-                    float const xzDirection_D_length{glm::length(xzDirection_D)};
-                    assert(1.0f - EPSILON <= xzDirection_D_length && xzDirection_D_length <= 1.0f + EPSILON);
-
-                    ++count;
-                    totalAmplitude += amplitude_A;
-                }
-
-                ~GerstnerWave() {
-                    --count;
-                    totalAmplitude -= amplitude_A;
-                }
-            private:
-                inline static unsigned int count = 0;
-                inline static float totalAmplitude = 0.0f;
-        };
-    }
+    // the fixed binding point of each uniform block shared between programs
+    enum UniformBlockBinding {
+        GERSTNER_WAVES = 0,
+        FRAME = 1,
+        PASS = 2,
+        SKY_CUBEMAP = 3
+    };
+
+    // one vertex of the water surface as captured by transform feedback (the interleaved layout of the capture program's varyings)
+    struct WaterSurfaceVertex {
+        glm::vec3 position; // world-space
+        glm::vec3 normal; // world-space unit normal, not flipped towards the camera
+        glm::vec2 xyPositionNDCSpaceHeight0; // the (x, z) position at height 0 in the NDC-space of the camera the capture was made with
+    };
+    static_assert(sizeof(WaterSurfaceVertex) == 8 * sizeof(float), "WaterSurfaceVertex must match the tightly packed transform feedback layout");
+
+    // 1 layer of the sky cubemap (stars, skysphere or clouds), as far as its rendered look is concerned
+    struct SkyCubemapLayerKey {
+        MeshObject const* object{nullptr};
+        bool isVisible{false};
+        GLuint textureID{0};
+        PolygonMode polygonMode{PolygonMode::FILL};
+
+        bool operator==(SkyCubemapLayerKey const& other) const;
+    };
+
+    // every input that changes the rendered sky cubemap, it is only re-rendered when this changes (see RenderEngine::render())
+    //NOTE: the sun position and the fog tint both follow from timeOfDayInHours
+    struct SkyCubemapKey {
+        float timeOfDayInHours{0.0f};
+        float cloudProportion{0.0f};
+        float overcastStrength{0.0f};
+        float sunHorizonDarkness{0.0f};
+        float sunShininess{0.0f};
+        float sunStrength{0.0f};
+        glm::vec4 fogColourFarAtNoon{0.0f};
+        bool isFogLayerVisible{false};
+        std::array<SkyCubemapLayerKey, 3> layers{};
+
+        bool operator==(SkyCubemapKey const& other) const;
+        inline bool operator!=(SkyCubemapKey const& other) const { return !(*this == other); }
+    };
 
     enum RenderMode {
         DEFAULT = 0,
         LOCAL_REFLECTIONS = 1,
-        LOCAL_REFRACTIONS = 2
+        LOCAL_REFRACTIONS = 2,
+        WORLD_SPACE_DEPTH = 3
+    };
+
+    // what the frame graph's declarations depend on (see RenderEngine::buildFrameGraph())
+    struct FrameGraphInputs {
+        int windowWidth{1};
+        int windowHeight{1};
+        unsigned int localReflectionsDownscale{1}; // 1, 2 or 4 (already rounded)
+        unsigned int localRefractionsDownscale{1}; // 1, 2 or 4 (already rounded)
+        bool isWaterInView{false};
+        RenderMode renderMode{RenderMode::DEFAULT}; // the debug render mode shown (DEFAULT if none)
+        std::size_t skyCubemapSizeInBytes{0}; // only for the dump
+    };
+
+    // the frame graph's passes (in execution order) and resources, as declared by RenderEngine::buildFrameGraph()
+    struct FrameGraphHandles {
+        FrameGraph::Pass skyPass{FrameGraph::NONE};
+        FrameGraph::Pass localReflectionsPass{FrameGraph::NONE};
+        FrameGraph::Pass localRefractionsPass{FrameGraph::NONE};
+        FrameGraph::Pass worldSpaceDepthPass{FrameGraph::NONE};
+        FrameGraph::Pass depthPass{FrameGraph::NONE};
+        FrameGraph::Pass opaquePass{FrameGraph::NONE};
+        FrameGraph::Pass waterPass{FrameGraph::NONE};
+        FrameGraph::Pass debugPass{FrameGraph::NONE};
+        FrameGraph::Pass uiPass{FrameGraph::NONE};
+
+        FrameGraph::Resource skyCubemap{FrameGraph::NONE};
+        FrameGraph::Resource backbuffer{FrameGraph::NONE};
+        FrameGraph::Resource localReflectionsTexture{FrameGraph::NONE};
+        FrameGraph::Resource localReflectionsDepthTexture{FrameGraph::NONE};
+        FrameGraph::Resource localRefractionsTexture{FrameGraph::NONE};
+        FrameGraph::Resource localRefractionsDepthTexture{FrameGraph::NONE};
+        FrameGraph::Resource worldSpaceDepthTexture{FrameGraph::NONE};
+        FrameGraph::Resource worldSpaceDepthBufferTexture{FrameGraph::NONE};
+        FrameGraph::Resource depthTexture{FrameGraph::NONE};
     };
 
     class RenderEngine {
@@ -187,8 +162,9 @@ namespace wave_tool {
             GL_TEXTURE_CUBE_MAP_NEGATIVE_Z
             */
             inline static glm::vec3 const CUBEMAP_CAMERA_EYE_POSITION{0.0f, 0.0f, 0.0f};
-            //matches the skybox texture length
-            static GLsizei const CUBEMAP_LENGTH{2048};
+            //matches the skybox texture length (the sources have no more detail than this)
+            static GLsizei const CUBEMAP_MAX_LENGTH{2048};
+            static GLsizei const CUBEMAP_MIN_LENGTH{256};
             // FOV must be 90 degrees
             // aspect must be 1.0 for cube
             // near clip distance of 0.1 is standard
@@ -221,11 +197,31 @@ namespace wave_tool {
             glm::vec4 fogColourFarAtNoon{1.0f, 1.0f, 1.0f, 0.1f}; // RGB is the uniform tint (will darken when sun is lower in sky), A is the density (alpha at >= fogDepthRadiusFar)
             float fogDepthRadiusFar{1.0f}; // in range [fogDepthRadiusNear, 1.0]
             float fogDepthRadiusNear{0.0f}; // in range [0.0, fogDepthRadiusFar]
+            unsigned int localReflectionsDownscale{2}; // 1, 2 or 4, the local reflections are rendered at 1/N of the window width and height (then depth-aware upsampled by the water)
+            unsigned int localRefractionsDownscale{2}; // 1, 2 or 4, the local refractions are rendered at 1/N of the window width and height (then depth-aware upsampled by the water)
             float heightmapDisplacementScale{1.0f}; // in range [0.0, inf)
             float heightmapSampleScale{0.02f}; // in range [0.0, inf)
+            float heightmapSequenceFramesPerSecond{8.0f}; // in range (0.0, inf), playback rate of the streamed heightmap sequence (cross-faded in between frames)
             bool isAnimatingTimeOfDay = false;
             bool isAnimatingWaves = true;
+            bool isMatchingSkyCubemapToViewport{true}; // true picks the sky cubemap length from the viewport height and the camera FOV (see getSkyCubemapLengthForViewport()), false uses skyCubemapLength
+            bool isAmortisingSkyCubemap{true}; // true re-renders just 1 (round-robin) face of the sky cubemap per frame while isAnimatingTimeOfDay, instead of all 6 faces every frame
+            bool isBatchingSceneDraws{true}; // true draws each run of same-state objects from shared buffers with 1 multi-draw (see SceneBatch), false draws the (still sorted) objects 1 by 1 from their own VAOs
+            bool isRenderingSkyCubemapLayered{false}; // true draws each sky layer once into all 6 faces of the sky cubemap (a layered attachment, see sky-cubemap-layers.geom) whenever all of them are stale, false draws every layer once per face
+            //NOTE: off by default, since the geometry stage can cost more than the 5 extra draws per layer it saves (compare both with: wave-tool --gpu-benchmark sky-cubemap)
+            bool isUsingHeightmapSequence{true}; // true plays the streamed heightmap sequence (see loadHeightmapSequence()) instead of the static heightmap
+            bool isUsingGerstnerAtlas{false}; // true plays back the baked (looping) gerstner atlas instead of summing the waves per vertex (see bakeGerstnerAtlas())
+            bool isUsingOceanFFT{false}; // true replaces the static heightmap with the CPU FFT ocean (displacement + normal textures)
+            bool isUsingFiniteDifferenceWaterNormals{false}; // false uses the analytic gerstner/heightmap derivatives (cheaper), true uses the old 4-neighbour surface re-evaluation
+            bool isUsingWaterClipmap{false}; // true draws the water as nested camera-centred clipmap levels (see WaterClipmap) instead of the projected grid
+            bool isUsingWaterTessellation{false}; // true draws the projected grid as coarse patches (see WaterGrid::PATCH_GRID_LENGTH) subdivided on the GPU by their on-screen size, instead of a pre-built resolution level
+            bool isUsingWaterSurfaceCapture{false}; // true displaces the water grid once per frame into a transform feedback buffer, then draws it with a pass-through vertex shader (see requestWaterSurfaceReadback())
+            bool isUsingWaveLOD{true}; // true fades out (then skips) gerstner waves and heightmap detail that are too short for the local grid cell size (less ALU + less shimmer near the horizon)
+            bool isDumpingFrameGraph{false}; // true prints the next frame's compiled frame graph (and its memory use) to stdout, then resets itself
+            bool isValidatingGLState{false}; // true compares GLStateCache's shadowed state against glGet*() at the end of each frame (slow, for debugging)
             float overcastStrength = 0.0f; // in range [0.0, 1.0]
+            GLsizei skyCubemapLength{CUBEMAP_MAX_LENGTH}; // in range [CUBEMAP_MIN_LENGTH, CUBEMAP_MAX_LENGTH], rounded up to a power of 2, only used while !isMatchingSkyCubemapToViewport
+            float skyReflectionDistanceLOD{2.0f}; // in range [0.0, inf), the sky cubemap mip level the water's reflections are blurred to (at least) at zFar, on top of the usual screen-space LOD
             float softEdgesDeltaDepthThreshold{0.05f}; // in range [0.0, 1.0]
             float sunHorizonDarkness = 0.25f; // in range [0.0, 1.0]
             float sunShininess = 50.0f; // in range [0.0, inf)
@@ -234,10 +230,18 @@ namespace wave_tool {
             float tintDeltaDepthThreshold{0.1f}; // in range [0.0, 1.0]
             float waterClarity{0.3f}; // in range [0.0, 1.0]
             float waveAnimationTimeInSeconds = 0.0f; // in range [0.0, inf)
+            float waveLODMinSamplesPerWavelength{2.0f}; // in range (0.0, inf), detail is fully faded at this many grid cells per wavelength and unfaded at twice that
             float verticalBounceWaveAmplitude{0.1f}; // in range [0.0, inf)
+            float waterClipmapBaseCellSize{0.05f}; // in range (0.0, inf), the cell size of the finest clipmap level (each coarser level doubles it)
+            float waterTessellationMinAmplitudeInPixels{1.0f}; // in range (0.0, inf), patch edges whose wave amplitude projects to less than this many pixels stay coarse (flat, far away water)
+            float waterTessellationPixelsPerSegment{8.0f}; // in range (0.0, inf), the target on-screen length of each tessellated patch edge segment
             float verticalBounceWavePhase = 0.0f; // in range [0.0, 1.0]
 
-            std::array<std::shared_ptr<geometry::GerstnerWave>, geometry::GerstnerWave::MAX_COUNT> gerstnerWaves;
+            //NOTE: any number of waves up to getGerstnerWaveCapacity() is allowed (extras are ignored), changes are detected and uploaded at the start of the next render()
+            std::vector<geometry::GerstnerWave> gerstnerWaves;
+
+            GerstnerAtlasParameters gerstnerAtlasParameters;
+            OceanFFTParameters oceanFFTParameters;
 
             RenderMode renderMode{RenderMode::DEFAULT};
 
@@ -245,19 +249,114 @@ namespace wave_tool {
             ~RenderEngine();
 
             std::shared_ptr<Camera> getCamera() const;
-            inline GLuint getDepthProgram() const { return depthProgram; }
-            inline GLuint getMainProgram() const { return mainProgram; }
-            inline GLuint getScreenSpaceQuadProgram() const { return screenSpaceQuadProgram; }
-            inline GLuint getSkyboxCloudsProgram() const { return skyboxCloudsProgram; }
-            inline GLuint getSkyboxStarsProgram() const { return skyboxStarsProgram; }
-            inline GLuint getSkyboxTrivialProgram() const { return skyboxTrivialProgram; }
-            inline GLuint getSkysphereProgram() const { return skysphereProgram; }
-            inline GLuint getTrivialProgram() const { return trivialProgram; }
-            inline GLuint getWaterGridProgram() const { return waterGridProgram; }
-            inline GLuint getWorldSpaceDepthProgram() const { return worldSpaceDepthProgram; }
-
-            void render(std::shared_ptr<const MeshObject> skyboxStars, std::shared_ptr<const MeshObject> skysphere, std::shared_ptr<const MeshObject> skyboxClouds, std::shared_ptr<const MeshObject> waterGrid, std::vector<std::shared_ptr<MeshObject>> const& objects);
+            inline unsigned int getGerstnerWaveCapacity() const { return m_gerstnerWaveCapacity; }
+            // null until the first successful bake
+            inline GerstnerAtlas const* getGerstnerAtlas() const { return m_gerstnerAtlas.get(); }
+            // the last FFT ocean update time (0.0 if it isn't in use)
+            inline float getOceanFFTUpdateTimeInMilliseconds() const { return m_oceanFFTUpdateTimeInMilliseconds; }
+            // null until a sequence is loaded
+            inline HeightmapSequence const* getHeightmapSequence() const { return m_heightmapSequence.get(); }
+            // CPU (decoded frames) + GPU (resident frame textures + pixel-unpack buffers) memory used by the heightmap sequence
+            std::size_t getHeightmapSequenceMemoryInBytes() const;
+            // the time spent on the render thread by the last heightmap sequence frame upload (map + copy + the async texture transfer request)
+            inline float getHeightmapSequenceUploadTimeInMilliseconds() const { return m_heightmapSequenceUploadTimeInMilliseconds; }
+            inline std::shared_ptr<ThreadPool> getThreadPool() const { return m_threadPool; }
+            // GPU time of the last finished water surface capture pass (0.0 if it isn't in use) and of the last water draw (either mode)
+            //NOTE: these lag a frame or two behind, since the timer queries are only read once their results are available
+            inline float getWaterSurfaceCaptureGPUTimeInMilliseconds() const { return m_waterSurfaceCaptureGPUTimeInMilliseconds; }
+            inline float getWaterSurfaceDrawGPUTimeInMilliseconds() const { return m_waterSurfaceDrawGPUTimeInMilliseconds; }
+            // GPU time of the last local reflections + local refractions passes together (0.0 until they're first rendered), which scales with their downscale
+            inline float getLocalPassesGPUTimeInMilliseconds() const { return m_localPassesGPUTimeInMilliseconds; }
+            // the last completed readback (empty until the first one completes), in water-grid.vert gl_VertexID order (row-major, gridLength x gridLength)
+            inline std::vector<WaterSurfaceVertex> const& getWaterSurfaceReadback() const { return m_waterSurfaceReadback; }
+            inline bool isWaterSurfaceReadbackPending() const { return m_isWaterSurfaceReadbackRequested || nullptr != m_waterSurfaceReadbackFence; }
+            // the larger of the GPU and CPU time spent in the last measured render() (the vsync'd wall-clock frame time would hide any headroom)
+            inline float getFrameGPUTimeInMilliseconds() const { return m_frameGPUTimeInMilliseconds; }
+            inline float getFrameCPUTimeInMilliseconds() const { return m_frameCPUTimeInMilliseconds; }
+            // the vertices and triangles submitted by the last water draw (any mode), the clipmap's are after its tile culling
+            //NOTE: the tessellated triangle count comes from a GL_PRIMITIVES_GENERATED query, so it lags a frame or two behind (and its vertex count is just the patch corners)
+            inline unsigned int getWaterVertexCount() const { return m_waterVertexCount; }
+            inline unsigned int getWaterTriangleCount() const { return m_waterTriangleCount; }
+            // the sky cubemap faces re-rendered last frame (0 while none of the sky inputs changed, see SkyCubemapKey)
+            inline unsigned int getSkyCubemapFaceRenderCount() const { return m_skyCubemapFaceRenderCount; }
+            // the size of the local reflections/refractions render targets (the window size divided by their current downscale)
+            inline int getLocalReflectionsWidth() const { return glm::max(m_windowWidth / (int)m_localReflectionsAllocatedDownscale, 1); }
+            inline int getLocalReflectionsHeight() const { return glm::max(m_windowHeight / (int)m_localReflectionsAllocatedDownscale, 1); }
+            inline int getLocalRefractionsWidth() const { return glm::max(m_windowWidth / (int)m_localRefractionsAllocatedDownscale, 1); }
+            inline int getLocalRefractionsHeight() const { return glm::max(m_windowHeight / (int)m_localRefractionsAllocatedDownscale, 1); }
+            // the current sky cubemap face length, and its VRAM (RGBA8, all 6 faces with their mip chains)
+            inline GLsizei getSkyCubemapLength() const { return m_skyCubemapLength; }
+            std::size_t getSkyCubemapSizeInBytes() const;
+            // the smallest power of 2 face length with at least 1 texel per pixel at the centre of the viewport, in range [CUBEMAP_MIN_LENGTH, CUBEMAP_MAX_LENGTH]
+            //NOTE: a 90 degree face spans length / 2 texels per unit of tan(angle), the viewport spans (height / 2) / tan(fovY / 2)
+            static GLsizei getSkyCubemapLengthForViewport(int const viewportHeight, float const fovYInDegrees);
+            // GPU time of the last (partial or full) sky cubemap update, lags a frame or two behind like the other GPU timers
+            inline float getSkyCubemapGPUTimeInMilliseconds() const { return m_skyCubemapGPUTimeInMilliseconds; }
+            // marks every face of the sky cubemap stale, so the next render() re-renders all of them even though none of the sky inputs changed (see GPUBenchmark)
+            inline void invalidateSkyCubemap() { m_skyCubemapStaleFaces = ALL_SKY_CUBEMAP_FACES; }
+            // the scene passes (local reflections, local refractions, world-space depth, depth, main) rendered last frame, the others were culled by the frame graph since nothing consumed them
+            inline unsigned int getScenePassCount() const { return m_scenePassCount; }
+            // last frame's compiled frame graph (passes, transients and their memory use)
+            inline FrameGraph const& getFrameGraph() const { return m_frameGraph; }
+            // resets the frame graph and declares (then compiles) a frame's passes and render targets, this is plain CPU work (see --benchmark frame-graph)
+            static FrameGraphHandles buildFrameGraph(FrameGraph &frameGraph, FrameGraphInputs const& inputs);
+            // the uniform uploads issued vs. skipped (unchanged since the last set) last frame, see ShaderProgram
+            inline unsigned int getIssuedUniformCount() const { return m_issuedUniformCount; }
+            inline unsigned int getSkippedUniformCount() const { return m_skippedUniformCount; }
+            // the GL state changes issued vs. filtered (already set) last frame, see GLStateCache
+            inline unsigned int getIssuedGLStateCallCount() const { return m_issuedGLStateCallCount; }
+            inline unsigned int getFilteredGLStateCallCount() const { return m_filteredGLStateCallCount; }
+            // the shadowed GL state that didn't match the driver's at the end of last frame (only checked while isValidatingGLState)
+            inline unsigned int getGLStateMismatchCount() const { return m_glStateMismatchCount; }
+            // the bytes written to the scene uniform buffer (frame + pass blocks, with their offset alignment padding) and the object data buffer last frame, and the range binds into the former
+            inline std::size_t getSceneBlocksSizeInBytes() const { return m_sceneBlocksStaging.size() + m_objectDataStaging.size() * sizeof(ObjectData); }
+            inline unsigned int getSceneBlockBindCount() const { return m_sceneBlockBindCount; }
+            // the draw calls issued for the scene objects (all passes) last frame, and the object draws they covered
+            inline unsigned int getSceneDrawCallCount() const { return m_sceneDrawCallCount; }
+            inline unsigned int getSceneObjectDrawCount() const { return m_sceneObjectDrawCount; }
+            inline std::size_t getSceneBatchSizeInBytes() const { return m_sceneBatch.getSizeInBytes(); }
+            inline WaterClipmap const& getWaterClipmap() const { return m_waterClipmap; }
+            // the projected grid's fit can be switched through this (see ProjectedGrid::isUsingHullFit)
+            inline ProjectedGrid& getProjectedGrid() { return m_projectedGrid; }
+            // the share of the projected grid's vertices that landed on-screen last frame (0.0 while isUsingWaterClipmap)
+            //NOTE: measured on the base plane over a coarser WATER_GRID_VISIBILITY_SAMPLE_LENGTH grid (see ProjectedGrid::countVisibleGridVertices())
+            inline float getWaterGridVisibleVertexFraction() const { return m_waterGridVisibleVertexFraction; }
+            // GL_MAX_TESS_GEN_LEVEL, the most segments a patch edge can be split into
+            inline GLint getMaxWaterTessellationLevel() const { return m_maxWaterTessellationLevel; }
+            // picks the water grid's resolution level (see WaterGrid::GRID_LENGTHS) from the measured frame times, set isAdaptive to false to pick it manually
+            //NOTE: only the pre-built projected grid has levels, the governor is paused while isUsingWaterClipmap or isUsingWaterTessellation
+            inline GridResolutionGovernor& getWaterGridResolutionGovernor() { return m_waterGridResolutionGovernor; }
+            inline GLuint getDepthProgram() const { return depthProgram.getID(); }
+            inline GLuint getMainProgram() const { return mainProgram.getID(); }
+            inline GLuint getScreenSpaceQuadProgram() const { return screenSpaceQuadProgram.getID(); }
+            inline GLuint getScreenSpaceQuadLayeredProgram() const { return screenSpaceQuadLayeredProgram.getID(); }
+            inline GLuint getSkyboxCloudsProgram() const { return skyboxCloudsProgram.getID(); }
+            inline GLuint getSkyboxCloudsLayeredProgram() const { return skyboxCloudsLayeredProgram.getID(); }
+            inline GLuint getSkyboxStarsProgram() const { return skyboxStarsProgram.getID(); }
+            inline GLuint getSkyboxStarsLayeredProgram() const { return skyboxStarsLayeredProgram.getID(); }
+            inline GLuint getSkyboxTrivialProgram() const { return skyboxTrivialProgram.getID(); }
+            inline GLuint getSkysphereProgram() const { return skysphereProgram.getID(); }
+            inline GLuint getSkysphereLayeredProgram() const { return skysphereLayeredProgram.getID(); }
+            inline GLuint getTrivialProgram() const { return trivialProgram.getID(); }
+            inline GLuint getWaterGridCaptureProgram() const { return waterGridCaptureProgram.getID(); }
+            inline GLuint getWaterGridCapturedProgram() const { return waterGridCapturedProgram.getID(); }
+            inline GLuint getWaterGridProgram() const { return waterGridProgram.getID(); }
+            // 0 if tessellation shaders failed to compile (isUsingWaterTessellation then falls back to the pre-built grid)
+            inline GLuint getWaterGridTessellationProgram() const { return waterGridTessellationProgram.getID(); }
+            inline GLuint getWorldSpaceDepthProgram() const { return worldSpaceDepthProgram.getID(); }
+
+            // snapshots the current gerstnerWaves into a looping atlas (loaded from the disk cache when the same bake was done before), returns false on failure
+            //NOTE: this is synchronous (can take a few seconds for large bakes), and later changes to gerstnerWaves are NOT reflected until the next bake
+            bool bakeGerstnerAtlas();
+            // asks for a copy of the next water surface capture (only while isUsingWaterSurfaceCapture), see getWaterSurfaceReadback()
+            //NOTE: the copy is made on the GPU and fenced, and the fence is only polled (never waited on), so the result shows up a few frames later without stalling the pipeline
+            void requestWaterSurfaceReadback();
+            void render(std::shared_ptr<const MeshObject> skyboxStars, std::shared_ptr<const MeshObject> skysphere, std::shared_ptr<const MeshObject> skyboxClouds, std::shared_ptr<const WaterGrid> waterGrid, std::vector<std::shared_ptr<MeshObject>> const& objects);
             void assignBuffers(MeshObject &object);
+            // assigns the (vertex-less) vao and pre-builds the index buffer of every resolution level (and the clipmap and the tessellation patches)
+            void assignWaterGridBuffers(WaterGrid &waterGrid);
+            // (re-)builds every resolution level's index buffer in the given layout (see WaterGrid::IndexLayout)
+            void assignWaterGridLevelIndexBuffers(WaterGrid &waterGrid, WaterGrid::IndexLayout const indexLayout);
             void updateBuffers(MeshObject &object, bool const updateVerts, bool const updateUVs, bool const updateNormals, bool const updateColours);
 
             void setWindowSize(int width, int height);
@@ -265,32 +364,183 @@ namespace wave_tool {
             GLuint load1DTexture(std::string const& filePath);
             GLuint load2DTexture(std::string const& filePath);
             GLuint loadCubemap(std::vector<std::string> const& faces);
+            // replaces the current heightmap sequence (see HeightmapSequence::open() for the pattern), returns false on failure (keeping the current one)
+            bool loadHeightmapSequence(std::string const& pathPattern);
         private:
             std::shared_ptr<Camera> m_camera = nullptr;
 
-            GLuint depthProgram;
-            GLuint screenSpaceQuadProgram;
-            GLuint skyboxCloudsProgram;
-            GLuint skyboxStarsProgram;
-            GLuint skyboxTrivialProgram;
-            GLuint skysphereProgram;
-            GLuint trivialProgram;
-            GLuint mainProgram;
-            GLuint waterGridProgram;
-            GLuint worldSpaceDepthProgram;
-
-            GLuint m_depth24Stencil8RBO{0};
-            GLuint m_depthFBO{0};
-            GLuint m_depthTexture2D{0};
+            // current frame, next frame and 1 prefetched frame
+            inline static unsigned int const HEIGHTMAP_SEQUENCE_TEXTURE_COUNT{3};
+            // uploads alternate between these, so a new upload never has to wait for the driver to finish reading the previous one
+            inline static unsigned int const HEIGHTMAP_SEQUENCE_PBO_COUNT{2};
+
+            // the grid length used to estimate getWaterGridVisibleVertexFraction() (a few thousand vertices, instead of the actual grid's 100Ks)
+            inline static unsigned int const WATER_GRID_VISIBILITY_SAMPLE_LENGTH{65};
+
+            // indices into each frame's set of GPU timer queries (GL_TIME_ELAPSED timers, then GL_TIMESTAMP pairs, then other counters)
+            inline static unsigned int const WATER_SURFACE_CAPTURE_TIMER{0};
+            inline static unsigned int const WATER_SURFACE_DRAW_TIMER{1};
+            inline static unsigned int const SKY_CUBEMAP_TIMER{2};
+            inline static unsigned int const LOCAL_PASSES_TIMER{3};
+            inline static unsigned int const FRAME_START_TIMESTAMP{4};
+            inline static unsigned int const FRAME_END_TIMESTAMP{5};
+            inline static unsigned int const WATER_TESSELLATION_PRIMITIVES_GENERATED{6};
+            inline static unsigned int const GPU_TIMER_COUNT{7};
+
+            // indices into each frame's array of PassBlocks (see updateSceneBlocks())
+            inline static unsigned int const CUBEMAP_FACE_0_PASS{0}; // + face index, in the GL_TEXTURE_CUBE_MAP_POSITIVE_X + i order
+            inline static unsigned int const LOCAL_REFLECTIONS_PASS{6};
+            inline static unsigned int const LOCAL_REFRACTIONS_PASS{7};
+            inline static unsigned int const DEPTH_PASS{8};
+            inline static unsigned int const MAIN_PASS{9};
+            inline static unsigned int const SKY_CUBEMAP_LAYERED_PASS{10}; // the identity view-projection, the faces' own are applied by the geometry stage (see SkyCubemapBlockStd140)
+            inline static unsigned int const SCENE_PASS_COUNT{11};
+            inline static unsigned int const ALL_SKY_CUBEMAP_FACES{0x3F};
+            // each frame writes the next buffer of the ring (and orphans it), so it never has to wait on the GPU still reading a previous frame's blocks
+            inline static unsigned int const SCENE_UNIFORM_BUFFER_COUNT{3};
+
+            int findHeightmapSequenceTextureSlot(unsigned int const frameIndex) const;
+            // collects the results of the GPU timer queries from 2 frames ago, returns true if that frame's GPU time was available
+            bool updateGPUTimers();
+            void updateGerstnerWaveBlock();
+            void updateHeightmapSequence();
+            void updateOceanFFT();
+            void updateWaterSurfaceReadback();
+            bool uploadHeightmapSequenceFrame(unsigned int const textureSlot);
+            // the smallest power of 2 >= length, in range [CUBEMAP_MIN_LENGTH, CUBEMAP_MAX_LENGTH]
+            static GLsizei roundUpSkyCubemapLength(float const length);
+            // rounds to the nearest supported downscale (1, 2 or 4)
+            static unsigned int roundLocalPassDownscale(unsigned int const downscale);
+            // (re-)allocates the sky cubemap with a full mip chain (and re-attaches it to the layered FBO), every face is stale afterwards
+            void resizeSkyCubemap(GLsizei const length);
+            // draws the sky layers (stars, skysphere, clouds, fog) into the bound sky cubemap FBO, either into its attached face or (isLayered) into all 6 faces of its layered attachment
+            void renderSkyCubemapLayers(bool const isLayered, std::shared_ptr<const MeshObject> skyboxStars, std::shared_ptr<const MeshObject> skysphere, std::shared_ptr<const MeshObject> skyboxClouds, glm::vec4 const& fogColourFarAtCurrentTime);
+            // writes this frame's frame and pass blocks into the next scene uniform buffer (then binds its FrameBlock), and the objects' data into the next object data buffer
+            void updateSceneBlocks(FrameBlockStd140 const& frameBlock, std::array<PassBlockStd140, SCENE_PASS_COUNT> const& passBlocks, std::vector<std::shared_ptr<MeshObject>> const& objects);
+            // binds the PassBlock range of the current scene uniform buffer
+            void bindPassBlock(unsigned int const pass);
+            // sorts the visible objects into m_renderQueue (once per frame, every pass walks the same order)
+            void buildRenderQueue(std::vector<std::shared_ptr<MeshObject>> const& objects);
+            // draws the queued objects, isMainProgramOnly skips the rest (local reflections/refractions), a depthOnlyProgram draws the generic objects untextured with it instead of their own programs
+            void drawSceneObjects(std::vector<std::shared_ptr<MeshObject>> const& objects, bool const isMainProgramOnly, ShaderProgram const* depthOnlyProgram);
+            // orphans the buffer, then copies the data in through a write-only map (so the GPU never has to be waited on)
+            static void streamBufferData(GLenum const target, GLuint const buffer, void const* data, std::size_t const sizeInBytes, char const* bufferName);
+
+            ShaderProgram depthProgram;
+            ShaderProgram screenSpaceQuadProgram;
+            ShaderProgram skyboxCloudsProgram;
+            ShaderProgram skyboxStarsProgram;
+            ShaderProgram skyboxTrivialProgram;
+            ShaderProgram skysphereProgram;
+            // the same sky programs with a geometry stage that copies each triangle into all 6 cubemap faces
+            ShaderProgram screenSpaceQuadLayeredProgram;
+            ShaderProgram skyboxCloudsLayeredProgram;
+            ShaderProgram skyboxStarsLayeredProgram;
+            ShaderProgram skysphereLayeredProgram;
+            ShaderProgram trivialProgram;
+            ShaderProgram mainProgram;
+            ShaderProgram waterGridCaptureProgram;
+            ShaderProgram waterGridCapturedProgram;
+            ShaderProgram waterGridProgram;
+            ShaderProgram waterGridTessellationProgram;
+            ShaderProgram worldSpaceDepthProgram;
+            // the programs scene objects are drawn with, each with its "textureData" sampler (unresolved for an untextured program)
+            //NOTE: the sampler is the only uniform still set per run of objects, resolved once after linking (the rest of the per-object state is in the object data buffer)
+            struct SceneProgram {
+                ShaderProgram *program;
+                Uniform<GLint> textureData;
+            };
+            std::array<SceneProgram, 2> m_scenePrograms;
+
             GLuint m_emptyVAO{0};
-            GLuint m_localReflectionsFBO{0};
-            GLuint m_localReflectionsTexture2D{0};
-            GLuint m_localRefractionsFBO{0};
-            GLuint m_localRefractionsTexture2D{0};
-            GLuint m_worldSpaceDepthFBO{0};
-            GLuint m_worldSpaceDepthTexture2D{0};
+            FrameGraph m_frameGraph;
+            float m_frameCPUTimeInMilliseconds{0.0f};
+            float m_frameGPUTimeInMilliseconds{0.0f};
+            std::unique_ptr<GerstnerAtlas> m_gerstnerAtlas = nullptr; // only keeps the snapped waves around once uploaded
+            GLuint m_gerstnerAtlasDisplacementTexture2DArray{0};
+            GLuint m_gerstnerAtlasNormalTexture2DArray{0};
+            unsigned int m_gerstnerWaveCapacity{0}; // the array length of the GerstnerWaveBlock, as compiled into the shaders
+            std::vector<geometry::GerstnerWaveStd140> m_gerstnerWavesPacked; // scratch space, reused every frame
+            std::vector<geometry::GerstnerWaveStd140> m_gerstnerWavesUploaded; // what is currently in the UBO
+            GLuint m_gerstnerWaveUBO{0};
+            std::unique_ptr<HeightmapSequence> m_heightmapSequence = nullptr;
+            HeightmapFrame m_heightmapSequenceFrame; // scratch space, swapped with the decoder's queue on every pop
+            float m_heightmapSequenceFrameBlend{0.0f}; // in range [0.0, 1.0), from the current slot to the next slot
+            int m_heightmapSequenceNextSlot{-1}; // -1 when the frame isn't resident
+            unsigned int m_heightmapSequenceNextPBO{0};
+            std::array<GLuint, HEIGHTMAP_SEQUENCE_PBO_COUNT> m_heightmapSequencePBOs{};
+            int m_heightmapSequenceSlot{-1}; // -1 when the frame isn't resident (the static heightmap is shown instead)
+            std::array<int, HEIGHTMAP_SEQUENCE_TEXTURE_COUNT> m_heightmapSequenceTextureFrames{-1, -1, -1}; // the frame index held by each texture (-1 = none)
+            std::array<GLuint, HEIGHTMAP_SEQUENCE_TEXTURE_COUNT> m_heightmapSequenceTextures{};
+            float m_heightmapSequenceUploadTimeInMilliseconds{0.0f};
+            bool m_isGerstnerWaveUBOValid{false}; // false forces the next update to upload
+            GLint m_maxWaterTessellationLevel{0};
+            unsigned int m_localReflectionsAllocatedDownscale{1}; // what this frame's local reflections targets are declared at (see buildFrameGraph())
+            unsigned int m_localRefractionsAllocatedDownscale{1};
+            GLuint m_oceanDisplacementTexture2D{0};
+            std::unique_ptr<OceanFFT> m_oceanFFT = nullptr; // lazily created the first time it is enabled
+            float m_oceanFFTUpdateTimeInMilliseconds{0.0f};
+            GLuint m_oceanNormalTexture2D{0};
+            GLuint m_placeholderTexture2DArray{0};
+            ProjectedGrid m_projectedGrid;
+            unsigned int m_filteredGLStateCallCount{0};
+            unsigned int m_glStateMismatchCount{0};
+            unsigned int m_issuedGLStateCallCount{0};
+            unsigned int m_issuedUniformCount{0};
+            unsigned int m_sceneBlockBindCount{0};
+            std::vector<unsigned char> m_sceneBlocksStaging; // [frame block][pass blocks][object blocks], re-used every frame
+            std::array<GLuint, SCENE_UNIFORM_BUFFER_COUNT> m_sceneUBOs{};
+            unsigned int m_sceneUBOIndex{0}; // the buffer written (and bound) this frame
+            // the offsets of the blocks are rounded up to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT (commonly 256 bytes)
+            std::size_t m_frameBlockStride{0};
+            std::size_t m_passBlockStride{0};
+            std::vector<ObjectData> m_objectDataStaging; // re-used every frame
+            std::array<GLuint, SCENE_UNIFORM_BUFFER_COUNT> m_objectDataBuffers{}; // written in step with m_sceneUBOs
+            GLuint m_objectDataTexture{0}; // the texture buffer view of the current object data buffer (RGBA32F)
+            RenderQueue m_renderQueue;
+            SceneBatch m_sceneBatch;
+            // the offsets + counts of 1 run's multi-draw, re-used for every run
+            std::vector<void const*> m_sceneMultiDrawIndexOffsets;
+            std::vector<GLsizei> m_sceneMultiDrawIndexCounts;
+            unsigned int m_sceneDrawCallCount{0};
+            unsigned int m_sceneObjectDrawCount{0};
+            unsigned int m_scenePassCount{0};
+            unsigned int m_skippedUniformCount{0};
+            WaterClipmap m_waterClipmap;
+            std::vector<GLint> m_waterGridBandBaseVertices; // per band (re-used every frame)
+            std::vector<void const*> m_waterGridBandFirstIndexOffsets; // per band, all 0 (re-used every frame)
+            std::vector<GLsizei> m_waterGridBandIndexCounts; // per band (re-used every frame)
+            unsigned int m_waterTessellatedTriangleCount{0}; // the last available GL_PRIMITIVES_GENERATED result
+            unsigned int m_waterTriangleCount{0};
+            unsigned int m_waterVertexCount{0};
+            GLuint m_waterSurfaceCaptureBuffer{0}; // gridLength x gridLength WaterSurfaceVertex
+            float m_waterSurfaceCaptureGPUTimeInMilliseconds{0.0f};
+            GLuint m_waterSurfaceCaptureVAO{0}; // reads the capture buffer as vertex attributes, with the water grid's index buffer
+            float m_waterSurfaceDrawGPUTimeInMilliseconds{0.0f};
+            float m_localPassesGPUTimeInMilliseconds{0.0f};
+            std::vector<WaterSurfaceVertex> m_waterSurfaceReadback;
+            GLuint m_waterSurfaceReadbackBuffer{0};
+            GLsync m_waterSurfaceReadbackFence{nullptr}; // non-null while a copy is in flight
+            bool m_isWaterSurfaceReadbackRequested{false};
+            GLuint m_waterSurfaceCaptureGridLength{0}; // the grid length the capture/readback buffers are currently allocated for
+            float m_waterGridVisibleVertexFraction{0.0f};
+            GridResolutionGovernor m_waterGridResolutionGovernor{WaterGrid::getLevelCount(), WaterGrid::DEFAULT_LEVEL};
+            // double-buffered queries per frame (see GPU_TIMER_COUNT), so the results from 2 frames ago are read while this frame's are recorded
+            std::array<std::array<GLuint, GPU_TIMER_COUNT>, 2> m_gpuTimerQueries{};
+            std::array<std::array<bool, GPU_TIMER_COUNT>, 2> m_isGPUTimerQueryIssued{};
+            unsigned int m_gpuTimerFrame{0};
             GLuint m_skyboxCubemap{0};
             GLuint m_skyboxFBO{0};
+            GLuint m_skyboxLayeredFBO{0}; // the whole cubemap attached as 1 layered colour attachment
+            GLuint m_skyCubemapUBO{0}; // SkyCubemapBlockStd140, static
+            float m_skyCubemapGPUTimeInMilliseconds{0.0f};
+            unsigned int m_skyCubemapFaceRenderCount{0};
+            GLsizei m_skyCubemapLength{0}; // 0 until allocated
+            SkyCubemapKey m_skyCubemapKey; // what the cubemap faces were (or are being) rendered with
+            unsigned int m_skyCubemapNextFace{0}; // where the round-robin search for a stale face starts
+            unsigned int m_skyCubemapStaleFaces{ALL_SKY_CUBEMAP_FACES}; // 1 bit per face (in the GL_TEXTURE_CUBE_MAP_POSITIVE_X + i order), set while it doesn't match m_skyCubemapKey
+            bool m_isSkyCubemapComplete{false}; // false until every face has been rendered once (amortising is only allowed after that)
+            std::shared_ptr<ThreadPool> m_threadPool = nullptr;
             int m_windowHeight{0};
             int m_windowWidth{0};
     };
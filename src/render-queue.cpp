@@ -0,0 +1,74 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include "render-queue.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace wave_tool {
+    std::uint64_t RenderQueue::makeSortKey(DrawState const& state, float const depth) {
+        // a non-negative float's bits sort the same as its value, so the top 27 of them are a (coarser) depth
+        std::uint32_t depthBits{0};
+        float const clampedDepth{std::max(depth, 0.0f)};
+        std::memcpy(&depthBits, &clampedDepth, sizeof(float));
+
+        std::uint64_t key{state.program & 0xFFu};
+        key = (key << 12) | (state.texture & 0xFFFu);
+        key = (key << 12) | (state.vao & 0xFFFu);
+        key = (key << 2) | ((state.polygonMode - GL_POINT) & 0x3u);
+        key = (key << 3) | (state.primitiveMode & 0x7u);
+        key = (key << 27) | (depthBits >> 5);
+        return key;
+    }
+
+    bool RenderQueue::isSameRun(DrawState const& a, DrawState const& b, bool const isIgnoringVAO) {
+        return a.program == b.program && a.texture == b.texture && (isIgnoringVAO || a.vao == b.vao) && a.polygonMode == b.polygonMode && a.primitiveMode == b.primitiveMode;
+    }
+
+    void RenderQueue::clear() {
+        m_items.clear();
+    }
+
+    void RenderQueue::push(std::uint32_t const objectIndex, DrawState const& state, float const depth) {
+        m_items.push_back(Item{makeSortKey(state, depth), objectIndex, state});
+    }
+
+    void RenderQueue::sort() {
+        //NOTE: ties keep the render list order, so the result doesn't flicker between frames
+        std::stable_sort(m_items.begin(), m_items.end(), [](Item const& a, Item const& b) { return a.sortKey < b.sortKey; });
+    }
+
+    std::vector<RenderQueue::Item> const& RenderQueue::getItems() const {
+        return m_items;
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef WAVE_TOOL_RENDER_QUEUE_H_
+#define WAVE_TOOL_RENDER_QUEUE_H_
+
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace wave_tool {
+    // the state a draw needs bound, as far as the order of the draws goes
+    struct DrawState {
+        GLuint program;
+        GLuint texture; // 0 = untextured
+        GLuint vao;
+        GLenum polygonMode;
+        GLenum primitiveMode;
+    };
+
+    // the scene's draws, sorted by a key so that the draws sharing state end up next to each other
+    // that way the re-binds between them are filtered (see GLStateCache), and a run of draws with the same state can be submitted as 1 multi-draw (see SceneBatch)
+    // key (most to least significant bits): program (8) | texture (12) | VAO (12) | polygon mode (2) | primitive mode (3) | depth (27)
+    //NOTE: the GL names are truncated to their key fields, so a huge name can sort out of place, which only costs state changes (every draw still binds its full state)
+    //NOTE: this is plain CPU work (no GL calls), so it is benchmarked headless (see --benchmark render-queue)
+    class RenderQueue {
+        public:
+            struct Item {
+                std::uint64_t sortKey;
+                std::uint32_t objectIndex; // into the render list
+                DrawState state;
+            };
+
+            // depth is the (non-negative) distance from the camera, so the draws with the same state go front-to-back (early depth rejection)
+            static std::uint64_t makeSortKey(DrawState const& state, float const depth);
+            // true if b can be appended to a run (1 multi-draw) started by a, isIgnoringVAO for draws from shared buffers
+            static bool isSameRun(DrawState const& a, DrawState const& b, bool const isIgnoringVAO);
+
+            void clear();
+            void push(std::uint32_t const objectIndex, DrawState const& state, float const depth);
+            void sort();
+            std::vector<Item> const& getItems() const;
+        private:
+            std::vector<Item> m_items;
+    };
+}
+
+#endif // WAVE_TOOL_RENDER_QUEUE_H_
@@ -0,0 +1,147 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include "scene-batch.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "gl-state-cache.h"
+
+namespace wave_tool {
+    SceneBatch::~SceneBatch() {
+        glDeleteBuffers((GLsizei)m_buffers.size(), m_buffers.data());
+        GLStateCache::deleteVertexArrays(1, &m_vao);
+    }
+
+    bool SceneBatch::update(std::vector<std::shared_ptr<MeshObject>> const& objects) {
+        if (!isStale(objects)) return false;
+
+        m_meshRanges.clear();
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> normals;
+        std::vector<glm::vec2> uvs;
+        std::vector<glm::vec3> colours;
+        std::vector<GLuint> objectIndices;
+        std::vector<GLuint> indices;
+        for (std::size_t objectIndex = 0; objectIndex < objects.size(); ++objectIndex) {
+            MeshObject const& object{*objects.at(objectIndex)};
+            std::size_t const vertexCount{object.drawVerts.size()};
+            GLuint const baseVertex{(GLuint)positions.size()};
+            m_meshRanges.push_back(MeshRange{&object, vertexCount, (GLsizei)indices.size(), (GLsizei)object.drawFaces.size()});
+
+            positions.insert(positions.end(), object.drawVerts.begin(), object.drawVerts.end());
+            // zero-fill (or cut off) the attributes that don't match the vertex count, so every attribute stays aligned with the positions
+            normals.insert(normals.end(), object.normals.begin(), object.normals.begin() + std::min(object.normals.size(), vertexCount));
+            normals.resize(positions.size(), glm::vec3{0.0f});
+            uvs.insert(uvs.end(), object.uvs.begin(), object.uvs.begin() + std::min(object.uvs.size(), vertexCount));
+            uvs.resize(positions.size(), glm::vec2{0.0f});
+            colours.insert(colours.end(), object.colours.begin(), object.colours.begin() + std::min(object.colours.size(), vertexCount));
+            colours.resize(positions.size(), glm::vec3{0.0f});
+            objectIndices.resize(positions.size(), (GLuint)objectIndex);
+            // the indices are rebased onto the shared vertex buffer up front, so the draws need no base vertex (and neighbouring meshes can merge into 1 draw)
+            for (GLuint const index : object.drawFaces) indices.push_back(baseVertex + index);
+        }
+
+        if (0 == m_vao) {
+            glGenVertexArrays(1, &m_vao);
+            glGenBuffers((GLsizei)m_buffers.size(), m_buffers.data());
+        }
+        GLStateCache::bindVertexArray(m_vao);
+
+        // locations 0-3 match assignBuffers(), location 4 is the object index (an integer attribute, so glVertexAttribIPointer)
+        glBindBuffer(GL_ARRAY_BUFFER, m_buffers.at(0));
+        glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * positions.size(), positions.data(), GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+        glEnableVertexAttribArray(0);
+
+        glBindBuffer(GL_ARRAY_BUFFER, m_buffers.at(1));
+        glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * normals.size(), normals.data(), GL_STATIC_DRAW);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+        glEnableVertexAttribArray(1);
+
+        glBindBuffer(GL_ARRAY_BUFFER, m_buffers.at(2));
+        glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec2) * uvs.size(), uvs.data(), GL_STATIC_DRAW);
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 0, (void*)0);
+        glEnableVertexAttribArray(2);
+
+        glBindBuffer(GL_ARRAY_BUFFER, m_buffers.at(3));
+        glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * colours.size(), colours.data(), GL_STATIC_DRAW);
+        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+        glEnableVertexAttribArray(3);
+
+        glBindBuffer(GL_ARRAY_BUFFER, m_buffers.at(4));
+        glBufferData(GL_ARRAY_BUFFER, sizeof(GLuint) * objectIndices.size(), objectIndices.data(), GL_STATIC_DRAW);
+        glVertexAttribIPointer(OBJECT_INDEX_ATTRIBUTE, 1, GL_UNSIGNED_INT, 0, (void*)0);
+        glEnableVertexAttribArray(OBJECT_INDEX_ATTRIBUTE);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_buffers.at(5));
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * indices.size(), indices.data(), GL_STATIC_DRAW);
+
+        GLStateCache::bindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        m_sizeInBytes = positions.size() * (3 * sizeof(glm::vec3) + sizeof(glm::vec2) + sizeof(GLuint)) + indices.size() * sizeof(GLuint);
+        m_isStale = false;
+        return true;
+    }
+
+    void SceneBatch::invalidate() {
+        m_isStale = true;
+    }
+
+    GLuint SceneBatch::getVAO() const {
+        return m_vao;
+    }
+
+    void const* SceneBatch::getIndexOffset(std::size_t const objectIndex) const {
+        return (void const*)((std::uintptr_t)m_meshRanges.at(objectIndex).firstIndex * sizeof(GLuint));
+    }
+
+    GLsizei SceneBatch::getIndexCount(std::size_t const objectIndex) const {
+        return m_meshRanges.at(objectIndex).indexCount;
+    }
+
+    std::size_t SceneBatch::getSizeInBytes() const {
+        return m_sizeInBytes;
+    }
+
+    bool SceneBatch::isStale(std::vector<std::shared_ptr<MeshObject>> const& objects) const {
+        if (m_isStale || objects.size() != m_meshRanges.size()) return true;
+        for (std::size_t objectIndex = 0; objectIndex < objects.size(); ++objectIndex) {
+            MeshRange const& meshRange{m_meshRanges.at(objectIndex)};
+            MeshObject const& object{*objects.at(objectIndex)};
+            if (meshRange.object != &object || meshRange.vertexCount != object.drawVerts.size() || (std::size_t)meshRange.indexCount != object.drawFaces.size()) return true;
+        }
+        return false;
+    }
+}
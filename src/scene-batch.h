@@ -0,0 +1,91 @@
+#ifndef WAVE_TOOL_SCENE_BATCH_H_
+#define WAVE_TOOL_SCENE_BATCH_H_
+
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "mesh-object.h"
+
+namespace wave_tool {
+    // the render list's meshes packed into shared vertex + index buffers (behind 1 VAO), so a run of draws with the same state can be submitted as 1 multi-draw (see RenderQueue)
+    // every vertex carries its object's index, which is how the per-object constants are found without a draw ID (see object-data.glsl)
+    //NOTE: GL 4.1 has neither multi-draw indirect nor gl_DrawID (GL 4.3 / 4.6), so the runs are drawn with glMultiDrawElements from the CPU-side offsets instead
+    //NOTE: the attributes a mesh doesn't have are zero-filled, which is what its own VAO reads for a disabled attribute anyway (so both draw paths shade the same)
+    class SceneBatch {
+        public:
+            // the attribute location of the object index (after the position, normal, uv and colour of assignBuffers())
+            inline static GLuint const OBJECT_INDEX_ATTRIBUTE{4};
+
+            SceneBatch() = default;
+            ~SceneBatch();
+            SceneBatch(SceneBatch const&) = delete;
+            SceneBatch& operator=(SceneBatch const&) = delete;
+
+            // re-packs the buffers if the render list (or the size of any of its meshes) changed since the last call, or after invalidate()
+            // returns true if it did
+            bool update(std::vector<std::shared_ptr<MeshObject>> const& objects);
+            // forces a re-pack on the next update(), e.g. after a mesh's data changed in place
+            void invalidate();
+
+            GLuint getVAO() const;
+            // the byte offset into the shared index buffer of an object's mesh (as glMultiDrawElements wants it), and its index count
+            void const* getIndexOffset(std::size_t const objectIndex) const;
+            GLsizei getIndexCount(std::size_t const objectIndex) const;
+            std::size_t getSizeInBytes() const;
+        private:
+            // what the buffers were packed from
+            struct MeshRange {
+                MeshObject const* object;
+                std::size_t vertexCount;
+                GLsizei firstIndex;
+                GLsizei indexCount;
+            };
+
+            std::vector<MeshRange> m_meshRanges;
+            bool m_isStale{true};
+            GLuint m_vao{0};
+            // position, normal, uv, colour, object index, index
+            std::array<GLuint, 6> m_buffers{};
+            std::size_t m_sizeInBytes{0};
+
+            bool isStale(std::vector<std::shared_ptr<MeshObject>> const& objects) const;
+    };
+}
+
+#endif // WAVE_TOOL_SCENE_BATCH_H_
@@ -0,0 +1,89 @@
+#ifndef WAVE_TOOL_SCENE_BLOCKS_H_
+#define WAVE_TOOL_SCENE_BLOCKS_H_
+
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+
+namespace wave_tool {
+    // the C++ mirrors of the FrameBlock / PassBlock uniform blocks declared in assets/shaders/scene-blocks.glsl (which is the single GLSL definition that every shader includes)
+    //NOTE: std140 rules: matrices are 4 x vec4 columns, a vec3 takes 16 bytes unless a scalar follows it, a bool is 4 bytes, and every member sits at a multiple of its alignment
+    //NOTE: glm::vec3 is 12 bytes (alignment 4), so a vec3 + float pair packs the same as in std140
+    struct FrameBlockStd140 {
+        glm::mat4 view;
+        glm::mat4 projection;
+        glm::mat4 viewProjection;
+        glm::mat4 viewMatOnlyYaw;
+        glm::vec4 fogColourFarAtCurrentTime;
+        glm::vec3 cameraPosition;
+        float fogDepthRadiusFar;
+        glm::vec3 lightVec;
+        float fogDepthRadiusNear;
+        glm::vec3 sunPosition;
+        float sunShininess;
+        glm::vec2 viewportWidthHeight;
+        float sunStrength;
+        float waveAnimationTimeInSeconds;
+        float verticalBounceWaveDisplacement;
+        float zNear;
+        float zFar;
+        float padding;
+    };
+    static_assert(sizeof(FrameBlockStd140) == 352);
+
+    struct PassBlockStd140 {
+        glm::mat4 passModelMat;
+        glm::mat4 VPNoTranslation;
+        glm::vec4 clipPlane0;
+        std::uint32_t forceFlipNormals;
+        std::uint32_t padding[3];
+    };
+    static_assert(sizeof(PassBlockStd140) == 160);
+
+    // the C++ mirror of the SkyCubemapBlock uniform block declared in assets/shaders/sky-cubemap-layers.geom (the only program that uses it)
+    struct SkyCubemapBlockStd140 {
+        glm::mat4 faceVPs[6];
+    };
+    static_assert(sizeof(SkyCubemapBlockStd140) == 6 * sizeof(glm::mat4));
+
+    // the per-object constants, 5 RGBA32F texels of the object data texture buffer (see assets/shaders/object-data.glsl)
+    struct ObjectData {
+        glm::mat4 modelMat;
+        glm::vec4 flags; // <hasNormals, isTextured, 0, 0> as 0.0 or 1.0
+    };
+    static_assert(sizeof(ObjectData) == 5 * sizeof(glm::vec4));
+}
+
+#endif // WAVE_TOOL_SCENE_BLOCKS_H_
@@ -0,0 +1,157 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include "shader-program.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace wave_tool {
+    ShaderProgram::ShaderProgram(GLuint const id) : m_id{id} {
+        if (0 == m_id) return;
+
+        // reflect every active uniform in the default block (the ones in blocks are set through their buffers instead)
+        GLint activeUniformCount{0};
+        GLint maxNameLength{0};
+        glGetProgramiv(m_id, GL_ACTIVE_UNIFORMS, &activeUniformCount);
+        glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+        std::vector<GLchar> nameBuffer(std::max(maxNameLength, 1));
+        for (GLuint index = 0; index < (GLuint)activeUniformCount; ++index) {
+            GLint blockIndex{-1};
+            glGetActiveUniformsiv(m_id, 1, &index, GL_UNIFORM_BLOCK_INDEX, &blockIndex);
+            if (-1 != blockIndex) continue;
+
+            GLsizei nameLength{0};
+            GLint arraySize{0};
+            ReflectedUniform reflectedUniform;
+            glGetActiveUniform(m_id, index, nameBuffer.size(), &nameLength, &arraySize, &reflectedUniform.type, nameBuffer.data());
+            reflectedUniform.name.assign(nameBuffer.data(), nameLength);
+            //NOTE: this is the only time the driver is asked for a location
+            reflectedUniform.location = glGetUniformLocation(m_id, reflectedUniform.name.c_str());
+            // arrays are reported as their first element
+            if (reflectedUniform.name.size() > 3 && 0 == reflectedUniform.name.compare(reflectedUniform.name.size() - 3, 3, "[0]")) reflectedUniform.name.resize(reflectedUniform.name.size() - 3);
+            m_uniforms.push_back(reflectedUniform);
+        }
+        std::sort(m_uniforms.begin(), m_uniforms.end(), [](ReflectedUniform const& a, ReflectedUniform const& b) { return a.name < b.name; });
+
+        GLint activeUniformBlockCount{0};
+        GLint maxBlockNameLength{0};
+        glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_BLOCKS, &activeUniformBlockCount);
+        glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxBlockNameLength);
+        nameBuffer.resize(std::max(maxBlockNameLength, 1));
+        for (GLuint index = 0; index < (GLuint)activeUniformBlockCount; ++index) {
+            GLsizei nameLength{0};
+            glGetActiveUniformBlockName(m_id, index, nameBuffer.size(), &nameLength, nameBuffer.data());
+            m_uniformBlocks.emplace_back(std::string{nameBuffer.data(), (std::size_t)nameLength}, index);
+        }
+    }
+
+    GLuint ShaderProgram::getUniformBlockIndex(char const* name) const {
+        for (std::pair<std::string, GLuint> const& uniformBlock : m_uniformBlocks) {
+            if (uniformBlock.first == name) return uniformBlock.second;
+        }
+        return GL_INVALID_INDEX;
+    }
+
+    void ShaderProgram::resetUniformCounts() {
+        s_issuedUniformCount = 0;
+        s_skippedUniformCount = 0;
+    }
+
+    int ShaderProgram::findUniform(char const* name, bool (*isCompatible)(GLenum const)) const {
+        std::vector<ReflectedUniform>::const_iterator const it{std::lower_bound(m_uniforms.begin(), m_uniforms.end(), name, [](ReflectedUniform const& reflectedUniform, char const* name) { return std::strcmp(reflectedUniform.name.c_str(), name) < 0; })};
+        if (m_uniforms.end() == it || it->name != name) return -1;
+        if (!isCompatible(it->type)) {
+            std::cout << "ERROR: shader-program.cpp - uniform " << name << " (GL type 0x" << std::hex << it->type << std::dec << ") set with a mismatched type!" << std::endl;
+            return -1;
+        }
+        return it - m_uniforms.begin();
+    }
+
+    bool ShaderProgram::updateValue(ReflectedUniform &reflectedUniform, void const* value, std::size_t const size) {
+        if (reflectedUniform.hasValue && 0 == std::memcmp(reflectedUniform.value.data(), value, size)) return false;
+        std::memcpy(reflectedUniform.value.data(), value, size);
+        reflectedUniform.hasValue = true;
+        return true;
+    }
+
+    template <> bool ShaderProgram::isCompatibleType<GLint>(GLenum const type) {
+        switch (type) {
+            case GL_INT:
+            case GL_BOOL:
+            case GL_SAMPLER_1D:
+            case GL_SAMPLER_2D:
+            case GL_SAMPLER_2D_ARRAY:
+            case GL_SAMPLER_3D:
+            case GL_SAMPLER_CUBE:
+                return true;
+            default:
+                return false;
+        }
+    }
+    template <> bool ShaderProgram::isCompatibleType<GLuint>(GLenum const type) { return GL_UNSIGNED_INT == type; }
+    template <> bool ShaderProgram::isCompatibleType<float>(GLenum const type) { return GL_FLOAT == type; }
+    template <> bool ShaderProgram::isCompatibleType<glm::vec2>(GLenum const type) { return GL_FLOAT_VEC2 == type; }
+    template <> bool ShaderProgram::isCompatibleType<glm::vec3>(GLenum const type) { return GL_FLOAT_VEC3 == type; }
+    template <> bool ShaderProgram::isCompatibleType<glm::vec4>(GLenum const type) { return GL_FLOAT_VEC4 == type; }
+    template <> bool ShaderProgram::isCompatibleType<glm::mat4>(GLenum const type) { return GL_FLOAT_MAT4 == type; }
+
+    void ShaderProgram::upload(GLint const location, GLint const value) const {
+        glProgramUniform1i(m_id, location, value);
+    }
+
+    void ShaderProgram::upload(GLint const location, GLuint const value) const {
+        glProgramUniform1ui(m_id, location, value);
+    }
+
+    void ShaderProgram::upload(GLint const location, float const value) const {
+        glProgramUniform1f(m_id, location, value);
+    }
+
+    void ShaderProgram::upload(GLint const location, glm::vec2 const& value) const {
+        glProgramUniform2fv(m_id, location, 1, glm::value_ptr(value));
+    }
+
+    void ShaderProgram::upload(GLint const location, glm::vec3 const& value) const {
+        glProgramUniform3fv(m_id, location, 1, glm::value_ptr(value));
+    }
+
+    void ShaderProgram::upload(GLint const location, glm::vec4 const& value) const {
+        glProgramUniform4fv(m_id, location, 1, glm::value_ptr(value));
+    }
+
+    void ShaderProgram::upload(GLint const location, glm::mat4 const& value) const {
+        glProgramUniformMatrix4fv(m_id, location, 1, GL_FALSE, glm::value_ptr(value));
+    }
+}
@@ -0,0 +1,132 @@
+#ifndef WAVE_TOOL_SHADER_PROGRAM_H_
+#define WAVE_TOOL_SHADER_PROGRAM_H_
+
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace wave_tool {
+    // a pre-resolved handle to 1 of a ShaderProgram's active uniforms, typed by the value it takes (see ShaderProgram::getUniform())
+    //NOTE: a default (or unresolved) handle is valid to set, it just does nothing (like GL's location -1)
+    template <typename T>
+    struct Uniform {
+        using Value = T;
+        int slot{-1};
+
+        bool isResolved() const { return slot >= 0; }
+    };
+
+    // wraps a linked program, with every active uniform (and uniform block) reflected once up front, so setting a uniform never asks the driver for its location
+    // every value set is remembered, and a set with the same value as last time is skipped (uploads go through glProgramUniform*, so the program doesn't need to be bound)
+    //NOTE: this doesn't own the program (the RenderEngine deletes its programs), and the remembered values assume every upload to it goes through here
+    class ShaderProgram {
+        public:
+            ShaderProgram() = default;
+            explicit ShaderProgram(GLuint const id);
+
+            GLuint getID() const { return m_id; }
+            bool isValid() const { return 0 != m_id; }
+
+            // looks the uniform up by name (array uniforms without the [0]), an unresolved handle if it isn't active (e.g. optimized out)
+            //NOTE: T must match the GLSL type (GLint also takes bool and sampler uniforms, like glUniform1i), otherwise an error is printed and the handle is unresolved
+            template <typename T>
+            Uniform<T> getUniform(char const* name) const { return Uniform<T>{findUniform(name, isCompatibleType<T>)}; }
+            //NOTE: the value's type comes from the handle (not deduced), so e.g. a bool converts for a Uniform<GLint>
+            template <typename T>
+            void set(Uniform<T> const uniform, typename Uniform<T>::Value const& value) {
+                if (uniform.slot < 0 || uniform.slot >= (int)m_uniforms.size()) return;
+                ReflectedUniform &reflectedUniform{m_uniforms[uniform.slot]};
+                if (!updateValue(reflectedUniform, &value, sizeof(T))) {
+                    ++s_skippedUniformCount;
+                    return;
+                }
+                ++s_issuedUniformCount;
+                upload(reflectedUniform.location, value);
+            }
+            // for uniforms set about once per frame (the name is looked up in the reflected uniforms, not by the driver)
+            template <typename T>
+            void set(char const* name, T const& value) { set(getUniform<T>(name), value); }
+            // GL_INVALID_INDEX if the block isn't active
+            GLuint getUniformBlockIndex(char const* name) const;
+            unsigned int getActiveUniformCount() const { return m_uniforms.size(); }
+
+            // the uploads issued/skipped by every program since the last reset (the RenderEngine resets them once per frame)
+            static unsigned int getIssuedUniformCount() { return s_issuedUniformCount; }
+            static unsigned int getSkippedUniformCount() { return s_skippedUniformCount; }
+            static void resetUniformCounts();
+        private:
+            struct ReflectedUniform {
+                std::string name;
+                GLint location{-1};
+                GLenum type{GL_NONE};
+                std::array<unsigned char, sizeof(glm::mat4)> value{}; // the last value set (largest supported type)
+                bool hasValue{false};
+            };
+
+            inline static unsigned int s_issuedUniformCount{0};
+            inline static unsigned int s_skippedUniformCount{0};
+
+            GLuint m_id{0};
+            std::vector<ReflectedUniform> m_uniforms; // sorted by name
+            std::vector<std::pair<std::string, GLuint>> m_uniformBlocks;
+
+            int findUniform(char const* name, bool (*isCompatible)(GLenum const)) const;
+            // remembers the value, returns false if it is the same as the last one
+            static bool updateValue(ReflectedUniform &reflectedUniform, void const* value, std::size_t const size);
+
+            template <typename T>
+            static bool isCompatibleType(GLenum const type);
+
+            void upload(GLint const location, GLint const value) const;
+            void upload(GLint const location, GLuint const value) const;
+            void upload(GLint const location, float const value) const;
+            void upload(GLint const location, glm::vec2 const& value) const;
+            void upload(GLint const location, glm::vec3 const& value) const;
+            void upload(GLint const location, glm::vec4 const& value) const;
+            void upload(GLint const location, glm::mat4 const& value) const;
+    };
+
+    template <> bool ShaderProgram::isCompatibleType<GLint>(GLenum const type);
+    template <> bool ShaderProgram::isCompatibleType<GLuint>(GLenum const type);
+    template <> bool ShaderProgram::isCompatibleType<float>(GLenum const type);
+    template <> bool ShaderProgram::isCompatibleType<glm::vec2>(GLenum const type);
+    template <> bool ShaderProgram::isCompatibleType<glm::vec3>(GLenum const type);
+    template <> bool ShaderProgram::isCompatibleType<glm::vec4>(GLenum const type);
+    template <> bool ShaderProgram::isCompatibleType<glm::mat4>(GLenum const type);
+}
+
+#endif // WAVE_TOOL_SHADER_PROGRAM_H_
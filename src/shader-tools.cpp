@@ -31,6 +31,9 @@
 
 #include "shader-tools.h"
 
+#include <array>
+#include <cstring>
+
 namespace wave_tool {
     GLuint ShaderTools::compileShaders(char const* vertexFilename, char const* fragmentFilename) {
         GLuint vertex_shader;
@@ -180,6 +183,126 @@ namespace wave_tool {
         return program;
     }
 
+    GLuint ShaderTools::compileTessellationShaders(char const* vertexFilename, char const* tessControlFilename, char const* tessEvaluationFilename, char const* fragmentFilename) {
+        GLuint program;
+
+        // the 4 stages in pipeline order
+        std::array<GLenum, 4> const shaderTypes{GL_VERTEX_SHADER, GL_TESS_CONTROL_SHADER, GL_TESS_EVALUATION_SHADER, GL_FRAGMENT_SHADER};
+        std::array<char const*, 4> const shaderNames{"vertex_shader", "tess_control_shader", "tess_evaluation_shader", "fragment_shader"};
+        std::array<GLchar const*, 4> shaderSources{loadshader(vertexFilename), loadshader(tessControlFilename), loadshader(tessEvaluationFilename), loadshader(fragmentFilename)};
+        std::array<GLuint, 4> shaders;
+
+        // Create and compile the shaders
+        for (unsigned int i = 0; i < shaders.size(); ++i) {
+            shaders.at(i) = glCreateShader(shaderTypes.at(i));
+            glShaderSource(shaders.at(i), 1, &shaderSources.at(i), nullptr);
+            glCompileShader(shaders.at(i));
+        }
+
+        // Create program, attach shaders to it, and link it
+        program = glCreateProgram();
+        for (GLuint const shader : shaders) glAttachShader(program, shader);
+
+        glLinkProgram(program);
+
+        GLint status;
+        for (unsigned int i = 0; i < shaders.size(); ++i) {
+            glGetShaderiv(shaders.at(i), GL_COMPILE_STATUS, &status);
+
+            if (GL_FALSE == status) {
+                GLint infoLogLength;
+                glGetShaderiv(shaders.at(i), GL_INFO_LOG_LENGTH, &infoLogLength);
+
+                GLchar *strInfoLog = new GLchar[infoLogLength + 1];
+                glGetShaderInfoLog(shaders.at(i), infoLogLength, nullptr, strInfoLog);
+
+                fprintf(stderr, "Compilation error in shader %s: %s\n", shaderNames.at(i), strInfoLog);
+                delete[] strInfoLog;
+            }
+        }
+
+        // mismatched interfaces between the stages (e.g. the patch size or the per-vertex arrays) only show up at link time
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+
+        if (GL_FALSE == status) {
+            GLint infoLogLength;
+            glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLogLength);
+
+            GLchar *strInfoLog = new GLchar[infoLogLength + 1];
+            glGetProgramInfoLog(program, infoLogLength, nullptr, strInfoLog);
+
+            fprintf(stderr, "Link error in tessellation program: %s\n", strInfoLog);
+            delete[] strInfoLog;
+
+            glDeleteProgram(program);
+            program = 0;
+        }
+
+        // Delete the shaders as the program has them now
+        for (GLuint const shader : shaders) glDeleteShader(shader);
+
+        for (GLchar const* &shaderSource : shaderSources) unloadshader((GLchar**)&shaderSource);
+
+        return program;
+    }
+
+    GLuint ShaderTools::compileTransformFeedbackShader(char const* vertexFilename, std::vector<char const*> const& varyings) {
+        GLuint vertex_shader;
+        GLuint program;
+
+        GLchar const*vertex_shader_source[] = {loadshader(vertexFilename)};
+
+        // Create and compile the vertex shader
+        vertex_shader = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(vertex_shader, 1, vertex_shader_source, nullptr);
+        glCompileShader(vertex_shader);
+
+        // Create program, attach the shader to it, declare the captured outputs (must happen before linking), and link it
+        program = glCreateProgram();
+        glAttachShader(program, vertex_shader);
+        glTransformFeedbackVaryings(program, (GLsizei)varyings.size(), varyings.data(), GL_INTERLEAVED_ATTRIBS);
+
+        glLinkProgram(program);
+
+        GLint status;
+        glGetShaderiv(vertex_shader, GL_COMPILE_STATUS, &status);
+
+        if (GL_FALSE == status) {
+            GLint infoLogLength;
+            glGetShaderiv(vertex_shader, GL_INFO_LOG_LENGTH, &infoLogLength);
+
+            GLchar *strInfoLog = new GLchar[infoLogLength + 1];
+            glGetShaderInfoLog(vertex_shader, infoLogLength, nullptr, strInfoLog);
+
+            fprintf(stderr, "Compilation error in shader vertex_shader: %s\n", strInfoLog);
+            delete[] strInfoLog;
+        }
+
+        // a misspelled (or optimized out) varying only shows up at link time
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+
+        if (GL_FALSE == status) {
+            GLint infoLogLength;
+            glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLogLength);
+
+            GLchar *strInfoLog = new GLchar[infoLogLength + 1];
+            glGetProgramInfoLog(program, infoLogLength, nullptr, strInfoLog);
+
+            fprintf(stderr, "Link error in transform feedback program: %s\n", strInfoLog);
+            delete[] strInfoLog;
+
+            glDeleteProgram(program);
+            program = 0;
+        }
+
+        // Delete the shader as the program has it now
+        glDeleteShader(vertex_shader);
+
+        unloadshader((GLchar**)vertex_shader_source);
+
+        return program;
+    }
+
     unsigned long ShaderTools::getFileLength(std::ifstream &file) {
         if (!file.good()) return 0;
 
@@ -191,33 +314,61 @@ namespace wave_tool {
     }
 
     GLchar* ShaderTools::loadshader(std::string filename) {
-        std::ifstream file;
-        file.open(filename.c_str(), std::ios::in); // opens as ASCII!
-        if (!file) return nullptr;
-
-        unsigned long len = getFileLength(file);
+        std::string source;
+        if (!loadShaderSource(filename, 0, source)) return nullptr;
 
-        if (0 == len) return nullptr; // Error: Empty File
+        if (source.empty()) return nullptr; // Error: Empty File
 
         GLchar *ShaderSource = nullptr;
-        ShaderSource = new char[len + 1];
+        ShaderSource = new char[source.length() + 1];
         if (nullptr == ShaderSource) return nullptr; // can't reserve memoryf
 
-        // len isn't always strlen cause some characters are stripped in ascii read...
-        // it is important to 0-terminate the real length later, len is just max possible value...
-        ShaderSource[len] = 0;
+        std::memcpy(ShaderSource, source.c_str(), source.length() + 1); // copies the 0-terminator as well
+
+        return ShaderSource; // No Error
+    }
 
-        unsigned int i = 0;
-        while (file.good()) {
-            ShaderSource[i] = file.get(); // get character from file.
-            if (!file.eof()) ++i;
+    //NOTE: GLSL 4.1 core has no include mechanism, so any line of the form: #include "relative/path.glsl" is replaced by the contents of that file (paths are relative to the including file)
+    //NOTE: this lets the GLSL side of shared definitions (e.g. gerstner-waves.glsl) live in exactly one place
+    //NOTE: included files must not contain their own #version line
+    bool ShaderTools::loadShaderSource(std::string const& filename, unsigned int const includeDepth, std::string &out_source) {
+        if (includeDepth > MAX_INCLUDE_DEPTH) {
+            std::cout << "ERROR: shader include depth exceeded (recursive include?) while loading " << filename << std::endl;
+            return false;
         }
 
-        ShaderSource[i] = 0; // 0-terminate it at the correct position
+        std::ifstream file;
+        file.open(filename.c_str(), std::ios::in); // opens as ASCII!
+        if (!file) {
+            std::cout << "ERROR: failed to open shader file " << filename << std::endl;
+            return false;
+        }
+
+        // directory of this file (including trailing slash), used to resolve includes
+        std::string const directory{filename.substr(0, filename.find_last_of("/\\") + 1)};
+
+        std::string line;
+        while (std::getline(file, line)) {
+            std::string::size_type const firstCharIndex{line.find_first_not_of(" \t")};
+            if (std::string::npos != firstCharIndex && 0 == line.compare(firstCharIndex, 8, "#include")) {
+                std::string::size_type const openQuoteIndex{line.find('"', firstCharIndex + 8)};
+                std::string::size_type const closeQuoteIndex{std::string::npos == openQuoteIndex ? std::string::npos : line.find('"', openQuoteIndex + 1)};
+                if (std::string::npos == closeQuoteIndex) {
+                    std::cout << "ERROR: malformed #include in shader file " << filename << ": " << line << std::endl;
+                    return false;
+                }
+
+                if (!loadShaderSource(directory + line.substr(openQuoteIndex + 1, closeQuoteIndex - openQuoteIndex - 1), includeDepth + 1, out_source)) return false;
+                continue;
+            }
+
+            out_source += line;
+            out_source += '\n';
+        }
 
         file.close();
 
-        return ShaderSource; // No Error
+        return true;
     }
 
     void ShaderTools::unloadshader(GLchar **ShaderSource) {
@@ -35,6 +35,8 @@
 #include <glad/glad.h>
 #include <iostream>
 #include <fstream>
+#include <string>
+#include <vector>
 
 namespace wave_tool {
     // Class modified from code provided by Allan Rocha for CPSC 591
@@ -42,9 +44,18 @@ namespace wave_tool {
         public:
             static GLuint compileShaders(char const* vertexFilename, char const* fragmentFilename);
             static GLuint compileShaders(char const* vertexFilename, char const* geometryFilename, char const* fragmentFilename);
+            // vertex -> tessellation control -> tessellation evaluation -> fragment program, returns 0 if it fails to link
+            //NOTE: draw with GL_PATCHES, with GL_PATCH_VERTICES set to the input patch size (the vertices per patch fed to the control stage, whose output size is its own layout(vertices = N) out)
+            static GLuint compileTessellationShaders(char const* vertexFilename, char const* tessControlFilename, char const* tessEvaluationFilename, char const* fragmentFilename);
+            // vertex-only program whose outputs (named by varyings, in order) are interleaved into the transform feedback buffer bound to index 0
+            //NOTE: there is no fragment stage, so draw with GL_RASTERIZER_DISCARD enabled
+            static GLuint compileTransformFeedbackShader(char const* vertexFilename, std::vector<char const*> const& varyings);
         private:
+            static unsigned int const MAX_INCLUDE_DEPTH{8};
+
             static unsigned long getFileLength(std::ifstream &file);
             static GLchar* loadshader(std::string filename);
+            static bool loadShaderSource(std::string const& filename, unsigned int const includeDepth, std::string &out_source);
             static void unloadshader(GLchar **ShaderSource);
     };
 }
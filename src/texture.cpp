@@ -31,6 +31,7 @@
 
 #include <cmath>
 #include <iostream>
+#include "gl-state-cache.h"
 #include "texture.h"
 
 namespace wave_tool {
@@ -39,7 +40,7 @@ namespace wave_tool {
 
         GLuint textureID;
         glGenTextures(1, &textureID);
-        glBindTexture(GL_TEXTURE_1D, textureID);
+        GLStateCache::bindTexture(GL_TEXTURE_1D, textureID);
         // set options on currently bound texture object...
         glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -56,7 +57,7 @@ namespace wave_tool {
 
         GLuint textureID;
         glGenTextures(1, &textureID);
-        glBindTexture(GL_TEXTURE_2D, textureID);
+        GLStateCache::bindTexture(GL_TEXTURE_2D, textureID);
         // set options on currently bound texture object...
         //glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
         //glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -71,23 +72,96 @@ namespace wave_tool {
         return textureID;
     }
 
-    void Texture::bind1DTexture(GLuint _program, GLuint _textureID, std::string const& varName) {
-        glActiveTexture(GL_TEXTURE0 + _textureID);
-        glBindTexture(GL_TEXTURE_1D, _textureID);
-        glUniform1i(glGetUniformLocation(_program, varName.c_str()), _textureID);
+    GLuint Texture::create2DTextureRGBA32F(float const* data, unsigned int width, unsigned int height) {
+        GLuint textureID;
+        glGenTextures(1, &textureID);
+        GLStateCache::bindTexture(GL_TEXTURE_2D, textureID);
+        // set options on currently bound texture object...
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // allocate (and optionally fill) texture...
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0, GL_RGBA, GL_FLOAT, data);
+        GLStateCache::bindTexture(GL_TEXTURE_2D, 0);
+
+        return textureID;
+    }
+
+    void Texture::update2DTextureRGBA32F(GLuint _textureID, float const* data, unsigned int width, unsigned int height) {
+        if (0 == _textureID || nullptr == data) return;
+
+        GLStateCache::bindTexture(GL_TEXTURE_2D, _textureID);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_FLOAT, data);
+        GLStateCache::bindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    GLuint Texture::create2DTextureArrayRGBA16F(float const* data, unsigned int width, unsigned int height, unsigned int layerCount) {
+        if (nullptr == data) return 0; // error code
+
+        GLuint textureID;
+        glGenTextures(1, &textureID);
+        GLStateCache::bindTexture(GL_TEXTURE_2D_ARRAY, textureID);
+        // set options on currently bound texture object...
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // generate texture from data (converted to half-floats by the driver)...
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA16F, width, height, layerCount, 0, GL_RGBA, GL_FLOAT, data);
+        GLStateCache::bindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+        return textureID;
+    }
+
+    GLuint Texture::create2DTextureR8OrR16(void const* data, unsigned int width, unsigned int height, unsigned int bytesPerTexel) {
+        if (1 != bytesPerTexel && 2 != bytesPerTexel) return 0; // error code
+
+        GLuint textureID;
+        glGenTextures(1, &textureID);
+        GLStateCache::bindTexture(GL_TEXTURE_2D, textureID);
+        // set options on currently bound texture object (matching create2DTexture())...
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_MIRRORED_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_MIRRORED_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // greyscale like an RGBA heightmap would be, instead of (r, 0, 0, 1)...
+        GLint const swizzle[4]{GL_RED, GL_RED, GL_RED, GL_ONE};
+        glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+        // allocate (and optionally fill) texture...
+        //NOTE: rows are tightly packed, which needs an unpack alignment of 1 for odd widths
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, 2 == bytesPerTexel ? GL_R16 : GL_R8, width, height, 0, GL_RED, 2 == bytesPerTexel ? GL_UNSIGNED_SHORT : GL_UNSIGNED_BYTE, data);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        GLStateCache::bindTexture(GL_TEXTURE_2D, 0);
+
+        return textureID;
+    }
+
+    void Texture::bind1DTexture(ShaderProgram &program, GLuint _textureID, char const* varName) {
+        GLStateCache::bindTextureToUnit(_textureID, GL_TEXTURE_1D, _textureID);
+        program.set<GLint>(varName, _textureID);
+    }
+
+    void Texture::bind2DTexture(ShaderProgram &program, GLuint _textureID, char const* varName) {
+        bind2DTexture(program, _textureID, program.getUniform<GLint>(varName));
+    }
+
+    void Texture::bind2DTexture(ShaderProgram &program, GLuint _textureID, Uniform<GLint> const sampler) {
+        GLStateCache::bindTextureToUnit(_textureID, GL_TEXTURE_2D, _textureID);
+        program.set(sampler, _textureID);
     }
 
-    void Texture::bind2DTexture(GLuint _program, GLuint _textureID, std::string const& varName) {
-        glActiveTexture(GL_TEXTURE0 + _textureID);
-        glBindTexture(GL_TEXTURE_2D, _textureID);
-        glUniform1i(glGetUniformLocation(_program, varName.c_str()), _textureID);
+    void Texture::bind2DTextureArray(ShaderProgram &program, GLuint _textureID, char const* varName) {
+        GLStateCache::bindTextureToUnit(_textureID, GL_TEXTURE_2D_ARRAY, _textureID);
+        program.set<GLint>(varName, _textureID);
     }
 
     void Texture::unbind1DTexture() {
-        glBindTexture(GL_TEXTURE_1D, 0);
+        GLStateCache::bindTexture(GL_TEXTURE_1D, 0);
     }
 
     void Texture::unbind2DTexture() {
-        glBindTexture(GL_TEXTURE_2D, 0);
+        GLStateCache::bindTexture(GL_TEXTURE_2D, 0);
     }
 }
@@ -35,14 +35,26 @@
 #include <glad/glad.h>
 #include <string>
 
+#include "shader-program.h"
+
 namespace wave_tool {
     class Texture {
         public:
             static GLuint create1DTexture(unsigned char *data, unsigned int length);
             static GLuint create2DTexture(unsigned char *data, unsigned int width, unsigned int height);
+            // float texture meant to be re-uploaded every frame with update2DTextureRGBA32F() (GL_REPEAT, no mipmaps), data may be null
+            static GLuint create2DTextureRGBA32F(float const* data, unsigned int width, unsigned int height);
+            static void update2DTextureRGBA32F(GLuint _textureID, float const* data, unsigned int width, unsigned int height);
+            // half-float layered texture (GL_REPEAT, no mipmaps), data is RGBA floats for all layers (layer-major)
+            static GLuint create2DTextureArrayRGBA16F(float const* data, unsigned int width, unsigned int height, unsigned int layerCount);
+            // single-channel GL_R8 (1 byte per texel) or GL_R16 (2 bytes per texel) texture, swizzled to read back as (r, r, r, 1) (GL_MIRRORED_REPEAT, no mipmaps), data may be null
+            static GLuint create2DTextureR8OrR16(void const* data, unsigned int width, unsigned int height, unsigned int bytesPerTexel);
 
-            static void bind1DTexture(GLuint _program, GLuint _textureID, std::string const& varName);
-            static void bind2DTexture(GLuint _program, GLuint _textureID, std::string const& varName);
+            // binds the texture to the unit matching its ID and points the program's sampler at it (the sampler is skipped if it already points there)
+            static void bind1DTexture(ShaderProgram &program, GLuint _textureID, char const* varName);
+            static void bind2DTexture(ShaderProgram &program, GLuint _textureID, char const* varName);
+            static void bind2DTexture(ShaderProgram &program, GLuint _textureID, Uniform<GLint> const sampler);
+            static void bind2DTextureArray(ShaderProgram &program, GLuint _textureID, char const* varName);
 
             static void unbind1DTexture();
             static void unbind2DTexture();
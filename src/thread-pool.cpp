@@ -0,0 +1,105 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include "thread-pool.h"
+
+#include <algorithm>
+
+namespace wave_tool {
+    ThreadPool::ThreadPool(unsigned int const threadCount) {
+        unsigned int const totalThreadCount{0 == threadCount ? std::max(std::thread::hardware_concurrency(), 1u) : threadCount};
+        m_workers.reserve(totalThreadCount - 1);
+        for (unsigned int i = 1; i < totalThreadCount; ++i) m_workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_isStopping = true;
+        }
+        m_workAvailable.notify_all();
+        for (std::thread &worker : m_workers) worker.join();
+    }
+
+    void ThreadPool::parallelFor(std::size_t const count, std::size_t const grainSize, std::function<void(std::size_t const begin, std::size_t const end)> const& task) {
+        if (0 == count) return;
+
+        std::size_t const chunkSize{0 != grainSize ? grainSize : std::max<std::size_t>(count / (4 * getThreadCount()), 1)};
+        // not worth waking anyone up...
+        if (m_workers.empty() || count <= chunkSize) {
+            task(0, count);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_task = &task;
+            m_count = count;
+            m_grainSize = chunkSize;
+            m_nextChunkBegin = 0;
+            m_activeWorkerCount = (unsigned int)m_workers.size();
+            ++m_generation;
+        }
+        m_workAvailable.notify_all();
+
+        runChunks();
+
+        std::unique_lock<std::mutex> lock{m_mutex};
+        m_workFinished.wait(lock, [this]() { return 0 == m_activeWorkerCount; });
+        m_task = nullptr;
+    }
+
+    void ThreadPool::runChunks() {
+        while (true) {
+            std::size_t const begin{m_nextChunkBegin.fetch_add(m_grainSize)};
+            if (begin >= m_count) return;
+            (*m_task)(begin, std::min(begin + m_grainSize, m_count));
+        }
+    }
+
+    void ThreadPool::workerLoop() {
+        std::uint64_t lastGeneration{0};
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock{m_mutex};
+                m_workAvailable.wait(lock, [this, lastGeneration]() { return m_isStopping || m_generation != lastGeneration; });
+                if (m_isStopping) return;
+                lastGeneration = m_generation;
+            }
+
+            runChunks();
+
+            std::lock_guard<std::mutex> lock{m_mutex};
+            if (0 == --m_activeWorkerCount) m_workFinished.notify_one();
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef WAVE_TOOL_THREAD_POOL_H_
+#define WAVE_TOOL_THREAD_POOL_H_
+
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wave_tool {
+    // a minimal fork-join pool for data-parallel CPU work (e.g. the FFT ocean)
+    //NOTE: the calling thread also works on chunks, so a pool with a thread count of 1 has no workers and just runs everything inline
+    //NOTE: parallelFor() is NOT re-entrant (don't call it from inside a task, or from 2 threads at once)
+    class ThreadPool {
+        public:
+            // 0 will use std::thread::hardware_concurrency()
+            explicit ThreadPool(unsigned int const threadCount = 0);
+            ~ThreadPool();
+
+            ThreadPool(ThreadPool const&) = delete;
+            ThreadPool& operator=(ThreadPool const&) = delete;
+
+            // includes the calling thread
+            inline unsigned int getThreadCount() const { return (unsigned int)m_workers.size() + 1; }
+
+            // splits [0, count) into chunks of grainSize and blocks until task(begin, end) has been run on all of them
+            //NOTE: a grainSize of 0 picks a chunk size that gives each thread a few chunks (for load balancing)
+            void parallelFor(std::size_t const count, std::size_t const grainSize, std::function<void(std::size_t const begin, std::size_t const end)> const& task);
+        private:
+            void runChunks();
+            void workerLoop();
+
+            std::atomic<std::size_t> m_nextChunkBegin{0};
+            unsigned int m_activeWorkerCount{0};
+            std::size_t m_count{0};
+            std::uint64_t m_generation{0}; // incremented per parallelFor, so workers can tell new work from a spurious wakeup
+            std::size_t m_grainSize{1};
+            bool m_isStopping{false};
+            std::mutex m_mutex;
+            std::function<void(std::size_t const begin, std::size_t const end)> const* m_task{nullptr};
+            std::condition_variable m_workAvailable;
+            std::condition_variable m_workFinished;
+            std::vector<std::thread> m_workers;
+    };
+}
+
+#endif // WAVE_TOOL_THREAD_POOL_H_
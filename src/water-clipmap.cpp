@@ -0,0 +1,178 @@
+
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include "water-clipmap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace wave_tool {
+    WaterClipmap::WaterClipmap() {
+        // the layout is deterministic, so this is the same table RenderEngine gets alongside the uploaded indices
+        std::vector<unsigned int> indices;
+        generateTriangleIndices(indices, m_tileRanges);
+    }
+
+    bool WaterClipmap::update(glm::vec3 const& cameraPosition, glm::mat4 const& viewProjection, float const displaceableAmplitude, float const baseCellSize, float const coverageRadius) {
+        m_levelCount = 0;
+        m_vertexCount = 0;
+        m_triangleCount = 0;
+        m_tileCount = 0;
+        m_culledTileCount = 0;
+        if (baseCellSize <= 0.0f) return false;
+
+        // skip the levels too fine for the camera height, then keep just enough levels to reach the coverage radius
+        //NOTE: a level always reaches at least (CELL_COUNT / 2 - 2) cells from the camera, since it is snapped to its parent's cell size
+        float const cameraHeight{glm::abs(cameraPosition.y)};
+        unsigned int finestLevel{0};
+        while (finestLevel + 1 < MAX_LEVEL_COUNT && cameraHeight > FINE_LEVEL_CUTOFF_HEIGHT_SCALAR * CELL_COUNT * std::ldexp(baseCellSize, finestLevel)) ++finestLevel;
+        unsigned int coarsestLevel{finestLevel};
+        while (coarsestLevel + 1 < MAX_LEVEL_COUNT && (CELL_COUNT / 2 - 2) * std::ldexp(baseCellSize, coarsestLevel) < coverageRadius) ++coarsestLevel;
+
+        // reference: https://www.gamedevs.org/uploads/fast-extraction-viewing-frustum-planes-from-world-view-projection-matrix.pdf
+        // left, right, bottom, top, near, far (clip-space -w <= x, y, z <= w)
+        glm::vec4 const row0{viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]};
+        glm::vec4 const row1{viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]};
+        glm::vec4 const row2{viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]};
+        glm::vec4 const row3{viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]};
+        std::array<glm::vec4, 6> const frustumPlanes{row3 + row0, row3 - row0, row3 + row1, row3 - row1, row3 + row2, row3 - row2};
+
+        unsigned int const TILE_CELL_COUNT{CELL_COUNT / TILES_PER_SIDE};
+        glm::vec2 finerCentre{0.0f};
+        for (unsigned int levelIndex = finestLevel; levelIndex <= coarsestLevel; ++levelIndex) {
+            Level &level{m_levels[m_levelCount++]};
+            float const cellSize{std::ldexp(baseCellSize, levelIndex)};
+            // snapped to the parent's cell size, so that the vertices stay put in world-space (no swimming) and a fully morphed edge lands on the parent's grid
+            glm::vec2 const centre{glm::floor(glm::vec2{cameraPosition.x, cameraPosition.z} / (2.0f * cellSize)) * (2.0f * cellSize)};
+            level.origin = centre - (0.5f * CELL_COUNT) * cellSize;
+            level.cellSize = cellSize;
+            if (levelIndex == finestLevel) level.variant = 0;
+            else {
+                // the finer level is off-centre by 0 or 1 of this level's cells
+                glm::ivec2 const holeOffset{glm::clamp(glm::ivec2{glm::round((finerCentre - centre) / cellSize)}, glm::ivec2{0}, glm::ivec2{1})};
+                level.variant = 1 + holeOffset.x + 2 * holeOffset.y;
+            }
+            //NOTE: the coarsest level has no parent to morph into (start == end)
+            if (levelIndex < coarsestLevel) {
+                level.morphEndDistance = (CELL_COUNT / 2 - 2) * cellSize;
+                level.morphStartDistance = level.morphEndDistance - MORPH_REGION_CELL_COUNT * cellSize;
+            } else {
+                level.morphStartDistance = std::numeric_limits<float>::max();
+                level.morphEndDistance = std::numeric_limits<float>::max();
+            }
+
+            // cull the tiles...
+            //NOTE: the box is padded by the displaceable amplitude horizontally too, since the gerstner waves also move the surface along x/z
+            level.drawCount = 0;
+            for (unsigned int tile = 0; tile < TILE_COUNT; ++tile) {
+                TileRange const& range{m_tileRanges[level.variant][tile]};
+                if (0 == range.indexCount) continue;
+                ++m_tileCount;
+
+                glm::vec2 const tileMin{level.origin + glm::vec2{(float)(tile % TILES_PER_SIDE), (float)(tile / TILES_PER_SIDE)} * (TILE_CELL_COUNT * cellSize)};
+                glm::vec2 const tileMax{tileMin + TILE_CELL_COUNT * cellSize};
+                if (isBoxOutsideFrustum(frustumPlanes, glm::vec3{tileMin.x - displaceableAmplitude, -displaceableAmplitude, tileMin.y - displaceableAmplitude},
+                                                       glm::vec3{tileMax.x + displaceableAmplitude, displaceableAmplitude, tileMax.y + displaceableAmplitude})) {
+                    ++m_culledTileCount;
+                    continue;
+                }
+
+                m_vertexCount += range.vertexCount;
+                m_triangleCount += range.indexCount / 3;
+                // merge with the previous range if they are neighbours in the index buffer
+                if (level.drawCount > 0 && level.firstIndices[level.drawCount - 1] + (unsigned int)level.indexCounts[level.drawCount - 1] == range.firstIndex) {
+                    level.indexCounts[level.drawCount - 1] += (int)range.indexCount;
+                } else {
+                    level.firstIndices[level.drawCount] = range.firstIndex;
+                    level.indexCounts[level.drawCount] = (int)range.indexCount;
+                    ++level.drawCount;
+                }
+            }
+
+            finerCentre = centre;
+        }
+
+        return m_triangleCount > 0;
+    }
+
+    void WaterClipmap::generateTriangleIndices(std::vector<unsigned int> &out_indices, std::array<std::array<TileRange, TILE_COUNT>, VARIANT_COUNT> &out_tileRanges) {
+        unsigned int const GRID_LENGTH{getGridLength()};
+        unsigned int const TILE_CELL_COUNT{CELL_COUNT / TILES_PER_SIDE};
+        out_indices.clear();
+        out_indices.reserve(getIndexCount());
+
+        std::vector<bool> isVertexReferenced(GRID_LENGTH * GRID_LENGTH);
+        for (unsigned int variant = 0; variant < VARIANT_COUNT; ++variant) {
+            // the hole (in cells) that the finer level covers, empty for the whole grid
+            unsigned int const holeMinCol{0 == variant ? 0 : CELL_COUNT / 4 + (variant - 1) % 2};
+            unsigned int const holeMinRow{0 == variant ? 0 : CELL_COUNT / 4 + (variant - 1) / 2};
+            unsigned int const holeCellCount{0 == variant ? 0 : CELL_COUNT / 2};
+
+            for (unsigned int tile = 0; tile < TILE_COUNT; ++tile) {
+                TileRange &range{out_tileRanges[variant][tile]};
+                range.firstIndex = (unsigned int)out_indices.size();
+                std::fill(isVertexReferenced.begin(), isVertexReferenced.end(), false);
+
+                unsigned int const tileMinCol{(tile % TILES_PER_SIDE) * TILE_CELL_COUNT};
+                unsigned int const tileMinRow{(tile / TILES_PER_SIDE) * TILE_CELL_COUNT};
+                for (unsigned int row = tileMinRow; row < tileMinRow + TILE_CELL_COUNT; ++row) {
+                    for (unsigned int col = tileMinCol; col < tileMinCol + TILE_CELL_COUNT; ++col) {
+                        if (col >= holeMinCol && col < holeMinCol + holeCellCount && row >= holeMinRow && row < holeMinRow + holeCellCount) continue;
+
+                        // same as WaterGrid::generateTriangleIndices() (counter-clockwise, bottom-left to top-right diagonal)
+                        unsigned int const bottomLeft{row * GRID_LENGTH + col};
+                        unsigned int const bottomRight{bottomLeft + 1};
+                        unsigned int const topLeft{bottomLeft + GRID_LENGTH};
+                        unsigned int const topRight{topLeft + 1};
+                        for (unsigned int const index : {bottomLeft, topRight, topLeft, bottomLeft, bottomRight, topRight}) {
+                            out_indices.push_back(index);
+                            isVertexReferenced[index] = true;
+                        }
+                    }
+                }
+
+                range.indexCount = (unsigned int)out_indices.size() - range.firstIndex;
+                range.vertexCount = (unsigned int)std::count(isVertexReferenced.begin(), isVertexReferenced.end(), true);
+            }
+        }
+    }
+
+    bool WaterClipmap::isBoxOutsideFrustum(std::array<glm::vec4, 6> const& frustumPlanes, glm::vec3 const& boxMin, glm::vec3 const& boxMax) {
+        for (glm::vec4 const& plane : frustumPlanes) {
+            // the box corner furthest along the plane normal
+            glm::vec3 const farthestCorner{plane.x >= 0.0f ? boxMax.x : boxMin.x, plane.y >= 0.0f ? boxMax.y : boxMin.y, plane.z >= 0.0f ? boxMax.z : boxMin.z};
+            if (glm::dot(glm::vec3{plane}, farthestCorner) + plane.w < 0.0f) return true;
+        }
+        return false;
+    }
+}
@@ -0,0 +1,137 @@
+#ifndef WAVE_TOOL_WATER_CLIPMAP_H_
+#define WAVE_TOOL_WATER_CLIPMAP_H_
+
+
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+// reference: https://hhoppe.com/proj/geomclipmap/
+// reference: https://developer.nvidia.com/gpugems/gpugems2/part-i-geometric-complexity/chapter-2-terrain-rendering-using-gpu-based-geometry
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <vector>
+
+namespace wave_tool {
+    // places the geometry-clipmap water (the alternative to ProjectedGrid), nested camera-centred levels that each double the cell size of the last
+    // every level is a CELL_COUNT x CELL_COUNT cell grid, drawn with the same vertex layout as the projected grid (gl_VertexID = row * (CELL_COUNT + 1) + col, see water-grid.vert)
+    // the finest active level is drawn whole, and every coarser level as a ring around the level inside it...
+    //
+    // +---+---+---+---+
+    // |   |   |   |   |
+    // +---+---+---+---+
+    // |   | finer |   |
+    // +---+ level +---+
+    // |   |       |   |
+    // +---+---+---+---+
+    // |   |   |   |   |
+    // +---+---+---+---+
+    //
+    //NOTE: a level is snapped to its parent's cell size, so its hole in the parent is off-centre by 0 or 1 parent cell along each axis (the 4 ring variants)
+    //NOTE: no GL dependencies and no heap allocation per update, the index layout is shared by all levels and built once (see generateTriangleIndices())
+    class WaterClipmap {
+        public:
+            // cells per level side (a multiple of 4 and of TILES_PER_SIDE, so that the ring's hole and the tiles land on whole cells)
+            inline static unsigned int const CELL_COUNT{128};
+            // every level is split into TILES_PER_SIDE x TILES_PER_SIDE tiles, which are culled on their own
+            inline static unsigned int const TILES_PER_SIDE{4};
+            inline static unsigned int const TILE_COUNT{TILES_PER_SIDE * TILES_PER_SIDE};
+            // [0] - the whole grid, [1 + dx + 2 * dz] - the ring with its hole offset by (dx, dz) cells
+            inline static unsigned int const VARIANT_COUNT{5};
+            inline static unsigned int const MAX_LEVEL_COUNT{12};
+            // the width (in cells of its own level) of the band along a level's outer edge where its vertices morph into the parent's grid
+            inline static unsigned int const MORPH_REGION_CELL_COUNT{16};
+            // a level is skipped once the camera is higher than this proportion of its width (its cells would be far below a pixel)
+            inline static float const FINE_LEVEL_CUTOFF_HEIGHT_SCALAR{0.4f};
+
+            static_assert(0 == CELL_COUNT % 4 && 0 == CELL_COUNT % TILES_PER_SIDE, "the ring's hole and the tiles must land on whole cells");
+            // the morph region is the band inside the level's outer edge, which has to stay clear of the hole (the finer level reaches out to CELL_COUNT / 4 + 1 cells)
+            static_assert(CELL_COUNT / 2 - 2 - MORPH_REGION_CELL_COUNT > CELL_COUNT / 4 + 1, "the morph region overlaps the hole");
+
+            // one contiguous range of the shared index buffer
+            struct TileRange {
+                unsigned int firstIndex{0};
+                unsigned int indexCount{0};
+                unsigned int vertexCount{0}; // unique vertices referenced by the range
+            };
+
+            // everything needed to draw one level
+            struct Level {
+                glm::vec2 origin{0.0f}; // world-space (x, z) of vertex 0
+                float cellSize{0.0f};
+                // the (x, z) chessboard distances from the camera between which the vertices morph into the parent's grid
+                float morphStartDistance{0.0f};
+                float morphEndDistance{0.0f};
+                unsigned int variant{0};
+                // the visible tiles, with neighbouring index ranges merged (the arguments of a single glMultiDrawElements)
+                unsigned int drawCount{0};
+                std::array<unsigned int, TILE_COUNT> firstIndices;
+                std::array<int, TILE_COUNT> indexCounts;
+            };
+
+            WaterClipmap();
+
+            // re-centres the levels on the camera and culls their tiles against the view frustum and the displaceable volume (the slab between the lower and upper bounding planes around the base plane y = 0)
+            // baseCellSize is the cell size of the finest level, and just enough levels are kept to reach coverageRadius (e.g. the far plane) from the camera
+            // returns false if no tile is visible (nothing to draw)
+            bool update(glm::vec3 const& cameraPosition, glm::mat4 const& viewProjection, float const displaceableAmplitude, float const baseCellSize, float const coverageRadius);
+
+            // the levels in use after the last update, finest first
+            inline unsigned int getLevelCount() const { return m_levelCount; }
+            inline Level const& getLevel(unsigned int const i) const { return m_levels.at(i); }
+            // totals over the visible tiles of the last update
+            inline unsigned int getVertexCount() const { return m_vertexCount; }
+            inline unsigned int getTriangleCount() const { return m_triangleCount; }
+            inline unsigned int getTileCount() const { return m_tileCount; }
+            inline unsigned int getCulledTileCount() const { return m_culledTileCount; }
+
+            static unsigned int getGridLength() { return CELL_COUNT + 1; }
+            // of all the variants together, the whole grid plus the 4 rings (each missing a quarter of the cells)
+            static unsigned int getIndexCount() { return 6 * CELL_COUNT * CELL_COUNT + (VARIANT_COUNT - 1) * 6 * (CELL_COUNT * CELL_COUNT - (CELL_COUNT / 2) * (CELL_COUNT / 2)); }
+            // triangulates every variant into one index buffer (same winding/diagonals as WaterGrid, so a fully morphed level matches its parent exactly), tile by tile
+            static void generateTriangleIndices(std::vector<unsigned int> &out_indices, std::array<std::array<TileRange, TILE_COUNT>, VARIANT_COUNT> &out_tileRanges);
+        private:
+            std::array<std::array<TileRange, TILE_COUNT>, VARIANT_COUNT> m_tileRanges;
+            std::array<Level, MAX_LEVEL_COUNT> m_levels;
+            unsigned int m_levelCount{0};
+            unsigned int m_vertexCount{0};
+            unsigned int m_triangleCount{0};
+            unsigned int m_tileCount{0};
+            unsigned int m_culledTileCount{0};
+
+            // true if the box is entirely on the outer side of any of the (non-normalized) frustum planes (ax + by + cz + d >= 0 is inside)
+            //NOTE: conservative, a box near a frustum corner can be outside without being outside any single plane
+            static bool isBoxOutsideFrustum(std::array<glm::vec4, 6> const& frustumPlanes, glm::vec3 const& boxMin, glm::vec3 const& boxMax);
+    };
+}
+
+#endif // WAVE_TOOL_WATER_CLIPMAP_H_
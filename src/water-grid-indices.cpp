@@ -0,0 +1,213 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+// the WaterGrid's index generation (and its cache simulation), which only needs the GL types/enums (no GL context), so it is built with WaterClipmap as a library of its own
+//NOTE: see tests/water-grid-indices-tests.cpp
+
+#include "water-grid.h"
+
+#include <algorithm>
+#include <climits>
+
+#include "water-clipmap.h"
+
+namespace wave_tool {
+    GLuint WaterGrid::getBandCellRowCount(unsigned int const level, IndexLayout const indexLayout) {
+        GLuint const gridLength{getGridLength(level)};
+        GLuint bandCellRowCount{gridLength - 1};
+        if (IndexLayout::ROW_LIST == indexLayout) return bandCellRowCount;
+
+        // the band's (bandCellRowCount + 1) rows of vertices have to be indexable below the restart index
+        while (bandCellRowCount > 1 && (bandCellRowCount + 1) * gridLength > PRIMITIVE_RESTART_INDEX) bandCellRowCount /= 2;
+        return bandCellRowCount;
+    }
+
+    GLsizei WaterGrid::getIndexCount(unsigned int const level, IndexLayout const indexLayout) {
+        GLuint const cellCount{getGridLength(level) - 1};
+        GLuint const bandCellRowCount{getBandCellRowCount(level, indexLayout)};
+        if (IndexLayout::ROW_LIST == indexLayout) return 6 * bandCellRowCount * cellCount;
+
+        GLsizei indexCount{0};
+        for (GLuint stripStartCol = 0; stripStartCol < cellCount; stripStartCol += CACHE_STRIP_CELL_COUNT) {
+            GLuint const stripCellCount{std::min(CACHE_STRIP_CELL_COUNT, cellCount - stripStartCol)};
+            if (IndexLayout::TILED_STRIP == indexLayout) {
+                // per strip row (and once more for the priming row), 2 indices per column then the restart index
+                indexCount += (bandCellRowCount + 1) * (2 * (stripCellCount + 1) + 1);
+            } else {
+                // per cell 2 triangles, plus 1 degenerate priming triangle for every 2 columns
+                indexCount += 6 * bandCellRowCount * stripCellCount + 3 * ((stripCellCount + 2) / 2);
+            }
+        }
+        return indexCount;
+    }
+
+    std::size_t WaterGrid::getIndexMemoryInBytes(IndexLayout const indexLayout) {
+        std::size_t levelIndexCount{0};
+        for (unsigned int level = 0; level < getLevelCount(); ++level) levelIndexCount += getIndexCount(level, indexLayout);
+        return levelIndexCount * getIndexSizeInBytes(indexLayout) + (WaterClipmap::getIndexCount() + getPatchIndexCount()) * sizeof(GLuint);
+    }
+
+    float WaterGrid::computeAverageCacheMissRatio(std::vector<GLuint> const& indices, IndexLayout const indexLayout, unsigned int const cacheSize) {
+        if (0 == cacheSize) return 0.0f;
+
+        std::vector<GLuint> cache(cacheSize, UINT_MAX);
+        unsigned int nextCacheEntry{0};
+        unsigned int missCount{0};
+        unsigned int triangleCount{0};
+        unsigned int stripLength{0};
+        for (std::size_t i = 0; i < indices.size(); ++i) {
+            GLuint const index{indices[i]};
+            // only count the triangles that get rasterized (the degenerate priming triangles are culled before that)
+            if (IndexLayout::TILED_STRIP == indexLayout) {
+                if (PRIMITIVE_RESTART_INDEX == index) {
+                    stripLength = 0;
+                    continue;
+                }
+                // every index after the first 2 of a strip adds a triangle
+                if (++stripLength >= 3 && index != indices[i - 1] && index != indices[i - 2] && indices[i - 1] != indices[i - 2]) ++triangleCount;
+            } else if (2 == i % 3 && index != indices[i - 1] && index != indices[i - 2] && indices[i - 1] != indices[i - 2]) {
+                ++triangleCount;
+            }
+
+            if (cache.end() != std::find(cache.begin(), cache.end(), index)) continue;
+            ++missCount;
+            cache[nextCacheEntry] = index;
+            nextCacheEntry = (nextCacheEntry + 1) % cacheSize;
+        }
+
+        return 0 == triangleCount ? 0.0f : (float)missCount / triangleCount;
+    }
+
+    void WaterGrid::generateIndices(GLuint const gridLength, GLuint const bandCellRowCount, IndexLayout const indexLayout, std::vector<GLuint> &out_indices) {
+        if (IndexLayout::ROW_LIST == indexLayout) {
+            generateTriangleIndices(gridLength, out_indices);
+            return;
+        }
+
+        out_indices.clear();
+        if (gridLength < 2 || 0 == bandCellRowCount) return;
+        GLuint const cellCount{gridLength - 1};
+
+        // the band is walked 1 column strip at a time (bottom to top), so each strip row re-uses the previous strip row's top vertices while they are still cached
+        //NOTE: the triangles are exactly the ones generateTriangleIndices() makes (split along the bottom-left to top-right diagonal, counter-clockwise)
+        for (GLuint stripStartCol = 0; stripStartCol < cellCount; stripStartCol += CACHE_STRIP_CELL_COUNT) {
+            GLuint const stripEndCol{std::min(stripStartCol + CACHE_STRIP_CELL_COUNT, cellCount)};
+
+            // prime the cache with the strip's bottom row (in order) through degenerate triangles, otherwise the first row loads its bottom and top vertices interleaved
+            // and a FIFO cache then evicts each row's vertices just before the next row needs them (for every row of the strip, not just the first)
+            if (IndexLayout::TILED_STRIP == indexLayout) {
+                for (GLuint col = stripStartCol; col <= stripEndCol; ++col) {
+                    out_indices.push_back(col);
+                    out_indices.push_back(col);
+                }
+                out_indices.push_back(PRIMITIVE_RESTART_INDEX);
+            } else {
+                for (GLuint col = stripStartCol; col <= stripEndCol; col += 2) {
+                    out_indices.push_back(col);
+                    out_indices.push_back(std::min(col + 1, stripEndCol));
+                    out_indices.push_back(col);
+                }
+            }
+
+            for (GLuint row = 0; row < bandCellRowCount; ++row) {
+                if (IndexLayout::TILED_STRIP == indexLayout) {
+                    // top-left, bottom-left, top-right, bottom-right... makes the counter-clockwise (top-left, bottom-left, top-right) then (top-right, bottom-left, bottom-right)
+                    for (GLuint col = stripStartCol; col <= stripEndCol; ++col) {
+                        out_indices.push_back((row + 1) * gridLength + col);
+                        out_indices.push_back(row * gridLength + col);
+                    }
+                    out_indices.push_back(PRIMITIVE_RESTART_INDEX);
+                } else {
+                    for (GLuint col = stripStartCol; col < stripEndCol; ++col) {
+                        GLuint const bottomLeft{row * gridLength + col};
+                        GLuint const bottomRight{bottomLeft + 1};
+                        GLuint const topLeft{bottomLeft + gridLength};
+                        GLuint const topRight{topLeft + 1};
+
+                        out_indices.push_back(bottomLeft);
+                        out_indices.push_back(topRight);
+                        out_indices.push_back(topLeft);
+
+                        out_indices.push_back(bottomLeft);
+                        out_indices.push_back(bottomRight);
+                        out_indices.push_back(topRight);
+                    }
+                }
+            }
+        }
+    }
+
+    void WaterGrid::generateTriangleIndices(GLuint const gridLength, std::vector<GLuint> &out_indices) {
+        out_indices.clear();
+        if (gridLength < 2) return;
+        out_indices.reserve(6 * (gridLength - 1) * (gridLength - 1));
+
+        // the grid vertices are indexed row by row (index = row * gridLength + col), which is the same order the shader derives from gl_VertexID
+        // now using the vertex indices in this format, we can easily tesselate this grid into triangles as so...
+        //TODO: draw a diagram comment here to better explain this
+        for (GLuint row = 0; row < gridLength - 1; ++row) {
+            for (GLuint col = 0; col < gridLength - 1; ++col) {
+                // make 2 triangles (thus a square) from each of these indices acting as the bottom-left corner
+                // ensures that the winding of all triangles is counter-clockwise
+                GLuint const bottomLeft{row * gridLength + col};
+                GLuint const bottomRight{bottomLeft + 1};
+                GLuint const topLeft{bottomLeft + gridLength};
+                GLuint const topRight{topLeft + 1};
+
+                out_indices.push_back(bottomLeft);
+                out_indices.push_back(topRight);
+                out_indices.push_back(topLeft);
+
+                out_indices.push_back(bottomLeft);
+                out_indices.push_back(bottomRight);
+                out_indices.push_back(topRight);
+            }
+        }
+    }
+
+    void WaterGrid::generatePatchIndices(GLuint const gridLength, std::vector<GLuint> &out_indices) {
+        out_indices.clear();
+        if (gridLength < 2) return;
+        out_indices.reserve(4 * (gridLength - 1) * (gridLength - 1));
+
+        for (GLuint row = 0; row < gridLength - 1; ++row) {
+            for (GLuint col = 0; col < gridLength - 1; ++col) {
+                GLuint const bottomLeft{row * gridLength + col};
+                GLuint const topLeft{bottomLeft + gridLength};
+
+                out_indices.push_back(bottomLeft);
+                out_indices.push_back(bottomLeft + 1);
+                out_indices.push_back(topLeft + 1);
+                out_indices.push_back(topLeft);
+            }
+        }
+    }
+}
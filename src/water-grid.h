@@ -0,0 +1,104 @@
+#ifndef WAVE_TOOL_WATER_GRID_H_
+#define WAVE_TOOL_WATER_GRID_H_
+
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "mesh-object.h"
+
+namespace wave_tool {
+    // the projected water grid, a gridLength x gridLength vertex grid with no vertex data (the vertex shader builds each vertex from gl_VertexID)
+    //NOTE: its resolution is a runtime property, one index buffer is pre-built per level (all sharing the vao) so switching levels is just a re-bind
+    //NOTE: by default a level's index buffer only covers 1 band of rows with 16-bit indices, re-drawn for every band with a base vertex (see IndexLayout)
+    //NOTE: the geometry-clipmap mode draws through the same vao, with its own shared index buffer
+    //NOTE: the tessellation mode also draws through the same vao, as a coarse PATCH_GRID_LENGTH x PATCH_GRID_LENGTH grid of quad patches
+    class WaterGrid : public MeshObject {
+        public:
+            // every level has (2^n + 1) vertices per side, so each halves/doubles the spacing of the last
+            inline static std::array<GLuint, 5> const GRID_LENGTHS{129, 257, 513, 1025, 2049};
+            inline static unsigned int const DEFAULT_LEVEL{2}; // 513
+            // the width (in cells) of the column strips the tiled layouts walk a band in, so that a strip's previous row is still in the post-transform cache when the next row re-uses it
+            //NOTE: sized for a 16-entry FIFO cache (a wider strip thrashes it, see --benchmark water-grid-indices), larger caches only gain a little from wider strips
+            inline static GLuint const CACHE_STRIP_CELL_COUNT{12};
+            // ends each strip row of IndexLayout::TILED_STRIP (so no 16-bit band can use it as a vertex index)
+            inline static GLuint const PRIMITIVE_RESTART_INDEX{0xFFFF};
+            // the tessellation control shader subdivides each of these cells on the GPU (up to GL_MAX_TESS_GEN_LEVEL segments per edge)
+            inline static GLuint const PATCH_GRID_LENGTH{33};
+
+            // how the levels' index buffers are laid out
+            enum class IndexLayout {
+                ROW_LIST, // 32-bit triangle list of the whole grid, row by row (the original layout)
+                TILED_LIST, // 16-bit triangle list of 1 band of rows, walked in CACHE_STRIP_CELL_COUNT wide column strips
+                TILED_STRIP, // as TILED_LIST, but every strip row is a triangle strip ended by PRIMITIVE_RESTART_INDEX
+            };
+
+            WaterGrid();
+            ~WaterGrid() override;
+
+            IndexLayout indexLayout{IndexLayout::TILED_STRIP}; // the layout levelIndexBuffers currently hold, switched through RenderEngine::assignWaterGridLevelIndexBuffers()
+            std::array<GLuint, GRID_LENGTHS.size()> levelIndexBuffers; // filled by RenderEngine::assignWaterGridBuffers()
+            GLuint clipmapIndexBuffer{0}; // every WaterClipmap variant (see WaterClipmap::generateTriangleIndices()), also filled by RenderEngine::assignWaterGridBuffers()
+            GLuint patchIndexBuffer{0}; // 4 indices per PATCH_GRID_LENGTH cell (see generatePatchIndices()), also filled by RenderEngine::assignWaterGridBuffers()
+
+            static unsigned int getLevelCount() { return GRID_LENGTHS.size(); }
+            static GLuint getGridLength(unsigned int const level) { return GRID_LENGTHS.at(level); }
+            static GLsizei getTriangleCount(unsigned int const level) { return 2 * (getGridLength(level) - 1) * (getGridLength(level) - 1); }
+            // the cell rows per band, the whole grid for IndexLayout::ROW_LIST, otherwise the most (a power of 2, so the bands tile the grid exactly) whose vertices all have a 16-bit index
+            static GLuint getBandCellRowCount(unsigned int const level, IndexLayout const indexLayout);
+            static unsigned int getBandCount(unsigned int const level, IndexLayout const indexLayout) { return (getGridLength(level) - 1) / getBandCellRowCount(level, indexLayout); }
+            // the number of indices in 1 band (every band is drawn from the same indices, offset by a base vertex of band * bandCellRowCount * gridLength)
+            static GLsizei getIndexCount(unsigned int const level, IndexLayout const indexLayout);
+            static GLenum getIndexType(IndexLayout const indexLayout) { return IndexLayout::ROW_LIST == indexLayout ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT; }
+            static std::size_t getIndexSizeInBytes(IndexLayout const indexLayout) { return IndexLayout::ROW_LIST == indexLayout ? sizeof(GLuint) : sizeof(GLushort); }
+            static GLsizei getPatchIndexCount() { return 4 * (PATCH_GRID_LENGTH - 1) * (PATCH_GRID_LENGTH - 1); }
+            // the GPU memory of all the levels' index buffers in the given layout (and the clipmap's and the patches')
+            static std::size_t getIndexMemoryInBytes(IndexLayout const indexLayout);
+
+            // simulates a FIFO post-transform vertex cache of cacheSize entries over indices in the given layout, returns the average cache misses per triangle (ACMR)
+            //NOTE: every vertex of a grid is shared by ~6 triangles, so ~0.5 is ideal (each vertex transformed once) and 3.0 is no re-use at all
+            static float computeAverageCacheMissRatio(std::vector<GLuint> const& indices, IndexLayout const indexLayout, unsigned int const cacheSize);
+            // the indices of 1 band (bandCellRowCount x (gridLength - 1) cells) in the given layout, relative to the band's bottom-left vertex (counter-clockwise winding, [row][col] = [0][0] is the bottom-left vertex)
+            //NOTE: kept as GLuint here for every layout, the 16-bit layouts are narrowed on upload
+            static void generateIndices(GLuint const gridLength, GLuint const bandCellRowCount, IndexLayout const indexLayout, std::vector<GLuint> &out_indices);
+            // triangulates the grid in the layout the shader expects (counter-clockwise winding, [row][col] = [0][0] is the bottom-left vertex), i.e. IndexLayout::ROW_LIST
+            static void generateTriangleIndices(GLuint const gridLength, std::vector<GLuint> &out_indices);
+            // one 4-vertex patch per cell in the order water-grid.tesc expects (bottom-left, bottom-right, top-right, top-left)
+            static void generatePatchIndices(GLuint const gridLength, std::vector<GLuint> &out_indices);
+    };
+}
+
+#endif // WAVE_TOOL_WATER_GRID_H_
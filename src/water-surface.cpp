@@ -0,0 +1,516 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include "water-surface.h"
+
+#include <stb/stb_image.h>
+
+#include <algorithm>
+#include <iostream>
+
+#include "thread-pool.h"
+
+namespace wave_tool {
+    std::shared_ptr<Heightmap> Heightmap::fromRGBA8(unsigned char const* data, unsigned int const width, unsigned int const height) {
+        if (nullptr == data || 0 == width || 0 == height) return nullptr;
+
+        std::shared_ptr<Heightmap> heightmap{std::make_shared<Heightmap>()};
+        heightmap->width = width;
+        heightmap->height = height;
+        heightmap->intensities.resize(width * height);
+        for (unsigned int i = 0; i < width * height; ++i) {
+            heightmap->intensities.at(i) = data[4 * i] / 255.0f;
+        }
+
+        return heightmap;
+    }
+
+    std::shared_ptr<Heightmap> Heightmap::loadFromFile(std::string const& filePath) {
+        int width;
+        int height;
+        int nrChannels;
+        stbi_set_flip_vertically_on_load(true);
+        unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, STBI_rgb_alpha);
+        if (nullptr == data) {
+            std::cout << "ERROR: failed to load heightmap: " << filePath << std::endl;
+            return nullptr;
+        }
+
+        std::shared_ptr<Heightmap> const heightmap{fromRGBA8(data, (unsigned int)width, (unsigned int)height)};
+        stbi_image_free(data);
+        return heightmap;
+    }
+
+    // reference: https://www.khronos.org/registry/OpenGL/specs/gl/glspec46.core.pdf (section 8.14.2 - coordinate wrapping and texel selection)
+    float Heightmap::sample(glm::vec2 const& uv, glm::vec2 *out_dIntensity_dUV) const {
+        float const s{uv.x * width - 0.5f};
+        float const t{uv.y * height - 0.5f};
+        float const i0Float{std::floor(s)};
+        float const j0Float{std::floor(t)};
+        float const alpha{s - i0Float};
+        float const beta{t - j0Float};
+
+        // GL_MIRRORED_REPEAT on the integer texel coordinates
+        //NOTE: only the lower texel needs a (slow) modulo, the upper one is at most 1 step further around the mirrored period
+        auto const mirror = [](long long const i, unsigned int const size, unsigned int &out_i0, unsigned int &out_i1) {
+            long long const period{2ll * size};
+            long long m0{i % period};
+            if (m0 < 0) m0 += period;
+            long long const m1{(m0 + 1 == period) ? 0 : m0 + 1};
+            out_i0 = (unsigned int)(m0 < size ? m0 : period - 1 - m0);
+            out_i1 = (unsigned int)(m1 < size ? m1 : period - 1 - m1);
+        };
+        unsigned int i0;
+        unsigned int i1;
+        unsigned int j0;
+        unsigned int j1;
+        mirror((long long)i0Float, width, i0, i1);
+        mirror((long long)j0Float, height, j0, j1);
+
+        float const t00{intensities[j0 * width + i0]};
+        float const t10{intensities[j0 * width + i1]};
+        float const t01{intensities[j1 * width + i0]};
+        float const t11{intensities[j1 * width + i1]};
+
+        // same math as computeHeightmapDisplacementGradient() in water-grid.vert
+        if (nullptr != out_dIntensity_dUV) {
+            out_dIntensity_dUV->x = glm::mix(t10 - t00, t11 - t01, beta) * width;
+            out_dIntensity_dUV->y = glm::mix(t01 - t00, t11 - t10, alpha) * height;
+        }
+
+        return glm::mix(glm::mix(t00, t10, alpha), glm::mix(t01, t11, alpha), beta);
+    }
+
+    void WaterGridSoA::resize(unsigned int const length) {
+        gridLength = length;
+        std::size_t const count{(std::size_t)length * length};
+        positionX.resize(count);
+        positionY.resize(count);
+        positionZ.resize(count);
+        normalX.resize(count);
+        normalY.resize(count);
+        normalZ.resize(count);
+    }
+
+    void WaterProbeBatch::resize(std::size_t const count) {
+        probeX.resize(count);
+        probeZ.resize(count);
+        height.resize(count);
+        normalX.resize(count);
+        normalY.resize(count);
+        normalZ.resize(count);
+        velocityX.resize(count);
+        velocityY.resize(count);
+        velocityZ.resize(count);
+    }
+
+    void WaterSurface::evaluateGrid(WaterGridCorners const& corners, unsigned int const gridLength, WaterSurfaceState const& state, ThreadPool *threadPool, WaterGridSoA &out_grid) {
+        if (gridLength < 2) {
+            std::cout << "ERROR: water grid length must be >= 2, got " << gridLength << std::endl;
+            return;
+        }
+        out_grid.resize(gridLength);
+
+        auto const task = [&](std::size_t const begin, std::size_t const end) {
+            //NOTE: per-thread so that rows don't re-allocate their working arrays
+            thread_local std::vector<float> scratch;
+            for (std::size_t row = begin; row < end; ++row) {
+                evaluateRow(corners, gridLength, (unsigned int)row, state, scratch, out_grid);
+            }
+        };
+
+        if (nullptr != threadPool) threadPool->parallelFor(gridLength, 0, task);
+        else task(0, gridLength);
+    }
+
+    void WaterSurface::evaluateRow(WaterGridCorners const& corners, unsigned int const gridLength, unsigned int const row, WaterSurfaceState const& state, std::vector<float> &scratch, WaterGridSoA &out_grid) {
+        unsigned int const L{gridLength};
+        scratch.resize((2 + SURFACE_SCRATCH_ARRAY_COUNT) * L);
+        float *const gridX{scratch.data()};
+        float *const gridZ{gridX + L};
+
+        // computeInterpolatedGridPosition() (bilinear, so mixing along v first gives the same surface)
+        float const du{1.0f / (L - 1)};
+        float const v{row * du};
+        glm::vec4 const left{glm::mix(corners.bottomLeft, corners.topLeft, v)};
+        glm::vec4 const right{glm::mix(corners.bottomRight, corners.topRight, v)};
+        float const stepX{du * (right.x - left.x)};
+        float const stepZ{du * (right.z - left.z)};
+        for (unsigned int c = 0; c < L; ++c) {
+            gridX[c] = left.x + c * stepX;
+            gridZ[c] = left.z + c * stepZ;
+        }
+
+        std::size_t const rowOffset{(std::size_t)row * L};
+        evaluateSurface(L, gridX, gridZ, state, gridZ + L,
+                        out_grid.positionX.data() + rowOffset, out_grid.positionY.data() + rowOffset, out_grid.positionZ.data() + rowOffset,
+                        out_grid.normalX.data() + rowOffset, out_grid.normalY.data() + rowOffset, out_grid.normalZ.data() + rowOffset);
+    }
+
+    void WaterSurface::queryProbes(WaterSurfaceState const& state, unsigned int const iterationCount, ThreadPool *threadPool, WaterProbeBatch &inout_batch) {
+        if (inout_batch.probeX.size() != inout_batch.probeZ.size()) {
+            std::cout << "ERROR: water probe batch has " << inout_batch.probeX.size() << " x positions but " << inout_batch.probeZ.size() << " z positions" << std::endl;
+            return;
+        }
+        std::size_t const probeCount{inout_batch.size()};
+        inout_batch.resize(probeCount);
+        std::size_t const blockCount{(probeCount + PROBE_BLOCK_SIZE - 1) / PROBE_BLOCK_SIZE};
+
+        auto const task = [&](std::size_t const begin, std::size_t const end) {
+            //NOTE: per-thread so that blocks don't re-allocate their working arrays
+            thread_local std::vector<float> scratch;
+            for (std::size_t block = begin; block < end; ++block) {
+                std::size_t const blockBegin{block * PROBE_BLOCK_SIZE};
+                queryProbeBlock(blockBegin, std::min(PROBE_BLOCK_SIZE, probeCount - blockBegin), state, iterationCount, scratch, inout_batch);
+            }
+        };
+
+        if (nullptr != threadPool) threadPool->parallelFor(blockCount, 0, task);
+        else task(0, blockCount);
+    }
+
+    void WaterSurface::queryProbeBlock(std::size_t const begin, std::size_t const count, WaterSurfaceState const& state, unsigned int const iterationCount, std::vector<float> &scratch, WaterProbeBatch &inout_batch) {
+        scratch.resize((7 + SURFACE_SCRATCH_ARRAY_COUNT) * count);
+        float *const gridX{scratch.data()};
+        float *const gridZ{gridX + count};
+        float *const positionX{gridZ + count};
+        float *const positionZ{positionX + count};
+        float *const dX_dX{positionZ + count};
+        float *const dX_dZ{dX_dX + count};
+        float *const dZ_dZ{dX_dZ + count};
+        float *const surfaceScratch{dZ_dZ + count};
+
+        float const* probeX{inout_batch.probeX.data() + begin};
+        float const* probeZ{inout_batch.probeZ.data() + begin};
+        std::copy(probeX, probeX + count, gridX);
+        std::copy(probeZ, probeZ + count, gridZ);
+
+        // invert the horizontal gerstner displacement, starting from the probe itself
+        if (!state.gerstnerWaves.empty()) {
+            for (unsigned int iteration = 0; iteration < iterationCount; ++iteration) {
+                std::copy(gridX, gridX + count, positionX);
+                std::copy(gridZ, gridZ + count, positionZ);
+                std::fill(dX_dX, dX_dX + count, 1.0f);
+                std::fill(dX_dZ, dX_dZ + count, 0.0f);
+                std::fill(dZ_dZ, dZ_dZ + count, 1.0f);
+                for (geometry::GerstnerWaveStd140 const& wave : state.gerstnerWaves) {
+                    accumulateGerstnerHorizontalKernel(count, wave, state.timeInSeconds, gridX, gridZ, positionX, positionZ, dX_dX, dX_dZ, dZ_dZ);
+                }
+                newtonStepKernel(count, probeX, probeZ, positionX, positionZ, dX_dX, dX_dZ, dZ_dZ, gridX, gridZ);
+            }
+        }
+
+        //NOTE: the displaced x/z are only needed for the heightmap lookup, so they go to scratch
+        evaluateSurface(count, gridX, gridZ, state, surfaceScratch,
+                        positionX, inout_batch.height.data() + begin, positionZ,
+                        inout_batch.normalX.data() + begin, inout_batch.normalY.data() + begin, inout_batch.normalZ.data() + begin);
+
+        float *const velocityX{inout_batch.velocityX.data() + begin};
+        float *const velocityY{inout_batch.velocityY.data() + begin};
+        float *const velocityZ{inout_batch.velocityZ.data() + begin};
+        std::fill(velocityX, velocityX + count, 0.0f);
+        std::fill(velocityY, velocityY + count, 0.0f);
+        std::fill(velocityZ, velocityZ + count, 0.0f);
+        for (geometry::GerstnerWaveStd140 const& wave : state.gerstnerWaves) {
+            accumulateGerstnerVelocityKernel(count, wave, state.timeInSeconds, gridX, gridZ, velocityX, velocityY, velocityZ);
+        }
+    }
+
+    //NOTE: every loop here runs over contiguous floats with no calls or branches (besides the heightmap fetch, which is a gather anyways)
+    void WaterSurface::evaluateSurface(std::size_t const count, float const* gridX, float const* gridZ, WaterSurfaceState const& state, float *scratch,
+                                       float *positionX, float *positionY, float *positionZ, float *normalX, float *normalY, float *normalZ) {
+        float *const tangentX{scratch};
+        float *const tangentY{tangentX + count};
+        float *const bitangentY{tangentY + count};
+        float *const bitangentZ{bitangentY + count};
+        //NOTE: tangent.z and bitangent.x get the same terms (-Dx * Dz * ...), so they share an array
+        float *const tangentZBitangentX{bitangentZ + count};
+
+        initializeSurfaceKernel(count, gridX, gridZ, positionX, positionY, positionZ, tangentX, tangentY, tangentZBitangentX, bitangentY, bitangentZ);
+
+        // computeGerstnerSurfacePositionAndDerivatives(), one wave at a time over the whole run
+        for (geometry::GerstnerWaveStd140 const& wave : state.gerstnerWaves) {
+            accumulateGerstnerWaveKernel(count, wave, state.timeInSeconds, gridX, gridZ, positionX, positionY, positionZ, tangentX, tangentY, tangentZBitangentX, bitangentY, bitangentZ);
+        }
+
+        // computeHeightmapDisplacement() + computeAnalyticNormal() (both at the gerstner-displaced position)
+        if (nullptr != state.heightmap) {
+            Heightmap const& heightmap{*state.heightmap};
+            float const displacementScale{2.0f * state.heightmapDisplacementScale};
+            float const gradientScale{displacementScale * state.heightmapSampleScale};
+            for (std::size_t c = 0; c < count; ++c) {
+                glm::vec2 dIntensity_dUV;
+                float const intensity{heightmap.sample(state.heightmapSampleScale * glm::vec2{positionX[c], -positionZ[c]}, &dIntensity_dUV)};
+                positionY[c] += displacementScale * (intensity - 0.5f);
+                float const gradientX{gradientScale * dIntensity_dUV.x};
+                float const gradientZ{-gradientScale * dIntensity_dUV.y};
+                tangentY[c] += gradientX * tangentX[c] + gradientZ * tangentZBitangentX[c];
+                bitangentY[c] += gradientX * tangentZBitangentX[c] + gradientZ * bitangentZ[c];
+            }
+        }
+
+        finalizeSurfaceKernel(count, state.verticalBounceWaveDisplacement, tangentX, tangentY, tangentZBitangentX, bitangentY, bitangentZ, positionY, normalX, normalY, normalZ);
+    }
+
+    void WaterSurface::initializeSurfaceKernel(std::size_t const count, float const*__restrict const gridX, float const*__restrict const gridZ,
+                                               float *__restrict const positionX, float *__restrict const positionY, float *__restrict const positionZ,
+                                               float *__restrict const tangentX, float *__restrict const tangentY, float *__restrict const tangentZBitangentX,
+                                               float *__restrict const bitangentY, float *__restrict const bitangentZ) {
+        for (std::size_t c = 0; c < count; ++c) {
+            positionX[c] = gridX[c];
+            positionY[c] = 0.0f;
+            positionZ[c] = gridZ[c];
+            tangentX[c] = 1.0f;
+            tangentY[c] = 0.0f;
+            tangentZBitangentX[c] = 0.0f;
+            bitangentY[c] = 0.0f;
+            bitangentZ[c] = 1.0f;
+        }
+    }
+
+    void WaterSurface::accumulateGerstnerWaveKernel(std::size_t const count, geometry::GerstnerWaveStd140 const& wave, float const timeInSeconds,
+                                                    float const*__restrict const gridX, float const*__restrict const gridZ,
+                                                    float *__restrict const positionX, float *__restrict const positionY, float *__restrict const positionZ,
+                                                    float *__restrict const tangentX, float *__restrict const tangentY, float *__restrict const tangentZBitangentX,
+                                                    float *__restrict const bitangentY, float *__restrict const bitangentZ) {
+        float const Dx{wave.xzDirection_D.x};
+        float const Dz{wave.xzDirection_D.y};
+        float const wDx{wave.frequency_w * Dx};
+        float const wDz{wave.frequency_w * Dz};
+        float const phiT{wave.phaseConstant_phi * timeInSeconds};
+        float const A{wave.amplitude_A};
+        float const QADx{wave.steepness_Q_i * A * Dx};
+        float const QADz{wave.steepness_Q_i * A * Dz};
+        float const WA{wave.frequency_w * A};
+        float const QWA{wave.steepness_Q_i * WA};
+        float const DxDxQWA{Dx * Dx * QWA};
+        float const DxDzQWA{Dx * Dz * QWA};
+        float const DzDzQWA{Dz * Dz * QWA};
+        float const DxWA{Dx * WA};
+        float const DzWA{Dz * WA};
+        for (std::size_t c = 0; c < count; ++c) {
+            float sinConstant;
+            float cosConstant;
+            sinCos(wDx * gridX[c] + wDz * gridZ[c] + phiT, sinConstant, cosConstant);
+            positionX[c] += QADx * cosConstant;
+            positionY[c] += A * sinConstant;
+            positionZ[c] += QADz * cosConstant;
+            tangentX[c] -= DxDxQWA * sinConstant;
+            tangentY[c] += DxWA * cosConstant;
+            tangentZBitangentX[c] -= DxDzQWA * sinConstant;
+            bitangentY[c] += DzWA * cosConstant;
+            bitangentZ[c] -= DzDzQWA * sinConstant;
+        }
+    }
+
+    // vertical bounce + normalize(cross(bitangent, tangent))
+    //NOTE: the shader also flips the normal to face the camera, which is left to the caller here
+    void WaterSurface::finalizeSurfaceKernel(std::size_t const count, float const verticalBounceWaveDisplacement,
+                                             float const*__restrict const tangentX, float const*__restrict const tangentY, float const*__restrict const tangentZBitangentX,
+                                             float const*__restrict const bitangentY, float const*__restrict const bitangentZ,
+                                             float *__restrict const positionY, float *__restrict const normalX, float *__restrict const normalY, float *__restrict const normalZ) {
+        for (std::size_t c = 0; c < count; ++c) {
+            positionY[c] += verticalBounceWaveDisplacement;
+            float const tX{tangentX[c]};
+            float const tY{tangentY[c]};
+            float const tZ{tangentZBitangentX[c]};
+            float const bX{tangentZBitangentX[c]};
+            float const bY{bitangentY[c]};
+            float const bZ{bitangentZ[c]};
+            float const nX{bY * tZ - bZ * tY};
+            float const nY{bZ * tX - bX * tZ};
+            float const nZ{bX * tY - bY * tX};
+            float const inverseLength{1.0f / std::sqrt(nX * nX + nY * nY + nZ * nZ)};
+            normalX[c] = nX * inverseLength;
+            normalY[c] = nY * inverseLength;
+            normalZ[c] = nZ * inverseLength;
+        }
+    }
+
+    void WaterSurface::accumulateGerstnerHorizontalKernel(std::size_t const count, geometry::GerstnerWaveStd140 const& wave, float const timeInSeconds,
+                                                          float const*__restrict const gridX, float const*__restrict const gridZ,
+                                                          float *__restrict const positionX, float *__restrict const positionZ,
+                                                          float *__restrict const dX_dX, float *__restrict const dX_dZ, float *__restrict const dZ_dZ) {
+        float const Dx{wave.xzDirection_D.x};
+        float const Dz{wave.xzDirection_D.y};
+        float const wDx{wave.frequency_w * Dx};
+        float const wDz{wave.frequency_w * Dz};
+        float const phiT{wave.phaseConstant_phi * timeInSeconds};
+        float const QADx{wave.steepness_Q_i * wave.amplitude_A * Dx};
+        float const QADz{wave.steepness_Q_i * wave.amplitude_A * Dz};
+        float const QWA{wave.steepness_Q_i * wave.frequency_w * wave.amplitude_A};
+        float const DxDxQWA{Dx * Dx * QWA};
+        float const DxDzQWA{Dx * Dz * QWA};
+        float const DzDzQWA{Dz * Dz * QWA};
+        for (std::size_t c = 0; c < count; ++c) {
+            float sinConstant;
+            float cosConstant;
+            sinCos(wDx * gridX[c] + wDz * gridZ[c] + phiT, sinConstant, cosConstant);
+            positionX[c] += QADx * cosConstant;
+            positionZ[c] += QADz * cosConstant;
+            dX_dX[c] -= DxDxQWA * sinConstant;
+            dX_dZ[c] -= DxDzQWA * sinConstant;
+            dZ_dZ[c] -= DzDzQWA * sinConstant;
+        }
+    }
+
+    void WaterSurface::newtonStepKernel(std::size_t const count, float const*__restrict const probeX, float const*__restrict const probeZ,
+                                        float const*__restrict const positionX, float const*__restrict const positionZ,
+                                        float const*__restrict const dX_dX, float const*__restrict const dX_dZ, float const*__restrict const dZ_dZ,
+                                        float *__restrict const gridX, float *__restrict const gridZ) {
+        //NOTE: the determinant only reaches 0 at a fully pinched crest (total steepness of 1), so clamping it just damps the step there
+        float const MIN_DETERMINANT{1.0e-3f};
+        for (std::size_t c = 0; c < count; ++c) {
+            float const residualX{positionX[c] - probeX[c]};
+            float const residualZ{positionZ[c] - probeZ[c]};
+            float const inverseDeterminant{1.0f / std::max(dX_dX[c] * dZ_dZ[c] - dX_dZ[c] * dX_dZ[c], MIN_DETERMINANT)};
+            gridX[c] -= inverseDeterminant * (dZ_dZ[c] * residualX - dX_dZ[c] * residualZ);
+            gridZ[c] -= inverseDeterminant * (dX_dX[c] * residualZ - dX_dZ[c] * residualX);
+        }
+    }
+
+    // the time derivative of the gerstner position (the phase advances at phi per second)
+    void WaterSurface::accumulateGerstnerVelocityKernel(std::size_t const count, geometry::GerstnerWaveStd140 const& wave, float const timeInSeconds,
+                                                        float const*__restrict const gridX, float const*__restrict const gridZ,
+                                                        float *__restrict const velocityX, float *__restrict const velocityY, float *__restrict const velocityZ) {
+        float const Dx{wave.xzDirection_D.x};
+        float const Dz{wave.xzDirection_D.y};
+        float const wDx{wave.frequency_w * Dx};
+        float const wDz{wave.frequency_w * Dz};
+        float const phiT{wave.phaseConstant_phi * timeInSeconds};
+        float const phiA{wave.phaseConstant_phi * wave.amplitude_A};
+        float const phiQADx{wave.steepness_Q_i * phiA * Dx};
+        float const phiQADz{wave.steepness_Q_i * phiA * Dz};
+        for (std::size_t c = 0; c < count; ++c) {
+            float sinConstant;
+            float cosConstant;
+            sinCos(wDx * gridX[c] + wDz * gridZ[c] + phiT, sinConstant, cosConstant);
+            velocityX[c] -= phiQADx * sinConstant;
+            velocityY[c] += phiA * cosConstant;
+            velocityZ[c] -= phiQADz * sinConstant;
+        }
+    }
+
+    void WaterSurface::evaluateGridReference(WaterGridCorners const& corners, unsigned int const gridLength, WaterSurfaceState const& state, WaterGridSoA &out_grid) {
+        if (gridLength < 2) {
+            std::cout << "ERROR: water grid length must be >= 2, got " << gridLength << std::endl;
+            return;
+        }
+        out_grid.resize(gridLength);
+
+        float const du{1.0f / (gridLength - 1)};
+        float const dv{1.0f / (gridLength - 1)};
+        for (unsigned int vertexID = 0; vertexID < gridLength * gridLength; ++vertexID) {
+            glm::vec2 const uv{(vertexID % gridLength) * du, (vertexID / gridLength) * dv};
+            // computeInterpolatedGridPosition()
+            glm::vec4 const mix_u_1{glm::mix(corners.bottomLeft, corners.bottomRight, uv.x)};
+            glm::vec4 const mix_u_2{glm::mix(corners.topLeft, corners.topRight, uv.x)};
+            glm::vec4 const position{glm::mix(mix_u_1, mix_u_2, uv.y)};
+
+            glm::vec3 normal;
+            glm::vec3 const surfacePosition{evaluatePointReference(glm::vec2{position.x, position.z}, state, &normal)};
+            out_grid.positionX.at(vertexID) = surfacePosition.x;
+            out_grid.positionY.at(vertexID) = surfacePosition.y;
+            out_grid.positionZ.at(vertexID) = surfacePosition.z;
+            out_grid.normalX.at(vertexID) = normal.x;
+            out_grid.normalY.at(vertexID) = normal.y;
+            out_grid.normalZ.at(vertexID) = normal.z;
+        }
+    }
+
+    glm::vec3 WaterSurface::evaluatePointReference(glm::vec2 const& xzGridPosition, WaterSurfaceState const& state, glm::vec3 *out_normal) {
+        glm::vec3 tangent;
+        glm::vec3 bitangent;
+        glm::vec3 position{evaluateGerstnerReference(xzGridPosition, state, tangent, bitangent)};
+
+        // computeHeightmapDisplacement() + computeHeightmapDisplacementGradient() + computeAnalyticNormal()
+        if (nullptr != state.heightmap) {
+            glm::vec2 dIntensity_dUV;
+            float const intensity{state.heightmap->sample(state.heightmapSampleScale * glm::vec2{position.x, -position.z}, &dIntensity_dUV)};
+            glm::vec2 const gradient{2.0f * state.heightmapDisplacementScale * state.heightmapSampleScale * glm::vec2{dIntensity_dUV.x, -dIntensity_dUV.y}};
+            float const tangentSlope{glm::dot(gradient, glm::vec2{tangent.x, tangent.z})};
+            float const bitangentSlope{glm::dot(gradient, glm::vec2{bitangent.x, bitangent.z})};
+            tangent.y += tangentSlope;
+            bitangent.y += bitangentSlope;
+            position.y += state.heightmapDisplacementScale * 2.0f * (intensity - 0.5f);
+        }
+
+        position.y += state.verticalBounceWaveDisplacement;
+        if (nullptr != out_normal) *out_normal = glm::normalize(glm::cross(bitangent, tangent));
+        return position;
+    }
+
+    float WaterSurface::queryProbeReference(glm::vec2 const& xzProbePosition, WaterSurfaceState const& state, unsigned int const iterationCount, glm::vec3 *out_normal, glm::vec3 *out_velocity) {
+        glm::vec2 xzGridPosition{xzProbePosition};
+        glm::vec3 tangent;
+        glm::vec3 bitangent;
+        if (!state.gerstnerWaves.empty()) {
+            for (unsigned int iteration = 0; iteration < iterationCount; ++iteration) {
+                glm::vec3 const position{evaluateGerstnerReference(xzGridPosition, state, tangent, bitangent)};
+                // the jacobian of the horizontal position is [tangent.xz, bitangent.xz] (as columns)
+                glm::vec2 const residual{glm::vec2{position.x, position.z} - xzProbePosition};
+                float const determinant{glm::max(tangent.x * bitangent.z - bitangent.x * tangent.z, 1.0e-3f)};
+                xzGridPosition -= glm::vec2{bitangent.z * residual.x - bitangent.x * residual.y, tangent.x * residual.y - tangent.z * residual.x} / determinant;
+            }
+        }
+
+        if (nullptr != out_velocity) evaluateGerstnerReference(xzGridPosition, state, tangent, bitangent, out_velocity);
+        return evaluatePointReference(xzGridPosition, state, out_normal).y;
+    }
+
+    // computeGerstnerSurfacePositionAndDerivatives()
+    glm::vec3 WaterSurface::evaluateGerstnerReference(glm::vec2 const& xzGridPosition, WaterSurfaceState const& state, glm::vec3 &out_tangent, glm::vec3 &out_bitangent, glm::vec3 *out_velocity) {
+        glm::vec3 position{xzGridPosition.x, 0.0f, xzGridPosition.y};
+        out_tangent = glm::vec3{1.0f, 0.0f, 0.0f};
+        out_bitangent = glm::vec3{0.0f, 0.0f, 1.0f};
+        if (nullptr != out_velocity) *out_velocity = glm::vec3{0.0f, 0.0f, 0.0f};
+        for (geometry::GerstnerWaveStd140 const& wave : state.gerstnerWaves) {
+            glm::vec2 const D{wave.xzDirection_D};
+            float const xyzConstant_1{wave.frequency_w * glm::dot(D, xzGridPosition) + wave.phaseConstant_phi * state.timeInSeconds};
+            float const sinConstant{std::sin(xyzConstant_1)};
+            float const cosConstant{std::cos(xyzConstant_1)};
+            float const xzConstant_1{wave.steepness_Q_i * cosConstant};
+            position += wave.amplitude_A * glm::vec3{D.x * xzConstant_1, sinConstant, D.y * xzConstant_1};
+
+            float const WA{wave.frequency_w * wave.amplitude_A};
+            float const xzDerivativeConstant{wave.steepness_Q_i * WA * sinConstant};
+            float const yDerivativeConstant{WA * cosConstant};
+            out_tangent += glm::vec3{-D.x * D.x * xzDerivativeConstant, D.x * yDerivativeConstant, -D.x * D.y * xzDerivativeConstant};
+            out_bitangent += glm::vec3{-D.x * D.y * xzDerivativeConstant, D.y * yDerivativeConstant, -D.y * D.y * xzDerivativeConstant};
+
+            // d/dt (the phase advances at phi per second)
+            if (nullptr != out_velocity) *out_velocity += wave.phaseConstant_phi * wave.amplitude_A * glm::vec3{-D.x * wave.steepness_Q_i * sinConstant, cosConstant, -D.y * wave.steepness_Q_i * sinConstant};
+        }
+
+        return position;
+    }
+}
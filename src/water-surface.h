@@ -0,0 +1,205 @@
+#ifndef WAVE_TOOL_WATER_SURFACE_H_
+#define WAVE_TOOL_WATER_SURFACE_H_
+
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gerstner-wave.h"
+
+namespace wave_tool {
+    class ThreadPool;
+
+    // CPU copy of the water heightmap (red channel only, as used by water-grid.vert)
+    //NOTE: sampling emulates GL_LINEAR + GL_MIRRORED_REPEAT on the base level, which is what the vertex shader sees
+    struct Heightmap {
+        unsigned int width{0};
+        unsigned int height{0};
+        std::vector<float> intensities; // in range [0.0, 1.0], row-major with row 0 at the bottom (same as the uploaded texture)
+
+        // data is RGBA8 in the same row order as uploaded to GL (i.e. already flipped)
+        static std::shared_ptr<Heightmap> fromRGBA8(unsigned char const* data, unsigned int const width, unsigned int const height);
+        // loads with the same flip as RenderEngine::load2DTexture(), returns null on failure
+        static std::shared_ptr<Heightmap> loadFromFile(std::string const& filePath);
+
+        // bilinear intensity at uv, optionally with the slope (d/du, d/dv) of the bilinear patch (same as textureGather in the shader)
+        float sample(glm::vec2 const& uv, glm::vec2 *out_dIntensity_dUV = nullptr) const;
+    };
+
+    // everything (besides the grid corners) that the water-grid vertex shader reads
+    struct WaterSurfaceState {
+        std::vector<geometry::GerstnerWaveStd140> gerstnerWaves; // packed, so steepness_Q_i is already normalized by the count
+        std::shared_ptr<Heightmap const> heightmap = nullptr; // null disables the heightmap displacement
+        float heightmapDisplacementScale{1.0f};
+        float heightmapSampleScale{0.02f};
+        float verticalBounceWaveDisplacement{0.0f};
+        float timeInSeconds{0.0f};
+    };
+
+    // world-space corners of the projected grid on the base plane (same order as the shader uniforms)
+    struct WaterGridCorners {
+        glm::vec4 bottomLeft;
+        glm::vec4 topLeft;
+        glm::vec4 bottomRight;
+        glm::vec4 topRight;
+    };
+
+    // structure-of-arrays output, gridLength x gridLength vertices in gl_VertexID order
+    struct WaterGridSoA {
+        unsigned int gridLength{0};
+        std::vector<float> positionX;
+        std::vector<float> positionY;
+        std::vector<float> positionZ;
+        std::vector<float> normalX;
+        std::vector<float> normalY;
+        std::vector<float> normalZ;
+
+        void resize(unsigned int const length);
+    };
+
+    // structure-of-arrays batch of water queries at world-space XZ points (e.g. buoys, boats, camera collision)
+    //NOTE: probeX/probeZ are the inputs, the rest are outputs that WaterSurface::queryProbes() sizes to match
+    struct WaterProbeBatch {
+        std::vector<float> probeX;
+        std::vector<float> probeZ;
+        std::vector<float> height; // world-space y of the surface at the probe
+        std::vector<float> normalX;
+        std::vector<float> normalY;
+        std::vector<float> normalZ;
+        std::vector<float> velocityX; // gerstner orbital velocity of the surface point over the probe (the heightmap and vertical bounce don't move with the water)
+        std::vector<float> velocityY;
+        std::vector<float> velocityZ;
+
+        inline std::size_t size() const { return probeX.size(); }
+        // resizes the inputs and the outputs
+        void resize(std::size_t const count);
+    };
+
+    // CPU mirror of the water-grid.vert surface (projected grid interpolation -> gerstner -> heightmap -> vertical bounce, with the analytic normals)
+    //NOTE: this mirrors the default path only (not the finite-difference normals, the FFT ocean, the gerstner atlas or the wave LOD, which is a rendering-only approximation)
+    class WaterSurface {
+        public:
+            inline static std::size_t const PROBE_BLOCK_SIZE{256};
+
+            // the fast path: rows are split across the thread pool, and each row is evaluated one wave at a time over contiguous float arrays with a branch-free sin/cos (so the inner loops auto-vectorize for AVX2/NEON)
+            //NOTE: a null threadPool runs single-threaded
+            static void evaluateGrid(WaterGridCorners const& corners, unsigned int const gridLength, WaterSurfaceState const& state, ThreadPool *threadPool, WaterGridSoA &out_grid);
+            // straight line-by-line port of the shader (scalar, std::sin/cos), used to validate evaluateGrid()
+            static void evaluateGridReference(WaterGridCorners const& corners, unsigned int const gridLength, WaterSurfaceState const& state, WaterGridSoA &out_grid);
+
+            // evaluates a single (undisplaced) grid position with the reference path, returns the displaced position
+            static glm::vec3 evaluatePointReference(glm::vec2 const& xzGridPosition, WaterSurfaceState const& state, glm::vec3 *out_normal = nullptr);
+
+            // gerstner waves move surface points horizontally, so the height over a probe is found by inverting the horizontal displacement (Newton's method on the undisplaced grid position), then evaluating the surface there
+            //NOTE: each iteration costs 1 sin/cos per wave per probe and converges quadratically, 3 is plenty for the steepness the UI allows (0 evaluates directly at the probe, i.e. no inversion)
+            //NOTE: probes are processed in blocks of PROBE_BLOCK_SIZE split across the thread pool (a null threadPool runs single-threaded)
+            static void queryProbes(WaterSurfaceState const& state, unsigned int const iterationCount, ThreadPool *threadPool, WaterProbeBatch &inout_batch);
+            // scalar version of a single probe query, used to validate queryProbes(), returns the surface height
+            static float queryProbeReference(glm::vec2 const& xzProbePosition, WaterSurfaceState const& state, unsigned int const iterationCount, glm::vec3 *out_normal = nullptr, glm::vec3 *out_velocity = nullptr);
+
+            // sin/cos accurate to ~1e-7 (absolute) on [-8192, 8192], written with no branches or calls so that loops calling it can be vectorized
+            // reference: http://www.netlib.org/cephes/ (sinf.c / cosf.c polynomials)
+            static inline void sinCos(float const x, float &out_sin, float &out_cos);
+        private:
+            // tangent frame arrays used by evaluateSurface()
+            inline static std::size_t const SURFACE_SCRATCH_ARRAY_COUNT{5};
+
+            static void evaluateRow(WaterGridCorners const& corners, unsigned int const gridLength, unsigned int const row, WaterSurfaceState const& state, std::vector<float> &scratch, WaterGridSoA &out_grid);
+            static void queryProbeBlock(std::size_t const begin, std::size_t const count, WaterSurfaceState const& state, unsigned int const iterationCount, std::vector<float> &scratch, WaterProbeBatch &inout_batch);
+            // gerstner -> heightmap -> vertical bounce -> normals for count undisplaced grid positions (scratch must hold SURFACE_SCRATCH_ARRAY_COUNT x count floats)
+            static void evaluateSurface(std::size_t const count, float const* gridX, float const* gridZ, WaterSurfaceState const& state, float *scratch,
+                                        float *positionX, float *positionY, float *positionZ, float *normalX, float *normalY, float *normalZ);
+            // the gerstner position + tangent frame (+ the orbital velocity when out_velocity isn't null) at an undisplaced grid position
+            static glm::vec3 evaluateGerstnerReference(glm::vec2 const& xzGridPosition, WaterSurfaceState const& state, glm::vec3 &out_tangent, glm::vec3 &out_bitangent, glm::vec3 *out_velocity = nullptr);
+
+            // the inner loops, split out so that the arrays can be marked __restrict (GCC ignores it on local pointers, and without it the loops need ~45 runtime alias checks and stay scalar)
+            static void initializeSurfaceKernel(std::size_t const count, float const*__restrict const gridX, float const*__restrict const gridZ,
+                                                float *__restrict const positionX, float *__restrict const positionY, float *__restrict const positionZ,
+                                                float *__restrict const tangentX, float *__restrict const tangentY, float *__restrict const tangentZBitangentX,
+                                                float *__restrict const bitangentY, float *__restrict const bitangentZ);
+            static void accumulateGerstnerWaveKernel(std::size_t const count, geometry::GerstnerWaveStd140 const& wave, float const timeInSeconds,
+                                                     float const*__restrict const gridX, float const*__restrict const gridZ,
+                                                     float *__restrict const positionX, float *__restrict const positionY, float *__restrict const positionZ,
+                                                     float *__restrict const tangentX, float *__restrict const tangentY, float *__restrict const tangentZBitangentX,
+                                                     float *__restrict const bitangentY, float *__restrict const bitangentZ);
+            static void finalizeSurfaceKernel(std::size_t const count, float const verticalBounceWaveDisplacement,
+                                              float const*__restrict const tangentX, float const*__restrict const tangentY, float const*__restrict const tangentZBitangentX,
+                                              float const*__restrict const bitangentY, float const*__restrict const bitangentZ,
+                                              float *__restrict const positionY, float *__restrict const normalX, float *__restrict const normalY, float *__restrict const normalZ);
+            // horizontal gerstner position + its (symmetric) jacobian w.r.t. the grid position, accumulated 1 wave at a time (for the probe inversion)
+            static void accumulateGerstnerHorizontalKernel(std::size_t const count, geometry::GerstnerWaveStd140 const& wave, float const timeInSeconds,
+                                                           float const*__restrict const gridX, float const*__restrict const gridZ,
+                                                           float *__restrict const positionX, float *__restrict const positionZ,
+                                                           float *__restrict const dX_dX, float *__restrict const dX_dZ, float *__restrict const dZ_dZ);
+            // 1 newton step: grid -= inverse(jacobian) x (position - probe)
+            static void newtonStepKernel(std::size_t const count, float const*__restrict const probeX, float const*__restrict const probeZ,
+                                         float const*__restrict const positionX, float const*__restrict const positionZ,
+                                         float const*__restrict const dX_dX, float const*__restrict const dX_dZ, float const*__restrict const dZ_dZ,
+                                         float *__restrict const gridX, float *__restrict const gridZ);
+            static void accumulateGerstnerVelocityKernel(std::size_t const count, geometry::GerstnerWaveStd140 const& wave, float const timeInSeconds,
+                                                         float const*__restrict const gridX, float const*__restrict const gridZ,
+                                                         float *__restrict const velocityX, float *__restrict const velocityY, float *__restrict const velocityZ);
+    };
+
+    inline void WaterSurface::sinCos(float const x, float &out_sin, float &out_cos) {
+        float const TWO_OVER_PI{0.636619772367581f};
+        // Cody-Waite split of pi/2
+        float const PI_OVER_2_HI{1.5703125f};
+        float const PI_OVER_2_MID{4.837512969970703125e-4f};
+        float const PI_OVER_2_LO{7.54978995489188216e-8f};
+
+        // round to nearest by adding and removing 1.5 x 2^23 (std::floor/std::round are libm calls without SSE4.1, which blocks vectorization)
+        float const ROUNDING_CONSTANT{12582912.0f};
+        float const quadrant{(x * TWO_OVER_PI + ROUNDING_CONSTANT) - ROUNDING_CONSTANT};
+        float const r{((x - quadrant * PI_OVER_2_HI) - quadrant * PI_OVER_2_MID) - quadrant * PI_OVER_2_LO};
+        float const r2{r * r};
+        float const s{r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f))};
+        float const c{1.0f - 0.5f * r2 + r2 * r2 * (4.166664568298827e-2f + r2 * (-1.388731625493765e-3f + r2 * 2.443315711809948e-5f))};
+
+        // rotate by the quadrant: 0 -> (s, c), 1 -> (c, -s), 2 -> (-s, -c), 3 -> (-c, s)
+        int const q{(int)quadrant & 3};
+        float const swappedSin{(q & 1) ? c : s};
+        float const swappedCos{(q & 1) ? s : c};
+        out_sin = (q & 2) ? -swappedSin : swappedSin;
+        out_cos = ((q + 1) & 2) ? -swappedCos : swappedCos;
+    }
+}
+
+#endif // WAVE_TOOL_WATER_SURFACE_H_
@@ -0,0 +1,126 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+// tests for HeightmapSequence on the shipped multi-frame sequence: it opens as more than 1 frame, the decoder hands the frames over in playback order and keeps looping through them
+// (several times around) without ever leaving the consumer waiting for long, a seek restarts it at the wanted frame, and its memory stays bounded by the queue
+// run with ctest (or directly, with the sequence's printf-style path pattern as the only argument), exits with EXIT_FAILURE if any case fails
+//NOTE: this is the CPU side of the streaming only (what feeds RenderEngine's pixel-unpack buffer ring), so no GL context/window is needed
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "heightmap-sequence.h"
+
+namespace {
+    // far more than a frame takes to decode, so hitting it means the decoder stalled
+    double const MAX_WAIT_IN_MILLISECONDS{2000.0};
+
+    // polls like the render thread would (once per ~1 ms "frame"), returns false on a stall
+    bool waitForFrame(wave_tool::HeightmapSequence &heightmapSequence, wave_tool::HeightmapFrame &out_frame, double &inout_maxWaitInMilliseconds) {
+        std::chrono::steady_clock::time_point const startTime{std::chrono::steady_clock::now()};
+        while (!heightmapSequence.tryPopFrame(out_frame)) {
+            double const waitInMilliseconds{std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count()};
+            if (waitInMilliseconds > MAX_WAIT_IN_MILLISECONDS) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        inout_maxWaitInMilliseconds = std::max(inout_maxWaitInMilliseconds, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count());
+        return true;
+    }
+
+    // 3 times around the loop, every frame in order and of the right size, and no 2 neighbouring frames the same image
+    bool testPlayback(wave_tool::HeightmapSequence &heightmapSequence) {
+        unsigned int const frameCount{heightmapSequence.getFrameCount()};
+        unsigned int const POP_COUNT{3 * frameCount};
+        wave_tool::HeightmapFrame frame;
+        wave_tool::HeightmapFrame previousFrame;
+        double maxWaitInMilliseconds{0.0};
+        unsigned int poppedCount{0};
+        unsigned int outOfOrderCount{0};
+        unsigned int repeatedImageCount{0};
+        std::size_t maxMemoryInBytes{0};
+        for (; poppedCount < POP_COUNT; ++poppedCount) {
+            if (!waitForFrame(heightmapSequence, frame, maxWaitInMilliseconds)) break;
+            if (frame.index != poppedCount % frameCount || frame.texels.size() != heightmapSequence.getFrameSizeInBytes()) ++outOfOrderCount;
+            if (poppedCount > 0 && frame.texels == previousFrame.texels) ++repeatedImageCount;
+            maxMemoryInBytes = std::max(maxMemoryInBytes, heightmapSequence.getMemoryInBytes());
+            std::swap(frame, previousFrame);
+        }
+
+        // queued + being decoded + the recycled spares, not counting the 2 frames held here
+        bool const isMemoryBounded{maxMemoryInBytes <= (wave_tool::HeightmapSequence::DEFAULT_QUEUE_CAPACITY + 2) * heightmapSequence.getFrameSizeInBytes()};
+        bool const isValid{POP_COUNT == poppedCount && 0 == outOfOrderCount && 0 == repeatedImageCount && isMemoryBounded};
+        std::cout << "  playback: " << poppedCount << " of " << POP_COUNT << " frames (" << frameCount << " x 3 loops), " << outOfOrderCount << " out of order, "
+                  << repeatedImageCount << " repeated images, max wait " << maxWaitInMilliseconds << " ms, max memory " << maxMemoryInBytes / 1024 << " KiB -> " << (isValid ? "OK" : "FAILED") << std::endl;
+        return isValid;
+    }
+
+    // the first frame after a seek has to be the one sought (whatever was queued or being decoded before it is thrown away), then playback carries on from there
+    bool testSeek(wave_tool::HeightmapSequence &heightmapSequence) {
+        unsigned int const frameCount{heightmapSequence.getFrameCount()};
+        wave_tool::HeightmapFrame frame;
+        double maxWaitInMilliseconds{0.0};
+        bool isValid{true};
+        for (unsigned int const seekFrame : {frameCount / 2, frameCount - 1, frameCount + 1}) {
+            heightmapSequence.seek(seekFrame);
+            for (unsigned int i = 0; i < 2; ++i) {
+                isValid = isValid && waitForFrame(heightmapSequence, frame, maxWaitInMilliseconds) && frame.index == (seekFrame + i) % frameCount;
+            }
+        }
+        std::cout << "  seek: max wait " << maxWaitInMilliseconds << " ms -> " << (isValid ? "OK" : "FAILED") << std::endl;
+        return isValid;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    std::string const pathPattern{argc > 1 ? argv[1] : "../../assets/textures/noise/waves/waves3/%02u.png"};
+    std::cout << "heightmap-sequence (" << pathPattern << ")" << std::endl;
+    std::unique_ptr<wave_tool::HeightmapSequence> heightmapSequence{wave_tool::HeightmapSequence::open(pathPattern)};
+    if (nullptr == heightmapSequence) {
+        std::cout << "ERROR: heightmap-sequence-tests.cpp - failed to open the sequence!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // a single frame would never exercise the streaming (nothing to cycle to)
+    bool isValid{heightmapSequence->getFrameCount() > 1};
+    std::cout << "  " << heightmapSequence->getFrameCount() << " frames (" << heightmapSequence->getWidth() << " x " << heightmapSequence->getHeight() << " R" << 8 * heightmapSequence->getBytesPerTexel() << ") -> " << (isValid ? "OK" : "FAILED") << std::endl;
+    if (isValid) {
+        isValid = testPlayback(*heightmapSequence) && isValid;
+        isValid = testSeek(*heightmapSequence) && isValid;
+    }
+
+    std::cout << (isValid ? "all heightmap-sequence tests passed" : "ERROR: heightmap-sequence-tests.cpp - some heightmap-sequence tests failed!") << std::endl;
+    return isValid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
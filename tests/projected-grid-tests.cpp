@@ -0,0 +1,157 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+
+// tests for ProjectedGrid::update() at the edge cases of the projector setup (horizon, bird's eye, underwater, inside the displaceable volume, looking away from the water), for both the bounds and the hull quad fit
+// run with ctest (or directly), exits with EXIT_FAILURE if any case fails
+//NOTE: only links wave-tool-projected-grid, so no GL context/window is needed
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include "camera.h"
+#include "projected-grid.h"
+
+namespace {
+    // the same lens as the application's camera
+    float const FOV{72.0f};
+    float const ASPECT{16.0f / 9.0f};
+    float const Z_NEAR{0.1f};
+    float const Z_FAR{100.0f};
+
+    // the corners are ordered bottom-left, top-left, bottom-right, top-right, so the quad's perimeter is [0] -> [2] -> [3] -> [1]
+    bool isInsideGrid(std::array<glm::vec4, 4> const& corners, glm::vec3 const& point) {
+        std::array<glm::vec2, 4> const perimeter{glm::vec2{corners[0].x, corners[0].z}, glm::vec2{corners[2].x, corners[2].z}, glm::vec2{corners[3].x, corners[3].z}, glm::vec2{corners[1].x, corners[1].z}};
+        // inside a convex polygon if on the same side of every edge (for either winding)
+        bool hasPositiveSide{false};
+        bool hasNegativeSide{false};
+        for (unsigned int i = 0; i < perimeter.size(); ++i) {
+            glm::vec2 const edge{perimeter[(i + 1) % perimeter.size()] - perimeter[i]};
+            glm::vec2 const toPoint{glm::vec2{point.x, point.z} - perimeter[i]};
+            float const side{edge.x * toPoint.y - edge.y * toPoint.x};
+            if (side > 0.0f) hasPositiveSide = true;
+            else if (side < 0.0f) hasNegativeSide = true;
+        }
+        return !(hasPositiveSide && hasNegativeSide);
+    }
+
+    // each case either expects the water to be out of view, or gives a world-space point on the base plane that the camera sees (which the grid must cover)
+    bool testEdgeCases(float const displaceableAmplitude, bool const isUsingHullFit) {
+        struct EdgeCase {
+            char const* name;
+            glm::vec3 position;
+            float pitchDegrees;
+            bool isVisible;
+            glm::vec3 visibleBasePlanePoint;
+        };
+        float const BELOW_VOLUME{-5.0f - displaceableAmplitude};
+        std::array<EdgeCase, 8> const edgeCases{EdgeCase{"above, horizon", glm::vec3{0.0f, 4.0f, 70.0f}, 0.0f, true, glm::vec3{0.0f, 0.0f, 50.0f}},
+                                                EdgeCase{"above, bird's eye", glm::vec3{0.0f, 30.0f, 0.0f}, -89.0f, true, glm::vec3{0.0f, 0.0f, 0.0f}},
+                                                EdgeCase{"above, looking at the sky", glm::vec3{0.0f, 50.0f, 0.0f}, 60.0f, false, glm::vec3{0.0f}},
+                                                EdgeCase{"on the base plane, horizon", glm::vec3{0.0f, 0.0f, 0.0f}, 0.0f, true, glm::vec3{0.0f, 0.0f, -20.0f}},
+                                                EdgeCase{"inside the displaceable volume", glm::vec3{0.0f, 0.5f * displaceableAmplitude, 0.0f}, -10.0f, true, glm::vec3{0.0f, 0.0f, -10.0f}},
+                                                EdgeCase{"underwater, horizon", glm::vec3{0.0f, BELOW_VOLUME, 0.0f}, 0.0f, true, glm::vec3{0.0f, 0.0f, -30.0f}},
+                                                EdgeCase{"underwater, looking up", glm::vec3{0.0f, BELOW_VOLUME, 0.0f}, 89.0f, true, glm::vec3{0.0f, 0.0f, 0.0f}},
+                                                EdgeCase{"underwater, looking down", glm::vec3{0.0f, BELOW_VOLUME, 0.0f}, -60.0f, false, glm::vec3{0.0f}}};
+
+        bool isValid{true};
+        for (EdgeCase const& edgeCase : edgeCases) {
+            wave_tool::Camera camera{FOV, ASPECT, Z_NEAR, Z_FAR, edgeCase.position};
+            camera.setRotation(wave_tool::Camera::DEFAULT_YAW, edgeCase.pitchDegrees);
+            wave_tool::ProjectedGrid projectedGrid;
+            projectedGrid.isUsingHullFit = isUsingHullFit;
+            bool const isVisible{projectedGrid.update(camera, displaceableAmplitude)};
+
+            bool isCaseValid{isVisible == edgeCase.isVisible && projectedGrid.getIntersectionPointCount() <= wave_tool::ProjectedGrid::MAX_INTERSECTION_POINT_COUNT};
+            if (isVisible) {
+                for (glm::vec4 const& corner : projectedGrid.getCornerPoints()) {
+                    isCaseValid = isCaseValid && std::isfinite(corner.x) && std::isfinite(corner.z) && std::abs(corner.y) <= 1.0e-3f;
+                }
+                isCaseValid = isCaseValid && isInsideGrid(projectedGrid.getCornerPoints(), edgeCase.visibleBasePlanePoint);
+            }
+            isValid = isValid && isCaseValid;
+            std::cout << "  " << edgeCase.name << ": " << (isVisible ? "visible" : "not visible") << ", " << projectedGrid.getIntersectionPointCount() << " intersection points, "
+                      << projectedGrid.getHullPointCount() << " hull points -> " << (isCaseValid ? "OK" : "FAILED") << std::endl;
+        }
+        return isValid;
+    }
+
+    // over a sweep of camera heights/orientations, the grid must still cover all of the base plane the camera sees
+    //NOTE: the coverage is sampled on a 9 x 9 grid of the camera's NDC-space (every sample whose ray hits the base plane before the far plane must be inside the grid)
+    bool testCoverage(float const displaceableAmplitude, bool const isUsingHullFit) {
+        unsigned int const SWEEP_COUNT{2000};
+        std::array<glm::vec3, 3> const SWEEP_POSITIONS{glm::vec3{0.0f, 1.0f + displaceableAmplitude, 0.0f}, glm::vec3{0.0f, 4.0f, 70.0f}, glm::vec3{0.0f, 30.0f, 0.0f}};
+        wave_tool::ProjectedGrid projectedGrid;
+        projectedGrid.isUsingHullFit = isUsingHullFit;
+        unsigned int visibleCount{0};
+        unsigned int uncoveredCount{0};
+        for (unsigned int sweep = 0; sweep < SWEEP_COUNT; ++sweep) {
+            wave_tool::Camera camera{FOV, ASPECT, Z_NEAR, Z_FAR, SWEEP_POSITIONS[sweep % SWEEP_POSITIONS.size()]};
+            camera.setRotation(sweep * 0.37f, -89.0f + 178.0f * ((sweep * 7919u) % 1000u) / 1000.0f);
+            if (!projectedGrid.update(camera, displaceableAmplitude)) continue;
+            ++visibleCount;
+
+            glm::mat4 const inverseViewProjection{glm::inverse(camera.getProjectionMat() * camera.getViewMat())};
+            for (unsigned int sample = 0; sample < 81; ++sample) {
+                glm::vec4 near{inverseViewProjection * glm::vec4{-1.0f + 0.25f * (sample % 9), -1.0f + 0.25f * (sample / 9), -1.0f, 1.0f}};
+                glm::vec4 far{inverseViewProjection * glm::vec4{-1.0f + 0.25f * (sample % 9), -1.0f + 0.25f * (sample / 9), 1.0f, 1.0f}};
+                near /= near.w;
+                far /= far.w;
+                if ((near.y > 0.0f) == (far.y > 0.0f)) continue;
+                glm::vec4 const basePlanePoint{glm::mix(near, far, near.y / (near.y - far.y))};
+                if (!isInsideGrid(projectedGrid.getCornerPoints(), glm::vec3{basePlanePoint})) ++uncoveredCount;
+            }
+        }
+        std::cout << "  coverage sweep: " << visibleCount << " of " << SWEEP_COUNT << " views visible, " << uncoveredCount << " uncovered samples -> " << (0 == uncoveredCount ? "OK" : "FAILED") << std::endl;
+        return 0 == uncoveredCount;
+    }
+}
+
+int main() {
+    bool isValid{true};
+    // a calm sea, the application's default and a rough sea (the volume's thickness moves the underwater/inside cases around)
+    for (float const displaceableAmplitude : {0.5f, 2.0f, 8.0f}) {
+        // both fits (the axis-aligned bounds, then the hull quad) must pass every case
+        for (bool const isUsingHullFit : {false, true}) {
+            std::cout << "projected-grid (" << (isUsingHullFit ? "hull quad" : "bounds") << ", displaceable amplitude " << displaceableAmplitude << ")" << std::endl;
+            isValid = testEdgeCases(displaceableAmplitude, isUsingHullFit) && isValid;
+            isValid = testCoverage(displaceableAmplitude, isUsingHullFit) && isValid;
+        }
+    }
+
+    std::cout << (isValid ? "all projected-grid tests passed" : "ERROR: projected-grid-tests.cpp - some projected-grid tests failed!") << std::endl;
+    return isValid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,162 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+// tests for RenderQueue's sort order: the key's fields order the draws by program, texture, VAO, polygon mode, primitive mode then depth (front-to-back), ties keep the render list order,
+// and a random stress scene (like --benchmark render-queue's) comes out with every visible object exactly once, in key order
+// run with ctest (or directly), exits with EXIT_FAILURE if any case fails
+//NOTE: the queue makes no GL calls (the GL types/enums come from the glad header), so no GL context/window is needed
+
+#include <glad/glad.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "render-queue.h"
+
+namespace {
+    bool report(char const* name, bool const isValid) {
+        std::cout << "  " << name << " -> " << (isValid ? "OK" : "FAILED") << std::endl;
+        return isValid;
+    }
+
+    // each field has to outrank everything less significant than it, even at their largest
+    bool testKeyFieldOrder() {
+        wave_tool::DrawState const low{1, 1, 1, GL_POINT, GL_POINTS};
+        wave_tool::DrawState const high{1, 0xFFF, 0xFFF, GL_FILL, GL_TRIANGLES};
+        float const FAR_DEPTH{1.0e6f};
+        auto const isBefore = [](wave_tool::DrawState const& a, float const depthA, wave_tool::DrawState const& b, float const depthB) {
+            return wave_tool::RenderQueue::makeSortKey(a, depthA) < wave_tool::RenderQueue::makeSortKey(b, depthB);
+        };
+
+        bool isValid{true};
+        isValid = report("program before texture/VAO/modes/depth", isBefore(high, FAR_DEPTH, wave_tool::DrawState{2, 1, 1, GL_POINT, GL_POINTS}, 0.0f)) && isValid;
+        isValid = report("texture before VAO/modes/depth", isBefore(wave_tool::DrawState{1, 1, 0xFFF, GL_FILL, GL_TRIANGLES}, FAR_DEPTH, wave_tool::DrawState{1, 2, 1, GL_POINT, GL_POINTS}, 0.0f)) && isValid;
+        isValid = report("VAO before modes/depth", isBefore(wave_tool::DrawState{1, 1, 1, GL_FILL, GL_TRIANGLES}, FAR_DEPTH, wave_tool::DrawState{1, 1, 2, GL_POINT, GL_POINTS}, 0.0f)) && isValid;
+        isValid = report("polygon mode before primitive mode/depth", isBefore(wave_tool::DrawState{1, 1, 1, GL_POINT, GL_TRIANGLES}, FAR_DEPTH, wave_tool::DrawState{1, 1, 1, GL_LINE, GL_POINTS}, 0.0f)) && isValid;
+        isValid = report("primitive mode before depth", isBefore(wave_tool::DrawState{1, 1, 1, GL_FILL, GL_POINTS}, FAR_DEPTH, wave_tool::DrawState{1, 1, 1, GL_FILL, GL_LINES}, 0.0f)) && isValid;
+        isValid = report("same state front-to-back", isBefore(low, 0.5f, low, 1.0f) && isBefore(low, 1.0f, low, 100.0f) && isBefore(low, 100.0f, low, FAR_DEPTH)) && isValid;
+        // behind the camera clamps to the camera
+        isValid = report("negative depth clamps to 0", wave_tool::RenderQueue::makeSortKey(low, -5.0f) == wave_tool::RenderQueue::makeSortKey(low, 0.0f)) && isValid;
+        return isValid;
+    }
+
+    bool testRuns() {
+        wave_tool::DrawState const a{1, 3, 7, GL_FILL, GL_TRIANGLES};
+        wave_tool::DrawState const otherVAO{1, 3, 8, GL_FILL, GL_TRIANGLES};
+        wave_tool::DrawState const otherTexture{1, 4, 7, GL_FILL, GL_TRIANGLES};
+        wave_tool::DrawState const otherPolygonMode{1, 3, 7, GL_LINE, GL_TRIANGLES};
+        return report("runs split on any state but the (ignored) VAO", wave_tool::RenderQueue::isSameRun(a, a, false) && !wave_tool::RenderQueue::isSameRun(a, otherVAO, false) && wave_tool::RenderQueue::isSameRun(a, otherVAO, true)
+                                                                       && !wave_tool::RenderQueue::isSameRun(a, otherTexture, true) && !wave_tool::RenderQueue::isSameRun(a, otherPolygonMode, true));
+    }
+
+    // equal keys (the same state at the same depth, or depths closer than the key's precision) keep the order they were pushed in
+    bool testTies() {
+        wave_tool::DrawState const state{1, 1, 1, GL_FILL, GL_TRIANGLES};
+        wave_tool::RenderQueue renderQueue;
+        renderQueue.push(0, state, 10.0f);
+        renderQueue.push(1, state, 5.0f);
+        renderQueue.push(2, state, 10.0f);
+        renderQueue.push(3, state, std::nextafter(5.0f, 6.0f));
+        renderQueue.push(4, wave_tool::DrawState{0, 1, 1, GL_FILL, GL_TRIANGLES}, 20.0f);
+        renderQueue.sort();
+        std::vector<std::uint32_t> order;
+        for (wave_tool::RenderQueue::Item const& item : renderQueue.getItems()) order.push_back(item.objectIndex);
+        bool isValid{std::vector<std::uint32_t>{4, 1, 3, 0, 2} == order};
+
+        // and clearing starts the next frame empty
+        renderQueue.clear();
+        isValid = isValid && renderQueue.getItems().empty();
+        return report("ties keep the render list order", isValid);
+    }
+
+    // a scene like the benchmark's: 2 programs, 16 textures (main program only), 3 polygon modes, every object with its own VAO (or a shared one, as when batched), ~10% culled
+    bool testStressScene(unsigned int const objectCount, bool const isSharingVAO) {
+        std::mt19937 randomEngine{1234 + objectCount};
+        std::uniform_real_distribution<float> unitDistribution{0.0f, 1.0f};
+        std::uniform_int_distribution<unsigned int> textureDistribution{1, 16};
+        std::vector<wave_tool::DrawState> states;
+        std::vector<float> depths;
+        std::vector<bool> isVisible;
+        for (unsigned int objectIndex = 0; objectIndex < objectCount; ++objectIndex) {
+            bool const isMainProgram{unitDistribution(randomEngine) < 0.9f};
+            float const polygonModeRoll{unitDistribution(randomEngine)};
+            GLenum const polygonMode{polygonModeRoll < 0.9f ? (GLenum)GL_FILL : (polygonModeRoll < 0.95f ? (GLenum)GL_LINE : (GLenum)GL_POINT)};
+            states.push_back(wave_tool::DrawState{isMainProgram ? 1u : 2u, isMainProgram ? textureDistribution(randomEngine) : 0, isSharingVAO ? objectCount + 1 : objectIndex + 1, polygonMode, GL_TRIANGLES});
+            depths.push_back(1.0f + 999.0f * unitDistribution(randomEngine));
+            isVisible.push_back(unitDistribution(randomEngine) < 0.9f);
+        }
+
+        wave_tool::RenderQueue renderQueue;
+        for (unsigned int objectIndex = 0; objectIndex < objectCount; ++objectIndex) {
+            if (isVisible.at(objectIndex)) renderQueue.push(objectIndex, states.at(objectIndex), depths.at(objectIndex));
+        }
+        renderQueue.sort();
+
+        // every visible object exactly once, in key order, with the draws of the same state front-to-back
+        bool isValid{true};
+        std::vector<wave_tool::RenderQueue::Item> const& items{renderQueue.getItems()};
+        std::vector<bool> isQueued(objectCount, false);
+        for (std::size_t itemIndex = 0; itemIndex < items.size(); ++itemIndex) {
+            wave_tool::RenderQueue::Item const& item{items.at(itemIndex)};
+            isValid = isValid && isVisible.at(item.objectIndex) && !isQueued.at(item.objectIndex);
+            isQueued.at(item.objectIndex) = true;
+            if (itemIndex > 0) {
+                wave_tool::RenderQueue::Item const& previousItem{items.at(itemIndex - 1)};
+                isValid = isValid && previousItem.sortKey <= item.sortKey;
+                //NOTE: depths closer than the key's depth precision tie (and keep the render list order)
+                if (wave_tool::RenderQueue::isSameRun(previousItem.state, item.state, false)) {
+                    isValid = isValid && (previousItem.sortKey != item.sortKey ? depths.at(previousItem.objectIndex) < depths.at(item.objectIndex) : previousItem.objectIndex < item.objectIndex);
+                }
+            }
+        }
+        for (unsigned int objectIndex = 0; objectIndex < objectCount; ++objectIndex) isValid = isValid && isQueued.at(objectIndex) == isVisible.at(objectIndex);
+
+        std::cout << "  " << objectCount << " objects (" << items.size() << " visible, " << (isSharingVAO ? "shared VAO" : "own VAOs") << ") -> " << (isValid ? "OK" : "FAILED") << std::endl;
+        return isValid;
+    }
+}
+
+int main() {
+    std::cout << "render-queue" << std::endl;
+    bool isValid{testKeyFieldOrder()};
+    isValid = testRuns() && isValid;
+    isValid = testTies() && isValid;
+    for (unsigned int const objectCount : {1000u, 10000u}) {
+        for (bool const isSharingVAO : {false, true}) isValid = testStressScene(objectCount, isSharingVAO) && isValid;
+    }
+
+    std::cout << (isValid ? "all render-queue tests passed" : "ERROR: render-queue-tests.cpp - some render-queue tests failed!") << std::endl;
+    return isValid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
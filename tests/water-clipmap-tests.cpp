@@ -0,0 +1,230 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+
+// tests for WaterClipmap: the shared index buffer's tile ranges and counts, the level placement for the edge cases of the camera (horizon, bird's eye, underwater, inside the displaceable volume, looking away from the water)
+// and the tile culling (no tile that the camera sees any of the base plane through is culled, and the drawn ranges add up to the reported counts)
+// run with ctest (or directly), exits with EXIT_FAILURE if any case fails
+//NOTE: only links the non-GL libraries (the camera comes from wave-tool-projected-grid), so no GL context/window is needed
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "camera.h"
+#include "water-clipmap.h"
+
+namespace {
+    // the same lens as the application's camera
+    float const FOV{72.0f};
+    float const ASPECT{16.0f / 9.0f};
+    float const Z_NEAR{0.1f};
+    float const Z_FAR{100.0f};
+    float const CELL_COUNT{(float)wave_tool::WaterClipmap::CELL_COUNT};
+
+    using TileRanges = std::array<std::array<wave_tool::WaterClipmap::TileRange, wave_tool::WaterClipmap::TILE_COUNT>, wave_tool::WaterClipmap::VARIANT_COUNT>;
+
+    // the ranges must tile the index buffer in order, whole cells at a time, and only reference grid vertices
+    bool testIndexBuffer(TileRanges &out_tileRanges) {
+        std::vector<unsigned int> indices;
+        wave_tool::WaterClipmap::generateTriangleIndices(indices, out_tileRanges);
+        bool isValid{indices.size() == wave_tool::WaterClipmap::getIndexCount()};
+        unsigned int nextFirstIndex{0};
+        for (unsigned int variant = 0; variant < wave_tool::WaterClipmap::VARIANT_COUNT; ++variant) {
+            unsigned int variantIndexCount{0};
+            for (wave_tool::WaterClipmap::TileRange const& range : out_tileRanges.at(variant)) {
+                isValid = isValid && range.firstIndex == nextFirstIndex && 0 == range.indexCount % 6 && range.vertexCount <= range.indexCount;
+                nextFirstIndex = range.firstIndex + range.indexCount;
+                variantIndexCount += range.indexCount;
+            }
+            // the whole grid, or the ring missing the centre quarter of its cells
+            unsigned int const cellCount{0 == variant ? wave_tool::WaterClipmap::CELL_COUNT * wave_tool::WaterClipmap::CELL_COUNT
+                                                      : wave_tool::WaterClipmap::CELL_COUNT * wave_tool::WaterClipmap::CELL_COUNT - (wave_tool::WaterClipmap::CELL_COUNT / 2) * (wave_tool::WaterClipmap::CELL_COUNT / 2)};
+            isValid = isValid && 6 * cellCount == variantIndexCount;
+        }
+        isValid = isValid && nextFirstIndex == indices.size() && *std::max_element(indices.begin(), indices.end()) < wave_tool::WaterClipmap::getGridLength() * wave_tool::WaterClipmap::getGridLength();
+        std::cout << "  index buffer: " << indices.size() << " indices in " << wave_tool::WaterClipmap::VARIANT_COUNT * wave_tool::WaterClipmap::TILE_COUNT << " tile ranges -> " << (isValid ? "OK" : "FAILED") << std::endl;
+        return isValid;
+    }
+
+    // the drawn (merged) ranges of every level must add up to the reported counts, and no update can cull more tiles than it has
+    bool isDrawListValid(wave_tool::WaterClipmap const& waterClipmap, bool const isVisible) {
+        unsigned int drawnIndexCount{0};
+        for (unsigned int i = 0; i < waterClipmap.getLevelCount(); ++i) {
+            wave_tool::WaterClipmap::Level const& level{waterClipmap.getLevel(i)};
+            for (unsigned int draw = 0; draw < level.drawCount; ++draw) drawnIndexCount += (unsigned int)level.indexCounts.at(draw);
+        }
+        return 3 * waterClipmap.getTriangleCount() == drawnIndexCount && waterClipmap.getCulledTileCount() <= waterClipmap.getTileCount()
+               && isVisible == (waterClipmap.getCulledTileCount() < waterClipmap.getTileCount());
+    }
+
+    // true if the tile under the base plane point (of the finest level containing it) is drawn
+    //NOTE: false if no level reaches the point at all
+    bool isPointDrawn(wave_tool::WaterClipmap const& waterClipmap, TileRanges const& tileRanges, glm::vec2 const& pointXZ) {
+        unsigned int const TILE_CELL_COUNT{wave_tool::WaterClipmap::CELL_COUNT / wave_tool::WaterClipmap::TILES_PER_SIDE};
+        for (unsigned int i = 0; i < waterClipmap.getLevelCount(); ++i) {
+            wave_tool::WaterClipmap::Level const& level{waterClipmap.getLevel(i)};
+            glm::vec2 const cell{(pointXZ - level.origin) / level.cellSize};
+            if (cell.x < 0.0f || cell.y < 0.0f || cell.x > CELL_COUNT || cell.y > CELL_COUNT) continue;
+
+            unsigned int const tileCol{std::min((unsigned int)cell.x / TILE_CELL_COUNT, wave_tool::WaterClipmap::TILES_PER_SIDE - 1)};
+            unsigned int const tileRow{std::min((unsigned int)cell.y / TILE_CELL_COUNT, wave_tool::WaterClipmap::TILES_PER_SIDE - 1)};
+            wave_tool::WaterClipmap::TileRange const& range{tileRanges.at(level.variant).at(tileCol + wave_tool::WaterClipmap::TILES_PER_SIDE * tileRow)};
+            for (unsigned int draw = 0; draw < level.drawCount; ++draw) {
+                if (range.firstIndex >= level.firstIndices.at(draw) && range.firstIndex + range.indexCount <= level.firstIndices.at(draw) + (unsigned int)level.indexCounts.at(draw)) return true;
+            }
+            return false;
+        }
+        return false;
+    }
+
+    // every level has to exactly fill its parent's hole, the camera has to be inside the finest level, and the morph has to finish before a level's outer edge (and not start before its hole)
+    bool isLevelPlacementValid(wave_tool::WaterClipmap const& waterClipmap, glm::vec3 const& cameraPosition) {
+        glm::vec2 const cameraXZ{cameraPosition.x, cameraPosition.z};
+        bool isValid{waterClipmap.getLevelCount() > 0};
+        for (unsigned int i = 0; isValid && i < waterClipmap.getLevelCount(); ++i) {
+            wave_tool::WaterClipmap::Level const& level{waterClipmap.getLevel(i)};
+            float const tolerance{1.0e-4f * level.cellSize};
+            glm::vec2 const levelMin{level.origin};
+            glm::vec2 const levelMax{level.origin + CELL_COUNT * level.cellSize};
+            // the nearest the camera gets to the level's outer edge (chessboard distance)
+            float const outerEdgeDistance{glm::min(glm::min(cameraXZ.x - levelMin.x, levelMax.x - cameraXZ.x), glm::min(cameraXZ.y - levelMin.y, levelMax.y - cameraXZ.y))};
+            if (0 == i) {
+                isValid = isValid && 0 == level.variant && outerEdgeDistance > 0.0f;
+            } else {
+                wave_tool::WaterClipmap::Level const& finerLevel{waterClipmap.getLevel(i - 1)};
+                glm::vec2 const holeMin{level.origin + (glm::vec2{(float)((level.variant - 1) % 2), (float)((level.variant - 1) / 2)} + 0.25f * CELL_COUNT) * level.cellSize};
+                glm::vec2 const finerMax{finerLevel.origin + CELL_COUNT * finerLevel.cellSize};
+                // the furthest the camera gets from the hole's edge (chessboard distance)
+                float const holeEdgeDistance{glm::max(glm::max(cameraXZ.x - finerLevel.origin.x, finerMax.x - cameraXZ.x), glm::max(cameraXZ.y - finerLevel.origin.y, finerMax.y - cameraXZ.y))};
+                isValid = isValid && 0 != level.variant && std::abs(level.cellSize - 2.0f * finerLevel.cellSize) <= tolerance
+                          && std::abs(holeMin.x - finerLevel.origin.x) <= tolerance && std::abs(holeMin.y - finerLevel.origin.y) <= tolerance
+                          && finerLevel.morphEndDistance <= glm::min(glm::min(cameraXZ.x - finerLevel.origin.x, finerMax.x - cameraXZ.x), glm::min(cameraXZ.y - finerLevel.origin.y, finerMax.y - cameraXZ.y)) + tolerance
+                          && level.morphStartDistance > holeEdgeDistance;
+            }
+        }
+        wave_tool::WaterClipmap::Level const& coarsestLevel{waterClipmap.getLevel(waterClipmap.getLevelCount() - 1)};
+        return isValid && (0.5f * CELL_COUNT - 2.0f) * coarsestLevel.cellSize >= Z_FAR;
+    }
+
+    bool testEdgeCases(float const displaceableAmplitude, float const baseCellSize) {
+        struct EdgeCase {
+            char const* name;
+            glm::vec3 position;
+            float pitchDegrees;
+            bool isVisible;
+        };
+        float const BELOW_VOLUME{-5.0f - displaceableAmplitude};
+        std::array<EdgeCase, 7> const edgeCases{EdgeCase{"above, horizon", glm::vec3{0.0f, 4.0f, 70.0f}, 0.0f, true},
+                                                EdgeCase{"above, bird's eye (off-grid position)", glm::vec3{12.34f, 30.0f, -7.71f}, -89.0f, true},
+                                                EdgeCase{"above, looking at the sky", glm::vec3{0.0f, 50.0f, 0.0f}, 60.0f, false},
+                                                EdgeCase{"on the base plane, horizon", glm::vec3{-3.21f, 0.0f, 0.55f}, 0.0f, true},
+                                                EdgeCase{"inside the displaceable volume", glm::vec3{0.0f, 0.5f * displaceableAmplitude, 0.0f}, -10.0f, true},
+                                                EdgeCase{"underwater, looking up", glm::vec3{0.0f, BELOW_VOLUME, 0.0f}, 89.0f, true},
+                                                EdgeCase{"underwater, looking down", glm::vec3{0.0f, BELOW_VOLUME, 0.0f}, -60.0f, false}};
+
+        bool isValid{true};
+        wave_tool::WaterClipmap waterClipmap;
+        for (EdgeCase const& edgeCase : edgeCases) {
+            wave_tool::Camera camera{FOV, ASPECT, Z_NEAR, Z_FAR, edgeCase.position};
+            camera.setRotation(wave_tool::Camera::DEFAULT_YAW, edgeCase.pitchDegrees);
+            bool const isVisible{waterClipmap.update(camera.getPosition(), camera.getProjectionMat() * camera.getViewMat(), displaceableAmplitude, baseCellSize, Z_FAR)};
+
+            bool const isCaseValid{isVisible == edgeCase.isVisible && isLevelPlacementValid(waterClipmap, edgeCase.position) && isDrawListValid(waterClipmap, isVisible)};
+            isValid = isValid && isCaseValid;
+            std::cout << "  " << edgeCase.name << ": " << (isVisible ? "visible" : "not visible") << ", " << waterClipmap.getLevelCount() << " levels, "
+                      << waterClipmap.getTileCount() - waterClipmap.getCulledTileCount() << " of " << waterClipmap.getTileCount() << " tiles -> " << (isCaseValid ? "OK" : "FAILED") << std::endl;
+        }
+        return isValid;
+    }
+
+    // over a sweep of camera positions/orientations, every tile the camera sees some of the base plane through must be drawn
+    //NOTE: the base plane is sampled on a 9 x 9 grid of the camera's NDC-space (every sample whose ray hits it before the far plane)
+    bool testTileCulling(TileRanges const& tileRanges, float const displaceableAmplitude, float const baseCellSize) {
+        unsigned int const SWEEP_COUNT{1000};
+        wave_tool::WaterClipmap waterClipmap;
+        wave_tool::Camera camera{FOV, ASPECT, Z_NEAR, Z_FAR, glm::vec3{0.0f, 4.0f, 70.0f}};
+        unsigned int visibleCount{0};
+        unsigned int culledTileCount{0};
+        unsigned int invalidCount{0};
+        unsigned int uncoveredCount{0};
+        for (unsigned int sweep = 0; sweep < SWEEP_COUNT; ++sweep) {
+            // wander around (and up/down through the volume), so that every ring variant is hit
+            float const height{-5.0f + 40.0f * ((sweep * 4513u) % 1000u) / 1000.0f};
+            camera.translate(glm::vec3{0.37f, height - camera.getPosition().y, -0.23f});
+            camera.setRotation(sweep * 0.37f, -89.0f + 178.0f * ((sweep * 7919u) % 1000u) / 1000.0f);
+            glm::mat4 const viewProjection{camera.getProjectionMat() * camera.getViewMat()};
+            bool const isVisible{waterClipmap.update(camera.getPosition(), viewProjection, displaceableAmplitude, baseCellSize, Z_FAR)};
+            if (!isDrawListValid(waterClipmap, isVisible)) ++invalidCount;
+            culledTileCount += waterClipmap.getCulledTileCount();
+            if (!isVisible) continue;
+            ++visibleCount;
+
+            glm::mat4 const inverseViewProjection{glm::inverse(viewProjection)};
+            for (unsigned int sample = 0; sample < 81; ++sample) {
+                glm::vec4 near{inverseViewProjection * glm::vec4{-1.0f + 0.25f * (sample % 9), -1.0f + 0.25f * (sample / 9), -1.0f, 1.0f}};
+                glm::vec4 far{inverseViewProjection * glm::vec4{-1.0f + 0.25f * (sample % 9), -1.0f + 0.25f * (sample / 9), 1.0f, 1.0f}};
+                near /= near.w;
+                far /= far.w;
+                if ((near.y > 0.0f) == (far.y > 0.0f)) continue;
+                glm::vec4 const basePlanePoint{glm::mix(near, far, near.y / (near.y - far.y))};
+                if (!isPointDrawn(waterClipmap, tileRanges, glm::vec2{basePlanePoint.x, basePlanePoint.z})) ++uncoveredCount;
+            }
+        }
+        bool const isValid{0 == invalidCount && 0 == uncoveredCount};
+        std::cout << "  tile culling sweep: " << visibleCount << " of " << SWEEP_COUNT << " views visible, " << culledTileCount << " tiles culled, " << invalidCount << " invalid draw lists, "
+                  << uncoveredCount << " samples on culled tiles -> " << (isValid ? "OK" : "FAILED") << std::endl;
+        return isValid;
+    }
+}
+
+int main() {
+    std::cout << "water-clipmap" << std::endl;
+    TileRanges tileRanges;
+    bool isValid{testIndexBuffer(tileRanges)};
+    // a calm sea, the application's default and a rough sea, each with the default and a coarser base cell size
+    for (float const displaceableAmplitude : {0.5f, 2.0f, 8.0f}) {
+        for (float const baseCellSize : {0.05f, 0.2f}) {
+            std::cout << "water-clipmap (displaceable amplitude " << displaceableAmplitude << ", base cell size " << baseCellSize << ")" << std::endl;
+            isValid = testEdgeCases(displaceableAmplitude, baseCellSize) && isValid;
+            isValid = testTileCulling(tileRanges, displaceableAmplitude, baseCellSize) && isValid;
+        }
+    }
+
+    std::cout << (isValid ? "all water-clipmap tests passed" : "ERROR: water-clipmap-tests.cpp - some water-clipmap tests failed!") << std::endl;
+    return isValid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
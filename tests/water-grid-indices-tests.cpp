@@ -0,0 +1,157 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+// tests for WaterGrid's index layouts: every IndexLayout has to make exactly the triangles of the original row-by-row list (same winding), fit its declared size and stay 16-bit where it claims to,
+// and the FIFO cache simulation behind computeAverageCacheMissRatio() has to count misses/triangles as expected
+// run with ctest (or directly), exits with EXIT_FAILURE if any case fails
+//NOTE: only the index generation is linked (the GL types/enums come from the glad header), so no GL context/window is needed
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "water-grid.h"
+
+namespace {
+    // every (non-degenerate) triangle as its 3 (absolute) vertex indices, rotated so the smallest comes first (keeping the winding), then sorted
+    using Triangle = std::array<GLuint, 3>;
+
+    void collectTriangles(std::vector<GLuint> const& indices, wave_tool::WaterGrid::IndexLayout const indexLayout, unsigned int const bandCount, GLuint const bandVertexStride, std::vector<Triangle> &out_triangles) {
+        out_triangles.clear();
+        auto const addTriangle = [&out_triangles](GLuint const v0, GLuint const v1, GLuint const v2) {
+            if (v0 == v1 || v1 == v2 || v2 == v0) return;
+            GLuint const smallest{std::min({v0, v1, v2})};
+            out_triangles.push_back(smallest == v0 ? Triangle{v0, v1, v2} : (smallest == v1 ? Triangle{v1, v2, v0} : Triangle{v2, v0, v1}));
+        };
+        for (unsigned int band = 0; band < bandCount; ++band) {
+            GLuint const baseVertex{band * bandVertexStride};
+            if (wave_tool::WaterGrid::IndexLayout::TILED_STRIP == indexLayout) {
+                // odd triangles of a strip are flipped to keep the winding
+                std::size_t stripStart{0};
+                for (std::size_t i = 0; i <= indices.size(); ++i) {
+                    if (i < indices.size() && wave_tool::WaterGrid::PRIMITIVE_RESTART_INDEX != indices[i]) continue;
+                    for (std::size_t v = stripStart; v + 2 < i; ++v) {
+                        if (0 == (v - stripStart) % 2) addTriangle(baseVertex + indices[v], baseVertex + indices[v + 1], baseVertex + indices[v + 2]);
+                        else addTriangle(baseVertex + indices[v + 1], baseVertex + indices[v], baseVertex + indices[v + 2]);
+                    }
+                    stripStart = i + 1;
+                }
+            } else {
+                for (std::size_t i = 0; i + 2 < indices.size(); i += 3) addTriangle(baseVertex + indices[i], baseVertex + indices[i + 1], baseVertex + indices[i + 2]);
+            }
+        }
+        std::sort(out_triangles.begin(), out_triangles.end());
+    }
+
+    char const* getLayoutName(wave_tool::WaterGrid::IndexLayout const indexLayout) {
+        return wave_tool::WaterGrid::IndexLayout::ROW_LIST == indexLayout ? "row list" : (wave_tool::WaterGrid::IndexLayout::TILED_LIST == indexLayout ? "tiled list" : "tiled strip");
+    }
+
+    // the reference (row list) has to be every cell's 2 triangles exactly once, and the tiled layouts exactly the same triangles
+    //NOTE: the tiled layouts should also beat the row list's ACMR on a 16/32-entry FIFO cache (that is their point), and no layout can do better than transforming every vertex once
+    bool testLayouts() {
+        bool isValid{true};
+        std::vector<GLuint> indices;
+        std::vector<Triangle> referenceTriangles;
+        std::vector<Triangle> triangles;
+        for (unsigned int level = 0; level < wave_tool::WaterGrid::getLevelCount(); ++level) {
+            GLuint const gridLength{wave_tool::WaterGrid::getGridLength(level)};
+            std::array<float, 2> referenceACMRs{};
+            std::cout << "  " << gridLength << " x " << gridLength << " (" << wave_tool::WaterGrid::getTriangleCount(level) << " triangles):" << std::endl;
+            for (wave_tool::WaterGrid::IndexLayout const indexLayout : {wave_tool::WaterGrid::IndexLayout::ROW_LIST, wave_tool::WaterGrid::IndexLayout::TILED_LIST, wave_tool::WaterGrid::IndexLayout::TILED_STRIP}) {
+                GLuint const bandCellRowCount{wave_tool::WaterGrid::getBandCellRowCount(level, indexLayout)};
+                unsigned int const bandCount{wave_tool::WaterGrid::getBandCount(level, indexLayout)};
+                wave_tool::WaterGrid::generateIndices(gridLength, bandCellRowCount, indexLayout, indices);
+
+                // the band must fit its declared size, and a 16-bit band must not reach the restart index with a vertex
+                bool isLayoutValid{indices.size() == (std::size_t)wave_tool::WaterGrid::getIndexCount(level, indexLayout) && bandCount * bandCellRowCount == gridLength - 1};
+                if (wave_tool::WaterGrid::IndexLayout::ROW_LIST != indexLayout) {
+                    for (GLuint const index : indices) isLayoutValid = isLayoutValid && (index < (bandCellRowCount + 1) * gridLength || (wave_tool::WaterGrid::IndexLayout::TILED_STRIP == indexLayout && wave_tool::WaterGrid::PRIMITIVE_RESTART_INDEX == index));
+                    isLayoutValid = isLayoutValid && (bandCellRowCount + 1) * gridLength <= wave_tool::WaterGrid::PRIMITIVE_RESTART_INDEX;
+                }
+
+                std::array<float, 2> ACMRs{wave_tool::WaterGrid::computeAverageCacheMissRatio(indices, indexLayout, 16), wave_tool::WaterGrid::computeAverageCacheMissRatio(indices, indexLayout, 32)};
+                float const minACMR{(float)((bandCellRowCount + 1) * gridLength) / (2 * bandCellRowCount * (gridLength - 1))};
+                for (float const ACMR : ACMRs) isLayoutValid = isLayoutValid && ACMR >= minACMR && ACMR <= 3.0f;
+                if (wave_tool::WaterGrid::IndexLayout::ROW_LIST == indexLayout) {
+                    collectTriangles(indices, indexLayout, bandCount, bandCellRowCount * gridLength, referenceTriangles);
+                    isLayoutValid = isLayoutValid && referenceTriangles.size() == (std::size_t)wave_tool::WaterGrid::getTriangleCount(level) && std::adjacent_find(referenceTriangles.begin(), referenceTriangles.end()) == referenceTriangles.end();
+                    referenceACMRs = ACMRs;
+                } else {
+                    collectTriangles(indices, indexLayout, bandCount, bandCellRowCount * gridLength, triangles);
+                    isLayoutValid = isLayoutValid && triangles == referenceTriangles && ACMRs.at(0) < referenceACMRs.at(0) && ACMRs.at(1) < referenceACMRs.at(1);
+                }
+                isValid = isValid && isLayoutValid;
+                std::cout << "    " << getLayoutName(indexLayout) << ": " << bandCount << " x " << indices.size() << " indices, ACMR " << ACMRs.at(0) << " (16) " << ACMRs.at(1) << " (32) -> " << (isLayoutValid ? "OK" : "FAILED") << std::endl;
+            }
+        }
+        return isValid;
+    }
+
+    // hand-counted FIFO cases, then a cache big enough for a whole (small) band, where every vertex misses exactly once
+    bool testAverageCacheMissRatio() {
+        // 2 triangles sharing an edge (0, 1, 2) (2, 1, 3)
+        std::vector<GLuint> const quad{0, 1, 2, 2, 1, 3};
+        // 4 misses with room for every vertex, 5 when the cache only holds the last vertex (1 is evicted by 2)
+        bool isValid{2.0f == wave_tool::WaterGrid::computeAverageCacheMissRatio(quad, wave_tool::WaterGrid::IndexLayout::ROW_LIST, 4)
+                     && 2.5f == wave_tool::WaterGrid::computeAverageCacheMissRatio(quad, wave_tool::WaterGrid::IndexLayout::ROW_LIST, 1)
+                     && 0.0f == wave_tool::WaterGrid::computeAverageCacheMissRatio(quad, wave_tool::WaterGrid::IndexLayout::ROW_LIST, 0)};
+        // the same quad as a strip, with the restart index (never a miss) and a degenerate triangle (never counted)
+        std::vector<GLuint> const strip{0, 1, 2, 3, wave_tool::WaterGrid::PRIMITIVE_RESTART_INDEX, 3, 3, 2};
+        isValid = isValid && 2.0f == wave_tool::WaterGrid::computeAverageCacheMissRatio(strip, wave_tool::WaterGrid::IndexLayout::TILED_STRIP, 4);
+        std::cout << "  hand-counted FIFO cases -> " << (isValid ? "OK" : "FAILED") << std::endl;
+
+        GLuint const GRID_LENGTH{17};
+        GLuint const BAND_CELL_ROW_COUNT{16};
+        std::vector<GLuint> indices;
+        for (wave_tool::WaterGrid::IndexLayout const indexLayout : {wave_tool::WaterGrid::IndexLayout::ROW_LIST, wave_tool::WaterGrid::IndexLayout::TILED_LIST, wave_tool::WaterGrid::IndexLayout::TILED_STRIP}) {
+            wave_tool::WaterGrid::generateIndices(GRID_LENGTH, BAND_CELL_ROW_COUNT, indexLayout, indices);
+            float const ACMR{wave_tool::WaterGrid::computeAverageCacheMissRatio(indices, indexLayout, (BAND_CELL_ROW_COUNT + 1) * GRID_LENGTH)};
+            bool const isLayoutValid{(float)((BAND_CELL_ROW_COUNT + 1) * GRID_LENGTH) / (2 * BAND_CELL_ROW_COUNT * (GRID_LENGTH - 1)) == ACMR};
+            isValid = isValid && isLayoutValid;
+            std::cout << "  " << getLayoutName(indexLayout) << ", " << GRID_LENGTH << " x " << GRID_LENGTH << " with every vertex cached: ACMR " << ACMR << " -> " << (isLayoutValid ? "OK" : "FAILED") << std::endl;
+        }
+        return isValid;
+    }
+}
+
+int main() {
+    std::cout << "water-grid-indices (strip width " << wave_tool::WaterGrid::CACHE_STRIP_CELL_COUNT << " cells)" << std::endl;
+    bool isValid{testAverageCacheMissRatio()};
+    isValid = testLayouts() && isValid;
+
+    std::cout << (isValid ? "all water-grid-indices tests passed" : "ERROR: water-grid-indices-tests.cpp - some water-grid-indices tests failed!") << std::endl;
+    return isValid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
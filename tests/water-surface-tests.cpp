@@ -0,0 +1,157 @@
+// BSD 3 - Clause License
+//
+// Copyright(c) 2020, Aaron Hornby
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//     SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//     OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+// tests for WaterSurface's fast (SoA, auto-vectorized, threaded) grid evaluation against the scalar line-by-line port of water-grid.vert, over a few sea states, times and grid lengths,
+// that the thread pool doesn't change the result, and that the branch-free sinCos() keeps its stated accuracy
+// run with ctest (or directly, with the heightmap's path as the only argument), exits with EXIT_FAILURE if any case fails
+//NOTE: only links the non-GL water surface library, so no GL context/window is needed
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "gerstner-wave.h"
+#include "thread-pool.h"
+#include "water-surface.h"
+
+namespace {
+    // more than the CPUs most machines running this have, so the rows get split into many uneven chunks
+    unsigned int const THREAD_COUNT{8};
+
+    // roughly what the projected grid covers from the default camera (same as --benchmark water-surface)
+    wave_tool::WaterGridCorners const CORNERS{glm::vec4{-60.0f, 0.0f, 20.0f, 1.0f}, glm::vec4{-400.0f, 0.0f, -500.0f, 1.0f}, glm::vec4{60.0f, 0.0f, 20.0f, 1.0f}, glm::vec4{400.0f, 0.0f, -500.0f, 1.0f}};
+
+    // a stand-in for the application's heightmap (a few octaves of ripples) when its file can't be found
+    std::shared_ptr<wave_tool::Heightmap> makeHeightmap() {
+        unsigned int const SIZE{256};
+        std::vector<unsigned char> data(4 * SIZE * SIZE, 255);
+        for (unsigned int y = 0; y < SIZE; ++y) {
+            for (unsigned int x = 0; x < SIZE; ++x) {
+                float const intensity{0.5f + 0.25f * std::sin(0.11f * x + 0.07f * y) + 0.15f * std::sin(0.53f * x - 0.31f * y) + 0.1f * std::cos(1.7f * y)};
+                data.at(4 * (x + SIZE * y)) = (unsigned char)(255.0f * glm::clamp(intensity, 0.0f, 1.0f));
+            }
+        }
+        return wave_tool::Heightmap::fromRGBA8(data.data(), SIZE, SIZE);
+    }
+
+    // the fast path against the reference at a few different times, then the pooled result against the single-threaded one (which has to match exactly, every row is evaluated on its own)
+    //NOTE: the position tolerance is relative to the displacement range, since the grid positions themselves can be in the hundreds
+    //NOTE: the heightmap slope is piecewise constant (it jumps at every texel edge), so a vertex that rounds onto the other side of an edge gets a different normal, thus only the fraction of mismatched normals is checked
+    bool testGrid(wave_tool::WaterSurfaceState state, float const totalAmplitude, unsigned int const gridLength, wave_tool::ThreadPool &threadPool) {
+        float const POSITION_TOLERANCE{1.0e-3f * (1.0f + totalAmplitude + 2.0f * state.heightmapDisplacementScale)};
+        float const NORMAL_TOLERANCE{1.0e-3f};
+        float const MAX_MISMATCHED_NORMAL_FRACTION{0.01f};
+        wave_tool::WaterGridSoA fastGrid;
+        wave_tool::WaterGridSoA pooledGrid;
+        wave_tool::WaterGridSoA referenceGrid;
+        float maxPositionError{0.0f};
+        float maxNormalError{0.0f};
+        std::size_t mismatchedNormalCount{0};
+        std::size_t comparedVertexCount{0};
+        bool isPoolDeterministic{true};
+        for (float const timeInSeconds : {0.0f, 12.345f, 1000.0f}) {
+            state.timeInSeconds = timeInSeconds;
+            wave_tool::WaterSurface::evaluateGrid(CORNERS, gridLength, state, nullptr, fastGrid);
+            wave_tool::WaterSurface::evaluateGrid(CORNERS, gridLength, state, &threadPool, pooledGrid);
+            wave_tool::WaterSurface::evaluateGridReference(CORNERS, gridLength, state, referenceGrid);
+            for (std::size_t i = 0; i < referenceGrid.positionX.size(); ++i) {
+                maxPositionError = std::max({maxPositionError, std::abs(fastGrid.positionX[i] - referenceGrid.positionX[i]), std::abs(fastGrid.positionY[i] - referenceGrid.positionY[i]), std::abs(fastGrid.positionZ[i] - referenceGrid.positionZ[i])});
+                float const normalError{std::max({std::abs(fastGrid.normalX[i] - referenceGrid.normalX[i]), std::abs(fastGrid.normalY[i] - referenceGrid.normalY[i]), std::abs(fastGrid.normalZ[i] - referenceGrid.normalZ[i])})};
+                maxNormalError = std::max(maxNormalError, normalError);
+                if (normalError > NORMAL_TOLERANCE) ++mismatchedNormalCount;
+            }
+            comparedVertexCount += referenceGrid.positionX.size();
+            isPoolDeterministic = isPoolDeterministic && fastGrid.positionX == pooledGrid.positionX && fastGrid.positionY == pooledGrid.positionY && fastGrid.positionZ == pooledGrid.positionZ
+                                  && fastGrid.normalX == pooledGrid.normalX && fastGrid.normalY == pooledGrid.normalY && fastGrid.normalZ == pooledGrid.normalZ;
+        }
+        float const mismatchedNormalFraction{(float)mismatchedNormalCount / comparedVertexCount};
+        bool const isValid{referenceGrid.positionX.size() == (std::size_t)gridLength * gridLength && maxPositionError <= POSITION_TOLERANCE && mismatchedNormalFraction <= MAX_MISMATCHED_NORMAL_FRACTION && isPoolDeterministic};
+        std::cout << "    " << gridLength << " x " << gridLength << ": max position error " << maxPositionError << " (tolerance " << POSITION_TOLERANCE << ")"
+                  << ", normals off by > " << NORMAL_TOLERANCE << ": " << mismatchedNormalFraction << " (max error " << maxNormalError << ")"
+                  << ", " << threadPool.getThreadCount() << " threads " << (isPoolDeterministic ? "match" : "DON'T match") << " 1 -> " << (isValid ? "OK" : "FAILED") << std::endl;
+        return isValid;
+    }
+
+    // ~1e-7 absolute on [-8192, 8192] is the claim, plus the float rounding of x itself (up to 2^-11 at 8192, which moves the result by as much)
+    bool testSinCos() {
+        unsigned int const SAMPLE_COUNT{1000000};
+        double maxError{0.0};
+        double maxRelativeToArgumentError{0.0};
+        for (unsigned int i = 0; i <= SAMPLE_COUNT; ++i) {
+            float const x{-8192.0f + 16384.0f * i / SAMPLE_COUNT};
+            float s;
+            float c;
+            wave_tool::WaterSurface::sinCos(x, s, c);
+            double const error{std::max(std::abs(s - std::sin((double)x)), std::abs(c - std::cos((double)x)))};
+            maxError = std::max(maxError, error);
+            // the error beyond what rounding x's reduction by pi/2 (in float) accounts for
+            maxRelativeToArgumentError = std::max(maxRelativeToArgumentError, error / (1.0 + std::abs((double)x) * 1.0e-7));
+        }
+        bool const isValid{maxRelativeToArgumentError <= 1.0e-6};
+        std::cout << "  sinCos on [-8192, 8192]: max abs. error " << maxError << " (" << maxRelativeToArgumentError << " scaled by 1 + |x| x 1e-7, tolerance 1e-6) -> " << (isValid ? "OK" : "FAILED") << std::endl;
+        return isValid;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    std::shared_ptr<wave_tool::Heightmap const> heightmap{argc > 1 ? wave_tool::Heightmap::loadFromFile(argv[1]) : nullptr};
+    if (nullptr == heightmap) {
+        std::cout << "WARNING: no heightmap given (or it can't be loaded), testing with a generated one" << std::endl;
+        heightmap = makeHeightmap();
+    }
+
+    std::cout << "water-surface" << std::endl;
+    bool isValid{testSinCos()};
+    wave_tool::ThreadPool threadPool{THREAD_COUNT};
+    for (unsigned int const waveCount : {0u, 4u, 16u}) {
+        for (bool const isUsingHeightmap : {false, true}) {
+            wave_tool::geometry::SeaStateParameters seaStateParameters;
+            seaStateParameters.waveCount = std::max(waveCount, 1u);
+            std::vector<wave_tool::geometry::GerstnerWave> gerstnerWaves{wave_tool::geometry::generateSeaState(seaStateParameters)};
+            if (0 == waveCount) gerstnerWaves.clear();
+
+            wave_tool::WaterSurfaceState state;
+            wave_tool::geometry::packGerstnerWavesStd140(gerstnerWaves, state.gerstnerWaves);
+            if (isUsingHeightmap) state.heightmap = heightmap;
+            state.verticalBounceWaveDisplacement = 0.1f;
+            std::cout << "  " << gerstnerWaves.size() << " waves" << (isUsingHeightmap ? " + heightmap" : "") << ":" << std::endl;
+            for (unsigned int const gridLength : {2u, 65u, 257u}) isValid = testGrid(state, wave_tool::geometry::computeTotalAmplitude(gerstnerWaves), gridLength, threadPool) && isValid;
+        }
+    }
+
+    std::cout << (isValid ? "all water-surface tests passed" : "ERROR: water-surface-tests.cpp - some water-surface tests failed!") << std::endl;
+    return isValid ? EXIT_SUCCESS : EXIT_FAILURE;
+}